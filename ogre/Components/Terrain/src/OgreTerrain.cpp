@@ -254,8 +254,9 @@ namespace Ogre
 	void Terrain::save(const String& filename)
 	{
 		DataStreamPtr stream = Root::getSingleton().createFileStream(filename, _getDerivedResourceGroup(), true);
-		// Compress
-		DataStreamPtr compressStream(OGRE_NEW DeflateStream(filename, stream));
+		// Compress, in chunks so that parts of the data can be read without
+		// inflating everything before them
+		DataStreamPtr compressStream(OGRE_NEW DeflateStream(filename, stream, 65536));
 		StreamSerialiser ser(compressStream);
 		save(ser);
 	}
@@ -82,6 +82,7 @@ THE SOFTWARE.
 #include "OgrePatchSurface.h"
 #include "OgreProfiler.h"
 #include "OgreRadixSort.h"
+#include "OgreIncrementalSort.h"
 #include "OgreRenderQueueInvocation.h"
 #include "OgreRenderQueueListener.h"
 #include "OgreRenderObjectListener.h"
@@ -99,6 +100,7 @@ THE SOFTWARE.
 #include "OgreSimpleRenderable.h"
 #include "OgreSkeleton.h"
 #include "OgreSkeletonInstance.h"
+#include "OgreSkeletonAnimationCache.h"
 #include "OgreSkeletonManager.h"
 #include "OgreSkeletonSerializer.h"
 #include "OgreStaticGeometry.h"
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgreParticleSystemRenderer.h"
 #include "OgreBillboardSet.h"
+#include "OgreBillboard.h"
 
 namespace Ogre {
 
@@ -53,6 +54,8 @@ namespace Ogre {
     protected:
         /// The billboard set that's doing the rendering
         BillboardSet* mBillboardSet;
+        /// Billboards built from the particles, injected into the set as one batch
+        vector<Billboard>::type mBillboardBatch;
     public:
         BillboardParticleRenderer();
         ~BillboardParticleRenderer();
@@ -202,6 +205,11 @@ namespace Ogre {
         /// @copydoc ParticleSystemRenderer::_updateRenderQueue
         void _updateRenderQueue(RenderQueue* queue, 
             list<Particle*>::type& currentParticles, bool cullIndividually);
+        /// @copydoc ParticleSystemRenderer::_supportsPackedParticles
+        bool _supportsPackedParticles(void) const { return true; }
+        /// @copydoc ParticleSystemRenderer::_updateRenderQueue
+        void _updateRenderQueue(RenderQueue* queue, 
+            PackedParticleData& currentParticles, bool cullIndividually);
 		/// @copydoc ParticleSystemRenderer::visitRenderables
 		void visitRenderables(Renderable::Visitor* visitor, 
 			bool debugRenderables = false);
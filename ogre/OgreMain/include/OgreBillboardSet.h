@@ -33,7 +33,7 @@ THE SOFTWARE.
 
 #include "OgreMovableObject.h"
 #include "OgreRenderable.h"
-#include "OgreRadixSort.h"
+#include "OgreIncrementalSort.h"
 #include "OgreCommon.h"
 #include "OgreResourceGroupManager.h"
 
@@ -250,6 +250,29 @@ namespace Ogre {
         */
         void genVertices(const Vector3* const offsets, const Billboard& pBillboard);
 
+        /** Internal method for generating the offsets and vertex data of a single
+            billboard, as used by injectBillboard.
+        */
+        void genBillboardVertices(const Billboard& bb);
+
+        /** Internal method for generating the vertex data of a batch of visible billboards.
+        @remarks
+            When the billboard axes are shared by the whole set, the quads are
+            expanded in a single pass without per-vertex branches (using SSE where
+            available), otherwise this falls back to genBillboardVertices.
+        */
+        void genBatchVertices(const Billboard* const* billboards, size_t count);
+
+        /** Adds a billboard to the current batch if it is visible.
+        @returns false if the pool is full and no more billboards can be accepted
+        */
+        bool addBatchBillboard(const Billboard& bb);
+        /** Generates the vertex data of the current batch. */
+        void flushBatchBillboards(void);
+
+        /// Visible billboards gathered for batch vertex generation
+        vector<const Billboard*>::type mBatchBillboards;
+
         /** Internal method generates vertex offsets.
         @remarks
             Takes in parametric offsets as generated from getParametericOffsets, width and height values
@@ -282,7 +305,25 @@ namespace Ogre {
             float operator()(Billboard* bill) const;
         };
 
-		static RadixSort<ActiveBillboardList, Billboard*, float> mRadixSorter;
+		/// Sorts active billboards, starting from the order of the previous sort
+		IncrementalSort<Billboard*> mBillboardSorter;
+
+		/** Sort the active billboard list using one of the sort functors */
+		template <class SortFunctor>
+		void sortActiveBillboards(const SortFunctor& func)
+		{
+			mBillboardSorter.begin(mActiveBillboards.size());
+			ActiveBillboardList::iterator i, iend = mActiveBillboards.end();
+			for (i = mActiveBillboards.begin(); i != iend; ++i)
+				mBillboardSorter.add(*i, func(*i));
+
+			if (mBillboardSorter.sort())
+			{
+				size_t n = 0;
+				for (i = mActiveBillboards.begin(); i != iend; ++i, ++n)
+					*i = mBillboardSorter.getItem(n);
+			}
+		}
 
 		/// Use point rendering?
 		bool mPointRendering;
@@ -300,6 +341,10 @@ namespace Ogre {
 		bool mAutoUpdate;
 		/// True if the billboard data changed. Will cause vertex buffer update.
 		bool mBillboardDataChanged;
+        /// First vertex of the buffer region holding the current billboards
+        size_t mVertexRegionStart;
+        /// First vertex of the buffer region the next update will write to
+        size_t mVertexRingOffset;
 
         /** Internal method creates vertex and index buffers.
         */
@@ -549,6 +594,13 @@ namespace Ogre {
         void beginBillboards(size_t numBillboards = 0);
         /** Define a billboard. */
         void injectBillboard(const Billboard& bb);
+        /** Define a contiguous array of billboards.
+        @remarks
+            Equivalent to calling injectBillboard for each element, but the
+            vertex data is generated in a single batch, which is much cheaper
+            when the billboards share their orientation.
+        */
+        void injectBillboards(const Billboard* billboards, size_t count);
         /** Finish defining billboards. */
         void endBillboards(void);
 		/** Set the bounds of the BillboardSet.
@@ -834,6 +886,9 @@ namespace Ogre {
 			When using static or semi-static billboards, it is recommended to set auto update to false.
 			In that case one should call notifyBillboardDataChanged method to reflect changes made to the
 			billboards data.			
+			An auto updating set keeps room for several updates in its vertex buffer and
+			fills them in turn, so that an update never has to wait for the GPU to finish
+			drawing the previous one.
 		*/
 		void setAutoUpdate(bool autoUpdate);
 
@@ -38,14 +38,16 @@ namespace Ogre {
 	*/
 
 	// Forward declarations
-	struct DXTColourBlock;
-	struct DXTExplicitAlphaBlock;
-	struct DXTInterpolatedAlphaBlock;
+	struct DDSHeader;
 
     /** Codec specialized in loading DDS (Direct Draw Surface) images.
 	@remarks
 		We implement our own codec here since we need to be able to keep DXT
 		data compressed if the card supports it.
+	@par
+		When it does not, or there is no render system, DXT1-5 data is
+		decompressed to PF_BYTE_RGBA. BC4 and BC5 (ATI1 and ATI2) data is always
+		decompressed, to red or red and green in PF_BYTE_RGBA.
     */
     class _OgreExport DDSCodec : public ImageCodec
     {
@@ -59,12 +61,9 @@ namespace Ogre {
 		PixelFormat convertPixelFormat(uint32 rgbBits, uint32 rMask, 
 			uint32 gMask, uint32 bMask, uint32 aMask) const;
 
-		/// Unpack DXT colours into array of 16 colour values
-		void unpackDXTColour(PixelFormat pf, const DXTColourBlock& block, ColourValue* pCol) const;
-		/// Unpack DXT alphas into array of 16 colour values
-		void unpackDXTAlpha(const DXTExplicitAlphaBlock& block, ColourValue* pCol) const;
-		/// Unpack DXT alphas into array of 16 colour values
-		void unpackDXTAlpha(const DXTInterpolatedAlphaBlock& block, ColourValue* pCol) const;
+		/// Reads and checks the file header and describes the complete image held in the file
+		ImageData* readHeader(DataStreamPtr& stream, DDSHeader& header,
+			PixelFormat& sourceFormat, bool& decompressDXT) const;
 
 		/// Single registered codec instance
 		static DDSCodec* msInstance;
@@ -78,6 +77,13 @@ namespace Ogre {
         void codeToFile(MemoryDataStreamPtr& input, const String& outFileName, CodecDataPtr& pData) const;
         /// @copydoc Codec::decode
         DecodeResult decode(DataStreamPtr& input) const;
+        /// @copydoc ImageCodec::decodeHeader
+        CodecDataPtr decodeHeader(DataStreamPtr& input) const;
+        /** @copydoc ImageCodec::decodeMipmaps
+        @remarks
+            Levels which are not asked for are skipped without being read.
+        */
+        DecodeResult decodeMipmaps(DataStreamPtr& input, size_t firstMip, size_t numMips) const;
 		/// @copydoc Codec::magicNumberToFileExt
 		String magicNumberToFileExt(const char *magicNumberPtr, size_t maxbytes) const;
         
@@ -295,6 +295,15 @@ namespace Ogre {
 		*/
         size_t size(void) const { return mSize; }
 
+		/** Returns a pointer to the contents of the stream, if they are held in memory.
+		@remarks
+			Streams backed by memory (such as MemoryDataStream and MappedFileDataStream)
+			return a pointer to their first byte, which remains valid until the stream is
+			closed, so that loaders can use size() bytes of data in place instead of 
+			copying them with read. Other streams return 0.
+		*/
+		virtual const uchar* getDataPtr(void) const { return 0; }
+
         /** Close the stream; this makes further operations invalid. */
         virtual void close(void) = 0;
 		
@@ -436,6 +445,10 @@ namespace Ogre {
 		
 		/** Get a pointer to the current position in the memory block this stream holds. */
 		uchar* getCurrentPtr(void) { return mPos; }
+
+		/** @copydoc DataStream::getDataPtr
+		*/
+		const uchar* getDataPtr(void) const { return mData; }
 		
 		/** @copydoc DataStream::read
 		*/
@@ -482,6 +495,38 @@ namespace Ogre {
     */
     typedef SharedPtr<MemoryDataStream> MemoryDataStreamPtr;
 
+	/** Subclass of MemoryDataStream giving read-only access to a file 
+		mapped into memory.
+	@remarks
+		The file contents are paged in by the operating system as they are 
+		accessed, so the data can be used in place through getPtr / getDataPtr 
+		without first being copied into a buffer of its own. The mapping is
+		released when the stream is closed.
+	*/
+	class _OgreExport MappedFileDataStream : public MemoryDataStream
+	{
+	protected:
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+		/// Handle of the open file
+		void* mFileHandle;
+		/// Handle of the file mapping object
+		void* mMappingHandle;
+#endif
+	public:
+		/** Map a file into memory.
+		@param name The name to give this stream
+		@param filename Full path of the file to map
+		@note Throws an exception if the file can't be opened or mapped.
+		*/
+		MappedFileDataStream(const String& name, const String& filename);
+
+		~MappedFileDataStream();
+
+        /** @copydoc DataStream::close
+        */
+        void close(void);
+	};
+
     /** Common subclass of DataStream for handling data from 
 		std::basic_istream.
 	*/
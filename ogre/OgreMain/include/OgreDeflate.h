@@ -51,6 +51,13 @@ namespace Ogre
 		You should avoid using this with already compressed archives.
 		Also note that this cannot be used as a read / write stream, only a read-only
 		or write-only stream.
+	@par
+		When written with a non-zero chunk size, the data is compressed as a series
+		of independent blocks preceded by an index of their offsets. Reading such
+		a stream is random access: seek / read only decompress the blocks they need,
+		and reads spanning several blocks decompress them in parallel. The chunked
+		format is detected automatically when reading, plain deflate streams are
+		still read as before.
 	*/
 	class _OgreExport DeflateStream : public DataStream
 	{
@@ -69,23 +76,45 @@ namespace Ogre
 		
 		// Whether the underlying stream is valid compressed data
 		bool mIsCompressedValid;
+
+		// Position of the compressed data in the underlying stream
+		size_t mCompressedStart;
+		// Block size of chunked data, 0 for a plain deflate stream
+		size_t mChunkSize;
+		// Chunk offsets relative to mCompressedStart when reading chunked data
+		vector<uint64>::type mChunkOffsets;
+		// Last decompressed chunk
+		uchar* mChunkBuffer;
+		size_t mCachedChunk;
+		// Staging area for compressed chunks read from the underlying stream
+		vector<uchar>::type mCompressedBuffer;
 		
 		
 		void init();
+		void initChunked(const uchar* header);
 		void destroy();
 		void compressFinal();
+		void compressFinalChunked();
+		size_t readChunked(void* buf, size_t count);
+		const uchar* readCompressedChunks(size_t firstChunk, size_t endChunk);
 	public:
 		/** Constructor for creating unnamed stream wrapping another stream.
 		 @param compressedStream The stream that this stream will use when reading / 
 			writing compressed data. The access mode from this stream will be matched.
+		 @param chunkSize When writing, the size of the independently compressed 
+			blocks, or 0 to write a plain deflate stream.
 		*/
-        DeflateStream(const DataStreamPtr& compressedStream);
+        DeflateStream(const DataStreamPtr& compressedStream, size_t chunkSize = 0);
 		/** Constructor for creating named stream wrapping another stream.
 		 @param name The name to give this stream
 		 @param compressedStream The stream that this stream will use when reading / 
 			writing compressed data. The access mode from this stream will be matched.
+		 @param chunkSize When writing, the size of the independently compressed 
+			blocks, or 0 to write a plain deflate stream. Ignored when reading, 
+			since the format is detected from the data.
 		 */
-		DeflateStream(const String& name, const DataStreamPtr& compressedStream);	
+		DeflateStream(const String& name, const DataStreamPtr& compressedStream, 
+			size_t chunkSize = 0);	
 		
 		~DeflateStream();
 		
@@ -96,6 +125,13 @@ namespace Ogre
 			will actually be executed as passthroughs as a fallback. 
 		*/
 		bool isCompressedStreamValid() const { return mIsCompressedValid; }
+
+		/** Returns whether the stream is in the seekable chunked format.
+		@remarks
+			For read streams this reflects the data found in the underlying stream,
+			size() then returns the uncompressed size.
+		*/
+		bool isChunked() const { return mChunkSize != 0; }
 		
 		/** @copydoc DataStream::read
 		 */
@@ -194,6 +194,8 @@ namespace Ogre {
 
 		/// Private method to cache bone matrices from skeleton
 		void cacheBoneMatrices(void);
+		/// Private method to determine whether bone matrices can come from the shared cache
+		bool useSkeletonAnimationCache(void) const;
 
 		/// Flag determines whether or not to display skeleton
 		bool mDisplaySkeleton;
@@ -218,6 +220,8 @@ namespace Ogre {
 		bool mSkipAnimStateUpdates;
 		/// Flag indicating whether to update the main entity skeleton even when an LOD is displayed
 		bool mAlwaysUpdateMainSkeleton;
+		/// Optional cache of bone matrices shared with other entities
+		SkeletonAnimationCache* mSkeletonAnimationCache;
 
 
 		/// The LOD number of the mesh to use, calculated by _notifyCurrentCamera
@@ -833,6 +837,25 @@ namespace Ogre {
 			return mAlwaysUpdateMainSkeleton;
 		}
 
+		/** Sets a cache through which this entity shares its bone matrices with
+			other entities using the same skeleton and animation state.
+		@remarks
+			This is useful for crowds where many entities play the same animation
+			at nearly the same time. The cache is not owned by the entity and must
+			outlive it, pass null to stop using a cache. Entities with objects
+			attached to bones, manual bones, blend masks or a displayed skeleton
+			bypass the cache.
+		@see SkeletonAnimationCache
+		*/
+		void setSkeletonAnimationCache(SkeletonAnimationCache* cache) {
+			mSkeletonAnimationCache = cache;
+		}
+
+		/** Gets the cache through which this entity shares its bone matrices, if any. */
+		SkeletonAnimationCache* getSkeletonAnimationCache() const {
+			return mSkeletonAnimationCache;
+		}
+
 		
 	};
 
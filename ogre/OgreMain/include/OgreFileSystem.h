@@ -116,7 +116,26 @@ namespace Ogre {
 			return ms_IgnoreHidden;
 		}
 
+		/** Set whether files opened read-only are mapped into memory.
+		@remarks
+			When enabled, open returns a MappedFileDataStream for read-only
+			requests, which lets loaders use the file contents in place instead
+			of reading them into buffers of their own. Writeable streams and 
+			empty files always use a FileStreamDataStream. The default is false.
+		*/
+		static void setUseMemoryMapping(bool mapping)
+		{
+			ms_UseMemoryMapping = mapping;
+		}
+
+		/// Get whether files opened read-only are mapped into memory.
+		static bool getUseMemoryMapping()
+		{
+			return ms_UseMemoryMapping;
+		}
+
 		static bool ms_IgnoreHidden;
+		static bool ms_UseMemoryMapping;
     };
 
     /** Specialisation of ArchiveFactory for FileSystem files. */
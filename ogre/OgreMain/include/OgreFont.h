@@ -160,8 +160,30 @@ namespace Ogre
 		/// Range of code points to generate glyphs for (truetype only)
 		CodePointRangeList mCodePointRangeList;
 
+		/// Name of the glyph atlas glyphs are rendered into on demand, if any
+		String mGlyphAtlasName;
+		/// The glyph atlas, while loaded
+		GlyphAtlas* mGlyphAtlas;
+		/// The truetype face glyphs are rendered from on demand
+		struct GlyphRenderer;
+		GlyphRenderer* mGlyphRenderer;
+
+		/// Renders a glyph into the glyph atlas, or returns the one already there
+		const GlyphInfo* getAtlasGlyph(CodePoint id) const;
+
+		/// Returns the glyph for a code point, or null if there is none
+		inline const GlyphInfo* findGlyph(CodePoint id) const
+		{
+			if (mGlyphAtlas)
+				return getAtlasGlyph(id);
+			CodePointMap::const_iterator i = mCodePointMap.find(id);
+			return i != mCodePointMap.end() ? &i->second : 0;
+		}
+
         /// Internal method for loading from ttf
         void createTextureFromFont(void);
+		/// Internal method for opening the ttf glyphs are rendered from on demand
+		void createGlyphRenderer(void);
 
 		/// @copydoc Resource::loadImpl
 		virtual void loadImpl();
@@ -249,10 +271,10 @@ namespace Ogre
         */
         inline const UVRect& getGlyphTexCoords(CodePoint id) const
         {
-			CodePointMap::const_iterator i = mCodePointMap.find(id);
-			if (i != mCodePointMap.end())
+			const GlyphInfo* glyph = findGlyph(id);
+			if (glyph)
 			{
-				return i->second.uvRect;
+				return glyph->uvRect;
 			}
 			else
 			{
@@ -291,10 +313,10 @@ namespace Ogre
         /** Gets the aspect ratio (width / height) of this character. */
         inline Real getGlyphAspectRatio(CodePoint id) const
         {
-			CodePointMap::const_iterator i = mCodePointMap.find(id);
-			if (i != mCodePointMap.end())
+			const GlyphInfo* glyph = findGlyph(id);
+			if (glyph)
 			{
-				return i->second.aspectRatio;
+				return glyph->aspectRatio;
 			}
 			else
 			{
@@ -386,6 +408,28 @@ namespace Ogre
             return mAntialiasColour;
         }
 
+		/** Sets the glyph atlas this truetype font renders its glyphs into.
+		@remarks
+			By default a truetype font renders every glyph in its code point ranges
+			into a texture of its own when it is loaded. A font given a glyph atlas
+			instead renders each glyph the first time its texture coordinates or
+			aspect ratio are asked for, and adds it to the atlas, so the code point
+			ranges are ignored and loading is quick whatever the size of the font.
+			Glyphs may be dropped from the atlas to make room for others, see 
+			GlyphAtlas. If FontManager has no atlas of this name when the font is
+			loaded, one of the default size is created. Must be set before loading;
+			the fontdef attribute is 'glyph_atlas'.
+		@param name The name of the atlas, or blank to render all glyphs at load time
+		*/
+		void setGlyphAtlas(const String& name) { mGlyphAtlasName = name; }
+
+		/** Gets the name of the glyph atlas of this font, if any. */
+		const String& getGlyphAtlas(void) const { return mGlyphAtlasName; }
+
+		/** Gets a number which changes whenever glyph texture coordinates handed
+			out before have become invalid, see GlyphAtlas::getGeneration. */
+		uint32 getGlyphGeneration(void) const;
+
 		/** Implementation of ManualResourceLoader::loadResource, called
 			when the Texture that this font creates needs to (re)load.
 		*/
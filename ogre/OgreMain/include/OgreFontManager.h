@@ -31,6 +31,7 @@ THE SOFTWARE
 #include "OgreSingleton.h"
 #include "OgreResourceManager.h"
 #include "OgreFont.h"
+#include "OgreResourceGroupManager.h"
 
 namespace Ogre
 {
@@ -50,6 +51,20 @@ namespace Ogre
 
         /** @copydoc ScriptLoader::parseScript */
         void parseScript(DataStreamPtr& stream, const String& groupName);
+
+		/** Creates a glyph atlas which fonts can share, see Font::setGlyphAtlas.
+		@param name The name of the atlas, which is also used for its texture
+		@param width The width of the atlas texture
+		@param pageHeight The height of each page of the atlas
+		@param numPages The number of pages
+		@param group The resource group the texture is created in
+		*/
+		GlyphAtlas* createGlyphAtlas(const String& name, size_t width = 1024, size_t pageHeight = 256,
+			size_t numPages = 4, const String& group = ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+		/** Gets a glyph atlas by name, or null if there is none. */
+		GlyphAtlas* getGlyphAtlas(const String& name) const;
+		/** Destroys a glyph atlas. Fonts using it must have been unloaded. */
+		void destroyGlyphAtlas(const String& name);
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
@@ -93,6 +108,9 @@ namespace Ogre
 
         void logBadAttrib(const String& line, FontPtr& pFont);
 
+		typedef map<String, GlyphAtlas*>::type GlyphAtlasMap;
+		GlyphAtlasMap mGlyphAtlases;
+
 
     };
 	/** @} */
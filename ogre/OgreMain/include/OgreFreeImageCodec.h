@@ -56,6 +56,13 @@ namespace Ogre {
 
 		/** Common encoding routine. */
 		FIBITMAP* encode(MemoryDataStreamPtr& input, CodecDataPtr& pData) const;
+		/** Common decoding routine, loads the bitmap held in a stream and describes it.
+		@remarks
+			Bitmaps are converted when Ogre has no matching pixel format. 8 bit palettes
+			are only expanded if expandPalette is set; otherwise they are described as
+			the 24 or 32 bit image they expand to.
+		*/
+		FIBITMAP* load(DataStreamPtr& input, ImageData* imgData, bool expandPalette) const;
 
     public:
         FreeImageCodec(const String &type, unsigned int fiType);
@@ -67,6 +74,8 @@ namespace Ogre {
         void codeToFile(MemoryDataStreamPtr& input, const String& outFileName, CodecDataPtr& pData) const;
         /// @copydoc Codec::decode
         DecodeResult decode(DataStreamPtr& input) const;
+        /// @copydoc ImageCodec::decodeInto
+        CodecDataPtr decodeInto(DataStreamPtr& input, DecodeTarget& target) const;
 
         
         virtual String getType() const;        
@@ -0,0 +1,176 @@
+/*-------------------------------------------------------------------------
+This source file is a part of OGRE
+(Object-oriented Graphics Rendering Engine)
+
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+-------------------------------------------------------------------------*/
+
+#ifndef _GlyphAtlas_H__
+#define _GlyphAtlas_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreFont.h"
+#include "OgreImage.h"
+
+namespace Ogre
+{
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup Resources
+	*  @{
+	*/
+	/** A texture which truetype fonts draw their glyphs into as they are needed.
+	@remarks
+		A Font which has been given a glyph atlas (see Font::setGlyphAtlas) does
+		not render its code point ranges when it is loaded, but renders each glyph
+		the first time its texture coordinates are asked for, and adds it here.
+		Any number of fonts and sizes may share one atlas, and so one texture.
+	@par
+		The texture is split into pages, horizontal bands the width of the texture,
+		which are filled with a skyline allocator. When no page has room for a 
+		new glyph, the least recently used page is cleared; pages used in the 
+		current frame are kept if any other page can be cleared. Glyphs are 
+		uploaded to the texture one rectangle at a time as they are added. 
+	@par
+		Clearing a page moves glyphs which were on it, so getGeneration changes
+		and users of texture coordinates, such as TextAreaOverlayElement, must 
+		ask for them again.
+	*/
+	class _OgreExport GlyphAtlas : public ResourceAlloc, public ManualResourceLoader
+	{
+	public:
+		/** Constructor.
+		@param name The name of the atlas, which is also used for its texture
+		@param group The resource group the texture is created in
+		@param width The width of the texture
+		@param pageHeight The height of each page
+		@param numPages The number of pages; the texture is pageHeight * numPages high
+		*/
+		GlyphAtlas(const String& name, const String& group, size_t width = 1024, 
+			size_t pageHeight = 256, size_t numPages = 4);
+		~GlyphAtlas();
+
+		/// Gets the name of the atlas
+		const String& getName(void) const { return mName; }
+		/// Gets the width of the atlas texture
+		size_t getWidth(void) const { return mImage.getWidth(); }
+		/// Gets the height of each page
+		size_t getPageHeight(void) const { return mPageHeight; }
+		/// Gets the number of pages
+		size_t getNumPages(void) const { return mPages.size(); }
+
+		/** Looks up a glyph a font has added, marking its page as used.
+		@returns The glyph, or null if it is not in the atlas. The pointer is
+			valid until the next call to addGlyph.
+		*/
+		const Font::GlyphInfo* findGlyph(const Font* font, Font::CodePoint id);
+
+		/** Adds a glyph, clearing a page if there is no room for it.
+		@param font The font the glyph belongs to
+		@param id The code point of the glyph
+		@param cell The image of the glyph, which its texture coordinates will cover
+		@returns The glyph, or null if it is too big for a page. The pointer is
+			valid until the next call to addGlyph.
+		*/
+		const Font::GlyphInfo* addGlyph(const Font* font, Font::CodePoint id, const PixelBox& cell);
+
+		/// Forgets all glyphs added by a font
+		void removeGlyphs(const Font* font);
+
+		/** Gets a number which changes whenever glyphs are moved or removed
+			from the atlas, invalidating texture coordinates handed out before. */
+		uint32 getGeneration(void) const { return mGeneration; }
+
+		/// Gets the number of glyphs in the atlas
+		size_t getGlyphCount(void) const { return mGlyphs.size(); }
+
+		/// Gets the number of times a page has been cleared to make room
+		size_t getEvictionCount(void) const { return mEvictionCount; }
+
+		/// Gets the texture, creating it the first time
+		const TexturePtr& getTexture(void);
+
+		/// Gets the contents of the atlas, as uploaded to the texture
+		const Image& getImage(void) const { return mImage; }
+
+		/** Implementation of ManualResourceLoader::loadResource, called
+			when the texture needs to (re)load. */
+		void loadResource(Resource* resource);
+
+	protected:
+		/// A segment of the top edge of the filled part of a page
+		struct SkylineNode
+		{
+			size_t x;
+			size_t y;
+			size_t width;
+		};
+		typedef vector<SkylineNode>::type Skyline;
+
+		struct Page
+		{
+			Skyline skyline;
+			/// Frame in which a glyph on the page was last used
+			unsigned long lastUsedFrame;
+			/// Order of last use, for choosing the page to clear
+			size_t lastUsed;
+		};
+		typedef vector<Page>::type PageList;
+
+		struct Glyph
+		{
+			Font::GlyphInfo info;
+			size_t page;
+		};
+		typedef std::pair<const Font*, Font::CodePoint> GlyphKey;
+		typedef map<GlyphKey, Glyph>::type GlyphMap;
+
+		String mName;
+		String mGroup;
+		size_t mPageHeight;
+		PageList mPages;
+		GlyphMap mGlyphs;
+		/// Contents of the atlas, kept for uploading and reloading the texture
+		Image mImage;
+		TexturePtr mTexture;
+		uint32 mGeneration;
+		size_t mEvictionCount;
+		size_t mUseCount;
+
+		/// Gets the number of the current frame
+		unsigned long getCurrentFrame(void) const;
+		/// Marks a page as used
+		void touchPage(size_t page);
+		/** Finds room for a rectangle on a page, using the lowest position the skyline
+			allows, and returns the position or false if the rectangle does not fit. */
+		bool allocate(Page& page, size_t width, size_t height, size_t& x, size_t& y);
+		/// Clears a page and forgets the glyphs on it
+		void clearPage(size_t page);
+		/// Uploads part of the atlas to the texture, if it is loaded
+		void upload(const Box& box);
+	};
+	/** @} */
+	/** @} */
+}
+
+#endif
@@ -447,19 +447,43 @@ namespace Ogre {
 			FILTER_BILINEAR,
 			FILTER_BOX,
 			FILTER_TRIANGLE,
-			FILTER_BICUBIC
+			FILTER_BICUBIC,
+			/// Windowed sinc with a 3 pixel radius, sharpest when minifying
+			FILTER_LANCZOS,
+			/// Kaiser windowed sinc with a 3 pixel radius, less ringing than FILTER_LANCZOS
+			FILTER_KAISER
 		};
 		/** Scale a 1D, 2D or 3D image volume. 
 			@param 	src			PixelBox containing the source pointer, dimensions and format
 			@param 	dst			PixelBox containing the destination pointer, dimensions and format
 			@param 	filter		Which filter to use
+			@param	gammaCorrect	Whether to filter the colour channels in linear space,
+				treating the data as sRGB encoded; alpha is always filtered as is
 			@remarks 	This function can do pixel format conversion in the process.
+				FILTER_BOX, FILTER_TRIANGLE, FILTER_BICUBIC, FILTER_LANCZOS and FILTER_KAISER
+				are separable filters whose footprint grows with the reduction, so they
+				are the ones to use for minification. All filters but FILTER_NEAREST split
+				the destination into bands of rows, processed in parallel.
 			@note	dst and src can point to the same PixelBox object without any problem
 		*/
-		static void scale(const PixelBox &src, const PixelBox &dst, Filter filter = FILTER_BILINEAR);
+		static void scale(const PixelBox &src, const PixelBox &dst, Filter filter = FILTER_BILINEAR,
+			bool gammaCorrect = false);
 		
 		/** Resize a 2D image, applying the appropriate filter. */
-		void resize(ushort width, ushort height, Filter filter = FILTER_BILINEAR);
+		void resize(ushort width, ushort height, Filter filter = FILTER_BILINEAR, bool gammaCorrect = false);
+
+		/** Generates the complete mipmap chain of the image, down to 1x1x1.
+		@remarks
+			Any existing mipmaps are replaced. Each level is filtered from the one
+			above it, for every face of the image. The image must not be compressed.
+			The chain is built in a new buffer which the image owns afterwards; if
+			the image was given a buffer with autoDelete false, that buffer is left
+			untouched and remains the application's to free.
+		@param filter The filter used to reduce each level
+		@param gammaCorrect Whether to filter the colour channels in linear space,
+			see scale()
+		*/
+		void generateMipmaps(Filter filter = FILTER_BOX, bool gammaCorrect = false);
 		
         // Static function to calculate size in bytes from the number of mipmaps, faces and the dimensions
         static size_t calculateSize(size_t mipmaps, size_t faces, size_t width, size_t height, size_t depth, PixelFormat format);
@@ -80,6 +80,60 @@ namespace Ogre {
         {
             return "ImageData";
         }
+
+        /** Reads the description of the image held in a stream without decoding
+            its pixel data.
+        @remarks
+            The returned ImageData describes the complete image, including all
+            of its mipmaps. Codecs which cannot do this without decoding the
+            whole image return a null pointer, which is the default.
+        */
+        virtual CodecDataPtr decodeHeader(DataStreamPtr& input) const;
+
+        /** Decodes only part of the mipmap chain held in a stream.
+        @remarks
+            Data is arranged as for decode(), all decoded levels of a face followed
+            by the next face, and the returned ImageData describes the decoded
+            levels only: its width, height and depth are those of level firstMip and
+            num_mipmaps is the number of levels decoded after it. The default
+            implementation decodes the whole image and copies out the requested
+            levels; codecs which can seek straight to a level override it.
+        @param input The stream holding the encoded image, positioned at its start
+        @param firstMip The most detailed level to decode
+        @param numMips The number of levels to decode, or 0 for all levels from firstMip
+        */
+        virtual DecodeResult decodeMipmaps(DataStreamPtr& input, size_t firstMip, size_t numMips) const;
+
+        /** Supplies the memory an image is decoded into, see decodeInto(). */
+        class _OgreExport DecodeTarget
+        {
+        public:
+            virtual ~DecodeTarget() {}
+            /** Returns where the top level of the image is to be written.
+            @remarks
+                Called once, as soon as the codec knows what the image is, with the
+                same description decode() would return. The returned box must have 
+                the dimensions of the image, but may have any accessible format and
+                any pitches: the codec converts while it writes. It may for instance
+                be a locked hardware buffer.
+            */
+            virtual PixelBox getDestination(const ImageData& description) = 0;
+        };
+
+        /** Decodes the top level of the first face of an image straight into memory 
+            supplied by the caller.
+        @remarks
+            This saves the copy into an intermediate buffer that decode() makes, and
+            the format conversion when the destination is in another format. The 
+            default implementation decodes the image and converts it into the 
+            destination; codecs which can write into the destination as they decode
+            override it. Implementations keep no state between calls, so several
+            images may be decoded at once on different threads.
+        @param input The stream holding the encoded image
+        @param target Supplies the destination once the image is known
+        @returns The description of the image, as decode() would return it
+        */
+        virtual CodecDataPtr decodeInto(DataStreamPtr& input, DecodeTarget& target) const;
     };
 
 	/** @} */
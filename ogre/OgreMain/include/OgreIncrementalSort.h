@@ -0,0 +1,164 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __IncrementalSort_H__
+#define __IncrementalSort_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreRadixSort.h"
+
+namespace Ogre {
+
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup General
+	*  @{
+	*/
+	/** Class for sorting items by a float key when the order changes little
+		between successive sorts.
+	@remarks
+		Depth sorting particles or billboards every frame usually finds them in
+		almost the same order as the frame before. This class holds the items
+		and their keys in a flat array, in the order of the previous sort, and
+		sorts it with an insertion sort, which is close to linear for nearly
+		sorted data. If the number of moves exceeds a limit relative to the number
+		of items the order is considered badly disturbed; the insertion sort is
+		abandoned and a RadixSort is used instead, and the next sort goes straight
+		to the radix sort too.
+	@par
+		Usage: call begin, add every item with its key in the current order of the
+		items, call sort, then read the items back with getItem. Both sorts are stable 
+		and sort ascending, so the result is the same whichever is used.
+	*/
+	template <class T>
+	class IncrementalSort
+	{
+	public:
+		struct Entry
+		{
+			float key;
+			T item;
+		};
+		typedef typename vector<Entry>::type EntryList;
+
+	protected:
+		struct EntryKeyFunctor
+		{
+			float operator()(const Entry& e) const { return e.key; }
+		};
+
+		EntryList mEntries;
+		RadixSort<EntryList, Entry, float> mRadixSorter;
+		/// Maximum average number of moves per item before falling back
+		Real mMaxMovesPerItem;
+		/// Whether the last sort fell back to the radix sort
+		bool mLastSortFellBack;
+
+	public:
+		IncrementalSort(Real maxMovesPerItem = 4)
+			: mMaxMovesPerItem(maxMovesPerItem), mLastSortFellBack(false) {}
+
+		/** Sets the average number of moves per item the insertion sort may make
+			before falling back to a radix sort. */
+		void setMaxMovesPerItem(Real moves) { mMaxMovesPerItem = moves; }
+		/** Gets the average number of moves per item the insertion sort may make. */
+		Real getMaxMovesPerItem(void) const { return mMaxMovesPerItem; }
+		/** Returns whether the last sort had to use the radix sort. */
+		bool getLastSortFellBack(void) const { return mLastSortFellBack; }
+
+		/** Starts filling in the items to sort. */
+		void begin(size_t count)
+		{
+			mEntries.clear();
+			mEntries.reserve(count);
+		}
+		/** Adds an item with its sort key. */
+		void add(const T& item, float key)
+		{
+			Entry e;
+			e.key = key;
+			e.item = item;
+			mEntries.push_back(e);
+		}
+		/** Gets the number of items added. */
+		size_t size(void) const { return mEntries.size(); }
+		/** Gets an item, in sorted order after calling sort. */
+		const T& getItem(size_t index) const { return mEntries[index].item; }
+
+		/** Sorts the items ascending by key.
+		@returns false if the items were already in order
+		*/
+		bool sort(void)
+		{
+			size_t count = mEntries.size();
+			if (count < 2)
+				return false;
+
+			if (!mLastSortFellBack)
+			{
+				size_t maxMoves = static_cast<size_t>(count * mMaxMovesPerItem);
+				size_t moves = 0;
+				Entry* e = &mEntries[0];
+				for (size_t i = 1; i < count; ++i)
+				{
+					if (!(e[i].key < e[i - 1].key))
+						continue;
+
+					Entry tmp = e[i];
+					size_t j = i;
+					do
+					{
+						e[j] = e[j - 1];
+						--j;
+						++moves;
+					} while (j > 0 && tmp.key < e[j - 1].key);
+					e[j] = tmp;
+
+					if (moves > maxMoves)
+					{
+						// Badly disturbed, the entries are still a permutation
+						// so the radix sort can take over from here
+						mLastSortFellBack = true;
+						mRadixSorter.sort(mEntries, EntryKeyFunctor());
+						return true;
+					}
+				}
+				return moves != 0;
+			}
+
+			// Sort fully this time, then try the incremental sort again
+			mLastSortFellBack = false;
+			mRadixSorter.sort(mEntries, EntryKeyFunctor());
+			return true;
+		}
+	};
+	/** @} */
+	/** @} */
+
+}
+#endif
@@ -38,6 +38,7 @@ THE SOFTWARE.
 
 namespace Ogre {
 
+	class AbstractNode;
 
 	/** \addtogroup Core
 	*  @{
@@ -139,6 +140,19 @@ namespace Ogre {
 		typedef std::map<String, ListenerList> ListenerMap;
 		ListenerMap mListenerMap;
 
+		/// A material script object waiting to be translated on first use
+		struct DeferredMaterial
+		{
+			String group;
+			SharedPtr<AbstractNode> node;
+		};
+		typedef map<String, DeferredMaterial>::type DeferredMaterialMap;
+		DeferredMaterialMap mDeferredMaterials;
+		/// Whether script materials are translated on first use
+		bool mDeferredTranslation;
+		/// Set while a deferred material is being translated
+		bool mTranslatingDeferred;
+
     public:
 		/// Default material scheme
 		static String DEFAULT_SCHEME_NAME;
@@ -159,6 +173,54 @@ namespace Ogre {
         */
         void parseScript(DataStreamPtr& stream, const String& groupName);
 
+		/** Sets whether materials defined in scripts are only translated when first used.
+		@remarks
+			By default every material in a script is created and fully populated
+			when its resource group is initialised. With deferred translation on,
+			the script compiler just hands the processed script object of each
+			material to this manager, and the Material (with its techniques,
+			passes and texture units) is built the first time it is asked for
+			through getByName, and therefore also through load, prepare and
+			createOrRetrieve. This saves time and memory when only a fraction
+			of a large material library is used.
+		@par
+			Deferred materials are not included in getResourceIterator until they
+			have been translated, and errors in them are only reported then. Materials
+			are translated immediately while a script compiler listener is set.
+		*/
+		void setDeferredTranslation(bool defer);
+		/// Returns whether materials defined in scripts are only translated when first used
+		bool getDeferredTranslation(void) const { return mDeferredTranslation; }
+
+		/** Retrieves a material by name, translating it first if it is deferred.
+		@see setDeferredTranslation
+		*/
+		ResourcePtr getByName(const String& name, const String& groupName = ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+		/// Returns whether the named material exists, without translating a deferred one
+		bool resourceExists(const String& name);
+		/// @copydoc ResourceManager::resourceExists(ResourceHandle)
+		bool resourceExists(ResourceHandle handle) { return ResourceManager::resourceExists(handle); }
+		/// Unloads the named material; a deferred one has nothing loaded and is left as it is
+		void unload(const String& name);
+		/// @copydoc ResourceManager::unload(ResourceHandle)
+		void unload(ResourceHandle handle) { ResourceManager::unload(handle); }
+		/// Removes the named material, dropping it without translation if it is deferred
+		void remove(const String& name);
+		/// @copydoc ResourceManager::remove(ResourcePtr&)
+		void remove(ResourcePtr& r) { ResourceManager::remove(r); }
+		/// @copydoc ResourceManager::remove(ResourceHandle)
+		void remove(ResourceHandle handle) { ResourceManager::remove(handle); }
+		/// @copydoc ResourceManager::removeAll
+		void removeAll(void);
+		/// @copydoc ResourceManager::_notifyResourceGroupCleared
+		void _notifyResourceGroupCleared(const String& group);
+
+		/** Internal method called by the script translator for each material it meets.
+		@returns true if the material has been kept for translation on first use, 
+			false if the translator must create it now
+		*/
+		bool _deferTranslation(const String& name, const String& group, const SharedPtr<AbstractNode>& node);
+
 
         /** Sets the default texture filtering to be used for loaded textures, for when textures are
             loaded automatically (e.g. by Material class) or when 'load' is called with the default
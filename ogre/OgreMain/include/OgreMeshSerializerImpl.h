@@ -168,6 +168,14 @@ namespace Ogre {
 		virtual void readExtremes(DataStreamPtr& stream, Mesh *pMesh);
 
 
+        /** Fills a hardware buffer from the stream, flipping elements of elemSize
+            bytes from little endian if required.
+        @remarks
+            If the stream holds its data in memory and no flipping is needed the data
+            is written to the buffer directly, without locking it or copying it first.
+        */
+        virtual void readBufferData(DataStreamPtr& stream, HardwareBuffer* buf, size_t elemSize);
+
         /// Flip an entire vertex buffer from little endian
         virtual void flipFromLittleEndian(void* pData, size_t vertexCount, size_t vertexSize, const VertexDeclaration::VertexElementList& elems);
         /// Flip an entire vertex buffer to little endian
@@ -0,0 +1,321 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __PackArchive_H__
+#define __PackArchive_H__
+
+#include "OgrePrerequisites.h"
+
+#include "OgreArchive.h"
+#include "OgreArchiveFactory.h"
+
+namespace Ogre {
+
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup Resources
+	*  @{
+	*/
+
+	/** Layout of the pack archive format, shared by PackArchive and PackArchiveWriter.
+	@remarks
+		All values are little endian. The file starts with MAGIC and VERSION as
+		two uint32 values, followed by the entry data, the index and finally a
+		Header. The index is read in one go and holds, in order:
+		- a hash table of Header::hashSize uint32 values, each either 0 (empty) or 
+		  1 + the index of an Entry, filled by linear probing on the hash of the 
+		  entry name
+		- Header::entryCount Entry records
+		- the chunk tables of the compressed entries, as uint32 offsets of each
+		  chunk relative to the entry data, plus one for the end of the last chunk
+		- the entry names, not null terminated
+		Compressed entries are split into chunks of Header::chunkSize bytes, 
+		each deflated on its own (zlib format) so that any chunk can be 
+		decompressed without the ones before it. A chunk whose compressed size
+		equals its uncompressed size is stored as is. Uncompressed entries are
+		aligned in the file, so they can be used in place from a mapping.
+	*/
+	namespace PackFormat
+	{
+		/// 'OPAK'
+		static const uint32 MAGIC = 0x4B41504F;
+		static const uint32 VERSION = 1;
+		/// Default uncompressed size of the chunks of compressed entries
+		static const uint32 DEFAULT_CHUNK_SIZE = 65536;
+
+		enum EntryFlags
+		{
+			/// Entry data is split into deflated chunks
+			EF_COMPRESSED = 1,
+			/// Entry is a directory, and has no data
+			EF_DIRECTORY = 2
+		};
+
+		struct Header
+		{
+			uint32 magic;
+			uint32 version;
+			uint32 entryCount;
+			/// Number of slots in the hash table, a power of 2
+			uint32 hashSize;
+			uint32 chunkSize;
+			/// Total number of chunk offsets in the index
+			uint32 chunkOffsetCount;
+			/// Offset and size of the index in the file
+			uint64 indexOffset;
+			uint64 indexSize;
+		};
+
+		struct Entry
+		{
+			/// Offset of the data in the file
+			uint64 offset;
+			uint64 size;
+			uint64 compressedSize;
+			int64 modifiedTime;
+			/// Hash of the name, see hashName
+			uint32 hash;
+			/// Offset of the name in the names area, and its length
+			uint32 nameOffset;
+			uint32 nameLength;
+			/// Index of the first chunk offset of compressed entries
+			uint32 firstChunk;
+			uint32 flags;
+			uint32 reserved;
+		};
+
+		/** Hash used to look up entry names; names are case insensitive and 
+			'\\' is treated as '/'. */
+		_OgreExport uint32 hashName(const String& name);
+	}
+
+	/** Specialisation of the Archive class to read the pack archive format.
+	@remarks
+		Packs are built with PackArchiveWriter, or the OgrePackTool command line
+		tool. Unlike zip files, the whole index is read with a single read when 
+		the archive is loaded and names are looked up through a hash table, so 
+		opening a file costs a single lookup. The pack is mapped into memory:
+		uncompressed files are read in place, and streams over compressed files 
+		decompress 64KB chunks on demand, seek in constant time and decompress
+		large reads on several threads at once.
+	*/
+	class _OgreExport PackArchive : public Archive 
+	{
+	protected:
+		/// Stream mapping the whole pack
+		DataStreamPtr mPackStream;
+		/// Copy of the index area
+		vector<uchar>::type mIndex;
+		/// Pointers into mIndex
+		const uint32* mHashTable;
+		const PackFormat::Entry* mEntries;
+		const uint32* mChunkOffsets;
+		const char* mNames;
+		PackFormat::Header mHeader;
+		/// File list, built on load
+		FileInfoList mFileList;
+
+		/// Find an entry by name, or return 0
+		const PackFormat::Entry* findEntry(const String& filename) const;
+		/// Get the name of an entry
+		String getEntryName(const PackFormat::Entry& entry) const;
+
+		OGRE_AUTO_MUTEX
+	public:
+		PackArchive(const String& name, const String& archType );
+		~PackArchive();
+		/// @copydoc Archive::isCaseSensitive
+		bool isCaseSensitive(void) const { return false; }
+
+		/// @copydoc Archive::load
+		void load();
+		/// @copydoc Archive::unload
+		void unload();
+
+		/// @copydoc Archive::open
+		DataStreamPtr open(const String& filename, bool readOnly = true) const;
+
+		/// @copydoc Archive::create
+		DataStreamPtr create(const String& filename) const;
+
+		/// @copydoc Archive::remove
+		void remove(const String& filename) const;
+
+		/// @copydoc Archive::list
+		StringVectorPtr list(bool recursive = true, bool dirs = false);
+
+		/// @copydoc Archive::listFileInfo
+		FileInfoListPtr listFileInfo(bool recursive = true, bool dirs = false);
+
+		/// @copydoc Archive::find
+		StringVectorPtr find(const String& pattern, bool recursive = true,
+			bool dirs = false);
+
+		/// @copydoc Archive::findFileInfo
+		FileInfoListPtr findFileInfo(const String& pattern, bool recursive = true,
+			bool dirs = false);
+
+		/// @copydoc Archive::exists
+		bool exists(const String& filename);
+
+		/// @copydoc Archive::getModifiedTime
+		time_t getModifiedTime(const String& filename);
+	};
+
+	/** Specialisation of ArchiveFactory for pack archives. */
+	class _OgreExport PackArchiveFactory : public ArchiveFactory
+	{
+	public:
+		virtual ~PackArchiveFactory() {}
+		/// @copydoc FactoryObj::getType
+		const String& getType(void) const;
+		/// @copydoc FactoryObj::createInstance
+		Archive *createInstance( const String& name ) 
+		{
+			return OGRE_NEW PackArchive(name, "Pack");
+		}
+		/// @copydoc FactoryObj::destroyInstance
+		void destroyInstance( Archive* arch) { OGRE_DELETE arch; }
+	};
+
+	/** Specialisation of DataStream reading an entry of a pack archive.
+	@remarks
+		Uncompressed entries are read straight from the mapped pack (and are
+		available through getDataPtr). Compressed entries keep the last
+		decompressed chunk, so small reads and seeks within it are cheap; reads 
+		covering several whole chunks decompress them directly into the 
+		destination, in parallel.
+	*/
+	class _OgreExport PackDataStream : public DataStream
+	{
+	protected:
+		/// Stream mapping the pack, kept to keep the mapping alive
+		DataStreamPtr mPackStream;
+		/// Data of the entry in the mapping
+		const uchar* mData;
+		/// Chunk offsets relative to mData, empty if not compressed
+		vector<uint32>::type mChunkOffsets;
+		size_t mChunkSize;
+		size_t mPos;
+		/// Decompressed chunk, and its index
+		uchar* mChunkBuffer;
+		size_t mCachedChunk;
+	public:
+		/** Constructor.
+		@param name The name of the stream
+		@param packStream Stream mapping the pack into memory
+		@param data Data of the entry
+		@param size Uncompressed size of the entry
+		@param chunkOffsets Offsets of the chunks of a compressed entry, 
+			relative to data, or 0 if the entry is not compressed
+		@param numChunks Number of chunks
+		@param chunkSize Uncompressed size of a chunk
+		*/
+		PackDataStream(const String& name, const DataStreamPtr& packStream,
+			const uchar* data, size_t size, const uint32* chunkOffsets, 
+			size_t numChunks, size_t chunkSize);
+		~PackDataStream();
+		/// @copydoc DataStream::read
+		size_t read(void* buf, size_t count);
+		/// @copydoc DataStream::skip
+		void skip(long count);
+		/// @copydoc DataStream::seek
+		void seek( size_t pos );
+		/// @copydoc DataStream::tell
+		size_t tell(void) const;
+		/// @copydoc DataStream::eof
+		bool eof(void) const;
+		/// @copydoc DataStream::getDataPtr
+		const uchar* getDataPtr(void) const;
+		/// @copydoc DataStream::close
+		void close(void);
+	};
+
+	/** Class for building pack archives.
+	@remarks
+		Add the files to include, then call write. Parent directories are added
+		automatically. Files are compressed unless that doesn't save at least 
+		a tenth of their size (or compression is disabled for them), in which
+		case they are stored as is, aligned for use from a mapped pack.
+	*/
+	class _OgreExport PackArchiveWriter : public ArchiveAlloc
+	{
+	public:
+		PackArchiveWriter();
+		~PackArchiveWriter();
+
+		/** Add a file to the pack.
+		@param name Name of the file in the pack, using '/' to separate directories
+		@param stream Stream providing the file contents, read during write
+		@param compress Whether to try compressing the file
+		@param modifiedTime Modification time recorded for the file
+		*/
+		void addFile(const String& name, const DataStreamPtr& stream,
+			bool compress = true, time_t modifiedTime = 0);
+
+		/** Add all files of an archive to the pack, under the same names. */
+		void addArchive(Archive* archive, bool compress = true);
+
+		/** Sets the alignment of uncompressed files in the pack (default 16).
+		@remarks
+			Set this to the page size to be able to map files on their own.
+		*/
+		void setAlignment(size_t alignment) { mAlignment = alignment; }
+		/** Sets the uncompressed size of the chunks compressed files are split into. */
+		void setChunkSize(size_t chunkSize) { mChunkSize = chunkSize; }
+		/** Sets the zlib compression level, from 1 to 9 (default 9). */
+		void setCompressionLevel(int level) { mCompressionLevel = level; }
+
+		/** Writes the pack.
+		@param stream Writeable stream to write the pack to
+		*/
+		void write(const DataStreamPtr& stream);
+
+	protected:
+		struct PendingFile
+		{
+			String name;
+			/// Stream to read, or archive to open the file from when writing
+			DataStreamPtr stream;
+			Archive* archive;
+			bool compress;
+			time_t modifiedTime;
+		};
+		typedef vector<PendingFile>::type PendingFileList;
+		PendingFileList mFiles;
+		size_t mAlignment;
+		size_t mChunkSize;
+		int mCompressionLevel;
+	};
+
+	/** @} */
+	/** @} */
+
+}
+
+#endif
@@ -0,0 +1,214 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __PackedParticleData_H__
+#define __PackedParticleData_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreVector3.h"
+#include "OgreColourValue.h"
+
+namespace Ogre {
+
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup Effects
+	*  @{
+	*/
+	/** Contiguous structure-of-arrays storage for the state of visual particles.
+	@remarks
+		ParticleSystem normally keeps its particles as a linked list of pointers
+		to individual Particle objects. When packed storage is enabled (see
+		ParticleSystem::setUsePackedStorage) the particle state is held here
+		instead, with one array per component so that emitters, affectors and
+		renderers can process all particles in tight, vectorisable loops.
+	@par
+		Live particles always occupy the indices [0, size()). Removing a particle
+		moves the last particle into its slot, so the order of particles is not
+		preserved across removals.
+	@par
+		Every array is 16-byte aligned and padded to a multiple of 4 elements,
+		so it is safe to process the arrays 4 particles at a time.
+	*/
+	class _OgreExport PackedParticleData : public FXAlloc
+	{
+	public:
+		// Note the intentional public access to the arrays; accessing via
+		// get/set would be too costly for 000's of particles
+		/// World (or local) position
+		float* positionX;
+		float* positionY;
+		float* positionZ;
+		/// Direction (and speed)
+		float* directionX;
+		float* directionY;
+		float* directionZ;
+		/// Current colour
+		float* colourR;
+		float* colourG;
+		float* colourB;
+		float* colourA;
+		/// Personal dimensions, only used where ownDimensions is non-zero
+		float* width;
+		float* height;
+		/// Current rotation in radians
+		float* rotation;
+		/// Speed of rotation in radians/sec
+		float* rotationSpeed;
+		/// Time to live, number of seconds left of particles natural life
+		float* timeToLive;
+		/// Total time to live, number of seconds of particles natural life
+		float* totalTimeToLive;
+		/// Non-zero for particles which deviate from the default dimensions
+		uint8* ownDimensions;
+
+		PackedParticleData();
+		~PackedParticleData();
+
+		/** Sets the maximum number of particles which can be stored.
+		@remarks
+			Existing particles are preserved, up to the new capacity.
+		*/
+		void setCapacity(size_t capacity);
+		/** Gets the maximum number of particles which can be stored. */
+		size_t getCapacity(void) const { return mCapacity; }
+		/** Gets the number of live particles. */
+		size_t size(void) const { return mSize; }
+		/** Returns whether there are no live particles. */
+		bool empty(void) const { return mSize == 0; }
+		/** Gets the number of particles which can still be allocated. */
+		size_t getFreeCount(void) const { return mCapacity - mSize; }
+
+		/** Appends up to count new particles.
+		@returns The number of particles actually allocated, which is limited
+			by the capacity. They occupy the indices [size() - result, size()).
+		*/
+		size_t allocate(size_t count);
+		/** Removes the particle at the given index by moving the last particle
+			into its place. */
+		void remove(size_t index);
+		/** Removes all particles. */
+		void clear(void) { mSize = 0; }
+
+		/** Decrements the time to live of every particle, removing those which
+			have expired.
+		@returns The number of particles removed
+		*/
+		size_t expire(Real timeElapsed);
+		/** Moves every particle along its direction. */
+		void applyMotion(Real timeElapsed);
+
+		/** Adds a value to every live element of one of the arrays.
+		@remarks
+			This and the following stream operations use SSE when it is available;
+			they are intended for affectors working on packed storage.
+		*/
+		void addToStream(float* stream, float value);
+		/** Sets every live element of one of the arrays to stream * scale + value. */
+		void scaleAddStream(float* stream, float scale, float value);
+		/** Adds a value to every live element of one of the arrays, clamping the
+			results to [minValue, maxValue]. */
+		void addClampStream(float* stream, float value, float minValue, float maxValue);
+		/** Adds the elements of one array multiplied by scale to the elements
+			of another, for every live particle. */
+		void addScaledStream(float* dest, const float* src, float scale);
+
+		/** Reorders the particles.
+		@param order Array of size() indices; the particle at order[i] is moved
+			to index i
+		*/
+		void reorder(const uint32* order);
+
+		/// Gets the position of a particle
+		Vector3 getPosition(size_t index) const
+		{
+			return Vector3(positionX[index], positionY[index], positionZ[index]);
+		}
+		/// Sets the position of a particle
+		void setPosition(size_t index, const Vector3& pos)
+		{
+			positionX[index] = pos.x; positionY[index] = pos.y; positionZ[index] = pos.z;
+		}
+		/// Gets the direction of a particle
+		Vector3 getDirection(size_t index) const
+		{
+			return Vector3(directionX[index], directionY[index], directionZ[index]);
+		}
+		/// Sets the direction of a particle
+		void setDirection(size_t index, const Vector3& dir)
+		{
+			directionX[index] = dir.x; directionY[index] = dir.y; directionZ[index] = dir.z;
+		}
+		/// Gets the colour of a particle
+		ColourValue getColour(size_t index) const
+		{
+			return ColourValue(colourR[index], colourG[index], colourB[index], colourA[index]);
+		}
+		/// Sets the colour of a particle
+		void setColour(size_t index, const ColourValue& col)
+		{
+			colourR[index] = col.r; colourG[index] = col.g; colourB[index] = col.b; colourA[index] = col.a;
+		}
+
+		/** Copies the state of a particle into a Particle instance.
+		@remarks
+			Used to provide the per-particle interfaces of emitters, affectors
+			and renderers which do not support packed data.
+		*/
+		void readParticle(size_t index, Particle* p) const;
+		/** Copies the state of a Particle instance into a particle. */
+		void writeParticle(size_t index, const Particle* p);
+
+	protected:
+		/// Number of float arrays
+		static const size_t NUM_FLOAT_STREAMS = 16;
+
+		/// Single allocation holding all the arrays
+		void* mBuffer;
+		/// Buffer of the same size used when reordering, allocated on demand
+		void* mBackBuffer;
+		size_t mCapacity;
+		size_t mSize;
+
+		/// Gets the padded capacity used as the distance between arrays
+		size_t getStride(void) const { return (mCapacity + 3) & ~size_t(3); }
+		/// Gets the size in bytes of a buffer holding all the arrays
+		static size_t getBufferSize(size_t stride);
+		/// Points the arrays into a buffer with a given stride
+		void assignStreams(void* buffer, size_t stride);
+		/// Moves the particle at index src to index dest
+		void move(size_t src, size_t dest);
+		/// Gets the number of elements processed by the stream operations
+		size_t getStreamCount(void) const { return (mSize + 3) & ~size_t(3); }
+	};
+	/** @} */
+	/** @} */
+
+}
+
+#endif
@@ -0,0 +1,94 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ParallelTasks_H__
+#define __ParallelTasks_H__
+
+#include "OgrePrerequisites.h"
+
+namespace Ogre
+{
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup General
+	*  @{
+	*/
+
+	/** Utility for running a number of independent tasks in parallel.
+	@remarks
+		The tasks are shared out between the calling thread and the worker
+		threads of Root's WorkQueue, each thread claiming the next task until
+		none are left. Because the calling thread always takes part, it is safe
+		to use from a worker thread (e.g. during background loading); if there 
+		is no work queue, or no thread support, the tasks simply run one after 
+		another on the calling thread.
+	*/
+	class _OgreExport ParallelTasks
+	{
+	public:
+		/** Interface for the work to be split into tasks. */
+		class _OgreExport Task
+		{
+		public:
+			virtual ~Task() {}
+			/** Runs a single task. 
+			@remarks
+				Called concurrently from several threads, with a different index
+				each time.
+			@param index Index of the task, from 0 to count - 1
+			*/
+			virtual void run(size_t index) = 0;
+		};
+
+		/** Runs tasks 0 to count - 1, returning once they have all completed.
+		@param task The work to run
+		@param count Number of tasks
+		@param maxThreads Maximum number of threads taking part, including the
+			calling thread; 0 means as many as there are hardware threads.
+		@note
+			If a task throws, the other tasks still run and once all of them
+			have completed this method throws an Exception describing the first
+			failure, or std::bad_alloc if that was running out of memory.
+		*/
+		static void run(Task& task, size_t count, size_t maxThreads = 0);
+
+		/** Lets tasks run on the worker threads of a WorkQueue (internal use).
+		@remarks
+			Called by Root for its WorkQueue, only tasks started while Root's 
+			current queue is registered use worker threads.
+		*/
+		static void _registerWorkQueue(WorkQueue* queue);
+		/** Stops using a WorkQueue, before it is destroyed (internal use). */
+		static void _unregisterWorkQueue(WorkQueue* queue);
+	};
+	/** @} */
+	/** @} */
+
+}
+
+#endif
@@ -109,6 +109,41 @@ namespace Ogre {
         */
         virtual void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) = 0;
 
+        /** Returns whether this affector can work on packed particle storage directly.
+        @remarks
+            If this returns false, a ParticleSystem using packed storage copies its particles
+            into temporary Particle instances around the call to the per-particle
+            _affectParticles. Affectors returning true must override the packed version.
+        */
+        virtual bool _supportsPackedParticles(void) const { return false; }
+
+        /** Batch version of _affectParticles for systems using packed storage.
+        @remarks
+            Called instead of the per-particle version if _supportsPackedParticles returns
+            true. Implementations should process the arrays of the data in bulk, see
+            the stream operations of PackedParticleData.
+        @param
+            pSystem Pointer to the ParticleSystem which owns the data.
+        @param
+            data The packed particles of the system.
+        @param
+            timeElapsed The number of seconds which have elapsed since the last call.
+        */
+        virtual void _affectParticles(ParticleSystem* pSystem, PackedParticleData& data,
+            Real timeElapsed) { (void)pSystem; (void)data; (void)timeElapsed; }
+
+        /** Method called to allow the affector to initialise a range of newly created particles
+            held in packed storage.
+        @remarks
+            The default implementation copies each particle into a temporary Particle and calls
+            _initParticle on it; affectors which initialise particles should override this
+            if they are commonly used with packed storage.
+        @param data The packed particle data of the system
+        @param first Index of the first particle to initialise
+        @param count Number of particles to initialise
+        */
+        virtual void _initParticles(PackedParticleData& data, size_t first, size_t count);
+
         /** Returns the name of the type of affector. 
         @remarks
             This property is useful for determining the type of affector procedurally so another
@@ -378,6 +378,17 @@ namespace Ogre {
             pParticle->resetDimensions();
         }
 
+        /** Initialises a range of particles held in packed storage.
+        @remarks
+            This is used instead of _initParticle when the ParticleSystem keeps its particles
+            in packed storage. The default implementation initialises each particle through
+            _initParticle using a temporary Particle, so existing emitters work unchanged.
+        @param data The packed particle data of the system
+        @param first Index of the first particle to initialise
+        @param count Number of particles to initialise
+        */
+        virtual void _initParticles(PackedParticleData& data, size_t first, size_t count);
+
 
         /** Returns the name of the type of emitter. 
         @remarks
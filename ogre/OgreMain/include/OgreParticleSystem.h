@@ -35,9 +35,10 @@ THE SOFTWARE.
 #include "OgreParticleIterator.h"
 #include "OgreStringInterface.h"
 #include "OgreMovableObject.h"
-#include "OgreRadixSort.h"
+#include "OgreIncrementalSort.h"
 #include "OgreController.h"
 #include "OgreResourceGroupManager.h"
+#include "OgrePackedParticleData.h"
 
 
 namespace Ogre {
@@ -144,6 +145,13 @@ namespace Ogre {
 			String doGet(const void* target) const;
 			void doSet(void* target, const String& val);
 		};
+		/** Command object for packed storage (see ParamCommand).*/
+		class CmdPackedStorage : public ParamCommand
+		{
+		public:
+			String doGet(const void* target) const;
+			void doSet(void* target, const String& val);
+		};
 
         /// Default constructor required for STL creation in manager
         ParticleSystem();
@@ -340,6 +348,27 @@ namespace Ogre {
         */
         void _update(Real timeElapsed);
 
+        /** Performs the parts of an update which must run on the main thread.
+        @remarks
+            _update is equivalent to calling _prepareUpdate, then _updateParticles
+            if it returned true, then _finishUpdate. ParticleSystemManager splits
+            the calls up like this to run _updateParticles of several systems on 
+            worker threads.
+        @returns false if the system does not need to be updated
+        */
+        bool _prepareUpdate(Real timeElapsed);
+
+        /** Updates the particles (emission, affectors, motion, expiry and bounds).
+        @remarks
+            Only touches state owned by this system, so the calls for different
+            systems can run concurrently once _prepareUpdate has been called.
+        */
+        void _updateParticles(Real timeElapsed);
+
+        /** Completes an update on the main thread, notifying the parent node
+            if the bounds have changed. */
+        void _finishUpdate(void);
+
         /** Returns an iterator for stepping through all particles in this system.
         @remarks
             This method is designed to be used by people providing new ParticleAffector subclasses,
@@ -638,6 +667,34 @@ namespace Ogre {
 
 		/// Override to return specific type flag
 		uint32 getTypeFlags(void) const;
+
+		/** Sets whether visual particles are stored in contiguous packed arrays
+			rather than as a list of individual Particle objects.
+		@remarks
+			With packed storage expiry, motion and bounds are computed over
+			flat arrays (see PackedParticleData), and emitters, affectors and
+			renderers which support it process all particles at once. Those
+			which don't are served through temporary Particle instances, so
+			all existing types keep working, albeit with a copying overhead.
+		@par
+			Packed storage only applies to visual particles; systems which emit
+			emitters always use the list based storage. Changing this setting
+			clears the system.
+		@note
+			Particles returned by getParticle and _getIterator are copies while
+			packed storage is in use, createParticle returns null and the
+			renderer is not notified of individual particles being emitted,
+			expired or moved.
+		*/
+		void setUsePackedStorage(bool packed);
+		/** Gets whether packed particle storage was requested. */
+		bool getUsePackedStorage(void) const { return mUsePackedStorage; }
+		/** Returns whether particles are currently held in packed storage. */
+		bool _isUsingPackedStorage(void) const
+		{ return mUsePackedStorage && mEmittedEmitterPool.empty(); }
+		/** Gets the packed storage of the particles; only valid while
+			_isUsingPackedStorage returns true. */
+		PackedParticleData& _getPackedParticles(void) { return mPackedParticles; }
     protected:
 
         /// Command objects
@@ -652,6 +709,7 @@ namespace Ogre {
 		static CmdLocalSpace msLocalSpaceCmd;
 		static CmdIterationInterval msIterationIntervalCmd;
 		static CmdNonvisibleTimeout msNonvisibleTimeoutCmd;
+		static CmdPackedStorage msPackedStorageCmd;
 
 
         AxisAlignedBox mAABB;
@@ -659,6 +717,8 @@ namespace Ogre {
         bool mBoundsAutoUpdate;
         Real mBoundsUpdateTime;
         Real mUpdateRemainTime;
+        /// Whether the bounds changed during _updateParticles
+        bool mBoundsChanged;
 
         /// World AABB, only used to compare world-space positions to calc bounds
         AxisAlignedBox mWorldAABB;
@@ -699,6 +759,10 @@ namespace Ogre {
 		bool mEmittedEmitterPoolInitialised;
 		/// Used to control if the particle system should emit particles or not.
 		bool mIsEmitting;
+		/// Keep visual particles in packed arrays?
+		bool mUsePackedStorage;
+		/// Particle state when using packed storage
+		PackedParticleData mPackedParticles;
 
         typedef list<Particle*>::type ActiveParticleList;
         typedef list<Particle*>::type FreeParticleList;
@@ -724,7 +788,15 @@ namespace Ogre {
             float operator()(Particle* p) const;
         };
 
-		static RadixSort<ActiveParticleList, Particle*, float> mRadixSorter;
+		/// Sorts active particles, starting from the order of the previous sort
+		IncrementalSort<Particle*> mParticleSorter;
+
+        typedef vector<uint32>::type PackedSortOrder;
+
+		/// Sorts the indices of packed particles, which keep the order of the previous sort
+		IncrementalSort<uint32> mPackedParticleSorter;
+		/// Sorted order of packed particles
+		PackedSortOrder mPackedSortOrder;
 
 		/** Active particle list.
             @remarks
@@ -809,6 +881,9 @@ namespace Ogre {
 		/// Optional origin of this particle system (eg script name)
 		String mOrigin;
 
+		/// Emissions requested by each emitter, kept per system since systems may update concurrently
+		vector<unsigned>::type mRequestedEmissions;
+
         /// Default iteration interval
         static Real msDefaultIterationInterval;
         /// Default nonvisible update timeout
@@ -817,6 +892,17 @@ namespace Ogre {
         /** Internal method used to expire dead particles. */
         void _expire(Real timeElapsed);
 
+		/** Spawn new particles into packed storage. */
+		void _executeTriggerEmittersPacked(ParticleEmitter* emitter, unsigned requested, Real timeElapsed);
+
+		/** Copies packed particles into Particle instances from the pool, which
+			are placed in the active particle list. */
+		void _checkoutProxyParticles(void);
+
+		/** Copies Particle instances checked out by _checkoutProxyParticles back
+			into packed storage and returns them to the free list. */
+		void _checkinProxyParticles(bool writeBack);
+
         /** Spawn new particles based on free quota and emitter requirements. */
         void _triggerEmitters(Real timeElapsed);
 
@@ -833,6 +919,31 @@ namespace Ogre {
 		/** Sort the particles in the system **/
 		void _sortParticles(Camera* cam);
 
+		/** Sort the particles in packed storage along a direction or by distance to a position */
+		void _sortPackedParticles(SortMode sortMode, const Vector3& ref);
+
+		/** Sort the active particle list using one of the sort functors */
+		template <class SortFunctor>
+		void sortActiveParticles(const SortFunctor& func)
+		{
+			mParticleSorter.begin(mActiveParticles.size());
+			ActiveParticleList::iterator i, iend = mActiveParticles.end();
+			for (i = mActiveParticles.begin(); i != iend; ++i)
+				mParticleSorter.add(*i, func(*i));
+
+			if (mParticleSorter.sort())
+			{
+				size_t n = 0;
+				for (i = mActiveParticles.begin(); i != iend; ++i, ++n)
+					*i = mParticleSorter.getItem(n);
+			}
+		}
+
+		/** Recalculates the bounds if required, without notifying the parent node.
+		@returns true if the bounds were recalculated
+		*/
+		bool calculateBounds(void);
+
         /** Resize the internal pool of particles. */
         void increasePool(size_t size);
 
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "OgreIteratorWrappers.h"
 #include "OgreScriptLoader.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreParallelTasks.h"
 
 namespace Ogre {
 
@@ -126,6 +127,34 @@ namespace Ogre {
         void destroySystemImpl(ParticleSystem* sys);
 		
 		
+
+		/// A particle system update run by _processQueuedUpdates
+		struct UpdateTask
+		{
+			ParticleSystem* system;
+			Real timeElapsed;
+			size_t numParticles;
+
+			/// Orders the largest systems first
+			bool operator<(const UpdateTask& rhs) const { return numParticles > rhs.numParticles; }
+		};
+		typedef map<ParticleSystem*, Real>::type QueuedUpdateMap;
+		typedef vector<UpdateTask>::type UpdateTaskList;
+
+		/// Whether particle systems are updated on worker threads
+		bool mUseWorkerThreads;
+		/// Updates queued by the frame time controllers of the systems
+		QueuedUpdateMap mQueuedUpdates;
+		/// Runs a list of update tasks through ParallelTasks
+		class UpdateTaskRunner : public ParallelTasks::Task
+		{
+		protected:
+			UpdateTaskList& mTasks;
+		public:
+			UpdateTaskRunner(UpdateTaskList& tasks) : mTasks(tasks) {}
+			void run(size_t index);
+		};
+
     public:
 
         ParticleSystemManager();
@@ -344,6 +373,39 @@ namespace Ogre {
                 mSystemTemplates.begin(), mSystemTemplates.end());
         } 
 
+		/** Sets whether particle systems are updated on the worker threads of
+			Root's WorkQueue.
+		@remarks
+			When enabled, the per-frame updates of particle systems (emission, affectors,
+			motion, expiry and bounds) are queued by their frame time controllers and
+			run concurrently, one task per system, when _processQueuedUpdates is called
+			before the scene graph is updated. All updates have completed by the time
+			the render queue is built, so renderers still run on the main thread.
+		@par
+			Custom emitters and affectors must not modify state shared with other
+			particle systems from their update methods when this is enabled. 
+			Only has an effect if OGRE is built with thread support; disabled by default.
+		*/
+		void setUseWorkerThreads(bool use) { mUseWorkerThreads = use; }
+		/** Gets whether particle systems are updated on worker threads. */
+		bool getUseWorkerThreads(void) const { return mUseWorkerThreads; }
+
+		/** Queues the update of a particle system (internal use).
+		@remarks
+			Called by the frame time controller of the system when updates on worker
+			threads are enabled. Queuing a system more than once accumulates the time.
+		*/
+		void _queueUpdate(ParticleSystem* sys, Real timeElapsed);
+		/** Removes a queued update of a particle system (internal use). */
+		void _cancelUpdate(ParticleSystem* sys);
+		/** Runs all queued particle system updates and waits for them to complete.
+		@remarks
+			Called by SceneManager after the controllers have been updated. The parts
+			of the updates which touch shared state, such as scene nodes, run on the
+			calling thread.
+		*/
+		void _processQueuedUpdates(void);
+
         /** Get an instance of ParticleSystemFactory (internal use). */
 		ParticleSystemFactory* _getFactory(void) { return mFactory; }
 		
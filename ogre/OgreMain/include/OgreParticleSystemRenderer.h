@@ -65,6 +65,20 @@ namespace Ogre {
         virtual void _updateRenderQueue(RenderQueue* queue, 
             list<Particle*>::type& currentParticles, bool cullIndividually) = 0;
 
+        /** Returns whether this renderer can render particles held in packed storage directly.
+        @remarks
+            If this returns false, a ParticleSystem using packed storage copies its particles
+            into temporary Particle instances and calls the list based _updateRenderQueue.
+            Renderers returning true must override the packed version of _updateRenderQueue.
+        */
+        virtual bool _supportsPackedParticles(void) const { return false; }
+
+        /** Delegated to by ParticleSystem::_updateRenderQueue for systems using packed storage,
+            if _supportsPackedParticles returns true.
+        */
+        virtual void _updateRenderQueue(RenderQueue* queue,
+            PackedParticleData& currentParticles, bool cullIndividually) {}
+
         /** Sets the material this renderer must use; called by ParticleSystem. */
         virtual void _setMaterial(MaterialPtr& mat) = 0;
         /** Delegated to by ParticleSystem::_notifyCurrentCamera */
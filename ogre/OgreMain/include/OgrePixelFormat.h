@@ -149,8 +149,12 @@ namespace Ogre {
         PF_PVRTC_RGB4 = 40,
         /// PVRTC (PowerVR) RGBA 4 bpp
         PF_PVRTC_RGBA4 = 41,
+        /// DDS (DirectDraw Surface) BC4 format (unsigned normalised), also known as ATI1
+        PF_BC4_UNORM = 42,
+        /// DDS (DirectDraw Surface) BC5 format (unsigned normalised), also known as ATI2 or 3Dc
+        PF_BC5_UNORM = 43,
 		// Number of pixel formats currently defined
-        PF_COUNT = 42
+        PF_COUNT = 44
     };
 	typedef vector<PixelFormat>::type PixelFormatList;
 
@@ -93,6 +93,13 @@ namespace Ogre {
 #   define __OGRE_HAVE_SSE  1
 #endif
 
+/* Define whether or not Ogre compiled with SSE2 supports. SSE2 code is
+   still only run when the CPU reports it, see PlatformInformation.
+*/
+#if __OGRE_HAVE_SSE && (OGRE_COMPILER == OGRE_COMPILER_MSVC || defined(__SSE2__))
+#   define __OGRE_HAVE_SSE2  1
+#endif
+
 /* Define whether or not Ogre compiled with VFP supports.
  */
 #if OGRE_DOUBLE_PRECISION == 0 && OGRE_CPU == OGRE_CPU_ARM && OGRE_COMPILER == OGRE_COMPILER_GNUC && defined(__ARM_ARCH_6K__) && defined(__VFP_FP__)
@@ -109,6 +116,10 @@ namespace Ogre {
 #   define __OGRE_HAVE_SSE  0
 #endif
 
+#ifndef __OGRE_HAVE_SSE2
+#   define __OGRE_HAVE_SSE2  0
+#endif
+
 #ifndef __OGRE_HAVE_VFP
 #   define __OGRE_HAVE_VFP  0
 #endif
@@ -155,6 +155,7 @@ namespace Ogre {
     struct FrameEvent;
     class FrameListener;
     class Frustum;
+    class GlyphAtlas;
     class GpuProgram;
     class GpuProgramPtr;
     class GpuProgramManager;
@@ -203,6 +204,7 @@ namespace Ogre {
     class OverlayElementFactory;
     class OverlayManager;
     class Particle;
+    class PackedParticleData;
     class ParticleAffector;
     class ParticleAffectorFactory;
     class ParticleEmitter;
@@ -268,6 +270,7 @@ namespace Ogre {
     class Skeleton;
     class SkeletonPtr;
     class SkeletonInstance;
+    class SkeletonAnimationCache;
     class SkeletonManager;
     class Sphere;
     class SphereSceneQuery;
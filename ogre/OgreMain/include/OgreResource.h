@@ -160,6 +160,10 @@ namespace Ogre {
 		ManualResourceLoader* mLoader;
 		/// State count, the number of times this resource has changed state
 		size_t mStateCount;
+		/// The frame in which this resource was last used, as counted by its creator
+		AtomicScalar<unsigned long> mLastUsedFrame;
+		/// The state count when this resource was last touched
+		size_t mTouchedStateCount;
 
 		typedef set<Listener*>::type ListenerList;
 		ListenerList mListenerList;
@@ -169,7 +173,8 @@ namespace Ogre {
 		*/
 		Resource() 
 			: mCreator(0), mHandle(0), mLoadingState(LOADSTATE_UNLOADED), 
-			mIsBackgroundLoaded(false),	mSize(0), mIsManual(0), mLoader(0)
+			mIsBackgroundLoaded(false),	mSize(0), mIsManual(0), mLoader(0),
+			mStateCount(0), mLastUsedFrame(0), mTouchedStateCount(0)
 		{ 
 		}
 
@@ -304,9 +309,24 @@ namespace Ogre {
         }
 
         /** 'Touches' the resource to indicate it has been used.
+		@remarks
+			The resource is loaded if it is not already, which reloads it if its
+			manager evicted it to stay within its memory budget, and is stamped
+			as used in the current frame.
         */
         virtual void touch(void);
 
+		/** Gets the frame in which this resource was last touched, as counted
+			by its manager.
+		@see ResourceManager::_updateResidency
+		*/
+		virtual unsigned long getLastUsedFrame(void) const { return mLastUsedFrame.get(); }
+
+		/** Records the frame in which this resource was last touched; called
+			by its manager.
+		*/
+		virtual void _notifyUsed(unsigned long frame) { mLastUsedFrame.set(frame); }
+
         /** Gets resource name.
         */
         virtual const String& getName(void) const 
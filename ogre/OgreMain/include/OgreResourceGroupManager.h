@@ -280,6 +280,8 @@ namespace Ogre {
 			Archive* archive;
 			/// Whether this location was added recursively
 			bool recursive;
+			/// Snapshot of the files in the location if a location cache is in use, null otherwise
+			FileInfoListPtr files;
 		};
 		/// List of possible file locations
 		typedef list<ResourceLocation*>::type LocationList;
@@ -298,7 +300,7 @@ namespace Ogre {
 		ResourceLoadingListener *mLoadingListener;
 
         /// Resource index entry, resourcename->location 
-        typedef map<String, Archive*>::type ResourceLocationIndex;
+        typedef HashMap<String, Archive*> ResourceLocationIndex;
 
 		/// List of resources which can be loaded / unloaded
 		typedef list<ResourcePtr>::type LoadUnloadResourceList;
@@ -401,6 +403,33 @@ namespace Ogre {
 
 		/// Stored current group - optimisation for when bulk loading a group
 		ResourceGroup* mCurrentGroup;
+
+		/// Cached listing of a resource location, see setResourceLocationCache
+		struct LocationCacheEntry
+		{
+			/// Size of the location if it's a file
+			uint64 size;
+			/// Modification time of the location
+			int64 modifiedTime;
+			/// Sub directories of a recursive directory location, with their modification times
+			vector<std::pair<String, int64> >::type dirs;
+			/// Files in the location
+			FileInfoList files;
+		};
+		/// Location cache entries by type, name and recursion
+		typedef map<String, LocationCacheEntry>::type LocationCache;
+		LocationCache mLocationCache;
+		String mLocationCacheFile;
+		bool mLocationCacheDirty;
+		OGRE_MUTEX(mLocationCacheMutex)
+
+		/// Gets the files of a location from the location cache, or null if not cached / out of date
+		FileInfoListPtr getCachedLocationFiles(Archive* arch, const String& locType, bool recursive);
+		/// Scans a location and stores its files in the location cache
+		FileInfoListPtr scanLocationFiles(Archive* arch, const String& locType, bool recursive);
+		/// Matches the files snapshotted for a location against a pattern
+		void findLocationFiles(const ResourceLocation* loc, const String& pattern, 
+			FileInfoList& result) const;
     public:
         ResourceGroupManager();
         virtual ~ResourceGroupManager();
@@ -1051,6 +1080,39 @@ namespace Ogre {
 		/// Returns the current loading listener
 		ResourceLoadingListener *getLoadingListener();
 
+		/** Sets a file in which the listings of resource locations are cached between runs.
+		@remarks
+			Normally every location is scanned when it's added, which for locations 
+			holding many files is a large part of startup time. With a cache file, 
+			addResourceLocation reuses the listing stored for a directory or archive
+			file if its modification time and size are unchanged; for recursive
+			directories the modification time of every sub directory is checked as 
+			well, so adding or removing files anywhere in the tree triggers a rescan.
+			Locations which aren't on the file system are always scanned.
+		@par
+			Only the modification times of the location and its directories are
+			checked, not those of the files in them: a file rewritten in place
+			keeps the size it had when the location was scanned, until something 
+			else causes a rescan. Touch its directory, or delete the cache file,
+			after changing files that way. On Windows, loading a writeable
+			FileSystem location creates a test file in it, so such locations are 
+			scanned again every time they are added.
+		@par
+			While a cache file is set, pattern searches over a location use the 
+			listing taken when it was added, so files created in the location 
+			later on are not found. New listings are written to the file by 
+			saveResourceLocationCache, which initialiseResourceGroup and 
+			initialiseAllResourceGroups call when needed.
+		@param filename Path of the cache file, which is read straight away if it
+			exists. Pass a blank string to stop using a cache.
+		*/
+		void setResourceLocationCache(const String& filename);
+		/// Gets the file used to cache resource location listings, blank if none
+		const String& getResourceLocationCache(void) const { return mLocationCacheFile; }
+		/** Writes the resource location cache file, if listings have changed since 
+			it was read or last written. */
+		void saveResourceLocationCache(void);
+
 		/** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
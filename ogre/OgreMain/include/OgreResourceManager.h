@@ -121,10 +121,13 @@ namespace Ogre {
 		
         /** Set a limit on the amount of memory this resource handler may use.
             @remarks
-                If, when asked to load a new resource, the manager believes it will exceed this memory
-                budget, it will temporarily unload a resource to make room for the new one. This unloading
-                is not permanent and the Resource is not destroyed; it simply needs to be reloaded when
-                next used.
+                Whenever the manager finds that it exceeds this memory budget, which it
+				checks once per frame in _updateResidency, it temporarily unloads the
+				resources which were used least recently until its usage falls to the
+				low watermark. This unloading is not permanent and the Resource is not
+				destroyed; it is reloaded when next touched. Only resources which can be
+				reloaded, and which were not used in the current frame, are evicted.
+			@see setMemoryLowWatermark
         */
         virtual void setMemoryBudget( size_t bytes);
 
@@ -132,9 +135,70 @@ namespace Ogre {
         */
         virtual size_t getMemoryBudget(void) const;
 
+		/** Sets the memory usage, in bytes, that the manager evicts down to once
+			it has exceeded its memory budget.
+		@remarks
+			Evicting below the budget leaves some headroom so that the manager does
+			not have to evict again on every frame in which a resource is reloaded.
+			Values above the budget are treated as the budget itself, which is the
+			default.
+		*/
+		virtual void setMemoryLowWatermark(size_t bytes) { mMemoryLowWatermark = bytes; }
+
+		/** Gets the memory usage that the manager evicts down to once it has
+			exceeded its memory budget.
+		*/
+		virtual size_t getMemoryLowWatermark(void) const { return mMemoryLowWatermark; }
+
 		/** Gets the current memory usage, in bytes. */
 		virtual size_t getMemoryUsage(void) const { return mMemoryUsage; }
 
+		/** Counts of how resources have been used against the memory budget. */
+		struct ResidencyStats
+		{
+			/// Number of times a resource was touched while still loaded from its last touch
+			size_t hits;
+			/// Number of resources unloaded to stay within the memory budget
+			size_t evictions;
+			/// Number of evicted resources which have since been loaded again
+			size_t reloads;
+
+			ResidencyStats() : hits(0), evictions(0), reloads(0) {}
+		};
+
+		/** Gets the residency statistics gathered since the manager was created
+			or resetResidencyStats was last called.
+		*/
+		virtual ResidencyStats getResidencyStats(void) const;
+
+		/** Resets the residency statistics to zero. */
+		virtual void resetResidencyStats(void);
+
+		/** Sets whether evicted resources may be unloaded on a background thread.
+		@remarks
+			When enabled, and thread support is available, evictions are queued on
+			the ResourceBackgroundQueue rather than performed in _updateResidency.
+			Managers whose resources need the render system to unload, such as
+			textures and meshes, always unload them in _updateResidency. This is
+			enabled by default.
+		*/
+		virtual void setBackgroundEviction(bool enabled) { mBackgroundEviction = enabled; }
+
+		/** Gets whether evicted resources may be unloaded on a background thread. */
+		virtual bool getBackgroundEviction(void) const { return mBackgroundEviction; }
+
+		/** Advances the manager's frame count and evicts resources if it is over
+			its memory budget.
+		@remarks
+			Called once per frame by Root, after rendering. Resources touched
+			during a frame are stamped with its number, which is what orders them
+			for eviction.
+		*/
+		virtual void _updateResidency(void);
+
+		/** Gets the frame number the manager stamps touched resources with. */
+		virtual unsigned long _getCurrentFrame(void) const { return mCurrentFrame.get(); }
+
 		/** Unloads a single resource by name.
 		@remarks
 			Unloaded resources are not removed, they simply free up their memory
@@ -320,6 +384,18 @@ namespace Ogre {
 		*/
 		virtual void _notifyResourceTouched(Resource* res);
 
+		/** Notify this manager that a resource which it manages has been 
+			'touched', before _notifyResourceTouched is called.
+		@remarks
+			This stamps the resource with the current frame and counts residency
+			hits. It is called for every resource used in every frame, so it does
+			not lock the manager.
+		@param res The resource which was used
+		@param resident Whether the resource stayed loaded since it was last
+			touched, rather than being loaded or reloaded in between
+		*/
+		virtual void _notifyResourceUsed(Resource* res, bool resident);
+
 		/** Notify this manager that a resource which it manages has been 
 			loaded. 
 		*/
@@ -330,6 +406,13 @@ namespace Ogre {
 		*/
 		virtual void _notifyResourceUnloaded(Resource* res);
 
+		/** Notify this manager that a resource group is being cleared or destroyed.
+		@remarks
+			Called by ResourceGroupManager once it has removed the resources of the
+			group, for managers which keep other state for it.
+		*/
+		virtual void _notifyResourceGroupCleared(const String& group) {}
+
 		/** Generic prepare method, used to create a Resource specific to this 
 			ResourceManager without using one of the specialised 'prepare' methods
 			(containing per-Resource-type parameters).
@@ -484,8 +567,22 @@ namespace Ogre {
 		/** Remove a resource from this manager; remove it from the lists. */
 		virtual void removeImpl( ResourcePtr& res );
 		/** Checks memory usage and pages out if required.
+		@remarks
+			Resources are evicted in order of the frame they were last used in,
+			oldest first, until the usage falls to the low watermark.
 		*/
 		virtual void checkUsage(void);
+		/** Returns whether a loaded resource may be evicted to meet the memory
+			budget.
+		@remarks
+			By default only reloadable resources which are referenced by nothing
+			but the resource system are evicted, since anything holding a
+			reference might use the resource without touching it. Managers whose
+			resources are always touched before use can relax this.
+		*/
+		virtual bool isEvictable(const ResourcePtr& res) const;
+		/** Unloads a resource chosen for eviction, in the background if possible. */
+		virtual void evict(const ResourcePtr& res);
 
 
     public:
@@ -499,6 +596,22 @@ namespace Ogre {
         ResourceHandle mNextHandle;
         size_t mMemoryBudget; // In bytes
         size_t mMemoryUsage; // In bytes
+		size_t mMemoryLowWatermark; // In bytes
+
+		/// Frame number resources touched now are stamped with
+		AtomicScalar<unsigned long> mCurrentFrame;
+		/// Evictions and reloads, counted under the manager lock
+		ResidencyStats mResidencyStats;
+		/// Hits, counted without the manager lock as resources are touched
+		AtomicScalar<size_t> mResidencyHits;
+		bool mBackgroundEviction;
+		/// Whether unloading this manager's resources requires the render system
+		bool mEvictionNeedsRenderSystem;
+		typedef set<ResourceHandle>::type ResourceHandleSet;
+		/// Resources evicted and not loaded since
+		ResourceHandleSet mEvictedResources;
+		/// Resources queued for unloading in the background
+		ResourceHandleSet mPendingEvictions;
 
         bool mVerbose;
 
@@ -234,6 +234,35 @@ namespace Ogre
 		AbstractNodeListPtr _generateAST(const String &str, const String &source, bool doImports = false, bool doObjects = false, bool doVariables = false);
 		/// Compiles the given abstract syntax tree
 		bool _compile(AbstractNodeListPtr nodes, const String &group, bool doImports = true, bool doObjects = true, bool doVariables = true);
+		/// Maps script names to their source text, used to resolve imports in _prepare
+		typedef map<String, String>::type ImportSourceMap;
+		/** Runs the lexer, parser and tree processing stages on a script without
+			translating it, so that it may be done away from the main thread.
+		@remarks
+			Imports are resolved from importSources only; the listener and the
+			ResourceGroupManager are never consulted. Errors are not reported but
+			returned in errors, to be reported later by _compilePrepared.
+		@returns The processed tree, or a null pointer if an import could not be
+			resolved from importSources and the script must be compiled normally
+		*/
+		AbstractNodeListPtr _prepare(const String &str, const String &source, const ImportSourceMap &importSources, ErrorList &errors);
+		/// Reports the errors and translates a tree created by _prepare
+		bool _compilePrepared(const AbstractNodeListPtr &nodes, const ErrorList &errors, const String &group);
+		/** Sets an archive used to cache fully processed scripts in binary form.
+		@remarks
+			When set, the trees produced by the lexer, parser, import, object and
+			variable processing stages are saved into the archive (if it is
+			writable) and loaded from it the next time the same script is compiled,
+			skipping all text processing. Entries are keyed by the script's name and
+			only used if the script text, the text of every script it imports and
+			the compiler version all match. Scripts which produced errors are never
+			cached, and the cache is bypassed while a listener is set. A directory
+			can be used through ArchiveManager::load(path, "FileSystem").
+		@param cache The archive to use, or null to disable caching
+		*/
+		void setCache(Archive *cache);
+		/// Returns the archive used to cache processed scripts, if any
+		Archive *getCache() const;
 		/// Adds the given error to the compiler's list of errors
 		void addError(uint32 code, const String &file, int line, const String &msg = "");
 		/// Sets the listener used by the compiler
@@ -259,6 +288,10 @@ namespace Ogre
 		void processImports(AbstractNodeListPtr &nodes);
 		/// Loads the requested script and converts it to an AST
 		AbstractNodeListPtr loadImportPath(const String &name);
+		/// Loads the cached tree of the given script, or returns null if there is no valid one
+		AbstractNodeListPtr loadCachedAST(const String &str, const String &source);
+		/// Saves the processed tree of the given script to the cache
+		void saveCachedAST(const AbstractNodeListPtr &nodes, const String &str, const String &source);
 		/// Returns the abstract nodes from the given tree which represent the target
 		AbstractNodeListPtr locateTarget(AbstractNodeList *nodes, const String &target);
 		/// Handles object inheritance and variable expansion
@@ -293,6 +326,22 @@ namespace Ogre
 
 		// The listener
 		ScriptCompilerListener *mListener;
+
+		// Import sources used while running _prepare, null otherwise
+		const ImportSourceMap *mImportSources;
+		// Set by _prepare when an import is not found in mImportSources
+		bool mImportMissing;
+
+		// The archive processed scripts are cached in
+		Archive *mCache;
+		// The text of the script compile is processing, when it should be cached
+		const String *mCacheText;
+		String mCacheSource;
+		// Length and hash of every script imported while processing, for the cache
+		typedef map<String, std::pair<size_t, uint32> >::type ImportHashMap;
+		ImportHashMap mImportHashes;
+		// Archives aren't generally safe to use from several threads at once
+		OGRE_STATIC_MUTEX(msCacheMutex)
 	private: // Internal helper classes and processors
 		class AbstractTreeBuilder
 		{
@@ -399,6 +448,19 @@ namespace Ogre
 
 		// A pointer to the specific compiler instance used
 		OGRE_THREAD_POINTER(ScriptCompiler, mScriptCompiler);
+
+		// Scripts processed ahead of time by _prepareScripts, waiting for parseScript
+		struct PreparedScript
+		{
+			String group;
+			AbstractNodeListPtr nodes;
+			ScriptCompiler::ErrorList errors;
+		};
+		typedef map<String, PreparedScript>::type PreparedScriptMap;
+		PreparedScriptMap mPreparedScripts;
+
+		// The archive used by compilers to cache processed scripts
+		Archive *mCache;
 	public:
 		ScriptCompilerManager();
 		virtual ~ScriptCompilerManager();
@@ -407,6 +469,10 @@ namespace Ogre
 		void setListener(ScriptCompilerListener *listener);
 		/// Returns the currently set listener used for compiler instances
 		ScriptCompilerListener *getListener();
+		/// Sets the archive compiler instances cache processed scripts in (see ScriptCompiler::setCache)
+		void setCache(Archive *cache);
+		/// Returns the archive compiler instances cache processed scripts in
+		Archive *getCache();
 
 		/// Adds the given translator manager to the list of managers
 		void addTranslatorManager(ScriptTranslatorManager *man);
@@ -423,6 +489,16 @@ namespace Ogre
         const StringVector& getScriptPatterns(void) const;
         /// @copydoc ScriptLoader::parseScript
         void parseScript(DataStreamPtr& stream, const String& groupName);
+		/** Lexes, parses and processes the given scripts in parallel.
+		@remarks
+			Only the translation, which creates the resources, is left to parseScript,
+			so that resources are still created in the usual order. Scripts are
+			compiled as normal if a listener is set or one of their imports isn't
+			among the scripts given.
+		*/
+		void _prepareScripts(const FileInfoList& scripts, const String& groupName);
+		/// @copydoc ScriptLoader::_endScriptPreparation
+		void _endScriptPreparation(void);
         /// @copydoc ScriptLoader::getLoadingOrder
         Real getLoadingOrder(void) const;
 
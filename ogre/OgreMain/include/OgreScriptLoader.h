@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 #include "OgrePrerequisites.h"
 #include "OgreDataStream.h"
+#include "OgreArchive.h"
 #include "OgreStringVector.h"
 
 namespace Ogre {
@@ -76,6 +77,23 @@ namespace Ogre {
 		*/
 		virtual void parseScript(DataStreamPtr& stream, const String& groupName) = 0;
 
+		/** Called before parseScript with every script of this loader in a group.
+		@remarks
+			ResourceGroupManager calls this once per group, before calling parseScript
+			for each of the files in order. Implementations may use it to perform
+			the context free part of parsing up front (for example in parallel), but
+			must not create any resources here; that is still left to parseScript.
+			The default implementation does nothing.
+		@param scripts The scripts which will be passed to parseScript, in order
+		@param groupName The name of the resource group being parsed
+		*/
+		virtual void _prepareScripts(const FileInfoList& scripts, const String& groupName) {}
+
+		/** Called once all the scripts of a group have been parsed, to release
+			anything left over from _prepareScripts (e.g. skipped scripts).
+		*/
+		virtual void _endScriptPreparation(void) {}
+
 		/** Gets the relative loading order of scripts of this type.
 		@remarks
 			There are dependencies between some kinds of scripts, and to enforce
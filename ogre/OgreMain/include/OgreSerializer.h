@@ -99,6 +99,14 @@ namespace Ogre {
 
         String readString(DataStreamPtr& stream);
         String readString(DataStreamPtr& stream, size_t numChars);
+
+        /** Returns a pointer to the next count bytes of the stream if the stream
+            holds them in memory (see DataStream::getDataPtr), or 0 otherwise.
+        @remarks
+            This lets bulk data be used in place rather than copied out with read;
+            the caller must skip the stream past the data afterwards.
+        */
+        const uchar* getInPlaceData(DataStreamPtr& stream, size_t count) const;
         
         virtual void flipToLittleEndian(void* pData, size_t size, size_t count = 1);
         virtual void flipFromLittleEndian(void* pData, size_t size, size_t count = 1);
@@ -0,0 +1,203 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __SkeletonAnimationCache_H__
+#define __SkeletonAnimationCache_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreResource.h"
+
+namespace Ogre {
+
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup Animation
+	*  @{
+	*/
+
+	/** Cache of bone matrix palettes which can be shared between entities
+		playing the same animations at (nearly) the same time.
+	@remarks
+		Normally every Entity owns a SkeletonInstance and recalculates its bone
+		matrices every frame it is animated. In a crowd many of these entities
+		will be using the same skeleton with the same enabled animations at
+		almost the same time position, so they all calculate the same result.
+	@par
+		An entity which has been assigned a cache (see
+		Entity::setSkeletonAnimationCache) will first look for a palette stored
+		under a key built from the master skeleton, the enabled animations,
+		their time positions divided into steps of the time quantum, and
+		their weights divided into steps of the weight quantum. Only if no
+		such palette exists is the skeleton instance actually updated, and
+		the result is then stored for the other entities. The least recently
+		used palettes are discarded once the maximum number of entries is
+		reached.
+	@par
+		Because a hit skips the update of the skeleton instance, the bones of
+		an entity using a cache do not reflect the current pose. Entities with
+		objects attached to bones, manually controlled bones, blend masks or
+		a displayed skeleton therefore always bypass the cache.
+	@note
+		Entities only share a palette if they use the same cache instance; you
+		can use several caches to separate groups of entities.
+	*/
+	class _OgreExport SkeletonAnimationCache : public AnimationAlloc
+	{
+	public:
+		/** Constructor.
+		@param maxEntries The maximum number of bone palettes kept in the cache
+		@param timeQuantum The time step (in seconds) used to quantise animation
+			time positions; entities within the same step share a palette
+		@param weightQuantum The step used to quantise animation weights
+		*/
+		SkeletonAnimationCache(size_t maxEntries = 256, Real timeQuantum = 1.0f / 30.0f,
+			Real weightQuantum = 1.0f / 64.0f);
+		virtual ~SkeletonAnimationCache();
+
+		/** Sets the maximum number of bone palettes kept in the cache.
+		@remarks
+			Reducing the size evicts the least recently used palettes immediately.
+		*/
+		void setMaxEntries(size_t maxEntries);
+		/** Gets the maximum number of bone palettes kept in the cache. */
+		size_t getMaxEntries(void) const { return mMaxEntries; }
+
+		/** Sets the time step used to quantise animation time positions.
+		@note Changing this clears the cache.
+		*/
+		void setTimeQuantum(Real quantum);
+		/** Gets the time step used to quantise animation time positions. */
+		Real getTimeQuantum(void) const { return mTimeQuantum; }
+
+		/** Sets the step used to quantise animation weights.
+		@note Changing this clears the cache.
+		*/
+		void setWeightQuantum(Real quantum);
+		/** Gets the step used to quantise animation weights. */
+		Real getWeightQuantum(void) const { return mWeightQuantum; }
+
+		/** Removes all palettes from the cache. */
+		void clear(void);
+
+		/** Gets the number of palettes currently held in the cache. */
+		size_t getNumEntries(void) const;
+
+		/** Gets the number of lookups which were satisfied by the cache. */
+		size_t getHitCount(void) const { return mHits; }
+		/** Gets the number of lookups which had to compute the palette. */
+		size_t getMissCount(void) const { return mMisses; }
+		/** Gets the number of palettes discarded to respect the maximum size. */
+		size_t getEvictionCount(void) const { return mEvictions; }
+		/** Resets the hit, miss and eviction counters. */
+		void resetStatistics(void);
+
+		/** Looks up the bone matrices for a skeleton in a given animation state.
+		@param skel The skeleton instance to be posed
+		@param animSet The animation states which would be applied to it
+		@param pMatrices Array of skel->getNumBones() matrices to fill in if
+			the palette is found
+		@returns true if the palette was found and copied into pMatrices
+		*/
+		bool _fetchBoneMatrices(const SkeletonInstance* skel,
+			const AnimationStateSet& animSet, Matrix4* pMatrices);
+
+		/** Stores the bone matrices calculated for a skeleton in a given
+			animation state, so that other entities can use them.
+		@param skel The skeleton instance the matrices were calculated from
+		@param animSet The animation states which were applied to it
+		@param pMatrices Array of skel->getNumBones() matrices
+		*/
+		void _storeBoneMatrices(const SkeletonInstance* skel,
+			const AnimationStateSet& animSet, const Matrix4* pMatrices);
+
+		/** Returns whether the given animation state can be cached at all.
+		@remarks
+			Animation states using a bone blend mask cannot be cached.
+		*/
+		static bool isCacheable(const AnimationStateSet& animSet);
+
+	protected:
+		typedef vector<int32>::type Signature;
+
+		struct CacheKey
+		{
+			ResourceHandle skeleton;
+			uint32 hash;
+
+			bool operator<(const CacheKey& rhs) const
+			{
+				if (skeleton != rhs.skeleton)
+					return skeleton < rhs.skeleton;
+				return hash < rhs.hash;
+			}
+		};
+
+		struct CacheEntry;
+		typedef list<CacheEntry*>::type EntryList;
+		typedef map<CacheKey, CacheEntry*>::type EntryMap;
+
+		struct CacheEntry : public AnimationAlloc
+		{
+			CacheKey key;
+			/// Full signature, to rule out hash collisions
+			Signature signature;
+			unsigned short numBones;
+			Matrix4* matrices;
+			/// Position in the LRU list
+			EntryList::iterator lruPos;
+		};
+
+		/// Most recently used entries at the front
+		EntryList mLRUList;
+		EntryMap mEntries;
+		/// Scratch signature, reused between calls
+		Signature mScratchSignature;
+
+		size_t mMaxEntries;
+		Real mTimeQuantum;
+		Real mWeightQuantum;
+
+		size_t mHits;
+		size_t mMisses;
+		size_t mEvictions;
+
+		/// Builds the signature & key of an animation state into the scratch members
+		CacheKey buildKey(const SkeletonInstance* skel, const AnimationStateSet& animSet);
+		/// Destroys the least recently used entry
+		void evictOldest(void);
+		/// Destroys an entry
+		void destroyEntry(CacheEntry* entry);
+
+	};
+	/** @} */
+	/** @} */
+
+}
+
+#endif
@@ -234,6 +234,8 @@ namespace Ogre
         ushort mPixelSpaceWidth;
         size_t mAllocSize;
 		Real mViewportAspectCoef;
+		/// Glyph generation of the font when the geometry was last built
+		uint32 mGlyphGeneration;
 
         /// Colours to use for the vertices
         ColourValue mColourBottom;
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreHardwareBuffer.h"
 #include "OgreResource.h"
 #include "OgreImage.h"
+#include "OgreStringVector.h"
 
 namespace Ogre {
 
@@ -401,8 +402,65 @@ namespace Ogre {
 
 		bool mInternalResourcesCreated;
 
+		/// Key of the texture in the transcode cache, see TextureManager::setTranscodeCache
+		String mTranscodeKey;
+		/// Size and hash of the source data the key was looked up with
+		size_t mTranscodeSourceSize;
+		uint32 mTranscodeSourceHash;
+		/// Whether _loadImages should transcode its images and save them into the cache
+		bool mTranscodePending;
+		/** Whether the images passed to _loadImages were read from the transcode cache,
+			or with mTranscodePending, decoded straight into what the cache holds
+		*/
+		bool mTranscodedImages;
+
 		/// @copydoc Resource::calculateSize
 		size_t calculateSize(void) const;
+
+		/** Reads the images the texture is loaded from.
+		@remarks
+			Implementations call this when preparing the texture, with the names
+			of its source files (one, or six for a cube map held in separate files).
+			If the TextureManager has a transcode cache holding a valid entry for
+			the sources and the texture's settings, images receives that single
+			image instead and the sources are not decoded. Otherwise the sources
+			are decoded, and _loadImages saves what it makes of them into the cache.
+		*/
+		void readSourceImages(const StringVector& names, const String& ext, vector<Image>::type& images);
+		/** Reads the images the texture is loaded from, out of streams already
+			opened on the named sources; for render systems which read their
+			sources when the texture is prepared and decode them when it is loaded.
+		@see readSourceImages(const StringVector&, const String&, vector<Image>::type&)
+		*/
+		void readSourceImages(const StringVector& names, const vector<DataStreamPtr>::type& sources, 
+			const String& ext, vector<Image>::type& images);
+
+		/** Converts images to the format, gamma and mipmaps the texture will have.
+		@returns false if the images can not be transcoded, for instance because
+			they are compressed or already have mipmaps
+		*/
+		bool transcodeImages(const ConstImagePtrList& images, Image& transcoded);
+
+		/** Gets the format transcodeImages converts images in the given format to.
+		@returns PF_UNKNOWN if such images can not be transcoded
+		*/
+		PixelFormat getTranscodeFormat(PixelFormat srcFormat) const;
+
+		/// Gets the number of mipmaps transcodeImages generates for images of this size
+		size_t getTranscodeMipmaps(size_t width, size_t height) const;
+
+		/** Decodes a source straight into the image transcodeImages would make of it,
+			without an intermediate image in the source format.
+		@returns false, with the stream back at its start, if the source can not be
+			transcoded that way, for instance because it has mipmaps or several faces
+		*/
+		bool decodeTranscoded(DataStreamPtr& stream, const String& ext, Image& image);
+
+		class TranscodeTarget;
+		friend class TranscodeTarget;
+
+		/// Loads images into the texture; transcoded images are used as they are
+		void loadImagesImpl(const ConstImagePtrList& images, bool transcoded);
 		
 
 		/** Implementation of creating internal texture resources 
@@ -416,6 +474,11 @@ namespace Ogre {
 		/** Default implementation of unload which calls freeInternalResources */
 		void unloadImpl(void);
 
+		/** Forgets what readSourceImages found in the transcode cache, subclasses 
+			overriding this must call it
+		*/
+		void unprepareImpl(void);
+
 		/** Identify the source file type as a string, either from the extension
 			or from a magic number.
 		*/
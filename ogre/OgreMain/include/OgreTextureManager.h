@@ -34,6 +34,8 @@ THE SOFTWARE.
 #include "OgreResourceManager.h"
 #include "OgreTexture.h"
 #include "OgreSingleton.h"
+#include "OgreWorkQueue.h"
+#include "OgreCodec.h"
 
 
 namespace Ogre {
@@ -56,10 +58,30 @@ namespace Ogre {
             and calling initialise from the Root object), and b)
             created at least one window - this may be done at the
             same time as part a if you allow Ogre to autocreate one.
+        @par
+            Textures can also be streamed (see loadStreamed), in which case only
+            their smallest mipmaps are uploaded when they are loaded and the more
+            detailed levels are decoded by the WorkQueue and uploaded over the
+            following frames.
      */
-    class _OgreExport TextureManager : public ResourceManager, public Singleton<TextureManager>
+    class _OgreExport TextureManager : public ResourceManager, public Singleton<TextureManager>,
+		public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
     {
     public:
+        /** Listener which is told about changes in the residency of streamed textures.
+        @see TextureManager::loadStreamed
+        */
+        class _OgreExport StreamingListener
+        {
+        public:
+            virtual ~StreamingListener() {}
+            /** Called when mipmaps of a streamed texture have been uploaded.
+            @param tex The texture
+            @param residentMipmap The most detailed level of the source image now
+                held by the texture; 0 once the texture is complete
+            */
+            virtual void textureResidencyChanged(Texture* tex, size_t residentMipmap) = 0;
+        };
 
         TextureManager(void);
         virtual ~TextureManager();
@@ -165,6 +187,34 @@ namespace Ogre {
             PixelFormat desiredFormat = PF_UNKNOWN, 
 			bool hwGammaCorrection = false);
 
+        /** Loads a texture from a file, uploading its smallest mipmaps first.
+            @remarks
+                Only the mipmaps no larger than the streaming initial size (see
+                setStreamingInitialSize) are decoded and uploaded by this call, so the
+                texture can be used straight away. The more detailed levels are then
+                decoded one at a time by the WorkQueue and uploaded by _updateStreaming
+                within the per-frame budget set by setStreamingUploadBudget, the texture
+                being recreated at the larger size with each level. StreamingListener
+                instances are told each time this happens. 
+            @par
+                Streaming needs a codec which can read the image header without
+                decoding the image, such as the DDS codec, and an image which holds
+                its own mipmaps; anything else is loaded in full. The texture is
+                created as manually loaded with an internal loader, so it is streamed
+                in again whenever it is reloaded.
+            @param
+                name The file to load
+            @param
+                group The name of the resource group to assign the texture to
+            @param
+                texType The type of texture to load, 2D or a cube map held in one file
+            @see TextureManager::load for the remaining parameters
+        */
+        virtual TexturePtr loadStreamed( 
+            const String& name, const String& group, 
+            TextureType texType = TEX_TYPE_2D, Real gamma = 1.0f, bool isAlpha = false,
+            PixelFormat desiredFormat = PF_UNKNOWN, bool hwGammaCorrection = false);
+
         /** Loads a texture from an Image object.
             @note
                 The texture will create as manual texture without loader.
@@ -462,6 +512,116 @@ namespace Ogre {
             return mDefaultNumMipmaps;
         }
 
+        /** Sets whether load() streams DDS textures by default.
+            @remarks
+                When enabled, load() hands 2D and cube map DDS files loaded with the
+                default number of mipmaps to loadStreamed. This covers textures loaded
+                through materials. The default is false.
+        */
+        virtual void setDefaultStreaming(bool stream) { mDefaultStreaming = stream; }
+
+        /** Gets whether load() streams DDS textures by default. */
+        virtual bool getDefaultStreaming(void) const { return mDefaultStreaming; }
+
+        /** Sets the size below which the mipmaps of streamed textures are uploaded
+            straight away when the texture is loaded.
+            @remarks
+                Levels whose largest dimension is no bigger than this are decoded
+                and uploaded by the load itself. The default is 64.
+        */
+        virtual void setStreamingInitialSize(size_t size) { mStreamingInitialSize = size; }
+
+        /** Gets the size below which the mipmaps of streamed textures are uploaded
+            straight away when the texture is loaded. */
+        virtual size_t getStreamingInitialSize(void) const { return mStreamingInitialSize; }
+
+        /** Sets the number of bytes of streamed mipmap data uploaded per frame.
+            @remarks
+                A texture is recreated each time a level is added to it, so adding
+                a level counts the size of all the levels the texture then holds.
+                At least one level is uploaded each frame while levels are waiting,
+                whatever their size. The default is 4MB.
+        */
+        virtual void setStreamingUploadBudget(size_t bytes) { mStreamingUploadBudget = bytes; }
+
+        /** Gets the number of bytes of streamed mipmap data uploaded per frame. */
+        virtual size_t getStreamingUploadBudget(void) const { return mStreamingUploadBudget; }
+
+        /** Gets the number of textures which are still being streamed in. */
+        virtual size_t getStreamingTextureCount(void) const;
+
+        /** Adds a listener which is told about streamed texture residency changes. */
+        virtual void addStreamingListener(StreamingListener* l);
+        /** Removes a listener added with addStreamingListener. */
+        virtual void removeStreamingListener(StreamingListener* l);
+
+        /** Uploads decoded mipmaps of streamed textures, within the upload budget.
+            @remarks
+                Called by Root once per frame; must be called from the thread which
+                owns the render system.
+        */
+        virtual void _updateStreaming(void);
+
+        /** Sets an archive used to cache textures in the form they are uploaded in.
+            @remarks
+                When set, textures loaded from uncompressed images without mipmaps
+                (PNG, JPEG, TGA and the like) are converted to the render system's
+                format, gamma corrected and given their mipmaps once, and the result
+                saved into the archive (if it is writable). Later loads of the same
+                source with the same settings read it straight from the archive 
+                instead of decoding, converting and filtering the source again.
+                Entries are keyed by the names of the source files and the texture's
+                format, bit depth, mipmap and gamma settings, and only used if the 
+                source data is unchanged. Mipmaps of cached textures are always 
+                generated in software. A directory can be used through
+                ArchiveManager::load(path, "FileSystem").
+            @par
+                Only textures a render system loads from their source files, which
+                all of them read through Texture::readSourceImages, are cached;
+                images handed to Texture::loadImage are not. On Direct3D, DDS files
+                are loaded by D3DX and never reach the cache.
+            @param cache The archive to use, or null to disable caching
+        */
+        virtual void setTranscodeCache(Archive* cache);
+
+        /** Gets the archive used to cache transcoded textures, if any. */
+        virtual Archive* getTranscodeCache(void) const { return mTranscodeCache; }
+
+        /** Sets the number of bytes the transcode cache may use.
+            @remarks
+                When a new entry takes the cache over the budget, the least recently
+                used entries are removed from the archive until it fits again. Entries
+                found in the archive when it is set are ordered by modification time.
+                0 means no limit; the default is 256MB.
+        */
+        virtual void setTranscodeCacheBudget(size_t bytes);
+
+        /** Gets the number of bytes the transcode cache may use. */
+        virtual size_t getTranscodeCacheBudget(void) const { return mTranscodeCacheBudget; }
+
+        /** Gets the number of bytes currently used by the transcode cache. */
+        virtual size_t getTranscodeCacheSize(void) const;
+
+        /** Loads a transcoded texture from the cache.
+            @param key Identifies the texture and its load settings
+            @param sourceSize, sourceHash Size and hash of the source data
+            @param image Receives the transcoded image
+            @returns true if a valid entry was found
+        */
+        virtual bool _loadTranscodedImage(const String& key, size_t sourceSize, uint32 sourceHash, Image& image);
+
+        /** Saves a transcoded texture into the cache, see _loadTranscodedImage. */
+        virtual void _saveTranscodedImage(const String& key, size_t sourceSize, uint32 sourceHash, const Image& image);
+
+		/// @copydoc WorkQueue::RequestHandler::canHandleRequest
+		bool canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
+		/// @copydoc WorkQueue::RequestHandler::handleRequest
+		WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
+		/// @copydoc WorkQueue::ResponseHandler::canHandleResponse
+		bool canHandleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ);
+		/// @copydoc WorkQueue::ResponseHandler::handleResponse
+		void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ);
+
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
@@ -496,10 +656,102 @@ namespace Ogre {
         static TextureManager* getSingletonPtr(void);
 
     protected:
+		/** Overridden from ResourceManager.
+		@remarks
+			Textures are touched whenever a pass binds them, so unlike most
+			resources they can be evicted while materials still reference them.
+		*/
+		bool isEvictable(const ResourcePtr& res) const;
 
         ushort mPreferredIntegerBitDepth;
         ushort mPreferredFloatBitDepth;
         size_t mDefaultNumMipmaps;
+
+		/// Loader given to streamed textures
+		class _OgrePrivate StreamingLoader : public ManualResourceLoader
+		{
+		public:
+			void loadResource(Resource* resource);
+		};
+		StreamingLoader mStreamingLoader;
+
+		/// Streaming state of a texture which is not yet complete
+		struct StreamingTexture
+		{
+			/// Number of the load which started the streaming
+			uint32 generation;
+			/// Codec type of the source file
+			String codecType;
+			/// Decoded levels the texture currently holds
+			Codec::DecodeResult resident;
+			/// Level of the source image that the resident data starts at
+			size_t residentMip;
+			/// Decoded next level, waiting to be uploaded
+			Codec::DecodeResult pending;
+		};
+		typedef map<ResourceHandle, StreamingTexture>::type StreamingTextureMap;
+		StreamingTextureMap mStreamingTextures;
+		OGRE_MUTEX(mStreamingMutex)
+		uint32 mStreamingGeneration;
+
+		/// Work queue request to decode one level of a streamed texture
+		struct StreamingRequest
+		{
+			ResourceHandle handle;
+			uint32 generation;
+			String name;
+			String group;
+			String codecType;
+			size_t mipmap;
+			_OgreExport friend std::ostream& operator<<(std::ostream& o, const StreamingRequest& r)
+			{ (void)r; return o; }
+		};
+		/// Work queue response carrying a decoded level
+		struct StreamingResponse
+		{
+			StreamingRequest request;
+			Codec::DecodeResult result;
+			_OgreExport friend std::ostream& operator<<(std::ostream& o, const StreamingResponse& r)
+			{ (void)r; return o; }
+		};
+
+		typedef vector<StreamingListener*>::type StreamingListenerList;
+		StreamingListenerList mStreamingListeners;
+
+		bool mDefaultStreaming;
+		size_t mStreamingInitialSize;
+		size_t mStreamingUploadBudget;
+		uint16 mStreamingChannel;
+		bool mStreamingChannelRegistered;
+
+		/// Loads the coarse levels of a streamed texture; called by the streaming loader
+		void loadStreamedTexture(Texture* tex);
+		/// Loads decoded levels into a texture, recreating it at their size
+		void loadStreamedLevels(Texture* tex, const Codec::DecodeResult& levels);
+		/// Queues decoding of the level above the resident ones
+		void requestStreamedMipmap(Texture* tex, const StreamingTexture& st);
+		/// Tells the streaming listeners about a texture
+		void fireResidencyChanged(Texture* tex, size_t residentMipmap);
+
+		/// Archive holding transcoded textures
+		Archive* mTranscodeCache;
+		size_t mTranscodeCacheBudget;
+		/// Size and last use of an entry in the transcode cache
+		struct TranscodeEntry
+		{
+			size_t size;
+			size_t lastUsed;
+		};
+		typedef map<String, TranscodeEntry>::type TranscodeEntryMap;
+		TranscodeEntryMap mTranscodeEntries;
+		size_t mTranscodeCacheSize;
+		size_t mTranscodeUseCount;
+		OGRE_MUTEX(mTranscodeMutex)
+
+		/// Records the use of an entry in the transcode cache
+		void touchTranscodeEntry(const String& filename, size_t size);
+		/// Removes the least recently used entries until the cache fits its budget
+		void evictTranscodeEntries(const String& keep);
     };
 	/** @} */
 	/** @} */
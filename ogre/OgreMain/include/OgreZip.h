@@ -36,6 +36,7 @@ THE SOFTWARE.
 // Forward declaration for zziplib to avoid header file dependency.
 typedef struct zzip_dir		ZZIP_DIR;
 typedef struct zzip_file	ZZIP_FILE;
+typedef struct zzip_disk	ZZIP_DISK;
 
 namespace Ogre {
 
@@ -45,6 +46,24 @@ namespace Ogre {
 	/** \addtogroup Resources
 	*  @{
 	*/
+	/** The zip archive file mapped into memory by zziplib.
+	@remarks
+		Streams over stored files point straight into the mapping, so they
+		share it with the archive and it is closed when the last of them
+		goes away.
+	*/
+	class _OgrePrivate ZipMapping : public ArchiveAlloc
+	{
+	protected:
+		ZZIP_DISK* mZzipDisk;
+	public:
+		ZipMapping(ZZIP_DISK* zzipDisk) : mZzipDisk(zzipDisk) {}
+		~ZipMapping();
+		/// Get the zziplib handle of the mapping
+		ZZIP_DISK* getDisk(void) const { return mZzipDisk; }
+	};
+	typedef SharedPtr<ZipMapping> ZipMappingPtr;
+
 	/** Specialisation of the Archive class to allow reading of files from a zip
         format source archive.
     @remarks
@@ -56,6 +75,8 @@ namespace Ogre {
     protected:
         /// Handle to root zip file
         ZZIP_DIR* mZzipDir;
+        /// The archive mapped into memory, null where it can't be mapped
+        ZipMappingPtr mMapping;
         /// Handle any errors from zzip
         void checkZzipError(int zzipError, const String& operation) const;
         /// File list (since zziplib seems to only allow scanning of dir tree once)
@@ -148,6 +169,23 @@ namespace Ogre {
         void close(void);
 
 
+    };
+
+    /** Specialisation of DataStream for files stored without compression in a
+        zip archive, which are read straight from the mapped archive without
+        going through zziplib or the file system.
+    */
+    class _OgrePrivate ZipMappedDataStream : public MemoryDataStream
+    {
+    protected:
+        /// Keeps the mapping alive while the stream is open
+        ZipMappingPtr mMapping;
+    public:
+        ZipMappedDataStream(const String& name, const ZipMappingPtr& mapping,
+            void* data, size_t size);
+        ~ZipMappedDataStream();
+        /// @copydoc DataStream::close
+        void close(void);
     };
 
 	/** @} */
@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include "OgreBillboardParticleRenderer.h"
 #include "OgreParticle.h"
+#include "OgrePackedParticleData.h"
 #include "OgreStringConverter.h"
 
 namespace Ogre {
@@ -128,13 +129,16 @@ namespace Ogre {
     {
         mBillboardSet->setCullIndividually(cullIndividually);
 
-        // Update billboard set geometry
-        mBillboardSet->beginBillboards(currentParticles.size());
-        Billboard bb;
+        // Update billboard set geometry in a single batch
+        size_t count = currentParticles.size();
+        if (mBillboardBatch.size() < count)
+            mBillboardBatch.resize(count);
+        size_t n = 0;
         for (list<Particle*>::type::iterator i = currentParticles.begin();
-            i != currentParticles.end(); ++i)
+            i != currentParticles.end(); ++i, ++n)
         {
             Particle* p = *i;
+            Billboard& bb = mBillboardBatch[n];
             bb.mPosition = p->position;
 			if (mBillboardSet->getBillboardType() == BBT_ORIENTED_SELF ||
 				mBillboardSet->getBillboardType() == BBT_PERPENDICULAR_SELF)
@@ -151,15 +155,60 @@ namespace Ogre {
                 bb.mWidth = p->mWidth;
                 bb.mHeight = p->mHeight;
             }
-            mBillboardSet->injectBillboard(bb);
-
         }
+
+        mBillboardSet->beginBillboards(count);
+        if (count)
+            mBillboardSet->injectBillboards(&mBillboardBatch[0], count);
         
         mBillboardSet->endBillboards();
 
         // Update the queue
         mBillboardSet->_updateRenderQueue(queue);
     }
+    //-----------------------------------------------------------------------
+    void BillboardParticleRenderer::_updateRenderQueue(RenderQueue* queue, 
+        PackedParticleData& currentParticles, bool cullIndividually)
+    {
+        mBillboardSet->setCullIndividually(cullIndividually);
+
+        const PackedParticleData& d = currentParticles;
+        size_t count = d.size();
+        bool selfOriented = 
+            mBillboardSet->getBillboardType() == BBT_ORIENTED_SELF ||
+            mBillboardSet->getBillboardType() == BBT_PERPENDICULAR_SELF;
+
+        // Update billboard set geometry in a single batch
+        if (mBillboardBatch.size() < count)
+            mBillboardBatch.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Billboard& bb = mBillboardBatch[i];
+            bb.mPosition = d.getPosition(i);
+            if (selfOriented)
+            {
+                // Normalise direction vector
+                bb.mDirection = d.getDirection(i);
+                bb.mDirection.normalise();
+            }
+            bb.mColour = d.getColour(i);
+            bb.mRotation = Radian(d.rotation[i]);
+            // Assign and compare at the same time
+            if ((bb.mOwnDimensions = (d.ownDimensions[i] != 0)) == true)
+            {
+                bb.mWidth = d.width[i];
+                bb.mHeight = d.height[i];
+            }
+        }
+
+        mBillboardSet->beginBillboards(count);
+        if (count)
+            mBillboardSet->injectBillboards(&mBillboardBatch[0], count);
+        mBillboardSet->endBillboards();
+
+        // Update the queue
+        mBillboardSet->_updateRenderQueue(queue);
+    }
 	//---------------------------------------------------------------------
 	void BillboardParticleRenderer::visitRenderables(Renderable::Visitor* visitor, 
 		bool debugRenderables)
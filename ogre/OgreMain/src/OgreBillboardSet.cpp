@@ -41,12 +41,17 @@ THE SOFTWARE.
 #include "OgreException.h"
 #include "OgreStringConverter.h"
 #include "OgreLogManager.h"
+#include "OgrePlatformInformation.h"
 #include <algorithm>
 
-namespace Ogre {
-    // Init statics
-    RadixSort<BillboardSet::ActiveBillboardList, Billboard*, float> BillboardSet::mRadixSorter;
+#if __OGRE_HAVE_SSE
+// Keep this include last, see OgreOptimisedUtilSSE.cpp
+#include "OgreSIMDHelper.h"
+#endif
 
+namespace Ogre {
+    /// Number of pool sized regions held by a dynamic vertex buffer
+    static const size_t VERTEX_BUFFER_REGIONS = 3;
     //-----------------------------------------------------------------------
     BillboardSet::BillboardSet() :
 		mBoundingRadius(0.0f), 
@@ -69,7 +74,9 @@ namespace Ogre {
         mPoolSize(0),
 		mExternalData(false),
 		mAutoUpdate(true),
-		mBillboardDataChanged(true)
+		mBillboardDataChanged(true),
+        mVertexRegionStart(0),
+        mVertexRingOffset(0)
     {
         setDefaultDimensions( 100, 100 );
         setMaterialName( "BaseWhite" );
@@ -103,7 +110,9 @@ namespace Ogre {
         mPoolSize(poolSize),
         mExternalData(externalData),
 		mAutoUpdate(true),
-		mBillboardDataChanged(true)
+		mBillboardDataChanged(true),
+        mVertexRegionStart(0),
+        mVertexRingOffset(0)
     {
         setDefaultDimensions( 100, 100 );
         setMaterialName( "BaseWhite" );
@@ -329,10 +338,10 @@ namespace Ogre {
         switch (_getSortMode())
         {
         case SM_DIRECTION:
-            mRadixSorter.sort(mActiveBillboards, SortByDirectionFunctor(-mCamDir));
+            sortActiveBillboards(SortByDirectionFunctor(-mCamDir));
             break;
         case SM_DISTANCE:
-            mRadixSorter.sort(mActiveBillboards, SortByDistanceFunctor(mCamPos));
+            sortActiveBillboards(SortByDistanceFunctor(mCamPos));
             break;
         }
     }
@@ -445,34 +454,34 @@ namespace Ogre {
         // Init num visible
         mNumVisibleBillboards = 0;
 
-        // Lock the buffer
-		if (numBillboards) // optimal lock
-		{
-			// clamp to max
-			numBillboards = std::min(mPoolSize, numBillboards);
-
-			size_t billboardSize;
-			if (mPointRendering)
-			{
-				// just one vertex per billboard (this also excludes texcoords)
-				billboardSize = mMainBuf->getVertexSize();
-			}
-			else
-			{
-				// 4 corners
-				billboardSize = mMainBuf->getVertexSize() * 4;
-			}
-			assert (numBillboards * billboardSize <= mMainBuf->getSizeInBytes());
+        // Lock the buffer; lock only what we need if the number of billboards is known
+        numBillboards = numBillboards ? std::min(mPoolSize, numBillboards) : mPoolSize;
+        // 1 vertex per billboard if point rendering (this also excludes texcoords), else 4 corners
+        size_t numVertices = numBillboards * (mPointRendering ? 1 : 4);
+        size_t vertexSize = mMainBuf->getVertexSize();
 
-			mLockPtr = static_cast<float*>(
-				mMainBuf->lock(0, numBillboards * billboardSize, 
-				mMainBuf->getUsage() & HardwareBuffer::HBU_DYNAMIC ?
-				HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL) );
-		}
-		else // lock the entire thing
-			mLockPtr = static_cast<float*>(
-			mMainBuf->lock(mMainBuf->getUsage() & HardwareBuffer::HBU_DYNAMIC ?
-			HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL) );
+        if (mMainBuf->getUsage() & HardwareBuffer::HBU_DYNAMIC)
+        {
+            /* Fill the regions of the buffer in turn, promising not to touch
+               the data written for previous updates which may still be in use
+               by the GPU. Only discard the buffer when wrapping around.
+            */
+            HardwareBuffer::LockOptions lockOpt = HardwareBuffer::HBL_NO_OVERWRITE;
+            if (mVertexRingOffset + numVertices > mMainBuf->getNumVertices())
+            {
+                mVertexRingOffset = 0;
+                lockOpt = HardwareBuffer::HBL_DISCARD;
+            }
+            mVertexRegionStart = mVertexRingOffset;
+            mLockPtr = static_cast<float*>(mMainBuf->lock(
+                mVertexRegionStart * vertexSize, numVertices * vertexSize, lockOpt));
+        }
+        else
+        {
+            mVertexRegionStart = 0;
+            mLockPtr = static_cast<float*>(mMainBuf->lock(
+                0, numVertices * vertexSize, HardwareBuffer::HBL_NORMAL));
+        }
 
     }
     //-----------------------------------------------------------------------
@@ -484,6 +493,47 @@ namespace Ogre {
 		// Skip if not visible (NB always true if not bounds checking individual billboards)
         if (!billboardVisible(mCurrentCamera, bb)) return;
 
+        genBillboardVertices(bb);
+
+        // Increment visibles
+        mNumVisibleBillboards++;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::injectBillboards(const Billboard* billboards, size_t count)
+    {
+        mBatchBillboards.clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!addBatchBillboard(billboards[i]))
+                break;
+        }
+        flushBatchBillboards();
+    }
+    //-----------------------------------------------------------------------
+    bool BillboardSet::addBatchBillboard(const Billboard& bb)
+    {
+        // Don't accept injections beyond pool size
+        if (mNumVisibleBillboards + mBatchBillboards.size() >= mPoolSize)
+            return false;
+
+        if (billboardVisible(mCurrentCamera, bb))
+            mBatchBillboards.push_back(&bb);
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::flushBatchBillboards(void)
+    {
+        if (!mBatchBillboards.empty())
+        {
+            genBatchVertices(&mBatchBillboards[0], mBatchBillboards.size());
+            mNumVisibleBillboards = static_cast<unsigned short>(
+                mNumVisibleBillboards + mBatchBillboards.size());
+            mBatchBillboards.clear();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::genBillboardVertices(const Billboard& bb)
+    {
         if (!mPointRendering &&
 			(mBillboardType == BBT_ORIENTED_SELF ||
             mBillboardType == BBT_PERPENDICULAR_SELF ||
@@ -531,13 +581,15 @@ namespace Ogre {
                 genVertices(mVOffset, bb);
             }
         }
-        // Increment visibles
-        mNumVisibleBillboards++;
     }
     //-----------------------------------------------------------------------
     void BillboardSet::endBillboards(void)
     {
         mMainBuf->unlock();
+
+        // Next update starts after the vertices just written
+        mVertexRingOffset = mVertexRegionStart +
+            mNumVisibleBillboards * (mPointRendering ? 1 : 4);
     }
 	//-----------------------------------------------------------------------
 	void BillboardSet::setBounds(const AxisAlignedBox& box, Real radius)
@@ -611,13 +663,16 @@ namespace Ogre {
             }
 
             beginBillboards(mActiveBillboards.size());
+            mBatchBillboards.clear();
             ActiveBillboardList::iterator it;
             for(it = mActiveBillboards.begin();
                 it != mActiveBillboards.end();
                 ++it )
             {
-                injectBillboard(*(*it));
+                if (!addBatchBillboard(*(*it)))
+                    break;
             }
+            flushBatchBillboards();
             endBillboards();
 			mBillboardDataChanged = false;
         }
@@ -647,7 +702,7 @@ namespace Ogre {
     void BillboardSet::getRenderOperation(RenderOperation& op)
     {
         op.vertexData = mVertexData;
-       	op.vertexData->vertexStart = 0;
+       	op.vertexData->vertexStart = mVertexRegionStart;
 
 		if (mPointRendering)
 		{
@@ -780,12 +835,16 @@ namespace Ogre {
             decl->addElement(0, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES, 0);
         }
 
+        // Dynamic buffers hold several pool sized regions which are filled in
+        // turn, so updating never waits for the GPU to finish with the last one
         mMainBuf =
             HardwareBufferManager::getSingleton().createVertexBuffer(
                 decl->getVertexSize(0),
-                mVertexData->vertexCount,
+                mVertexData->vertexCount * (mAutoUpdate ? VERTEX_BUFFER_REGIONS : 1),
 				mAutoUpdate ? HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE : 
 				HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        mVertexRegionStart = 0;
+        mVertexRingOffset = 0;
         // bind position and diffuses
         binding->setBinding(0, mMainBuf);
 
@@ -1104,8 +1163,8 @@ namespace Ogre {
     void BillboardSet::genVertices(
         const Vector3* const offsets, const Billboard& bb)
     {
-        RGBA colour;
-        Root::getSingleton().convertColourValue(bb.mColour, &colour);
+        RGBA colour = VertexElement::convertColourValue(bb.mColour,
+            VertexElement::getBestColourVertexElementType());
 		RGBA* pCol;
 
         // Texcoords
@@ -1342,6 +1401,163 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    /** Writes the 4 vertices (position, colour, texture coordinates) of a
+        billboard quad.
+    @param pDest Destination, advanced past the written vertices
+    @param pos Billboard position
+    @param offsets Offsets of the 4 corners from the position
+    @param colour Vertex colour, in render system format
+    @param uv Texture coordinates of the 4 corners
+    */
+    static void writeBillboardQuad(float*& pDest, const Vector3& pos,
+        const Vector3* offsets, const RGBA& colour, const float* uv)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            *pDest++ = offsets[c].x + pos.x;
+            *pDest++ = offsets[c].y + pos.y;
+            *pDest++ = offsets[c].z + pos.z;
+            *reinterpret_cast<RGBA*>(pDest++) = colour;
+            *pDest++ = uv[c * 2];
+            *pDest++ = uv[c * 2 + 1];
+        }
+    }
+#if __OGRE_HAVE_SSE
+    //-----------------------------------------------------------------------
+    static FORCEINLINE __m128 loadVector3(const Vector3& v)
+    {
+        return _mm_setr_ps(v.x, v.y, v.z, 0.0f);
+    }
+    //-----------------------------------------------------------------------
+    /** SSE version of writeBillboardQuad.
+    @remarks
+        The 24 floats of the quad are assembled in registers by shuffling the
+        corner positions, colour and texture coordinates together, so they can
+        be written with 6 vector stores.
+    */
+    static void writeBillboardQuadSSE(float*& pDest, const Vector3& pos,
+        const Vector3* offsets, const RGBA& colour, const float* uv)
+    {
+        __m128 p = loadVector3(pos);
+        __m128 p0 = _mm_add_ps(p, loadVector3(offsets[0]));
+        __m128 p1 = _mm_add_ps(p, loadVector3(offsets[1]));
+        __m128 p2 = _mm_add_ps(p, loadVector3(offsets[2]));
+        __m128 p3 = _mm_add_ps(p, loadVector3(offsets[3]));
+        // Load the colour from memory so its bits go through untouched
+        __m128 col = _mm_load_ss(reinterpret_cast<const float*>(&colour));
+        __m128 uvTop = _mm_loadu_ps(uv);
+        __m128 uvBottom = _mm_loadu_ps(uv + 4);
+        __m128 zc;
+
+        // x0 y0 z0 c | u0 v0 x1 y1 | z1 c u1 v1
+        zc = _mm_shuffle_ps(p0, col, _MM_SHUFFLE(0, 0, 2, 2));
+        _mm_storeu_ps(pDest, _mm_shuffle_ps(p0, zc, _MM_SHUFFLE(2, 0, 1, 0)));
+        _mm_storeu_ps(pDest + 4, _mm_shuffle_ps(uvTop, p1, _MM_SHUFFLE(1, 0, 1, 0)));
+        zc = _mm_shuffle_ps(p1, col, _MM_SHUFFLE(0, 0, 2, 2));
+        _mm_storeu_ps(pDest + 8, _mm_shuffle_ps(zc, uvTop, _MM_SHUFFLE(3, 2, 2, 0)));
+        // x2 y2 z2 c | u2 v2 x3 y3 | z3 c u3 v3
+        zc = _mm_shuffle_ps(p2, col, _MM_SHUFFLE(0, 0, 2, 2));
+        _mm_storeu_ps(pDest + 12, _mm_shuffle_ps(p2, zc, _MM_SHUFFLE(2, 0, 1, 0)));
+        _mm_storeu_ps(pDest + 16, _mm_shuffle_ps(uvBottom, p3, _MM_SHUFFLE(1, 0, 1, 0)));
+        zc = _mm_shuffle_ps(p3, col, _MM_SHUFFLE(0, 0, 2, 2));
+        _mm_storeu_ps(pDest + 20, _mm_shuffle_ps(zc, uvBottom, _MM_SHUFFLE(3, 2, 2, 0)));
+
+        pDest += 24;
+    }
+#endif
+    //-----------------------------------------------------------------------
+    void BillboardSet::genBatchVertices(const Billboard* const* billboards, size_t count)
+    {
+        if (mPointRendering ||
+            mBillboardType == BBT_ORIENTED_SELF ||
+            mBillboardType == BBT_PERPENDICULAR_SELF ||
+            (mAccurateFacing && mBillboardType != BBT_PERPENDICULAR_COMMON))
+        {
+            // Nothing shared between billboards, generate them one by one
+            for (size_t i = 0; i < count; ++i)
+                genBillboardVertices(*billboards[i]);
+            return;
+        }
+
+        // Axes and default offsets were computed in beginBillboards, so the
+        // only per-billboard work left is the corners, colour and texcoords
+        VertexElementType colourType = VertexElement::getBestColourVertexElementType();
+#if __OGRE_HAVE_SSE
+        bool useSSE =
+            (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE) != 0;
+#endif
+        Vector3 vOwnOffset[4];
+        float uv[8];
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Billboard& bb = *billboards[i];
+
+            const Vector3* offsets = mVOffset;
+            if (!mAllDefaultSize && bb.mOwnDimensions)
+            {
+                genVertOffsets(mLeftOff, mRightOff, mTopOff, mBottomOff,
+                    bb.mWidth, bb.mHeight, mCamX, mCamY, vOwnOffset);
+                offsets = vOwnOffset;
+            }
+
+            bool rotated = !mAllDefaultRotation && bb.mRotation != Radian(0);
+            if (rotated && mRotationType == BBR_VERTEX)
+            {
+                // Rotating the corners needs a matrix per billboard anyway
+                genVertices(offsets, bb);
+                continue;
+            }
+
+            assert( bb.mUseTexcoordRect || bb.mTexcoordIndex < mTextureCoords.size() );
+            const Ogre::FloatRect & r =
+                bb.mUseTexcoordRect ? bb.mTexcoordRect : mTextureCoords[bb.mTexcoordIndex];
+            if (!rotated)
+            {
+                uv[0] = r.left;  uv[1] = r.top;
+                uv[2] = r.right; uv[3] = r.top;
+                uv[4] = r.left;  uv[5] = r.bottom;
+                uv[6] = r.right; uv[7] = r.bottom;
+            }
+            else
+            {
+                // Texture coordinate rotation, as genVertices
+                const Real cos_rot ( Math::Cos(bb.mRotation) );
+                const Real sin_rot ( Math::Sin(bb.mRotation) );
+
+                float width = (r.right-r.left)/2;
+                float height = (r.bottom-r.top)/2;
+                float mid_u = r.left+width;
+                float mid_v = r.top+height;
+
+                float cos_rot_w = cos_rot * width;
+                float cos_rot_h = cos_rot * height;
+                float sin_rot_w = sin_rot * width;
+                float sin_rot_h = sin_rot * height;
+
+                uv[0] = mid_u - cos_rot_w + sin_rot_h;
+                uv[1] = mid_v - sin_rot_w - cos_rot_h;
+                uv[2] = mid_u + cos_rot_w + sin_rot_h;
+                uv[3] = mid_v + sin_rot_w - cos_rot_h;
+                uv[4] = mid_u - cos_rot_w - sin_rot_h;
+                uv[5] = mid_v - sin_rot_w + cos_rot_h;
+                uv[6] = mid_u + cos_rot_w - sin_rot_h;
+                uv[7] = mid_v + sin_rot_w + cos_rot_h;
+            }
+
+            RGBA colour = VertexElement::convertColourValue(bb.mColour, colourType);
+
+#if __OGRE_HAVE_SSE
+            if (useSSE)
+            {
+                writeBillboardQuadSSE(mLockPtr, bb.mPosition, offsets, colour, uv);
+                continue;
+            }
+#endif
+            writeBillboardQuad(mLockPtr, bb.mPosition, offsets, colour, uv);
+        }
+    }
+    //-----------------------------------------------------------------------
     void BillboardSet::genVertOffsets(Real inleft, Real inright, Real intop, Real inbottom,
         Real width, Real height, const Vector3& x, const Vector3& y, Vector3* pDestVec)
     {
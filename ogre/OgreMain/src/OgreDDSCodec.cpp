@@ -36,7 +36,12 @@ THE SOFTWARE.
 
 #include "OgreLogManager.h"
 #include "OgreStringConverter.h"
+#include "OgreParallelTasks.h"
+#include "OgrePlatformInformation.h"
 
+#if __OGRE_HAVE_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace Ogre {
 	// Internal DDS structure definitions
@@ -84,32 +89,6 @@ namespace Ogre {
 		uint32 reserved2;
 	};
 
-	// An 8-byte DXT colour block, represents a 4x4 texel area. Used by all DXT formats
-	struct DXTColourBlock
-	{
-		// 2 colour ranges
-		uint16 colour_0;
-		uint16 colour_1;
-		// 16 2-bit indexes, each byte here is one row
-		uint8 indexRow[4];
-	};
-	// An 8-byte DXT explicit alpha block, represents a 4x4 texel area. Used by DXT2/3
-	struct DXTExplicitAlphaBlock
-	{
-		// 16 4-bit values, each 16-bit value is one row
-		uint16 alphaRow[4];
-	};
-	// An 8-byte DXT interpolated alpha block, represents a 4x4 texel area. Used by DXT4/5
-	struct DXTInterpolatedAlphaBlock
-	{
-		// 2 alpha ranges
-		uint8 alpha_0;
-		uint8 alpha_1;
-		// 16 3-bit indexes. Unfortunately 3 bits doesn't map too well to row bytes
-		// so just stored raw
-		uint8 indexes[6];
-	};
-	
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
 #pragma pack (pop)
 #else
@@ -152,6 +131,392 @@ namespace Ogre {
 	const uint32 D3DFMT_G32R32F         = 115;
 	const uint32 D3DFMT_A32B32G32R32F   = 116;
 
+	// Block decoding. Blocks are little endian byte streams, so are read a
+	// byte at a time and need no endian flipping; texels are written as
+	// PF_BYTE_RGBA, 4 bytes in R, G, B, A order, one native uint32 at a time.
+	namespace
+	{
+#if OGRE_ENDIAN == OGRE_ENDIAN_BIG
+		const uint32 TEXEL_SHIFT_R = 24;
+		const uint32 TEXEL_SHIFT_G = 16;
+		const uint32 TEXEL_SHIFT_B = 8;
+		const uint32 TEXEL_SHIFT_A = 0;
+#else
+		const uint32 TEXEL_SHIFT_R = 0;
+		const uint32 TEXEL_SHIFT_G = 8;
+		const uint32 TEXEL_SHIFT_B = 16;
+		const uint32 TEXEL_SHIFT_A = 24;
+#endif
+		const uint32 TEXEL_MASK_A = 0xFFu << TEXEL_SHIFT_A;
+
+		/// Block rows decoded by each parallel task
+		const size_t BLOCK_ROWS_PER_TASK = 16;
+
+		inline uint32 packTexel(uint32 r, uint32 g, uint32 b, uint32 a)
+		{
+			return (r << TEXEL_SHIFT_R) | (g << TEXEL_SHIFT_G) | 
+				(b << TEXEL_SHIFT_B) | (a << TEXEL_SHIFT_A);
+		}
+
+		/** Builds the 4 texel palette of an 8-byte BC1-3 colour block.
+		@param threeColour Whether colour_0 <= colour_1 selects the 3 colour
+			and transparent black mode, which is only the case for BC1
+		*/
+		inline void buildColourPalette(const uchar* block, bool threeColour, uint32* palette)
+		{
+			uint32 c0 = block[0] | (block[1] << 8);
+			uint32 c1 = block[2] | (block[3] << 8);
+			// Expand 5:6:5 to 8 bits per channel by replicating the top bits
+			uint32 r0 = (c0 >> 11) & 0x1F, g0 = (c0 >> 5) & 0x3F, b0 = c0 & 0x1F;
+			uint32 r1 = (c1 >> 11) & 0x1F, g1 = (c1 >> 5) & 0x3F, b1 = c1 & 0x1F;
+			r0 = (r0 << 3) | (r0 >> 2); g0 = (g0 << 2) | (g0 >> 4); b0 = (b0 << 3) | (b0 >> 2);
+			r1 = (r1 << 3) | (r1 >> 2); g1 = (g1 << 2) | (g1 >> 4); b1 = (b1 << 3) | (b1 >> 2);
+
+			palette[0] = packTexel(r0, g0, b0, 0xFF);
+			palette[1] = packTexel(r1, g1, b1, 0xFF);
+			if (threeColour && c0 <= c1)
+			{
+				// one intermediate colour, half way between the other two
+				palette[2] = packTexel((r0 + r1 + 1) / 2, (g0 + g1 + 1) / 2, 
+					(b0 + b1 + 1) / 2, 0xFF);
+				// transparent black
+				palette[3] = 0;
+			}
+			else
+			{
+				// intermediate colours 1/3 and 2/3 of the way along
+				palette[2] = packTexel((2 * r0 + r1 + 1) / 3, (2 * g0 + g1 + 1) / 3,
+					(2 * b0 + b1 + 1) / 3, 0xFF);
+				palette[3] = packTexel((r0 + 2 * r1 + 1) / 3, (g0 + 2 * g1 + 1) / 3,
+					(b0 + 2 * b1 + 1) / 3, 0xFF);
+			}
+		}
+
+		/** Decodes an 8-byte BC1-3 colour block into 16 texels. */
+		inline void decodeColourBlock(const uchar* block, bool threeColour, uint32* texels)
+		{
+			uint32 palette[4];
+			buildColourPalette(block, threeColour, palette);
+
+			// 16 2-bit indexes, LSB first, a byte per row
+			uint32 indexes = block[4] | (block[5] << 8) | (block[6] << 16) | 
+				(static_cast<uint32>(block[7]) << 24);
+			for (size_t i = 0; i < 16; ++i, indexes >>= 2)
+				texels[i] = palette[indexes & 0x3];
+		}
+
+		/** Builds the 8 value palette of an interpolated alpha block (BC3-5). */
+		inline void buildInterpolatedPalette(const uchar* block, uchar* palette)
+		{
+			uint32 a0 = block[0], a1 = block[1];
+			palette[0] = static_cast<uchar>(a0);
+			palette[1] = static_cast<uchar>(a1);
+			if (a0 > a1)
+			{
+				// 6 interpolated values, weights from 1/7 to 6/7
+				for (uint32 i = 1; i < 7; ++i)
+					palette[i + 1] = static_cast<uchar>(((7 - i) * a0 + i * a1 + 3) / 7);
+			}
+			else
+			{
+				// 4 interpolated values, weights from 1/5 to 4/5, plus zero and one
+				for (uint32 i = 1; i < 5; ++i)
+					palette[i + 1] = static_cast<uchar>(((5 - i) * a0 + i * a1 + 2) / 5);
+				palette[6] = 0;
+				palette[7] = 0xFF;
+			}
+		}
+
+		/// Reads the 16 3-bit indexes of an interpolated block, LSB first, 12 bits per row
+		inline uint64 readInterpolatedIndexes(const uchar* block)
+		{
+			uint64 indexes = 0;
+			for (int i = 5; i >= 0; --i)
+				indexes = (indexes << 8) | block[2 + i];
+			return indexes;
+		}
+
+		/** Decodes an 8-byte interpolated alpha block (BC3-5) into 16 values. */
+		inline void decodeInterpolatedBlock(const uchar* block, uchar* values)
+		{
+			uchar palette[8];
+			buildInterpolatedPalette(block, palette);
+			uint64 indexes = readInterpolatedIndexes(block);
+			for (size_t i = 0; i < 16; ++i, indexes >>= 3)
+				values[i] = palette[indexes & 0x7];
+		}
+
+		void decodeBC1Block(const uchar* block, uint32* texels)
+		{
+			decodeColourBlock(block, true, texels);
+		}
+
+		void decodeBC2Block(const uchar* block, uint32* texels)
+		{
+			decodeColourBlock(block + 8, false, texels);
+			// Explicit alpha, 4 bits per texel, LSB first
+			for (size_t i = 0; i < 8; ++i)
+			{
+				uint32 lo = (block[i] & 0xF) * 0x11;
+				uint32 hi = (block[i] >> 4) * 0x11;
+				texels[i * 2] = (texels[i * 2] & ~TEXEL_MASK_A) | (lo << TEXEL_SHIFT_A);
+				texels[i * 2 + 1] = (texels[i * 2 + 1] & ~TEXEL_MASK_A) | (hi << TEXEL_SHIFT_A);
+			}
+		}
+
+		void decodeBC3Block(const uchar* block, uint32* texels)
+		{
+			uchar alphas[16];
+			decodeInterpolatedBlock(block, alphas);
+			decodeColourBlock(block + 8, false, texels);
+			for (size_t i = 0; i < 16; ++i)
+				texels[i] = (texels[i] & ~TEXEL_MASK_A) | (alphas[i] << TEXEL_SHIFT_A);
+		}
+
+		void decodeBC4Block(const uchar* block, uint32* texels)
+		{
+			uchar reds[16];
+			decodeInterpolatedBlock(block, reds);
+			for (size_t i = 0; i < 16; ++i)
+				texels[i] = packTexel(reds[i], 0, 0, 0xFF);
+		}
+
+		void decodeBC5Block(const uchar* block, uint32* texels)
+		{
+			uchar reds[16], greens[16];
+			decodeInterpolatedBlock(block, reds);
+			decodeInterpolatedBlock(block + 8, greens);
+			for (size_t i = 0; i < 16; ++i)
+				texels[i] = packTexel(reds[i], greens[i], 0, 0xFF);
+		}
+
+#if __OGRE_HAVE_SSE2
+		// SSE2 versions of the decoders, a row of 4 texels per register. SSE2
+		// has no byte shuffle to look texels up in a palette, so each palette
+		// entry is broadcast and selected where a lane's index equals it. The
+		// palettes are built by the same scalar code, so results are identical.
+
+		static bool hasSSE2(void)
+		{
+			static const bool sse2 =
+				(PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE2) != 0;
+			return sse2;
+		}
+
+		/** Selects a palette entry per texel of a row of 2-bit indexes. */
+		inline __m128i selectColours(uint32 rowIndexes, const __m128i* palette)
+		{
+			__m128i indexes = _mm_and_si128(_mm_set1_epi32(rowIndexes), 
+				_mm_set_epi32(0x3 << 6, 0x3 << 4, 0x3 << 2, 0x3));
+			__m128i step = _mm_set_epi32(1 << 6, 1 << 4, 1 << 2, 1);
+			__m128i index = _mm_setzero_si128();
+			__m128i result = _mm_setzero_si128();
+			for (size_t i = 0; i < 4; ++i, index = _mm_add_epi32(index, step))
+				result = _mm_or_si128(result, 
+					_mm_and_si128(_mm_cmpeq_epi32(indexes, index), palette[i]));
+			return result;
+		}
+
+		/** Selects a palette entry per texel of a row of 3-bit indexes. */
+		inline __m128i selectValues(uint32 rowIndexes, const __m128i* palette)
+		{
+			__m128i indexes = _mm_and_si128(_mm_set1_epi32(rowIndexes), 
+				_mm_set_epi32(0x7 << 9, 0x7 << 6, 0x7 << 3, 0x7));
+			__m128i step = _mm_set_epi32(1 << 9, 1 << 6, 1 << 3, 1);
+			__m128i index = _mm_setzero_si128();
+			__m128i result = _mm_setzero_si128();
+			for (size_t i = 0; i < 8; ++i, index = _mm_add_epi32(index, step))
+				result = _mm_or_si128(result, 
+					_mm_and_si128(_mm_cmpeq_epi32(indexes, index), palette[i]));
+			return result;
+		}
+
+		/** Decodes a colour block into 4 rows of texels. */
+		inline void decodeColourRowsSSE2(const uchar* block, bool threeColour, __m128i* rows)
+		{
+			uint32 colours[4];
+			buildColourPalette(block, threeColour, colours);
+			__m128i palette[4];
+			for (size_t i = 0; i < 4; ++i)
+				palette[i] = _mm_set1_epi32(colours[i]);
+			for (size_t y = 0; y < 4; ++y)
+				rows[y] = selectColours(block[4 + y], palette);
+		}
+
+		/** Decodes an interpolated block into 4 rows of values, each moved to shift.
+		@param fill Bits set in every texel
+		*/
+		inline void decodeInterpolatedRowsSSE2(const uchar* block, uint32 shift, uint32 fill,
+			__m128i* rows)
+		{
+			uchar values[8];
+			buildInterpolatedPalette(block, values);
+			__m128i palette[8];
+			for (size_t i = 0; i < 8; ++i)
+				palette[i] = _mm_set1_epi32((static_cast<uint32>(values[i]) << shift) | fill);
+			uint64 indexes = readInterpolatedIndexes(block);
+			for (size_t y = 0; y < 4; ++y, indexes >>= 12)
+				rows[y] = selectValues(static_cast<uint32>(indexes & 0xFFF), palette);
+		}
+
+		void decodeBC1BlockSSE2(const uchar* block, uint32* texels)
+		{
+			__m128i rows[4];
+			decodeColourRowsSSE2(block, true, rows);
+			for (size_t y = 0; y < 4; ++y)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(texels + y * 4), rows[y]);
+		}
+
+		void decodeBC2BlockSSE2(const uchar* block, uint32* texels)
+		{
+			__m128i rows[4];
+			decodeColourRowsSSE2(block + 8, false, rows);
+			__m128i alphaMask = _mm_set1_epi32(TEXEL_MASK_A);
+			for (size_t y = 0; y < 4; ++y)
+			{
+				// Move each texel's 4 bits to the top of the low 16 bits of its
+				// lane, then down to the bottom, as SSE2 only shifts all lanes alike
+				uint32 rowAlphas = block[y * 2] | (block[y * 2 + 1] << 8);
+				__m128i alphas = _mm_and_si128(_mm_set1_epi32(rowAlphas),
+					_mm_set_epi32(0xF << 12, 0xF << 8, 0xF << 4, 0xF));
+				alphas = _mm_srli_epi32(_mm_mullo_epi16(alphas, 
+					_mm_set_epi32(1, 1 << 4, 1 << 8, 1 << 12)), 12);
+				alphas = _mm_or_si128(alphas, _mm_slli_epi32(alphas, 4));
+				__m128i texelRow = _mm_or_si128(_mm_andnot_si128(alphaMask, rows[y]),
+					_mm_slli_epi32(alphas, TEXEL_SHIFT_A));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(texels + y * 4), texelRow);
+			}
+		}
+
+		void decodeBC3BlockSSE2(const uchar* block, uint32* texels)
+		{
+			__m128i rows[4], alphas[4];
+			decodeInterpolatedRowsSSE2(block, TEXEL_SHIFT_A, 0, alphas);
+			decodeColourRowsSSE2(block + 8, false, rows);
+			__m128i alphaMask = _mm_set1_epi32(TEXEL_MASK_A);
+			for (size_t y = 0; y < 4; ++y)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(texels + y * 4), 
+					_mm_or_si128(_mm_andnot_si128(alphaMask, rows[y]), alphas[y]));
+		}
+
+		void decodeBC4BlockSSE2(const uchar* block, uint32* texels)
+		{
+			__m128i reds[4];
+			decodeInterpolatedRowsSSE2(block, TEXEL_SHIFT_R, TEXEL_MASK_A, reds);
+			for (size_t y = 0; y < 4; ++y)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(texels + y * 4), reds[y]);
+		}
+
+		void decodeBC5BlockSSE2(const uchar* block, uint32* texels)
+		{
+			__m128i reds[4], greens[4];
+			decodeInterpolatedRowsSSE2(block, TEXEL_SHIFT_R, TEXEL_MASK_A, reds);
+			decodeInterpolatedRowsSSE2(block + 8, TEXEL_SHIFT_G, 0, greens);
+			for (size_t y = 0; y < 4; ++y)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(texels + y * 4), 
+					_mm_or_si128(reds[y], greens[y]));
+		}
+#endif
+
+		typedef void (*BlockDecoder)(const uchar* block, uint32* texels);
+
+		/** Decodes the blocks of a level into PF_BYTE_RGBA, a band of block
+			rows per task. Slices follow each other in both source and destination.
+		*/
+		class DecodeBlockRowsTask : public ParallelTasks::Task
+		{
+		protected:
+			BlockDecoder mDecoder;
+			size_t mBlockSize;
+			const uchar* mSrc;
+			uchar* mDest;
+			size_t mWidth;
+			size_t mHeight;
+			size_t mBlocksX;
+			size_t mBlocksY;
+			size_t mTotalBlockRows;
+		public:
+			DecodeBlockRowsTask(PixelFormat format, const uchar* src, uchar* dest,
+				size_t width, size_t height, size_t depth)
+				: mSrc(src), mDest(dest), mWidth(width), mHeight(height),
+				mBlocksX((width + 3) / 4), mBlocksY((height + 3) / 4),
+				mTotalBlockRows(((height + 3) / 4) * depth)
+			{
+				mBlockSize = 16;
+				switch (format)
+				{
+				case PF_DXT1:
+					mDecoder = decodeBC1Block;
+					mBlockSize = 8;
+					break;
+				case PF_DXT2:
+				case PF_DXT3:
+					mDecoder = decodeBC2Block;
+					break;
+				case PF_DXT4:
+				case PF_DXT5:
+					mDecoder = decodeBC3Block;
+					break;
+				case PF_BC4_UNORM:
+					mDecoder = decodeBC4Block;
+					mBlockSize = 8;
+					break;
+				case PF_BC5_UNORM:
+					mDecoder = decodeBC5Block;
+					break;
+				default:
+					OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+						"Unsupported block compressed format",
+						"DDSCodec::decodeMipmaps");
+				}
+#if __OGRE_HAVE_SSE2
+				if (hasSSE2())
+				{
+					if (mDecoder == decodeBC1Block)
+						mDecoder = decodeBC1BlockSSE2;
+					else if (mDecoder == decodeBC2Block)
+						mDecoder = decodeBC2BlockSSE2;
+					else if (mDecoder == decodeBC3Block)
+						mDecoder = decodeBC3BlockSSE2;
+					else if (mDecoder == decodeBC4Block)
+						mDecoder = decodeBC4BlockSSE2;
+					else
+						mDecoder = decodeBC5BlockSSE2;
+				}
+#endif
+			}
+
+			size_t getTaskCount() const
+			{
+				return (mTotalBlockRows + BLOCK_ROWS_PER_TASK - 1) / BLOCK_ROWS_PER_TASK;
+			}
+
+			void run(size_t index)
+			{
+				size_t rowPitch = mWidth * 4;
+				size_t endRow = std::min(mTotalBlockRows, (index + 1) * BLOCK_ROWS_PER_TASK);
+				for (size_t row = index * BLOCK_ROWS_PER_TASK; row < endRow; ++row)
+				{
+					size_t slice = row / mBlocksY;
+					size_t y = (row % mBlocksY) * 4;
+					size_t rows = std::min((size_t)4, mHeight - y);
+					const uchar* src = mSrc + row * mBlocksX * mBlockSize;
+					uchar* dest = mDest + (slice * mHeight + y) * rowPitch;
+					uint32 texels[16];
+					for (size_t x = 0; x < mWidth; x += 4)
+					{
+						mDecoder(src, texels);
+						src += mBlockSize;
+						// Edge blocks of levels smaller than a block are clipped
+						size_t rowBytes = std::min((size_t)4, mWidth - x) * 4;
+						for (size_t by = 0; by < rows; ++by)
+							memcpy(dest + by * rowPitch + x * 4, texels + by * 4, rowBytes);
+					}
+				}
+			}
+		};
+	}
+
 
 	//---------------------------------------------------------------------
 	DDSCodec* DDSCodec::msInstance = 0;
@@ -380,6 +745,12 @@ namespace Ogre {
 			return PF_DXT4;
 		case FOURCC('D','X','T','5'):
 			return PF_DXT5;
+		case FOURCC('A','T','I','1'):
+		case FOURCC('B','C','4','U'):
+			return PF_BC4_UNORM;
+		case FOURCC('A','T','I','2'):
+		case FOURCC('B','C','5','U'):
+			return PF_BC5_UNORM;
 		case D3DFMT_R16F:
 			return PF_FLOAT16_R;
 		case D3DFMT_G16R16F:
@@ -392,7 +763,6 @@ namespace Ogre {
 			return PF_FLOAT32_GR;
 		case D3DFMT_A32B32G32R32F:
 			return PF_FLOAT32_RGBA;
-		// We could support 3Dc here, but only ATI cards support it, not nVidia
 		default:
 			OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
 				"Unsupported FourCC format found in DDS file", 
@@ -430,150 +800,9 @@ namespace Ogre {
 
 	}
 	//---------------------------------------------------------------------
-	void DDSCodec::unpackDXTColour(PixelFormat pf, const DXTColourBlock& block, 
-		ColourValue* pCol) const
-	{
-		// Note - we assume all values have already been endian swapped
-
-		// Colour lookup table
-		ColourValue derivedColours[4];
-
-		if (pf == PF_DXT1 && block.colour_0 <= block.colour_1)
-		{
-			// 1-bit alpha
-			PixelUtil::unpackColour(&(derivedColours[0]), PF_R5G6B5, &(block.colour_0));
-			PixelUtil::unpackColour(&(derivedColours[1]), PF_R5G6B5, &(block.colour_1));
-			// one intermediate colour, half way between the other two
-			derivedColours[2] = (derivedColours[0] + derivedColours[1]) / 2;
-			// transparent colour
-			derivedColours[3] = ColourValue::ZERO;
-		}
-		else
-		{
-			PixelUtil::unpackColour(&(derivedColours[0]), PF_R5G6B5, &(block.colour_0));
-			PixelUtil::unpackColour(&(derivedColours[1]), PF_R5G6B5, &(block.colour_1));
-			// first interpolated colour, 1/3 of the way along
-			derivedColours[2] = (2 * derivedColours[0] + derivedColours[1]) / 3;
-			// second interpolated colour, 2/3 of the way along
-			derivedColours[3] = (derivedColours[0] + 2 * derivedColours[1]) / 3;
-		}
-
-		// Process 4x4 block of texels
-		for (size_t row = 0; row < 4; ++row)
-		{
-			for (size_t x = 0; x < 4; ++x)
-			{
-				// LSB come first
-				uint8 colIdx = static_cast<uint8>(block.indexRow[row] >> (x * 2) & 0x3);
-				if (pf == PF_DXT1)
-				{
-					// Overwrite entire colour
-					pCol[(row * 4) + x] = derivedColours[colIdx];
-				}
-				else
-				{
-					// alpha has already been read (alpha precedes colour)
-					ColourValue& col = pCol[(row * 4) + x];
-					col.r = derivedColours[colIdx].r;
-					col.g = derivedColours[colIdx].g;
-					col.b = derivedColours[colIdx].b;
-				}
-			}
-
-		}
-
-
-	}
-	//---------------------------------------------------------------------
-	void DDSCodec::unpackDXTAlpha(
-		const DXTExplicitAlphaBlock& block, ColourValue* pCol) const
-	{
-		// Note - we assume all values have already been endian swapped
-		
-		// This is an explicit alpha block, 4 bits per pixel, LSB first
-		for (size_t row = 0; row < 4; ++row)
-		{
-			for (size_t x = 0; x < 4; ++x)
-			{
-				// Shift and mask off to 4 bits
-				uint8 val = static_cast<uint8>(block.alphaRow[row] >> (x * 4) & 0xF);
-				// Convert to [0,1]
-				pCol->a = (Real)val / (Real)0xF;
-				pCol++;
-				
-			}
-			
-		}
-
-	}
-	//---------------------------------------------------------------------
-	void DDSCodec::unpackDXTAlpha(
-		const DXTInterpolatedAlphaBlock& block, ColourValue* pCol) const
+    DDSCodec::ImageData* DDSCodec::readHeader(DataStreamPtr& stream, DDSHeader& header,
+		PixelFormat& sourceFormat, bool& decompressDXT) const
 	{
-		// 8 derived alpha values to be indexed
-		Real derivedAlphas[8];
-
-		// Explicit extremes
-		derivedAlphas[0] = block.alpha_0 / (Real)0xFF;
-		derivedAlphas[1] = block.alpha_1 / (Real)0xFF;
-		
-		
-		if (block.alpha_0 <= block.alpha_1)
-		{
-			// 4 interpolated alphas, plus zero and one			
-			// full range including extremes at [0] and [5]
-			// we want to fill in [1] through [4] at weights ranging
-			// from 1/5 to 4/5
-			Real denom = 1.0f / 5.0f;
-			for (size_t i = 0; i < 4; ++i) 
-			{
-				Real factor0 = (4 - i) * denom;
-				Real factor1 = (i + 1) * denom;
-				derivedAlphas[i + 2] = 
-					(factor0 * block.alpha_0) + (factor1 * block.alpha_1);
-			}
-			derivedAlphas[6] = 0.0f;
-			derivedAlphas[7] = 1.0f;
-
-		}
-		else
-		{
-			// 6 interpolated alphas
-			// full range including extremes at [0] and [7]
-			// we want to fill in [1] through [6] at weights ranging
-			// from 1/7 to 6/7
-			Real denom = 1.0f / 7.0f;
-			for (size_t i = 0; i < 6; ++i) 
-			{
-				Real factor0 = (6 - i) * denom;
-				Real factor1 = (i + 1) * denom;
-				derivedAlphas[i + 2] = 
-					(factor0 * block.alpha_0) + (factor1 * block.alpha_1);
-			}
-			
-		}
-
-		// Ok, now we've built the reference values, process the indexes
-		for (size_t i = 0; i < 16; ++i)
-		{
-			size_t baseByte = (i * 3) / 8;
-			size_t baseBit = (i * 3) % 8;
-			uint8 bits = static_cast<uint8>(block.indexes[baseByte] >> baseBit & 0x7);
-			// do we need to stitch in next byte too?
-			if (baseBit > 5)
-			{
-				uint8 extraBits = static_cast<uint8>(
-					(block.indexes[baseByte+1] << (8 - baseBit)) & 0xFF);
-				bits |= extraBits & 0x7;
-			}
-			pCol[i].a = derivedAlphas[bits];
-
-		}
-
-	}
-    //---------------------------------------------------------------------
-    Codec::DecodeResult DDSCodec::decode(DataStreamPtr& stream) const
-    {
 		// Read 4 character code
 		uint32 fileType;
 		stream->read(&fileType, sizeof(uint32));
@@ -582,11 +811,10 @@ namespace Ogre {
 		if (FOURCC('D', 'D', 'S', ' ') != fileType)
 		{
 			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
-				"This is not a DDS file!", "DDSCodec::decode");
+				"This is not a DDS file!", "DDSCodec::readHeader");
 		}
 		
 		// Read header in full
-		DDSHeader header;
 		stream->read(&header, sizeof(DDSHeader));
 
 		// Endian flip if required, all 32-bit values
@@ -596,21 +824,20 @@ namespace Ogre {
 		if (header.size != DDS_HEADER_SIZE)
 		{
 			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
-				"DDS header size mismatch!", "DDSCodec::decode");
+				"DDS header size mismatch!", "DDSCodec::readHeader");
 		}
 		if (header.pixelFormat.size != DDS_PIXELFORMAT_SIZE)
 		{
 			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
-				"DDS header size mismatch!", "DDSCodec::decode");
+				"DDS header size mismatch!", "DDSCodec::readHeader");
 		}
 
 		ImageData* imgData = OGRE_NEW ImageData();
-		MemoryDataStreamPtr output;
-
 		imgData->depth = 1; // (deal with volume later)
 		imgData->width = header.width;
 		imgData->height = header.height;
 		size_t numFaces = 1; // assume one face until we know otherwise
+		decompressDXT = false;
 
 		if (header.caps.caps1 & DDSCAPS_MIPMAP)
 		{
@@ -622,7 +849,6 @@ namespace Ogre {
 		}
 		imgData->flags = 0;
 
-		bool decompressDXT = false;
 		// Figure out basic image type
 		if (header.caps.caps2 & DDSCAPS2_CUBEMAP)
 		{
@@ -635,7 +861,7 @@ namespace Ogre {
 			imgData->depth = header.depth;
 		}
 		// Pixel format
-		PixelFormat sourceFormat = PF_UNKNOWN;
+		sourceFormat = PF_UNKNOWN;
 
 		if (header.pixelFormat.flags & DDPF_FOURCC)
 		{
@@ -652,49 +878,17 @@ namespace Ogre {
 
 		if (PixelUtil::isCompressed(sourceFormat))
 		{
-			if (!Root::getSingleton().getRenderSystem()->getCapabilities()
-				->hasCapability(RSC_TEXTURE_COMPRESSION_DXT))
+			// No render system takes BC4 or BC5 data yet
+			RenderSystem* rs = Root::getSingletonPtr() ? 
+				Root::getSingleton().getRenderSystem() : 0;
+			if (sourceFormat == PF_BC4_UNORM || sourceFormat == PF_BC5_UNORM || !rs ||
+				!rs->getCapabilities()->hasCapability(RSC_TEXTURE_COMPRESSION_DXT))
 			{
-				// We'll need to decompress
+				// We'll need to decompress. We always expand to 32-bit RGBA, 
+				// even from DXT1: any of its blocks may hold transparent texels,
+				// and the interpolated values benefit from the extra precision.
 				decompressDXT = true;
-				// Convert format
-				switch (sourceFormat)
-				{
-				case PF_DXT1:
-					// source can be either 565 or 5551 depending on whether alpha present
-					// unfortunately you have to read a block to figure out which
-					// Note that we upgrade to 32-bit pixel formats here, even 
-					// though the source is 16-bit; this is because the interpolated
-					// values will benefit from the 32-bit results, and the source
-					// from which the 16-bit samples are calculated may have been
-					// 32-bit so can benefit from this.
-					DXTColourBlock block;
-					stream->read(&block, sizeof(DXTColourBlock));
-					flipEndian(&(block.colour_0), sizeof(uint16), 1);
-					flipEndian(&(block.colour_1), sizeof(uint16), 1);
-					// skip back since we'll need to read this again
-					stream->skip(0 - sizeof(DXTColourBlock));
-					// colour_0 <= colour_1 means transparency in DXT1
-					if (block.colour_0 <= block.colour_1)
-					{
-						imgData->format = PF_BYTE_RGBA;
-					}
-					else
-					{
-						imgData->format = PF_BYTE_RGB;
-					}
-					break;
-				case PF_DXT2:
-				case PF_DXT3:
-				case PF_DXT4:
-				case PF_DXT5:
-					// full alpha present, formats vary only in encoding 
-					imgData->format = PF_BYTE_RGBA;
-					break;
-                default:
-                    // all other cases need no special format handling
-                    break;
-				}
+				imgData->format = PF_BYTE_RGBA;
 			}
 			else
 			{
@@ -715,105 +909,107 @@ namespace Ogre {
 		imgData->size = Image::calculateSize(imgData->num_mipmaps, numFaces, 
 			imgData->width, imgData->height, imgData->depth, imgData->format);
 
+		return imgData;
+	}
+    //---------------------------------------------------------------------
+    Codec::CodecDataPtr DDSCodec::decodeHeader(DataStreamPtr& stream) const
+    {
+		DDSHeader header;
+		PixelFormat sourceFormat;
+		bool decompressDXT;
+		return CodecDataPtr(readHeader(stream, header, sourceFormat, decompressDXT));
+    }
+    //---------------------------------------------------------------------
+    Codec::DecodeResult DDSCodec::decode(DataStreamPtr& stream) const
+    {
+		return decodeMipmaps(stream, 0, 0);
+    }
+    //---------------------------------------------------------------------
+    Codec::DecodeResult DDSCodec::decodeMipmaps(DataStreamPtr& stream,
+		size_t firstMip, size_t numMips) const
+    {
+		DDSHeader header;
+		PixelFormat sourceFormat;
+		bool decompressDXT;
+		ImageData* imgData = readHeader(stream, header, sourceFormat, decompressDXT);
+		CodecDataPtr codecData(imgData);
+
+		size_t numFaces = (imgData->flags & IF_CUBEMAP) ? 6 : 1;
+		size_t totalMips = imgData->num_mipmaps + 1;
+		if (firstMip >= totalMips)
+		{
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+				"Requested mipmap is not present in the DDS file", 
+				"DDSCodec::decodeMipmaps");
+		}
+		if (numMips == 0 || firstMip + numMips > totalMips)
+			numMips = totalMips - firstMip;
+		size_t lastMip = firstMip + numMips;
+
+		// Dimensions of level 0 in the file; the image data describes the decoded levels only
+		size_t fullWidth = imgData->width;
+		size_t fullHeight = imgData->height;
+		size_t fullDepth = imgData->depth;
+		imgData->width = std::max((size_t)1, fullWidth >> firstMip);
+		imgData->height = std::max((size_t)1, fullHeight >> firstMip);
+		imgData->depth = std::max((size_t)1, fullDepth >> firstMip);
+		imgData->num_mipmaps = static_cast<ushort>(numMips - 1);
+		imgData->size = Image::calculateSize(imgData->num_mipmaps, numFaces, 
+			imgData->width, imgData->height, imgData->depth, imgData->format);
+
 		// Bind output buffer
-		output.bind(OGRE_NEW MemoryDataStream(imgData->size));
+		MemoryDataStreamPtr output(OGRE_NEW MemoryDataStream(imgData->size));
 
-		
 		// Now deal with the data
 		void* destPtr = output->getPtr();
+		// Compressed levels which are being decompressed
+		vector<uchar>::type compressed;
 
 		// all mips for a face, then each face
-		for(size_t i = 0; i < numFaces; ++i)
+		for(size_t face = 0; face < numFaces; ++face)
 		{   
-			size_t width = imgData->width;
-			size_t height = imgData->height;
-			size_t depth = imgData->depth;
+			size_t width = fullWidth;
+			size_t height = fullHeight;
+			size_t depth = fullDepth;
 
-			for(size_t mip = 0; mip <= imgData->num_mipmaps; ++mip)
+			for(size_t mip = 0; mip < totalMips; ++mip)
 			{
 				size_t dstPitch = width * PixelUtil::getNumElemBytes(imgData->format);
+				// Incoming pitch of uncompressed data, which may be padded
+				size_t srcPitch = dstPitch;
+				if (!PixelUtil::isCompressed(sourceFormat) && (header.flags & DDSD_PITCH))
+				{
+					srcPitch = std::max(dstPitch, static_cast<size_t>(header.sizeOrPitch >> mip));
+				}
 
-				if (PixelUtil::isCompressed(sourceFormat))
+				if (mip < firstMip || mip >= lastMip)
+				{
+					// Seek past levels which were not asked for
+					if (face + 1 == numFaces && mip >= lastMip)
+						break;
+					size_t srcSize = PixelUtil::isCompressed(sourceFormat) ?
+						PixelUtil::getMemorySize(width, height, depth, sourceFormat) :
+						srcPitch * height * depth;
+					stream->skip(static_cast<long>(srcSize));
+				}
+				else if (PixelUtil::isCompressed(sourceFormat))
 				{
 					// Compressed data
 					if (decompressDXT)
 					{
-						DXTColourBlock col;
-						DXTInterpolatedAlphaBlock iAlpha;
-						DXTExplicitAlphaBlock eAlpha;
-						// 4x4 block of decompressed colour
-						ColourValue tempColours[16];
-						size_t destBpp = PixelUtil::getNumElemBytes(imgData->format);
-						size_t sx = std::min(width, (size_t)4);
-						size_t sy = std::min(height, (size_t)4);
-						size_t destPitchMinus4 = dstPitch - destBpp * sx;
-						// slices are done individually
-						for(size_t z = 0; z < depth; ++z)
+						// Read the whole level, then decode it in parallel bands of block rows
+						size_t srcSize = PixelUtil::getMemorySize(width, height, depth, sourceFormat);
+						compressed.resize(srcSize);
+						if (stream->read(&compressed[0], srcSize) != srcSize)
 						{
-							// 4x4 blocks in x/y
-							for (size_t y = 0; y < height; y += 4)
-							{
-								for (size_t x = 0; x < width; x += 4)
-								{
-									if (sourceFormat == PF_DXT2 || 
-										sourceFormat == PF_DXT3)
-									{
-										// explicit alpha
-										stream->read(&eAlpha, sizeof(DXTExplicitAlphaBlock));
-										flipEndian(eAlpha.alphaRow, sizeof(uint16), 4);
-										unpackDXTAlpha(eAlpha, tempColours) ;
-									}
-									else if (sourceFormat == PF_DXT4 || 
-										sourceFormat == PF_DXT5)
-									{
-										// interpolated alpha
-										stream->read(&iAlpha, sizeof(DXTInterpolatedAlphaBlock));
-										flipEndian(&(iAlpha.alpha_0), sizeof(uint16), 1);
-										flipEndian(&(iAlpha.alpha_1), sizeof(uint16), 1);
-										unpackDXTAlpha(iAlpha, tempColours) ;
-									}
-									// always read colour
-									stream->read(&col, sizeof(DXTColourBlock));
-									flipEndian(&(col.colour_0), sizeof(uint16), 1);
-									flipEndian(&(col.colour_1), sizeof(uint16), 1);
-									unpackDXTColour(sourceFormat, col, tempColours);
-
-									// write 4x4 block to uncompressed version
-									for (size_t by = 0; by < sy; ++by)
-									{
-										for (size_t bx = 0; bx < sx; ++bx)
-										{
-											PixelUtil::packColour(tempColours[by*4+bx],
-												imgData->format, destPtr);
-											destPtr = static_cast<void*>(
-												static_cast<uchar*>(destPtr) + destBpp);
-										}
-										// advance to next row
-										destPtr = static_cast<void*>(
-											static_cast<uchar*>(destPtr) + destPitchMinus4);
-									}
-									// next block. Our dest pointer is 4 lines down
-									// from where it started
-									if (x + 4 >= width)
-									{
-										// Jump back to the start of the line
-										destPtr = static_cast<void*>(
-											static_cast<uchar*>(destPtr) - destPitchMinus4);
-									}
-									else
-									{
-										// Jump back up 4 rows and 4 pixels to the
-										// right to be at the next block to the right
-										destPtr = static_cast<void*>(
-											static_cast<uchar*>(destPtr) - dstPitch * sy + destBpp * sx);
-
-									}
-
-								}
-
-							}
+							OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+								"DDS file is truncated", "DDSCodec::decodeMipmaps");
 						}
-
+						DecodeBlockRowsTask task(sourceFormat, &compressed[0], 
+							static_cast<uchar*>(destPtr), width, height, depth);
+						ParallelTasks::run(task, task.getTaskCount());
+						destPtr = static_cast<void*>(static_cast<uchar*>(destPtr) + 
+							PixelUtil::getMemorySize(width, height, depth, imgData->format));
 					}
 					else
 					{
@@ -828,23 +1024,11 @@ namespace Ogre {
 				else
 				{
 					// Final data - trim incoming pitch
-					size_t srcPitch;
-					if (header.flags & DDSD_PITCH)
-					{
-						srcPitch = header.sizeOrPitch / 
-							std::max((size_t)1, mip * 2);
-					}
-					else
-					{
-						// assume same as final pitch
-						srcPitch = dstPitch;
-					}
-					assert (dstPitch <= srcPitch);
 					long srcAdvance = static_cast<long>(srcPitch) - static_cast<long>(dstPitch);
 
-					for (size_t z = 0; z < imgData->depth; ++z)
+					for (size_t z = 0; z < depth; ++z)
 					{
-						for (size_t y = 0; y < imgData->height; ++y)
+						for (size_t y = 0; y < height; ++y)
 						{
 							stream->read(destPtr, dstPitch);
 							if (srcAdvance > 0)
@@ -867,11 +1051,8 @@ namespace Ogre {
 
 		DecodeResult ret;
 		ret.first = output;
-		ret.second = CodecDataPtr(imgData);
+		ret.second = codecData;
 		return ret;
-		
-
-
     }
     //---------------------------------------------------------------------    
     String DDSCodec::getType() const 
@@ -30,6 +30,20 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreException.h"
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  if !defined(NOMINMAX) && defined(_MSC_VER)
+#	define NOMINMAX // required to stop windows.h messing up std::min
+#  endif
+#  include <windows.h>
+#else
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
 namespace Ogre {
 
     //-----------------------------------------------------------------------
@@ -413,6 +427,94 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+    MappedFileDataStream::MappedFileDataStream(const String& name, const String& filename)
+        : MemoryDataStream(name, 0, 0, false, true)
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        mMappingHandle = 0;
+        mFileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+        if (mFileHandle == INVALID_HANDLE_VALUE)
+        {
+            mFileHandle = 0;
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                "Cannot open file: " + filename,
+                "MappedFileDataStream::MappedFileDataStream");
+        }
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(mFileHandle, &fileSize) && fileSize.QuadPart > 0)
+        {
+            mMappingHandle = CreateFileMappingA(mFileHandle, 0, PAGE_READONLY, 0, 0, 0);
+            if (mMappingHandle)
+            {
+                mData = static_cast<uchar*>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+                mSize = static_cast<size_t>(fileSize.QuadPart);
+            }
+        }
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                "Cannot open file: " + filename,
+                "MappedFileDataStream::MappedFileDataStream");
+        }
+        struct stat tagStat;
+        if (fstat(fd, &tagStat) == 0 && tagStat.st_size > 0)
+        {
+            void* p = mmap(0, static_cast<size_t>(tagStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED)
+            {
+                mData = static_cast<uchar*>(p);
+                mSize = static_cast<size_t>(tagStat.st_size);
+                // Loaders usually go through the whole file, start paging it in now
+                madvise(p, mSize, MADV_WILLNEED);
+            }
+        }
+        // The mapping stays valid once the descriptor is closed
+        ::close(fd);
+#endif
+
+        if (!mData)
+        {
+            close();
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                "Cannot map file into memory: " + filename,
+                "MappedFileDataStream::MappedFileDataStream");
+        }
+        mPos = mData;
+        mEnd = mData + mSize;
+    }
+    //-----------------------------------------------------------------------
+    MappedFileDataStream::~MappedFileDataStream()
+    {
+        close();
+    }
+    //-----------------------------------------------------------------------
+    void MappedFileDataStream::close(void)
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        if (mData)
+            UnmapViewOfFile(mData);
+        if (mMappingHandle)
+        {
+            CloseHandle(mMappingHandle);
+            mMappingHandle = 0;
+        }
+        if (mFileHandle)
+        {
+            CloseHandle(mFileHandle);
+            mFileHandle = 0;
+        }
+#else
+        if (mData)
+            munmap(mData, mSize);
+#endif
+        mData = mPos = mEnd = 0;
+        mSize = 0;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     FileStreamDataStream::FileStreamDataStream(std::ifstream* s, bool freeOnClose)
         : DataStream(), mpInStream(s), mpFStreamRO(s), mpFStream(0), mFreeOnClose(freeOnClose)
     {
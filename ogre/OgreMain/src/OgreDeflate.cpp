@@ -28,8 +28,7 @@
 #include "OgreStableHeaders.h"
 #include "OgreDeflate.h"
 #include "OgreException.h"
-
-#include <zlib.h>
+#include "OgreDeflateChunks.h"
 
 namespace Ogre
 {
@@ -43,25 +42,67 @@ namespace Ogre
 		OGRE_FREE(address, MEMCATEGORY_GENERAL);
 	}
 	#define OGRE_DEFLATE_TMP_SIZE 16384
+
+	namespace
+	{
+		// Chunked format: header, offsets of each chunk plus the end offset 
+		// (relative to the start of the header), then the compressed chunks.
+		// All values little endian. 'O' isn't a valid zlib header byte, so
+		// the chunked format can't be mistaken for a plain deflate stream.
+		const uint32 CHUNKED_MAGIC = 0x5A44474F; // 'OGDZ'
+		const uint32 CHUNKED_VERSION = 1;
+		const size_t CHUNKED_HEADER_SIZE = 24;
+		// Number of chunks compressed together when writing
+		const size_t CHUNKED_WRITE_BATCH = 16;
+
+		void writeLE32(uchar* p, uint32 val)
+		{
+			for (int i = 0; i < 4; ++i)
+				p[i] = static_cast<uchar>(val >> (i * 8));
+		}
+		uint32 readLE32(const uchar* p)
+		{
+			return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32>(p[3]) << 24);
+		}
+		void writeLE64(uchar* p, uint64 val)
+		{
+			for (int i = 0; i < 8; ++i)
+				p[i] = static_cast<uchar>(val >> (i * 8));
+		}
+		uint64 readLE64(const uchar* p)
+		{
+			return readLE32(p) | (static_cast<uint64>(readLE32(p + 4)) << 32);
+		}
+	}
     //---------------------------------------------------------------------
-	DeflateStream::DeflateStream(const DataStreamPtr& compressedStream)
+	DeflateStream::DeflateStream(const DataStreamPtr& compressedStream, 
+		size_t chunkSize)
 	: DataStream(compressedStream->getAccessMode())
 	, mCompressedStream(compressedStream)
 	, mpZStream(0)
 	, mCurrentPos(0)
 	, mpTmp(0)
 	, mIsCompressedValid(true)
+	, mCompressedStart(0)
+	, mChunkSize(getAccessMode() == READ ? 0 : chunkSize)
+	, mChunkBuffer(0)
+	, mCachedChunk(0)
 	{
 		init();
 	}
     //---------------------------------------------------------------------
-	DeflateStream::DeflateStream(const String& name, const DataStreamPtr& compressedStream)		
+	DeflateStream::DeflateStream(const String& name, const DataStreamPtr& compressedStream, 
+		size_t chunkSize)		
 	: DataStream(name, compressedStream->getAccessMode())
 	, mCompressedStream(compressedStream)
 	, mpZStream(0)
 	, mCurrentPos(0)
 	, mpTmp(0)
 	, mIsCompressedValid(true)
+	, mCompressedStart(0)
+	, mChunkSize(getAccessMode() == READ ? 0 : chunkSize)
+	, mChunkBuffer(0)
+	, mCachedChunk(0)
 	{
 		init();
 	}
@@ -76,9 +117,23 @@ namespace Ogre
 		{
 			mpTmp = (unsigned char*)OGRE_MALLOC(OGRE_DEFLATE_TMP_SIZE, MEMCATEGORY_GENERAL);
 			size_t restorePoint = mCompressedStream->tell();
+			mCompressedStart = restorePoint;
 			// read early chunk
 			mpZStream->next_in = mpTmp;
 			mpZStream->avail_in = mCompressedStream->read(mpTmp, OGRE_DEFLATE_TMP_SIZE);
+
+			if (mpZStream->avail_in >= CHUNKED_HEADER_SIZE && readLE32(mpTmp) == CHUNKED_MAGIC)
+			{
+				// Chunks are inflated independently, no stream state is kept
+				uchar header[CHUNKED_HEADER_SIZE];
+				memcpy(header, mpTmp, CHUNKED_HEADER_SIZE);
+				OGRE_FREE(mpZStream, MEMCATEGORY_GENERAL);
+				mpZStream = 0;
+				OGRE_FREE(mpTmp, MEMCATEGORY_GENERAL);
+				mpTmp = 0;
+				initChunked(header);
+				return;
+			}
 			
 			if (inflateInit(mpZStream) != Z_OK)
 			{
@@ -125,16 +180,57 @@ namespace Ogre
 		}
 
 	}
+    //---------------------------------------------------------------------
+	void DeflateStream::initChunked(const uchar* header)
+	{
+		uint32 version = readLE32(header + 4);
+		size_t chunkSize = readLE32(header + 8);
+		size_t numChunks = readLE32(header + 12);
+		uint64 size = readLE64(header + 16);
+		if (version != CHUNKED_VERSION || chunkSize == 0 || 
+			numChunks != (size + chunkSize - 1) / chunkSize)
+		{
+			OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+				"Unsupported chunked deflate stream in " + mName, 
+				"DeflateStream::init");
+		}
+
+		// The index of chunk offsets follows the header
+		size_t indexSize = (numChunks + 1) * sizeof(uint64);
+		vector<uchar>::type index(indexSize);
+		mCompressedStream->seek(mCompressedStart + CHUNKED_HEADER_SIZE);
+		bool valid = mCompressedStream->read(&index[0], indexSize) == indexSize;
+
+		mChunkOffsets.resize(numChunks + 1);
+		for (size_t i = 0; valid && i <= numChunks; ++i)
+		{
+			mChunkOffsets[i] = readLE64(&index[i * sizeof(uint64)]);
+			valid = i ? mChunkOffsets[i] >= mChunkOffsets[i - 1] :
+				mChunkOffsets[0] == CHUNKED_HEADER_SIZE + indexSize;
+		}
+		if (!valid)
+		{
+			mChunkOffsets.clear();
+			OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+				"Corrupted chunked deflate stream in " + mName, 
+				"DeflateStream::init");
+		}
+
+		mChunkSize = chunkSize;
+		mSize = static_cast<size_t>(size);
+	}
     //---------------------------------------------------------------------
 	void DeflateStream::destroy()
 	{
-		if (getAccessMode() == READ)
+		if (getAccessMode() == READ && mpZStream)
 			inflateEnd(mpZStream);
 
 		OGRE_FREE(mpZStream, MEMCATEGORY_GENERAL);
 		mpZStream = 0;
 		OGRE_FREE(mpTmp, MEMCATEGORY_GENERAL);
 		mpTmp = 0;
+		OGRE_FREE(mChunkBuffer, MEMCATEGORY_GENERAL);
+		mChunkBuffer = 0;
 	}
 	//---------------------------------------------------------------------
 	DeflateStream::~DeflateStream()
@@ -154,6 +250,10 @@ namespace Ogre
 		{
 			return mTmpWriteStream->read(buf, count);
 		}
+		else if (mChunkSize)
+		{
+			return readChunked(buf, count);
+		}
 		else 
 		{
 
@@ -214,6 +314,83 @@ namespace Ogre
 			return newReadUncompressed + cachereads;
 		}
 	}
+    //---------------------------------------------------------------------
+	const uchar* DeflateStream::readCompressedChunks(size_t firstChunk, size_t endChunk)
+	{
+		size_t start = mCompressedStart + static_cast<size_t>(mChunkOffsets[firstChunk]);
+		size_t size = static_cast<size_t>(mChunkOffsets[endChunk] - mChunkOffsets[firstChunk]);
+
+		// Use memory resident data in place
+		const uchar* data = mCompressedStream->getDataPtr();
+		if (data && start + size <= mCompressedStream->size())
+			return data + start;
+
+		mCompressedBuffer.resize(std::max(size, size_t(1)));
+		mCompressedStream->seek(start);
+		if (mCompressedStream->read(&mCompressedBuffer[0], size) != size)
+		{
+			OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+				"Truncated compressed stream", "DeflateStream::read");
+		}
+		return &mCompressedBuffer[0];
+	}
+    //---------------------------------------------------------------------
+	size_t DeflateStream::readChunked(void* buf, size_t count)
+	{
+		if (mCurrentPos >= mSize)
+			return 0;
+		count = std::min(count, mSize - mCurrentPos);
+
+		uchar* dest = static_cast<uchar*>(buf);
+		size_t remaining = count;
+		size_t numChunks = mChunkOffsets.size() - 1;
+		while (remaining)
+		{
+			size_t chunk = mCurrentPos / mChunkSize;
+			size_t offset = mCurrentPos - chunk * mChunkSize;
+
+			if (offset == 0)
+			{
+				// Whole chunks covered by the read are inflated in parallel,
+				// straight into the destination
+				size_t end = mCurrentPos + remaining;
+				size_t endChunk = (end == mSize) ? numChunks : end / mChunkSize;
+				if (endChunk > chunk + 1)
+				{
+					DeflateChunks::InflateTask<uint64> task(readCompressedChunks(chunk, endChunk), 
+						&mChunkOffsets[chunk], dest, mChunkSize, mSize - mCurrentPos, 
+						mName, "DeflateStream::read");
+					ParallelTasks::run(task, endChunk - chunk);
+
+					size_t done = std::min(remaining, (endChunk - chunk) * mChunkSize);
+					dest += done;
+					remaining -= done;
+					mCurrentPos += done;
+					continue;
+				}
+			}
+
+			size_t chunkStart = chunk * mChunkSize;
+			if (!mChunkBuffer || mCachedChunk != chunk)
+			{
+				if (!mChunkBuffer)
+					mChunkBuffer = OGRE_ALLOC_T(uchar, mChunkSize, MEMCATEGORY_GENERAL);
+				DeflateChunks::InflateTask<uint64> task(readCompressedChunks(chunk, chunk + 1), 
+					&mChunkOffsets[chunk], mChunkBuffer, mChunkSize, mSize - chunkStart, 
+					mName, "DeflateStream::read");
+				task.run(0);
+				mCachedChunk = chunk;
+			}
+
+			size_t cnt = std::min(remaining, std::min(mChunkSize, mSize - chunkStart) - offset);
+			memcpy(dest, mChunkBuffer + offset, cnt);
+			dest += cnt;
+			remaining -= cnt;
+			mCurrentPos += cnt;
+		}
+
+		return count;
+	}
     //---------------------------------------------------------------------
 	size_t DeflateStream::write(const void* buf, size_t count)
 	{
@@ -228,6 +405,12 @@ namespace Ogre
 	{
 		// Close temp stream
 		mTmpWriteStream->close();
+
+		if (mChunkSize)
+		{
+			compressFinalChunked();
+			return;
+		}
 		
 		// Copy & compress
 		// We do this rather than compress directly because some code seeks
@@ -285,6 +468,64 @@ namespace Ogre
 		remove(mTempFileName.c_str());
 						
 	}
+    //---------------------------------------------------------------------
+	void DeflateStream::compressFinalChunked()
+	{
+		std::ifstream inFile;
+		inFile.open(mTempFileName.c_str(), std::ios::in | std::ios::binary);
+		inFile.seekg(0, std::ios::end);
+		size_t totalSize = static_cast<size_t>(inFile.tellg());
+		inFile.seekg(0, std::ios::beg);
+		size_t numChunks = (totalSize + mChunkSize - 1) / mChunkSize;
+
+		size_t start = mCompressedStream->tell();
+		uchar header[CHUNKED_HEADER_SIZE];
+		writeLE32(header, CHUNKED_MAGIC);
+		writeLE32(header + 4, CHUNKED_VERSION);
+		writeLE32(header + 8, static_cast<uint32>(mChunkSize));
+		writeLE32(header + 12, static_cast<uint32>(numChunks));
+		writeLE64(header + 16, totalSize);
+		mCompressedStream->write(header, CHUNKED_HEADER_SIZE);
+
+		// Offsets are only known once compressed, so reserve the index now
+		// and fill it in at the end
+		vector<uchar>::type index((numChunks + 1) * sizeof(uint64), 0);
+		mCompressedStream->write(&index[0], index.size());
+		uint64 offset = CHUNKED_HEADER_SIZE + index.size();
+
+		vector<uchar>::type in(std::min(numChunks, CHUNKED_WRITE_BATCH) * mChunkSize);
+		for (size_t chunk = 0; chunk < numChunks; chunk += CHUNKED_WRITE_BATCH)
+		{
+			size_t batchChunks = std::min(CHUNKED_WRITE_BATCH, numChunks - chunk);
+			size_t batchSize = std::min(batchChunks * mChunkSize, totalSize - chunk * mChunkSize);
+			inFile.read(reinterpret_cast<char*>(&in[0]), batchSize);
+			if (static_cast<size_t>(inFile.gcount()) != batchSize)
+			{
+				OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+							"Error reading temp uncompressed stream!",
+							"DeflateStream::compressFinalChunked");
+			}
+
+			DeflateChunks::DeflateTask task(&in[0], batchSize, mChunkSize, Z_DEFAULT_COMPRESSION);
+			ParallelTasks::run(task, task.getChunkCount());
+
+			for (size_t c = 0; c < batchChunks; ++c)
+			{
+				writeLE64(&index[(chunk + c) * sizeof(uint64)], offset);
+				mCompressedStream->write(task.getChunk(c), task.sizes[c]);
+				offset += task.sizes[c];
+			}
+		}
+		writeLE64(&index[numChunks * sizeof(uint64)], offset);
+
+		size_t end = mCompressedStream->tell();
+		mCompressedStream->seek(start + CHUNKED_HEADER_SIZE);
+		mCompressedStream->write(&index[0], index.size());
+		mCompressedStream->seek(end);
+
+		inFile.close();
+		remove(mTempFileName.c_str());
+	}
     //---------------------------------------------------------------------
 	void DeflateStream::skip(long count)
 	{
@@ -298,6 +539,14 @@ namespace Ogre
 		{
 			mTmpWriteStream->skip(count);
 		}
+		else if (mChunkSize)
+		{
+			// Any position can be reached, clamp to the data
+			if (count < 0 && static_cast<size_t>(-count) > mCurrentPos)
+				count = -static_cast<long>(mCurrentPos);
+			else if (count > 0 && static_cast<size_t>(count) > mSize - mCurrentPos)
+				count = static_cast<long>(mSize - mCurrentPos);
+		}
 		else 
 		{
 			if (count > 0)
@@ -335,13 +584,17 @@ namespace Ogre
 		{
 			mTmpWriteStream->seek(pos);
 		}
+		else if (mChunkSize)
+		{
+			mCurrentPos = std::min(pos, mSize);
+		}
 		else
 		{
 			if (pos == 0)
 			{
 				mCurrentPos = 0;
 				mpZStream->next_in = mpTmp;
-				mCompressedStream->seek(0);
+				mCompressedStream->seek(mCompressedStart);
 				mpZStream->avail_in = mCompressedStream->read(mpTmp, OGRE_DEFLATE_TMP_SIZE);			
 				inflateReset(mpZStream);
 			}
@@ -377,6 +630,8 @@ namespace Ogre
 		{
 			if (!mIsCompressedValid)
 				return mCompressedStream->eof();
+			else if (mChunkSize)
+				return mCurrentPos >= mSize;
 			else
 				return mCompressedStream->eof() && mpZStream->avail_in == 0;
 		}
@@ -384,9 +639,11 @@ namespace Ogre
     //---------------------------------------------------------------------
 	void DeflateStream::close(void)
 	{
-		if (getAccessMode() & WRITE)
+		// Only compress once, close is called again on destruction
+		if ((getAccessMode() & WRITE) && !mTempFileName.empty())
 		{
 			compressFinal();
+			mTempFileName.clear();
 		}
 		
 		// don't close underlying compressed stream in case used for something else
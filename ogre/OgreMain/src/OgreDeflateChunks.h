@@ -0,0 +1,149 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __DeflateChunks_H__
+#define __DeflateChunks_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreException.h"
+#include "OgreParallelTasks.h"
+#include "OgreStringConverter.h"
+
+#include <zlib.h>
+
+// Shared by DeflateStream's chunked format and PackArchive, do not include
+// anywhere else. Data is split in fixed size chunks compressed independently,
+// so any chunk can be decompressed alone and several at once. Chunks which
+// don't compress are stored as they are, so are recognised by their size.
+namespace Ogre {
+namespace DeflateChunks {
+
+	/** Decompresses consecutive chunks, one per task.
+	@remarks
+		Offset is the type of the chunk offsets, which are relative to any
+		base; src points at the data of the first chunk.
+	*/
+	template <typename Offset>
+	class InflateTask : public ParallelTasks::Task
+	{
+	protected:
+		const uchar* mSrc;
+		const Offset* mOffsets;
+		uchar* mDest;
+		size_t mChunkSize;
+		size_t mRawSize;
+		const String& mName;
+		const char* mSource;
+	public:
+		/** Constructor.
+		@param src Data of the first chunk
+		@param offsets Offset of each chunk, plus the end of the last one
+		@param dest Destination of the first chunk, the others follow it
+		@param chunkSize Uncompressed size of a chunk
+		@param rawSize Uncompressed size from the first chunk to the end of
+			the data, which may end with a short chunk
+		@param name Name of the data, for errors
+		@param source Function reported in errors
+		*/
+		InflateTask(const uchar* src, const Offset* offsets, uchar* dest, size_t chunkSize,
+			size_t rawSize, const String& name, const char* source)
+			: mSrc(src), mOffsets(offsets), mDest(dest), mChunkSize(chunkSize), 
+			mRawSize(rawSize), mName(name), mSource(source) {}
+
+		void run(size_t index)
+		{
+			const uchar* src = mSrc + (mOffsets[index] - mOffsets[0]);
+			size_t srcSize = static_cast<size_t>(mOffsets[index + 1] - mOffsets[index]);
+			size_t rawSize = std::min(mChunkSize, mRawSize - index * mChunkSize);
+			uchar* dest = mDest + index * mChunkSize;
+
+			if (srcSize == rawSize)
+			{
+				// Chunk didn't compress, it was stored as is
+				memcpy(dest, src, rawSize);
+				return;
+			}
+			uLongf destSize = static_cast<uLongf>(rawSize);
+			if (uncompress(dest, &destSize, src, static_cast<uLong>(srcSize)) != Z_OK ||
+				destSize != rawSize)
+			{
+				OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+					mName + " - error decompressing chunk " + StringConverter::toString(index),
+					mSource);
+			}
+		}
+	};
+
+	/** Compresses consecutive chunks into fixed size slots, one per task. */
+	class DeflateTask : public ParallelTasks::Task
+	{
+	protected:
+		const uchar* mSrc;
+		size_t mSize;
+		size_t mChunkSize;
+		size_t mSlotSize;
+		int mLevel;
+		vector<uchar>::type mDest;
+	public:
+		/// Compressed size of each chunk, equal to its size if stored as is
+		vector<size_t>::type sizes;
+
+		DeflateTask(const uchar* src, size_t size, size_t chunkSize, int level)
+			: mSrc(src), mSize(size), mChunkSize(chunkSize),
+			mSlotSize(compressBound(static_cast<uLong>(chunkSize))), mLevel(level),
+			sizes((size + chunkSize - 1) / chunkSize)
+		{
+			mDest.resize(mSlotSize * sizes.size());
+		}
+
+		/// Number of chunks, which is the number of tasks to run
+		size_t getChunkCount() const { return sizes.size(); }
+
+		/// Data of a chunk, sizes[index] bytes long
+		const uchar* getChunk(size_t index) const { return &mDest[index * mSlotSize]; }
+
+		void run(size_t index)
+		{
+			const uchar* src = mSrc + index * mChunkSize;
+			size_t rawSize = std::min(mChunkSize, mSize - index * mChunkSize);
+			uchar* dest = &mDest[index * mSlotSize];
+			uLongf destSize = static_cast<uLongf>(mSlotSize);
+			if (compress2(dest, &destSize, src, static_cast<uLong>(rawSize), mLevel) != Z_OK ||
+				destSize >= rawSize)
+			{
+				// Store chunks which don't compress as they are
+				memcpy(dest, src, rawSize);
+				destSize = static_cast<uLongf>(rawSize);
+			}
+			sizes[index] = destSize;
+		}
+	};
+
+}
+}
+
+#endif
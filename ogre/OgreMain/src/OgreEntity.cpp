@@ -53,6 +53,7 @@ THE SOFTWARE.
 #include "OgreLodStrategy.h"
 #include "OgreLodListener.h"
 #include "OgreMaterialManager.h"
+#include "OgreSkeletonAnimationCache.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -75,6 +76,7 @@ namespace Ogre {
 		  mSoftwareAnimationNormalsRequests(0),
           mSkipAnimStateUpdates(false),
 		  mAlwaysUpdateMainSkeleton(false),
+		  mSkeletonAnimationCache(0),
 		  mMeshLodIndex(0),
 		  mMeshLodFactorTransformed(1.0f),
 		  mMinMeshLodIndex(99),
@@ -112,6 +114,7 @@ namespace Ogre {
 		mSoftwareAnimationNormalsRequests(0),
         mSkipAnimStateUpdates(false),
 		mAlwaysUpdateMainSkeleton(false),
+		mSkeletonAnimationCache(0),
 		mMeshLodIndex(0),
 		mMeshLodFactorTransformed(1.0f),
 		mMinMeshLodIndex(99),
@@ -551,6 +554,12 @@ namespace Ogre {
 		if (!mInitialised)
 			return;
 
+		// Stamp the mesh and skeleton as used this frame for their managers'
+		// memory budgets
+		mMesh->touch();
+		if (hasSkeleton())
+			mMesh->getSkeleton()->touch();
+
 		// Check mesh state count, will be incremented if reloaded
 		if (mMesh->getStateCount() != mMeshStateCount)
 		{
@@ -1321,12 +1330,35 @@ namespace Ogre {
         if ((*mFrameBonesLastUpdated != currentFrameNumber) ||
 			(hasSkeleton() && getSkeleton()->getManualBonesDirty()))
 		{
+			bool useCache = useSkeletonAnimationCache() &&
+				(*mFrameBonesLastUpdated != currentFrameNumber);
+			if (useCache &&
+				mSkeletonAnimationCache->_fetchBoneMatrices(mSkeletonInstance, *mAnimationState, mBoneMatrices))
+			{
+				// Another entity already calculated this pose
+				*mFrameBonesLastUpdated  = currentFrameNumber;
+				return;
+			}
+
 			if ((!mSkipAnimStateUpdates) && (*mFrameBonesLastUpdated != currentFrameNumber))
 	            mSkeletonInstance->setAnimationState(*mAnimationState);
             mSkeletonInstance->_getBoneMatrices(mBoneMatrices);
             *mFrameBonesLastUpdated  = currentFrameNumber;
+
+			if (useCache)
+				mSkeletonAnimationCache->_storeBoneMatrices(mSkeletonInstance, *mAnimationState, mBoneMatrices);
         }
     }
+	//-----------------------------------------------------------------------
+	bool Entity::useSkeletonAnimationCache(void) const
+	{
+		// The cache only provides matrices, so anything which relies on the
+		// bones of the skeleton instance being posed has to bypass it
+		return mSkeletonAnimationCache && !mSkipAnimStateUpdates &&
+			!mDisplaySkeleton && mChildObjectList.empty() &&
+			!mSkeletonInstance->hasManualBones() &&
+			SkeletonAnimationCache::isCacheable(*mAnimationState);
+	}
     //-----------------------------------------------------------------------
     void Entity::setDisplaySkeleton(bool display)
     {
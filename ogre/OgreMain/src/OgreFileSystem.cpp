@@ -40,6 +40,7 @@ THE SOFTWARE.
 	OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_TEGRA2
 #   include "OgreSearchOps.h"
 #   include <sys/param.h>
+#   include <unistd.h>
 #   define MAX_PATH MAXPATHLEN
 #endif
 
@@ -56,6 +57,7 @@ THE SOFTWARE.
 namespace Ogre {
 
 	bool FileSystemArchive::ms_IgnoreHidden = true;
+	bool FileSystemArchive::ms_UseMemoryMapping = false;
 
     //-----------------------------------------------------------------------
     FileSystemArchive::FileSystemArchive(const String& name, const String& archType )
@@ -190,6 +192,7 @@ namespace Ogre {
     void FileSystemArchive::load()
     {
 		OGRE_LOCK_AUTO_MUTEX
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
         // test to see if this folder is writeable
 		String testPath = concatenate_path(mName, "__testwrite.ogre");
 		std::ofstream writeStream;
@@ -202,6 +205,11 @@ namespace Ogre {
 			writeStream.close();
 			::remove(testPath.c_str());
 		}
+#else
+		// Ask rather than writing a test file, which would change the folder's
+		// modification time and so invalidate any cached listing of it
+		mReadOnly = access(mName.c_str(), W_OK) != 0;
+#endif
     }
     //-----------------------------------------------------------------------
     void FileSystemArchive::unload()
@@ -220,6 +228,12 @@ namespace Ogre {
 		assert(ret == 0 && "Problem getting file size" );
         (void)ret;  // Silence warning
 
+		if (ms_UseMemoryMapping && (readOnly || !isReadOnly()) && tagStat.st_size > 0)
+		{
+			// Hand out the file contents in place
+			return DataStreamPtr(OGRE_NEW MappedFileDataStream(filename, full_path));
+		}
+
 		// Always open in binary mode
 		// Also, always include reading
 		std::ios::openmode mode = std::ios::in | std::ios::binary;
@@ -40,6 +40,8 @@ THE SOFTWARE
 #include "OgrePass.h"
 #include "OgreMaterial.h"
 #include "OgreBitwise.h"
+#include "OgreFontManager.h"
+#include "OgreGlyphAtlas.h"
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
@@ -48,6 +50,22 @@ THE SOFTWARE
 
 namespace Ogre
 {
+	/// FreeType state of a font which renders glyphs on demand
+	struct Font::GlyphRenderer
+	{
+		FT_Library library;
+		FT_Face face;
+		/// The ttf file, which FreeType reads from while the face is open
+		MemoryDataStreamPtr data;
+		/// Distance from the top of a glyph's cell to the baseline, in pixels
+		int ascender;
+		/// Height of a glyph's cell, in pixels
+		size_t lineHeight;
+		/// Code points the face could not render
+		set<CodePoint>::type missing;
+		/// Buffer the glyph cells are drawn in
+		vector<uchar>::type cell;
+	};
     //---------------------------------------------------------------------
 	Font::CmdType Font::msTypeCmd;
 	Font::CmdSource Font::msSourceCmd;
@@ -59,7 +77,8 @@ namespace Ogre
 	Font::Font(ResourceManager* creator, const String& name, ResourceHandle handle,
 		const String& group, bool isManual, ManualResourceLoader* loader)
 		:Resource (creator, name, handle, group, isManual, loader),
-		mType(FT_TRUETYPE), mTtfSize(0), mTtfResolution(0), mTtfMaxBearingY(0), mAntialiasColour(false)
+		mType(FT_TRUETYPE), mTtfSize(0), mTtfResolution(0), mTtfMaxBearingY(0), mAntialiasColour(false),
+		mGlyphAtlas(0), mGlyphRenderer(0)
     {
 
 		if (createParamDictionary("Font"))
@@ -138,14 +157,78 @@ namespace Ogre
 	//---------------------------------------------------------------------
 	const Font::GlyphInfo& Font::getGlyphInfo(CodePoint id) const
 	{
-		CodePointMap::const_iterator i = mCodePointMap.find(id);
-		if (i == mCodePointMap.end())
+		const GlyphInfo* glyph = findGlyph(id);
+		if (!glyph)
 		{
 			OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
 				"Code point " + StringConverter::toString(id) + " not found in font "
 				+ mName, "Font::getGlyphInfo");
 		}
-		return i->second;
+		return *glyph;
+	}
+	//---------------------------------------------------------------------
+	uint32 Font::getGlyphGeneration(void) const
+	{
+		return mGlyphAtlas ? mGlyphAtlas->getGeneration() : 0;
+	}
+	//---------------------------------------------------------------------
+	const Font::GlyphInfo* Font::getAtlasGlyph(CodePoint id) const
+	{
+		const GlyphInfo* glyph = mGlyphAtlas->findGlyph(this, id);
+		if (glyph || !mGlyphRenderer || mGlyphRenderer->missing.find(id) != mGlyphRenderer->missing.end())
+			return glyph;
+
+		FT_Face face = mGlyphRenderer->face;
+		if (FT_Load_Char(face, id, FT_LOAD_RENDER) || 
+			(!face->glyph->bitmap.buffer && face->glyph->bitmap.rows && face->glyph->bitmap.width))
+		{
+			LogManager::getSingleton().logMessage("Info: cannot load character " +
+				StringConverter::toString(id) + " in font " + mName);
+			mGlyphRenderer->missing.insert(id);
+			return 0;
+		}
+
+		// The cell is laid out as createTextureFromFont does: as wide as the
+		// advance, with the baseline at the same height for every glyph
+		const FT_Bitmap& bitmap = face->glyph->bitmap;
+		int width = std::max(static_cast<int>(face->glyph->advance.x >> 6), 1);
+		int height = static_cast<int>(mGlyphRenderer->lineHeight);
+		int y_bearing = mGlyphRenderer->ascender - static_cast<int>(face->glyph->metrics.horiBearingY >> 6);
+		int x_bearing = static_cast<int>(face->glyph->metrics.horiBearingX >> 6);
+
+		vector<uchar>::type& cell = mGlyphRenderer->cell;
+		cell.resize(width * height * 2);
+		for (size_t i = 0; i < cell.size(); i += 2)
+		{
+			cell[i + 0] = 0xFF; // luminance
+			cell[i + 1] = 0x00; // alpha
+		}
+		for (int j = 0; j < static_cast<int>(bitmap.rows); ++j)
+		{
+			int row = j + y_bearing;
+			if (row < 0 || row >= height)
+				continue;
+			const uchar* buffer = bitmap.buffer + j * bitmap.pitch;
+			for (int k = 0; k < static_cast<int>(bitmap.width); ++k)
+			{
+				int column = k + x_bearing;
+				if (column < 0 || column >= width)
+					continue;
+				uchar* pDest = &cell[(row * width + column) * 2];
+				// Same rules as createTextureFromFont for the colour
+				pDest[0] = mAntialiasColour ? buffer[k] : 0xFF;
+				pDest[1] = buffer[k];
+			}
+		}
+
+		glyph = mGlyphAtlas->addGlyph(this, id, PixelBox(width, height, 1, PF_BYTE_LA, &cell[0]));
+		if (!glyph)
+		{
+			LogManager::getSingleton().logMessage("Info: character " + StringConverter::toString(id) + 
+				" in font " + mName + " is too big for glyph atlas " + mGlyphAtlas->getName());
+			mGlyphRenderer->missing.insert(id);
+		}
+		return glyph;
 	}
     //---------------------------------------------------------------------
     void Font::loadImpl()
@@ -162,7 +245,14 @@ namespace Ogre
 
         TextureUnitState *texLayer;
         bool blendByAlpha = true;
-        if (mType == FT_TRUETYPE)
+        if (mType == FT_TRUETYPE && !mGlyphAtlasName.empty())
+        {
+            createGlyphRenderer();
+            texLayer = mpMaterial->getTechnique(0)->getPass(0)->createTextureUnitState(
+                mGlyphAtlas->getTexture()->getName());
+            blendByAlpha = true;
+        }
+        else if (mType == FT_TRUETYPE)
         {
             createTextureFromFont();
             texLayer = mpMaterial->getTechnique(0)->getPass(0)->getTextureUnitState(0);
@@ -210,6 +300,59 @@ namespace Ogre
 			TextureManager::getSingleton().remove(mTexture->getHandle());
 			mTexture.setNull();
 		}
+
+		if (mGlyphAtlas)
+		{
+			mGlyphAtlas->removeGlyphs(this);
+			mGlyphAtlas = 0;
+		}
+
+		if (mGlyphRenderer)
+		{
+			FT_Done_Face(mGlyphRenderer->face);
+			FT_Done_FreeType(mGlyphRenderer->library);
+			OGRE_DELETE_T(mGlyphRenderer, GlyphRenderer, MEMCATEGORY_RESOURCE);
+			mGlyphRenderer = 0;
+		}
+    }
+    //---------------------------------------------------------------------
+    void Font::createGlyphRenderer(void)
+    {
+		FontManager& fontMgr = FontManager::getSingleton();
+		mGlyphAtlas = fontMgr.getGlyphAtlas(mGlyphAtlasName);
+		if (!mGlyphAtlas)
+			mGlyphAtlas = fontMgr.createGlyphAtlas(mGlyphAtlasName);
+
+		GlyphRenderer* renderer = OGRE_NEW_T(GlyphRenderer, MEMCATEGORY_RESOURCE)();
+		if (FT_Init_FreeType(&renderer->library))
+		{
+			OGRE_DELETE_T(renderer, GlyphRenderer, MEMCATEGORY_RESOURCE);
+			OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "Could not init FreeType library!",
+				"Font::createGlyphRenderer");
+		}
+
+		// The face reads from the ttf as glyphs are rendered, so it is kept in memory
+		DataStreamPtr dataStreamPtr =
+			ResourceGroupManager::getSingleton().openResource(mSource, mGroup, true, this);
+		renderer->data.bind(OGRE_NEW MemoryDataStream(dataStreamPtr));
+
+		FT_F26Dot6 ftSize = (FT_F26Dot6)(mTtfSize * (1 << 6));
+		if (FT_New_Memory_Face(renderer->library, renderer->data->getPtr(), 
+				(FT_Long)renderer->data->size(), 0, &renderer->face) ||
+			FT_Set_Char_Size(renderer->face, ftSize, 0, mTtfResolution, mTtfResolution))
+		{
+			FT_Done_FreeType(renderer->library);
+			OGRE_DELETE_T(renderer, GlyphRenderer, MEMCATEGORY_RESOURCE);
+			OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+				"Could not open font face!", "Font::createGlyphRenderer");
+		}
+
+		// Glyphs are not known up front, so the cells are sized from the face metrics
+		const FT_Size_Metrics& metrics = renderer->face->size->metrics;
+		mTtfMaxBearingY = static_cast<int>(metrics.ascender);
+		renderer->ascender = static_cast<int>(metrics.ascender >> 6);
+		renderer->lineHeight = std::max(static_cast<int>((metrics.ascender - metrics.descender) >> 6), 1);
+		mGlyphRenderer = renderer;
     }
     //---------------------------------------------------------------------
     void Font::createTextureFromFont(void)
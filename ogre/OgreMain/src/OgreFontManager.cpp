@@ -31,6 +31,7 @@ THE SOFTWARE
 #include "OgreStringVector.h"
 #include "OgreException.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreGlyphAtlas.h"
 
 namespace Ogre
 {
@@ -70,6 +71,41 @@ namespace Ogre
 		// Unegister scripting with resource group manager
 		ResourceGroupManager::getSingleton()._unregisterScriptLoader(this);
 
+		// Fonts let go of their atlases when unloaded
+		removeAll();
+		for (GlyphAtlasMap::iterator i = mGlyphAtlases.begin(); i != mGlyphAtlases.end(); ++i)
+			OGRE_DELETE i->second;
+		mGlyphAtlases.clear();
+	}
+	//---------------------------------------------------------------------
+	GlyphAtlas* FontManager::createGlyphAtlas(const String& name, size_t width, size_t pageHeight,
+		size_t numPages, const String& group)
+	{
+		if (mGlyphAtlases.find(name) != mGlyphAtlases.end())
+		{
+			OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, 
+				"A glyph atlas with the name " + name + " already exists.",
+				"FontManager::createGlyphAtlas");
+		}
+		GlyphAtlas* atlas = OGRE_NEW GlyphAtlas(name, group, width, pageHeight, numPages);
+		mGlyphAtlases[name] = atlas;
+		return atlas;
+	}
+	//---------------------------------------------------------------------
+	GlyphAtlas* FontManager::getGlyphAtlas(const String& name) const
+	{
+		GlyphAtlasMap::const_iterator i = mGlyphAtlases.find(name);
+		return i != mGlyphAtlases.end() ? i->second : 0;
+	}
+	//---------------------------------------------------------------------
+	void FontManager::destroyGlyphAtlas(const String& name)
+	{
+		GlyphAtlasMap::iterator i = mGlyphAtlases.find(name);
+		if (i != mGlyphAtlases.end())
+		{
+			OGRE_DELETE i->second;
+			mGlyphAtlases.erase(i);
+		}
 	}
 	//---------------------------------------------------------------------
 	Resource* FontManager::createImpl(const String& name, ResourceHandle handle, 
@@ -215,6 +251,17 @@ namespace Ogre
             pFont->setTrueTypeResolution(
                 (uint)StringConverter::parseReal(params[1]) );
         }
+        else if (attrib == "glyph_atlas")
+        {
+            // Check params
+            if (params.size() != 2)
+            {
+                logBadAttrib(line, pFont);
+                return;
+            }
+            // Set
+            pFont->setGlyphAtlas(params[1]);
+        }
         else if (attrib == "antialias_colour")
         {
         	// Check params
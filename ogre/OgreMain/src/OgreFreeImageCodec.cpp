@@ -419,20 +419,34 @@ namespace Ogre {
 
 
     }
-    //---------------------------------------------------------------------
-    Codec::DecodeResult FreeImageCodec::decode(DataStreamPtr& input) const
-    {
-		// Set error handler
-		FreeImage_SetOutputMessage(FreeImageLoadErrorHandler);
-
-		// Buffer stream into memory (TODO: override IO functions instead?)
-		MemoryDataStream memStream(input, true);
+	//---------------------------------------------------------------------
+	FIBITMAP* FreeImageCodec::load(DataStreamPtr& input, ImageData* imgData, bool expandPalette) const
+	{
+		// Use the data in place if the stream holds it in memory, otherwise
+		// buffer stream into memory (TODO: override IO functions instead?)
+		MemoryDataStreamPtr memStream;
+		BYTE* pData;
+		size_t dataSize;
+		if (input->getDataPtr())
+		{
+			pData = const_cast<BYTE*>(input->getDataPtr() + input->tell());
+			dataSize = input->size() - input->tell();
+			input->seek(input->size());
+		}
+		else
+		{
+			memStream.bind(OGRE_NEW MemoryDataStream(input, true));
+			pData = memStream->getPtr();
+			dataSize = memStream->size();
+		}
 
 		FIMEMORY* fiMem = 
-			FreeImage_OpenMemory(memStream.getPtr(), static_cast<DWORD>(memStream.size()));
+			FreeImage_OpenMemory(pData, static_cast<DWORD>(dataSize));
 
 		FIBITMAP* fiBitmap = FreeImage_LoadFromMemory(
 			(FREE_IMAGE_FORMAT)mFreeImageType, fiMem);
+		// The bitmap holds its own copy of the pixels
+		FreeImage_CloseMemory(fiMem);
 		if (!fiBitmap)
 		{
 			OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
@@ -440,10 +454,6 @@ namespace Ogre {
 				"FreeImageCodec::decode");
 		}
 
-
-		ImageData* imgData = OGRE_NEW ImageData();
-		MemoryDataStreamPtr output;
-
 		imgData->depth = 1; // only 2D formats handled by this codec
 		imgData->width = FreeImage_GetWidth(fiBitmap);
 		imgData->height = FreeImage_GetHeight(fiBitmap);
@@ -464,6 +474,7 @@ namespace Ogre {
 		case FIT_INT32:
 		case FIT_DOUBLE:
         default:
+			FreeImage_Unload(fiBitmap);
 			OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
 				"Unknown or unsupported image format", 
 				"FreeImageCodec::decode");
@@ -471,8 +482,10 @@ namespace Ogre {
 			break;
 		case FIT_BITMAP:
 			// Standard image type
-			// Perform any colour conversions for greyscale
-			if (colourType == FIC_MINISWHITE || colourType == FIC_MINISBLACK)
+			// Perform any colour conversions for greyscale; 8 bit black to white
+			// is greyscale already
+			if (colourType == FIC_MINISWHITE || 
+				(colourType == FIC_MINISBLACK && bpp != 8))
 			{
 				FIBITMAP* newBitmap = FreeImage_ConvertToGreyscale(fiBitmap);
 				// free old bitmap and replace
@@ -482,6 +495,11 @@ namespace Ogre {
 				bpp = FreeImage_GetBPP(fiBitmap);
 				colourType = FreeImage_GetColorType(fiBitmap);
 			}
+			else if (!expandPalette && bpp == 8 && colourType == FIC_PALETTE)
+			{
+				// Left for the caller to expand, describe the image it expands to
+				bpp = FreeImage_IsTransparent(fiBitmap) ? 32 : 24;
+			}
 			// Perform any colour conversions for RGB
 			else if (bpp < 8 || colourType == FIC_PALETTE || colourType == FIC_CMYK)
 			{
@@ -571,14 +589,26 @@ namespace Ogre {
 			
 		};
 
+		imgData->size = PixelUtil::getMemorySize(imgData->width, imgData->height, 1, imgData->format);
+		return fiBitmap;
+	}
+    //---------------------------------------------------------------------
+    Codec::DecodeResult FreeImageCodec::decode(DataStreamPtr& input) const
+    {
+		// Set error handler
+		FreeImage_SetOutputMessage(FreeImageLoadErrorHandler);
+
+		ImageData* imgData = OGRE_NEW ImageData();
+		CodecDataPtr codecData(imgData);
+		FIBITMAP* fiBitmap = load(input, imgData, true);
+
 		unsigned char* srcData = FreeImage_GetBits(fiBitmap);
 		unsigned srcPitch = FreeImage_GetPitch(fiBitmap);
 
 		// Final data - invert image and trim pitch at the same time
 		size_t dstPitch = imgData->width * PixelUtil::getNumElemBytes(imgData->format);
-		imgData->size = dstPitch * imgData->height;
         // Bind output buffer
-        output.bind(OGRE_NEW MemoryDataStream(imgData->size));
+        MemoryDataStreamPtr output(OGRE_NEW MemoryDataStream(imgData->size));
 
 		uchar* pSrc;
 		uchar* pDst = output->getPtr();
@@ -589,17 +619,87 @@ namespace Ogre {
 			pDst += dstPitch;
 		}
 
-		
 		FreeImage_Unload(fiBitmap);
-		FreeImage_CloseMemory(fiMem);
-
 
         DecodeResult ret;
         ret.first = output;
-        ret.second = CodecDataPtr(imgData);
+        ret.second = codecData;
 		return ret;
 
     }
+	//---------------------------------------------------------------------
+	Codec::CodecDataPtr FreeImageCodec::decodeInto(DataStreamPtr& input, DecodeTarget& target) const
+	{
+		// Set error handler
+		FreeImage_SetOutputMessage(FreeImageLoadErrorHandler);
+
+		ImageData* imgData = OGRE_NEW ImageData();
+		CodecDataPtr codecData(imgData);
+		FIBITMAP* fiBitmap = load(input, imgData, false);
+
+		try
+		{
+			PixelBox dest = target.getDestination(*imgData);
+			if (dest.getWidth() != imgData->width || dest.getHeight() != imgData->height ||
+				dest.getDepth() != 1 || !PixelUtil::isAccessible(dest.format))
+			{
+				OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+					"Destination does not match the size of the image or is not accessible",
+					"FreeImageCodec::decodeInto");
+			}
+
+			const uchar* srcData = FreeImage_GetBits(fiBitmap);
+			unsigned srcPitch = FreeImage_GetPitch(fiBitmap);
+			size_t dstPixelSize = PixelUtil::getNumElemBytes(dest.format);
+			uchar* dstData = static_cast<uchar*>(dest.data) +
+				(dest.left + dest.top * dest.rowPitch + dest.front * dest.slicePitch) * dstPixelSize;
+
+			// Write the rows bottom up, converting as we go
+			if (FreeImage_GetColorType(fiBitmap) == FIC_PALETTE)
+			{
+				// Pack the palette in the destination format, then look up each pixel
+				const RGBQUAD* palette = FreeImage_GetPalette(fiBitmap);
+				unsigned numColours = std::min(FreeImage_GetColorsUsed(fiBitmap), 256u);
+				bool transparent = FreeImage_IsTransparent(fiBitmap) != 0;
+				const BYTE* alphas = FreeImage_GetTransparencyTable(fiBitmap);
+				unsigned numAlphas = FreeImage_GetTransparencyCount(fiBitmap);
+				vector<uchar>::type packed(256 * dstPixelSize, 0);
+				for (unsigned i = 0; i < numColours; ++i)
+				{
+					uint8 alpha = (transparent && i < numAlphas) ? alphas[i] : 255;
+					PixelUtil::packColour(palette[i].rgbRed, palette[i].rgbGreen, palette[i].rgbBlue,
+						alpha, dest.format, &packed[i * dstPixelSize]);
+				}
+
+				for (size_t y = 0; y < imgData->height; ++y)
+				{
+					const BYTE* pSrc = srcData + (imgData->height - y - 1) * srcPitch;
+					uchar* pDst = dstData + y * dest.rowPitch * dstPixelSize;
+					for (size_t x = 0; x < imgData->width; ++x, pDst += dstPixelSize)
+						memcpy(pDst, &packed[pSrc[x] * dstPixelSize], dstPixelSize);
+				}
+			}
+			else
+			{
+				for (size_t y = 0; y < imgData->height; ++y)
+				{
+					PixelBox srcRow(imgData->width, 1, 1, imgData->format, 
+						const_cast<uchar*>(srcData) + (imgData->height - y - 1) * srcPitch);
+					PixelBox dstRow(imgData->width, 1, 1, dest.format, 
+						dstData + y * dest.rowPitch * dstPixelSize);
+					PixelUtil::bulkPixelConversion(srcRow, dstRow);
+				}
+			}
+		}
+		catch (...)
+		{
+			FreeImage_Unload(fiBitmap);
+			throw;
+		}
+
+		FreeImage_Unload(fiBitmap);
+		return codecData;
+	}
     //---------------------------------------------------------------------    
     String FreeImageCodec::getType() const 
     {
@@ -0,0 +1,268 @@
+/*-------------------------------------------------------------------------
+This source file is a part of OGRE
+(Object-oriented Graphics Rendering Engine)
+
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+-------------------------------------------------------------------------*/
+#include "OgreStableHeaders.h"
+#include "OgreGlyphAtlas.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreRoot.h"
+#include "OgreException.h"
+
+namespace Ogre
+{
+	namespace
+	{
+		/// Transparent gap to the right of and below each glyph, so filtering doesn't pick up its neighbours
+		const size_t GLYPH_PADDING = 2;
+	}
+    //---------------------------------------------------------------------
+	GlyphAtlas::GlyphAtlas(const String& name, const String& group, size_t width, 
+		size_t pageHeight, size_t numPages)
+		: mName(name), mGroup(group), mPageHeight(pageHeight), mPages(numPages),
+		mGeneration(0), mEvictionCount(0), mUseCount(0)
+	{
+		if (width == 0 || pageHeight == 0 || numPages == 0)
+		{
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+				"Glyph atlas " + name + " must have at least one page of non-zero size",
+				"GlyphAtlas::GlyphAtlas");
+		}
+
+		size_t height = pageHeight * numPages;
+		size_t size = PixelUtil::getMemorySize(width, height, 1, PF_BYTE_LA);
+		mImage.loadDynamicImage(OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL), 
+			width, height, 1, PF_BYTE_LA, true);
+		for (size_t i = 0; i < numPages; ++i)
+			clearPage(i);
+		// Nothing has been handed out yet
+		mGeneration = 0;
+	}
+    //---------------------------------------------------------------------
+	GlyphAtlas::~GlyphAtlas()
+	{
+		if (!mTexture.isNull() && TextureManager::getSingletonPtr())
+			TextureManager::getSingleton().remove(mTexture->getHandle());
+	}
+    //---------------------------------------------------------------------
+	const Font::GlyphInfo* GlyphAtlas::findGlyph(const Font* font, Font::CodePoint id)
+	{
+		GlyphMap::iterator i = mGlyphs.find(GlyphKey(font, id));
+		if (i == mGlyphs.end())
+			return 0;
+		touchPage(i->second.page);
+		return &i->second.info;
+	}
+    //---------------------------------------------------------------------
+	const Font::GlyphInfo* GlyphAtlas::addGlyph(const Font* font, Font::CodePoint id, const PixelBox& cell)
+	{
+		size_t width = cell.getWidth() + GLYPH_PADDING;
+		size_t height = cell.getHeight() + GLYPH_PADDING;
+		if (width > getWidth() || height > mPageHeight)
+			return 0;
+
+		GlyphKey key(font, id);
+		mGlyphs.erase(key);
+
+		size_t page, x, y;
+		bool placed = false;
+		for (page = 0; page < mPages.size(); ++page)
+		{
+			if (allocate(mPages[page], width, height, x, y))
+			{
+				placed = true;
+				break;
+			}
+		}
+
+		if (!placed)
+		{
+			// Clear the least recently used page, sparing those used this frame if possible
+			unsigned long frame = getCurrentFrame();
+			size_t oldest = mPages.size(), oldestUsedThisFrame = mPages.size();
+			for (size_t i = 0; i < mPages.size(); ++i)
+			{
+				size_t& candidate = mPages[i].lastUsedFrame == frame ? oldestUsedThisFrame : oldest;
+				if (candidate == mPages.size() || mPages[i].lastUsed < mPages[candidate].lastUsed)
+					candidate = i;
+			}
+			page = oldest != mPages.size() ? oldest : oldestUsedThisFrame;
+			clearPage(page);
+			++mEvictionCount;
+			allocate(mPages[page], width, height, x, y);
+		}
+		touchPage(page);
+
+		// Write the cell; the padding is still clear from when the page was cleared
+		size_t top = page * mPageHeight + y;
+		PixelUtil::bulkPixelConversion(cell, mImage.getPixelBox().getSubVolume(
+			Box(x, top, x + cell.getWidth(), top + cell.getHeight())));
+		upload(Box(x, top, x + width, top + height));
+
+		Real texWidth = static_cast<Real>(getWidth());
+		Real texHeight = static_cast<Real>(mImage.getHeight());
+		Glyph glyph = 
+		{
+			Font::GlyphInfo(id, Font::UVRect(x / texWidth, top / texHeight, 
+				(x + cell.getWidth()) / texWidth, (top + cell.getHeight()) / texHeight),
+				static_cast<Real>(cell.getWidth()) / cell.getHeight()),
+			page
+		};
+		return &mGlyphs.insert(GlyphMap::value_type(key, glyph)).first->second.info;
+	}
+    //---------------------------------------------------------------------
+	void GlyphAtlas::removeGlyphs(const Font* font)
+	{
+		GlyphMap::iterator i = mGlyphs.lower_bound(GlyphKey(font, 0));
+		while (i != mGlyphs.end() && i->first.first == font)
+			mGlyphs.erase(i++);
+	}
+    //---------------------------------------------------------------------
+	const TexturePtr& GlyphAtlas::getTexture(void)
+	{
+		if (mTexture.isNull())
+		{
+			// Create, setting isManual to true and passing self as loader
+			mTexture = TextureManager::getSingleton().create(mName, mGroup, true, this);
+			mTexture->setTextureType(TEX_TYPE_2D);
+			mTexture->setNumMipmaps(0);
+			mTexture->load();
+		}
+		return mTexture;
+	}
+    //---------------------------------------------------------------------
+	void GlyphAtlas::loadResource(Resource* resource)
+	{
+		// Call internal _loadImages, not loadImage since that's external and 
+		// will determine load status etc again, and this is a manual loader inside load()
+		ConstImagePtrList imagePtrs;
+		imagePtrs.push_back(&mImage);
+		static_cast<Texture*>(resource)->_loadImages(imagePtrs);
+	}
+    //---------------------------------------------------------------------
+	unsigned long GlyphAtlas::getCurrentFrame(void) const
+	{
+		return Root::getSingletonPtr() ? Root::getSingleton().getNextFrameNumber() : 0;
+	}
+    //---------------------------------------------------------------------
+	void GlyphAtlas::touchPage(size_t page)
+	{
+		mPages[page].lastUsedFrame = getCurrentFrame();
+		mPages[page].lastUsed = ++mUseCount;
+	}
+    //---------------------------------------------------------------------
+	bool GlyphAtlas::allocate(Page& page, size_t width, size_t height, size_t& x, size_t& y)
+	{
+		Skyline& skyline = page.skyline;
+		size_t best = skyline.size();
+		size_t bestY = mPageHeight;
+		for (size_t i = 0; i < skyline.size() && skyline[i].x + width <= getWidth(); ++i)
+		{
+			// The rectangle rests on the highest of the segments it spans
+			size_t top = 0;
+			for (size_t j = i; ; ++j)
+			{
+				top = std::max(top, skyline[j].y);
+				if (skyline[j].x + skyline[j].width >= skyline[i].x + width)
+					break;
+			}
+			if (top + height <= mPageHeight && top < bestY)
+			{
+				best = i;
+				bestY = top;
+			}
+		}
+		if (best == skyline.size())
+			return false;
+
+		x = skyline[best].x;
+		y = bestY;
+
+		// Raise the skyline over the rectangle
+		SkylineNode node = { x, y + height, width };
+		skyline.insert(skyline.begin() + best, node);
+		size_t right = x + width;
+		for (size_t i = best + 1; i < skyline.size() && skyline[i].x < right; )
+		{
+			size_t nodeRight = skyline[i].x + skyline[i].width;
+			if (nodeRight <= right)
+			{
+				skyline.erase(skyline.begin() + i);
+			}
+			else
+			{
+				skyline[i].x = right;
+				skyline[i].width = nodeRight - right;
+				break;
+			}
+		}
+		for (size_t i = 0; i + 1 < skyline.size(); )
+		{
+			if (skyline[i].y == skyline[i + 1].y)
+			{
+				skyline[i].width += skyline[i + 1].width;
+				skyline.erase(skyline.begin() + i + 1);
+			}
+			else
+			{
+				++i;
+			}
+		}
+		return true;
+	}
+    //---------------------------------------------------------------------
+	void GlyphAtlas::clearPage(size_t page)
+	{
+		Page& p = mPages[page];
+		p.skyline.clear();
+		SkylineNode node = { 0, 0, getWidth() };
+		p.skyline.push_back(node);
+		p.lastUsedFrame = 0;
+		p.lastUsed = 0;
+
+		GlyphMap::iterator i = mGlyphs.begin();
+		while (i != mGlyphs.end())
+		{
+			if (i->second.page == page)
+				mGlyphs.erase(i++);
+			else
+				++i;
+		}
+
+		// White, transparent
+		uchar* data = mImage.getData() + page * mPageHeight * getWidth() * 2;
+		for (size_t j = 0, size = mPageHeight * getWidth(); j < size; ++j)
+		{
+			*data++ = 0xFF;
+			*data++ = 0x00;
+		}
+		++mGeneration;
+	}
+    //---------------------------------------------------------------------
+	void GlyphAtlas::upload(const Box& box)
+	{
+		if (!mTexture.isNull() && mTexture->isLoaded())
+			mTexture->getBuffer()->blitFromMemory(mImage.getPixelBox().getSubVolume(box), box);
+	}
+}
@@ -31,13 +31,96 @@ THE SOFTWARE.
 #include "OgreException.h"
 #include "OgreImageCodec.h"
 #include "OgreColourValue.h"
+#include "OgreMath.h"
+#include "OgreParallelTasks.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_SSE
+// Keep this include last but for the resampler using it, see OgreOptimisedUtilSSE.cpp
+#include "OgreSIMDHelper.h"
+#endif
 
 #include "OgreImageResampler.h"
 
 namespace Ogre {
 	ImageCodec::~ImageCodec() {
 	}
+	//-----------------------------------------------------------------------------
+	Codec::CodecDataPtr ImageCodec::decodeHeader(DataStreamPtr& input) const
+	{
+		return CodecDataPtr();
+	}
+	//-----------------------------------------------------------------------------
+	Codec::DecodeResult ImageCodec::decodeMipmaps(DataStreamPtr& input,
+		size_t firstMip, size_t numMips) const
+	{
+		DecodeResult res = decode(input);
+		ImageData* full = static_cast<ImageData*>(res.second.getPointer());
+
+		size_t totalMips = full->num_mipmaps + 1;
+		if (firstMip >= totalMips)
+		{
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+				"Requested mipmap is not present in the image",
+				"ImageCodec::decodeMipmaps");
+		}
+		if (numMips == 0 || firstMip + numMips > totalMips)
+			numMips = totalMips - firstMip;
+		if (firstMip == 0 && numMips == totalMips)
+			return res;
+
+		size_t numFaces = (full->flags & IF_CUBEMAP) ? 6 : 1;
+		size_t width = std::max((size_t)1, full->width >> firstMip);
+		size_t height = std::max((size_t)1, full->height >> firstMip);
+		size_t depth = std::max((size_t)1, full->depth >> firstMip);
+		size_t skipSize = firstMip == 0 ? 0 : Image::calculateSize(firstMip - 1, 1,
+			full->width, full->height, full->depth, full->format);
+		size_t faceSize = Image::calculateSize(full->num_mipmaps, 1,
+			full->width, full->height, full->depth, full->format);
+		size_t levelsSize = Image::calculateSize(numMips - 1, 1,
+			width, height, depth, full->format);
+
+		ImageData* imgData = OGRE_NEW ImageData();
+		imgData->width = width;
+		imgData->height = height;
+		imgData->depth = depth;
+		imgData->num_mipmaps = static_cast<ushort>(numMips - 1);
+		imgData->flags = full->flags;
+		imgData->format = full->format;
+		imgData->size = levelsSize * numFaces;
+
+		MemoryDataStreamPtr output(OGRE_NEW MemoryDataStream(imgData->size));
+		const uchar* src = res.first->getPtr();
+		uchar* dst = output->getPtr();
+		for (size_t face = 0; face < numFaces; ++face)
+		{
+			memcpy(dst + face * levelsSize, src + face * faceSize + skipSize, levelsSize);
+		}
+
+		DecodeResult ret;
+		ret.first = output;
+		ret.second = CodecDataPtr(imgData);
+		return ret;
+	}
 
+	//-----------------------------------------------------------------------------
+	Codec::CodecDataPtr ImageCodec::decodeInto(DataStreamPtr& input, DecodeTarget& target) const
+	{
+		DecodeResult res = decode(input);
+		const ImageData* data = static_cast<const ImageData*>(res.second.getPointer());
+
+		PixelBox dest = target.getDestination(*data);
+		if (dest.getWidth() != data->width || dest.getHeight() != data->height ||
+			dest.getDepth() != data->depth)
+		{
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+				"Destination does not match the size of the image",
+				"ImageCodec::decodeInto");
+		}
+		PixelUtil::bulkPixelConversion(PixelBox(data->width, data->height, data->depth,
+			data->format, res.first->getPtr()), dest);
+		return res.second;
+	}
 	//-----------------------------------------------------------------------------
 	Image::Image()
 		: m_uWidth(0),
@@ -570,7 +653,7 @@ namespace Ogre {
 		}
 	}
 	//-----------------------------------------------------------------------------
-	void Image::resize(ushort width, ushort height, Filter filter)
+	void Image::resize(ushort width, ushort height, Filter filter, bool gammaCorrect)
 	{
 		// resizing dynamic images is not supported
 		assert(m_bAutoDelete);
@@ -589,10 +672,53 @@ namespace Ogre {
         m_uNumMipmaps = 0; // Loses precomputed mipmaps
 
 		// scale the image from temp into our resized buffer
-		Image::scale(temp.getPixelBox(), getPixelBox(), filter);
+		Image::scale(temp.getPixelBox(), getPixelBox(), filter, gammaCorrect);
 	}
 	//-----------------------------------------------------------------------
-	void Image::scale(const PixelBox &src, const PixelBox &scaled, Filter filter) 
+	void Image::generateMipmaps(Filter filter, bool gammaCorrect)
+	{
+		if (PixelUtil::isCompressed(m_eFormat))
+		{
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+				"Can not generate mipmaps for a compressed image",
+				"Image::generateMipmaps");
+		}
+
+		size_t numMips = 0;
+		for (size_t width = m_uWidth, height = m_uHeight, depth = m_uDepth; 
+			width > 1 || height > 1 || depth > 1; ++numMips)
+		{
+			if (width > 1) width /= 2;
+			if (height > 1) height /= 2;
+			if (depth > 1) depth /= 2;
+		}
+
+		size_t numFaces = getNumFaces();
+		size_t size = calculateSize(numMips, numFaces, m_uWidth, m_uHeight, m_uDepth, m_eFormat);
+		Image chain;
+		chain.loadDynamicImage(OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL),
+			m_uWidth, m_uHeight, m_uDepth, m_eFormat, true, numFaces, numMips);
+
+		for (size_t face = 0; face < numFaces; ++face)
+		{
+			PixelUtil::bulkPixelConversion(getPixelBox(face, 0), chain.getPixelBox(face, 0));
+			for (size_t mip = 1; mip <= numMips; ++mip)
+			{
+				scale(chain.getPixelBox(face, mip - 1), chain.getPixelBox(face, mip), filter, gammaCorrect);
+			}
+		}
+
+		// take over the new buffer; a buffer the application holds is left
+		// alone, and the image owns the chain from now on
+		freeMemory();
+		m_pBuffer = chain.m_pBuffer;
+		m_uSize = chain.m_uSize;
+		m_uNumMipmaps = chain.m_uNumMipmaps;
+		m_bAutoDelete = true;
+		chain.m_pBuffer = NULL;
+	}
+	//-----------------------------------------------------------------------
+	void Image::scale(const PixelBox &src, const PixelBox &scaled, Filter filter, bool gammaCorrect) 
 	{
 		assert(PixelUtil::isAccessible(src.format));
 		assert(PixelUtil::isAccessible(scaled.format));
@@ -638,6 +764,12 @@ namespace Ogre {
 
 		case FILTER_LINEAR:
 		case FILTER_BILINEAR:
+			if (gammaCorrect)
+			{
+				// the fixed point resamplers below work on the encoded values
+				FilterResampler::scale(src, scaled, filter, gammaCorrect);
+				break;
+			}
 			switch (src.format) 
 			{
 			case PF_L8: case PF_A8: case PF_BYTE_LA:
@@ -688,6 +820,14 @@ namespace Ogre {
 				LinearResampler::scale(src, scaled);
 			}
 			break;
+
+		case FILTER_BOX:
+		case FILTER_TRIANGLE:
+		case FILTER_BICUBIC:
+		case FILTER_LANCZOS:
+		case FILTER_KAISER:
+			FilterResampler::scale(src, scaled, filter, gammaCorrect);
+			break;
 		}
 	}
 
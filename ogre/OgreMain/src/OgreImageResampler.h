@@ -277,6 +277,28 @@ struct LinearResampler_Float32 {
 
 
 
+// splits a 2D resampler into bands of destination rows, run in parallel.
+// the resampler provides scaleRows(src, dst, ybegin, yend)
+template<class Resampler> class ResampleRowsTask : public ParallelTasks::Task {
+	const PixelBox& mSrc;
+	const PixelBox& mDst;
+public:
+	enum { ROWS_PER_TASK = 32 };
+
+	ResampleRowsTask(const PixelBox& src, const PixelBox& dst) : mSrc(src), mDst(dst) {}
+
+	size_t getTaskCount() const {
+		return (mDst.getHeight() + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+	}
+
+	void run(size_t index) {
+		size_t ybegin = index * ROWS_PER_TASK;
+		Resampler::scaleRows(mSrc, mDst, ybegin,
+			std::min(ybegin + ROWS_PER_TASK, mDst.getHeight()));
+	}
+};
+
+
 // byte linear resampler, does not do any format conversions.
 // only handles pixel formats that use 1 byte per color channel.
 // 2D only; punts 3D pixelboxes to default LinearResampler (slow).
@@ -292,9 +314,15 @@ template<unsigned int channels> struct LinearResampler_Byte {
 			return;
 		}
 
+		ResampleRowsTask<LinearResampler_Byte<channels> > task(src, dst);
+		ParallelTasks::run(task, task.getTaskCount());
+	}
+
+	// scales destination rows [ybegin, yend), counted from dst.top
+	static void scaleRows(const PixelBox& src, const PixelBox& dst, size_t ybegin, size_t yend) {
 		// srcdata stays at beginning of slice, pdst is a moving pointer
 		uchar* srcdata = (uchar*)src.data;
-		uchar* pdst = (uchar*)dst.data;
+		uchar* pdst = (uchar*)dst.data + ybegin*dst.rowPitch*channels;
 
 		// sx_48,sy_48 represent current position in source
 		// using 16/48-bit fixed precision, incremented by steps
@@ -307,8 +335,8 @@ template<unsigned int channels> struct LinearResampler_Byte {
 		// fractional bits are the blend weight of the second sample
 		unsigned int temp;
 		
-		uint64 sy_48 = (stepy >> 1) - 1;
-		for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+		uint64 sy_48 = (stepy >> 1) - 1 + stepy*ybegin;
+		for (size_t y = ybegin; y < yend; y++, sy_48+=stepy) {
 			temp = static_cast<unsigned int>(sy_48 >> 36);
 			temp = (temp > 0x800)? temp - 0x800: 0;
 			unsigned int syf = temp & 0xFFF;
@@ -341,6 +369,338 @@ template<unsigned int channels> struct LinearResampler_Byte {
 		}
 	}
 };
+
+
+// separable filter kernels, x in destination-scaled source pixels.
+// support is the kernel radius
+struct ResampleKernel {
+	float (*weight)(float x);
+	float support;
+	// whether the kernel widens with the reduction when minifying
+	bool widen;
+
+	static float sinc(float x) {
+		if (x == 0.0f)
+			return 1.0f;
+		x *= Math::PI;
+		return std::sin(x) / x;
+	}
+
+	static float bessel0(float x) {
+		// power series of the zeroth order modified bessel function
+		float sum = 1.0f, term = 1.0f;
+		float halfxsq = x * x * 0.25f;
+		for (int k = 1; k < 32 && term > sum * 1e-8f; ++k) {
+			term *= halfxsq / (k * k);
+			sum += term;
+		}
+		return sum;
+	}
+
+	static float box(float x) {
+		return (x >= -0.5f && x < 0.5f)? 1.0f : 0.0f;
+	}
+
+	static float triangle(float x) {
+		x = std::fabs(x);
+		return (x < 1.0f)? 1.0f - x : 0.0f;
+	}
+
+	static float bicubic(float x) {
+		// mitchell-netravali, B = C = 1/3
+		const float B = 1.0f / 3.0f, C = 1.0f / 3.0f;
+		x = std::fabs(x);
+		if (x < 1.0f)
+			return ((12 - 9*B - 6*C)*x*x*x + (-18 + 12*B + 6*C)*x*x + (6 - 2*B)) / 6.0f;
+		if (x < 2.0f)
+			return ((-B - 6*C)*x*x*x + (6*B + 30*C)*x*x + (-12*B - 48*C)*x + (8*B + 24*C)) / 6.0f;
+		return 0.0f;
+	}
+
+	static float lanczos(float x) {
+		if (std::fabs(x) >= 3.0f)
+			return 0.0f;
+		return sinc(x) * sinc(x / 3.0f);
+	}
+
+	static float kaiser(float x) {
+		const float alpha = 4.0f;
+		float t = x / 3.0f;
+		if (std::fabs(t) >= 1.0f)
+			return 0.0f;
+		return sinc(x) * bessel0(alpha * std::sqrt(1.0f - t * t)) / bessel0(alpha);
+	}
+
+	static ResampleKernel create(Image::Filter filter) {
+		ResampleKernel k;
+		k.widen = true;
+		switch (filter) {
+		case Image::FILTER_LINEAR:
+		case Image::FILTER_BILINEAR:
+			// plain bilinear interpolation, whatever the reduction
+			k.weight = triangle; k.support = 1.0f; k.widen = false;
+			break;
+		case Image::FILTER_TRIANGLE:
+			k.weight = triangle; k.support = 1.0f;
+			break;
+		case Image::FILTER_BICUBIC:
+			k.weight = bicubic; k.support = 2.0f;
+			break;
+		case Image::FILTER_LANCZOS:
+			k.weight = lanczos; k.support = 3.0f;
+			break;
+		case Image::FILTER_KAISER:
+			k.weight = kaiser; k.support = 3.0f;
+			break;
+		case Image::FILTER_BOX:
+		default:
+			k.weight = box; k.support = 0.5f;
+			break;
+		}
+		return k;
+	}
+};
+
+// source samples and normalised weights of every destination pixel along
+// one axis. samples outside the source are clamped to its edge
+struct ResampleTaps {
+	// taps of destination pixel i are [first[i], first[i+1])
+	vector<size_t>::type first;
+	vector<size_t>::type index;
+	vector<float>::type weight;
+
+	ResampleTaps(const ResampleKernel& kernel, size_t srcSize, size_t dstSize) {
+		const float ratio = (float)srcSize / dstSize;
+		const float fscale = kernel.widen? std::max(ratio, 1.0f) : 1.0f;
+		const float support = kernel.support * fscale;
+
+		first.reserve(dstSize + 1);
+		for (size_t i = 0; i < dstSize; ++i) {
+			first.push_back(index.size());
+			const float center = (i + 0.5f) * ratio;
+			const int lo = (int)std::floor(center - support);
+			const int hi = (int)std::ceil(center + support);
+			float total = 0.0f;
+			for (int j = lo; j <= hi; ++j) {
+				float w = kernel.weight((j + 0.5f - center) / fscale);
+				if (std::fabs(w) < 1e-6f)
+					continue;
+				int clamped = std::min(std::max(j, 0), (int)srcSize - 1);
+				index.push_back((size_t)clamped);
+				weight.push_back(w);
+				total += w;
+			}
+			if (total == 0.0f) {
+				// kernel fell between samples, use the nearest one
+				index.resize(first.back());
+				weight.resize(first.back());
+				index.push_back(std::min((size_t)center, srcSize - 1));
+				weight.push_back(1.0f);
+				total = 1.0f;
+			}
+			for (size_t t = first.back(); t < weight.size(); ++t)
+				weight[t] /= total;
+		}
+		first.push_back(index.size());
+	}
+};
+
+// separable filter resampler, does format conversion.
+// rows are unpacked to float rgba, filtered horizontally, then combined
+// vertically and across slices. each task produces a band of destination
+// rows of one slice. with SSE, a pixel is one register in the horizontal
+// pass and the vertical pass runs 4 floats at a time; both do the same
+// multiplies and adds in the same order, so results don't depend on it
+struct FilterResampler {
+	static bool hasSSE() {
+#if __OGRE_HAVE_SSE
+		static const bool sse =
+			(PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE) != 0;
+		return sse;
+#else
+		return false;
+#endif
+	}
+
+	// horizontal pass, filters a row of source pixels into width pixels
+	static void filterRow(const ResampleTaps& taps, const float* src, float* out, size_t width) {
+		for (size_t x = 0; x < width; ++x, out += 4) {
+			float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+			for (size_t t = taps.first[x]; t < taps.first[x + 1]; ++t) {
+				const float* p = &src[taps.index[t] * 4];
+				const float w = taps.weight[t];
+				r += p[0] * w; g += p[1] * w; b += p[2] * w; a += p[3] * w;
+			}
+			out[0] = r; out[1] = g; out[2] = b; out[3] = a;
+		}
+	}
+
+	// vertical pass, adds count floats of a filtered row times its weight
+	static void accumulateRow(const float* in, float w, float* out, size_t count) {
+		for (size_t i = 0; i < count; ++i)
+			out[i] += in[i] * w;
+	}
+
+#if __OGRE_HAVE_SSE
+	static void filterRowSSE(const ResampleTaps& taps, const float* src, float* out, size_t width) {
+		for (size_t x = 0; x < width; ++x, out += 4) {
+			__m128 sum = _mm_setzero_ps();
+			for (size_t t = taps.first[x]; t < taps.first[x + 1]; ++t) {
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&src[taps.index[t] * 4]),
+					_mm_set1_ps(taps.weight[t])));
+			}
+			_mm_storeu_ps(out, sum);
+		}
+	}
+
+	// count is a whole number of rgba pixels
+	static void accumulateRowSSE(const float* in, float w, float* out, size_t count) {
+		const __m128 weight = _mm_set1_ps(w);
+		for (size_t i = 0; i < count; i += 4) {
+			_mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i),
+				_mm_mul_ps(_mm_loadu_ps(in + i), weight)));
+		}
+	}
+#endif
+
+	static float toLinear(float c) {
+		return (c <= 0.04045f)? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+	}
+
+	static float fromLinear(float c) {
+		if (c <= 0.0f)
+			return 0.0f;
+		return (c <= 0.0031308f)? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+	}
+
+	class Task : public ParallelTasks::Task {
+		const PixelBox& mSrc;
+		const PixelBox& mDst;
+		ResampleTaps mTapsX, mTapsY, mTapsZ;
+		bool mGammaCorrect;
+		bool mSSE;
+		size_t mBandsPerSlice;
+	public:
+		enum { ROWS_PER_TASK = 16 };
+
+		Task(const PixelBox& src, const PixelBox& dst, const ResampleKernel& kernel, bool gammaCorrect)
+			: mSrc(src), mDst(dst),
+			mTapsX(kernel, src.getWidth(), dst.getWidth()),
+			mTapsY(kernel, src.getHeight(), dst.getHeight()),
+			mTapsZ(kernel, src.getDepth(), dst.getDepth()),
+			mGammaCorrect(gammaCorrect),
+			mSSE(hasSSE()),
+			mBandsPerSlice((dst.getHeight() + ROWS_PER_TASK - 1) / ROWS_PER_TASK)
+		{
+		}
+
+		size_t getTaskCount() const {
+			return mBandsPerSlice * mDst.getDepth();
+		}
+
+		void run(size_t index) {
+			const size_t z = index / mBandsPerSlice;
+			const size_t ybegin = (index % mBandsPerSlice) * ROWS_PER_TASK;
+			const size_t yend = std::min(ybegin + ROWS_PER_TASK, mDst.getHeight());
+			const size_t srcWidth = mSrc.getWidth();
+			const size_t dstWidth = mDst.getWidth();
+			const size_t dstRowFloats = dstWidth * 4;
+
+			// range of source rows feeding this band
+			size_t symin = mSrc.getHeight(), symax = 0;
+			for (size_t t = mTapsY.first[ybegin]; t < mTapsY.first[yend]; ++t) {
+				symin = std::min(symin, mTapsY.index[t]);
+				symax = std::max(symax, mTapsY.index[t]);
+			}
+
+			vector<float>::type srcRow(srcWidth * 4);
+			vector<float>::type filtered((symax - symin + 1) * dstRowFloats);
+			vector<float>::type accum((yend - ybegin) * dstRowFloats, 0.0f);
+
+			for (size_t tz = mTapsZ.first[z]; tz < mTapsZ.first[z + 1]; ++tz) {
+				const size_t sz = mTapsZ.index[tz];
+				const float wz = mTapsZ.weight[tz];
+
+				// horizontal pass over the source rows
+				for (size_t sy = symin; sy <= symax; ++sy) {
+					unpackRow(sy, sz, &srcRow[0]);
+					float* out = &filtered[(sy - symin) * dstRowFloats];
+#if __OGRE_HAVE_SSE
+					if (mSSE) {
+						filterRowSSE(mTapsX, &srcRow[0], out, dstWidth);
+						continue;
+					}
+#endif
+					filterRow(mTapsX, &srcRow[0], out, dstWidth);
+				}
+
+				// vertical pass into the band
+				for (size_t y = ybegin; y < yend; ++y) {
+					float* out = &accum[(y - ybegin) * dstRowFloats];
+					for (size_t t = mTapsY.first[y]; t < mTapsY.first[y + 1]; ++t) {
+						const float* in = &filtered[(mTapsY.index[t] - symin) * dstRowFloats];
+						const float w = mTapsY.weight[t] * wz;
+#if __OGRE_HAVE_SSE
+						if (mSSE) {
+							accumulateRowSSE(in, w, out, dstRowFloats);
+							continue;
+						}
+#endif
+						accumulateRow(in, w, out, dstRowFloats);
+					}
+				}
+			}
+
+			for (size_t y = ybegin; y < yend; ++y)
+				packRow(y, z, &accum[(y - ybegin) * dstRowFloats]);
+		}
+
+	protected:
+		void unpackRow(size_t y, size_t z, float* rgba) {
+			PixelBox row(Box(mSrc.left, mSrc.top + y, mSrc.front + z,
+				mSrc.right, mSrc.top + y + 1, mSrc.front + z + 1), mSrc.format, mSrc.data);
+			row.rowPitch = mSrc.rowPitch;
+			row.slicePitch = mSrc.slicePitch;
+			PixelUtil::bulkPixelConversion(row, PixelBox(mSrc.getWidth(), 1, 1, PF_FLOAT32_RGBA, rgba));
+			if (mGammaCorrect) {
+				for (size_t x = 0; x < mSrc.getWidth(); ++x, rgba += 4) {
+					rgba[0] = toLinear(rgba[0]);
+					rgba[1] = toLinear(rgba[1]);
+					rgba[2] = toLinear(rgba[2]);
+				}
+			}
+		}
+
+		void packRow(size_t y, size_t z, float* rgba) {
+			if (mGammaCorrect) {
+				float* p = rgba;
+				for (size_t x = 0; x < mDst.getWidth(); ++x, p += 4) {
+					p[0] = fromLinear(p[0]);
+					p[1] = fromLinear(p[1]);
+					p[2] = fromLinear(p[2]);
+				}
+			}
+			PixelBox row(Box(mDst.left, mDst.top + y, mDst.front + z,
+				mDst.right, mDst.top + y + 1, mDst.front + z + 1), mDst.format, mDst.data);
+			row.rowPitch = mDst.rowPitch;
+			row.slicePitch = mDst.slicePitch;
+			PixelUtil::bulkPixelConversion(PixelBox(mDst.getWidth(), 1, 1, PF_FLOAT32_RGBA, rgba), row);
+		}
+	};
+
+	static void scale(const PixelBox& src, const PixelBox& dst, Image::Filter filter, bool gammaCorrect) {
+		if (src.data == dst.data) {
+			// scaling in place, filter from a copy of the source
+			MemoryDataStream copy(src.getConsecutiveSize());
+			PixelBox srccopy(src.getWidth(), src.getHeight(), src.getDepth(), src.format, copy.getPtr());
+			PixelUtil::bulkPixelConversion(src, srccopy);
+			scale(srccopy, dst, filter, gammaCorrect);
+			return;
+		}
+		Task task(src, dst, ResampleKernel::create(filter), gammaCorrect);
+		ParallelTasks::run(task, task.getTaskCount());
+	}
+};
 /** @} */
 /** @} */
 
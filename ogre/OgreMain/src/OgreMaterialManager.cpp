@@ -59,7 +59,8 @@ namespace Ogre {
     }
 	String MaterialManager::DEFAULT_SCHEME_NAME = "Default";
     //-----------------------------------------------------------------------
-    MaterialManager::MaterialManager() : OGRE_THREAD_POINTER_INIT(mSerializer)
+    MaterialManager::MaterialManager() : OGRE_THREAD_POINTER_INIT(mSerializer),
+		mDeferredTranslation(false), mTranslatingDeferred(false)
     {
 	    mDefaultMinFilter = FO_LINEAR;
 	    mDefaultMagFilter = FO_LINEAR;
@@ -95,6 +96,7 @@ namespace Ogre {
     MaterialManager::~MaterialManager()
     {
         mDefaultSettings.setNull();
+		mDeferredMaterials.clear();
 	    // Resources cleared by superclass
 		// Unregister with resource group manager
 		ResourceGroupManager::getSingleton()._unregisterResourceManager(mResourceType);
@@ -111,6 +113,123 @@ namespace Ogre {
 	{
 		return OGRE_NEW Material(this, name, handle, group, isManual, loader);
 	}
+	//-----------------------------------------------------------------------
+	void MaterialManager::setDeferredTranslation(bool defer)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		mDeferredTranslation = defer;
+	}
+	//-----------------------------------------------------------------------
+	bool MaterialManager::_deferTranslation(const String& name, const String& group, 
+		const SharedPtr<AbstractNode>& node)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+
+		if (!mDeferredTranslation || mTranslatingDeferred)
+			return false;
+		// Let duplicates be created now, so they are reported as usual
+		if (mDeferredMaterials.find(name) != mDeferredMaterials.end() ||
+			!ResourceManager::getByName(name, group).isNull())
+			return false;
+
+		DeferredMaterial& deferred = mDeferredMaterials[name];
+		deferred.group = group;
+		deferred.node = node;
+		return true;
+	}
+	//-----------------------------------------------------------------------
+	ResourcePtr MaterialManager::getByName(const String& name, const String& groupName)
+	{
+		ResourcePtr res = ResourceManager::getByName(name, groupName);
+		if (!res.isNull())
+			return res;
+
+#if OGRE_USE_NEW_COMPILERS == 1
+		OGRE_LOCK_AUTO_MUTEX
+		DeferredMaterialMap::iterator i = mDeferredMaterials.find(name);
+		if (i == mDeferredMaterials.end())
+			return res;
+		if (groupName != ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME &&
+			groupName != i->second.group &&
+			!ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(i->second.group))
+			return res;
+
+		DeferredMaterial deferred = i->second;
+		mDeferredMaterials.erase(i);
+
+		// Use a compiler of our own, we may be called while the thread's one is busy
+		ScriptCompiler compiler;
+		compiler.setListener(ScriptCompilerManager::getSingleton().getListener());
+		AbstractNodeListPtr nodes(OGRE_NEW_T(AbstractNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+		nodes->push_back(deferred.node);
+
+		bool wasTranslating = mTranslatingDeferred;
+		mTranslatingDeferred = true;
+		try
+		{
+			compiler._compilePrepared(nodes, ScriptCompiler::ErrorList(), deferred.group);
+		}
+		catch (...)
+		{
+			mTranslatingDeferred = wasTranslating;
+			throw;
+		}
+		mTranslatingDeferred = wasTranslating;
+
+		return ResourceManager::getByName(name, groupName);
+#else
+		// Only the script translator of the new compilers defers materials
+		return res;
+#endif
+	}
+	//-----------------------------------------------------------------------
+	bool MaterialManager::resourceExists(const String& name)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		return mDeferredMaterials.find(name) != mDeferredMaterials.end() ||
+			!ResourceManager::getByName(name).isNull();
+	}
+	//-----------------------------------------------------------------------
+	void MaterialManager::unload(const String& name)
+	{
+		// Not through getByName, which would translate a deferred material first
+		ResourcePtr res = ResourceManager::getByName(name);
+		if (!res.isNull())
+			res->unload();
+	}
+	//-----------------------------------------------------------------------
+	void MaterialManager::remove(const String& name)
+	{
+		{
+			OGRE_LOCK_AUTO_MUTEX
+			mDeferredMaterials.erase(name);
+		}
+		ResourcePtr res = ResourceManager::getByName(name);
+		if (!res.isNull())
+			ResourceManager::remove(res);
+	}
+	//-----------------------------------------------------------------------
+	void MaterialManager::removeAll(void)
+	{
+		{
+			OGRE_LOCK_AUTO_MUTEX
+			mDeferredMaterials.clear();
+		}
+		ResourceManager::removeAll();
+	}
+	//-----------------------------------------------------------------------
+	void MaterialManager::_notifyResourceGroupCleared(const String& group)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		DeferredMaterialMap::iterator i = mDeferredMaterials.begin();
+		while (i != mDeferredMaterials.end())
+		{
+			if (i->second.group == group)
+				mDeferredMaterials.erase(i++);
+			else
+				++i;
+		}
+	}
     //-----------------------------------------------------------------------
 	void MaterialManager::initialise(void)
 	{
@@ -277,8 +277,11 @@ namespace Ogre {
             ResourceGroupManager::getSingleton().openResource(
 				mName, mGroup, true, this);
  
-        // fully prebuffer into host RAM
-        mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
+        // fully prebuffer into host RAM, unless the stream already holds
+        // its contents in memory (e.g. a mapped file), in which case the 
+        // serializer reads straight from it
+        if (!mFreshFromDisk->getDataPtr())
+            mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
     }
     //-----------------------------------------------------------------------
     void Mesh::unprepareImpl()
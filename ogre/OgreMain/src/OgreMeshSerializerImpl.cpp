@@ -764,16 +764,27 @@ namespace Ogre {
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
 			pMesh->mVertexBufferShadowBuffer);
-        void* pBuf = vbuf->lock(HardwareBuffer::HBL_DISCARD);
-        stream->read(pBuf, dest->vertexCount * vertexSize);
-
-		// endian conversion for OSX
-		flipFromLittleEndian(
-			pBuf,
-			dest->vertexCount,
-			vertexSize,
-			dest->vertexDeclaration->findElementsBySource(bindIndex));
-        vbuf->unlock();
+		size_t bufferSize = dest->vertexCount * vertexSize;
+		const uchar* pSrc = mFlipEndian ? 0 : getInPlaceData(stream, bufferSize);
+		if (pSrc)
+		{
+			// Straight from the stream's memory, no lock or intermediate copy
+			vbuf->writeData(0, bufferSize, pSrc, true);
+			stream->skip(static_cast<long>(bufferSize));
+		}
+		else
+		{
+			void* pBuf = vbuf->lock(HardwareBuffer::HBL_DISCARD);
+			stream->read(pBuf, bufferSize);
+
+			// endian conversion for OSX
+			flipFromLittleEndian(
+				pBuf,
+				dest->vertexCount,
+				vertexSize,
+				dest->vertexDeclaration->findElementsBySource(bindIndex));
+			vbuf->unlock();
+		}
 
 		// Set binding
         dest->vertexBufferBinding->setBinding(bindIndex, vbuf);
@@ -965,11 +976,7 @@ namespace Ogre {
                         pMesh->mIndexBufferUsage,
 					    pMesh->mIndexBufferShadowBuffer);
                 // unsigned int* faceVertexIndices
-                unsigned int* pIdx = static_cast<unsigned int*>(
-                    ibuf->lock(HardwareBuffer::HBL_DISCARD)
-                    );
-                readInts(stream, pIdx, sm->indexData->indexCount);
-                ibuf->unlock();
+                readBufferData(stream, ibuf.get(), sizeof(unsigned int));
 
             }
             else // 16-bit
@@ -981,11 +988,7 @@ namespace Ogre {
                         pMesh->mIndexBufferUsage,
 					    pMesh->mIndexBufferShadowBuffer);
                 // unsigned short* faceVertexIndices
-                unsigned short* pIdx = static_cast<unsigned short*>(
-                    ibuf->lock(HardwareBuffer::HBL_DISCARD)
-                    );
-                readShorts(stream, pIdx, sm->indexData->indexCount);
-                ibuf->unlock();
+                readBufferData(stream, ibuf.get(), sizeof(unsigned short));
             }
         }
         sm->indexData->indexBuffer = ibuf;
@@ -1479,14 +1482,7 @@ namespace Ogre {
                 indexData->indexBuffer = HardwareBufferManager::getSingleton().
                     createIndexBuffer(HardwareIndexBuffer::IT_32BIT, indexData->indexCount,
                     pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                unsigned int* pIdx = static_cast<unsigned int*>(
-                    indexData->indexBuffer->lock(
-                        0,
-                        indexData->indexBuffer->getSizeInBytes(),
-                        HardwareBuffer::HBL_DISCARD) );
-
-			    readInts(stream, pIdx, indexData->indexCount);
-                indexData->indexBuffer->unlock();
+                readBufferData(stream, indexData->indexBuffer.get(), sizeof(unsigned int));
 
             }
             else
@@ -1494,19 +1490,32 @@ namespace Ogre {
                 indexData->indexBuffer = HardwareBufferManager::getSingleton().
                     createIndexBuffer(HardwareIndexBuffer::IT_16BIT, indexData->indexCount,
                     pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                unsigned short* pIdx = static_cast<unsigned short*>(
-                    indexData->indexBuffer->lock(
-                        0,
-                        indexData->indexBuffer->getSizeInBytes(),
-                        HardwareBuffer::HBL_DISCARD) );
-			    readShorts(stream, pIdx, indexData->indexCount);
-                indexData->indexBuffer->unlock();
+                readBufferData(stream, indexData->indexBuffer.get(), sizeof(unsigned short));
 
             }
 
 		}
 	}
     //---------------------------------------------------------------------
+    void MeshSerializerImpl::readBufferData(DataStreamPtr& stream, HardwareBuffer* buf, 
+        size_t elemSize)
+    {
+        size_t size = buf->getSizeInBytes();
+        const uchar* pSrc = mFlipEndian ? 0 : getInPlaceData(stream, size);
+        if (pSrc)
+        {
+            buf->writeData(0, size, pSrc, true);
+            stream->skip(static_cast<long>(size));
+        }
+        else
+        {
+            void* pDst = buf->lock(HardwareBuffer::HBL_DISCARD);
+            stream->read(pDst, size);
+            Serializer::flipFromLittleEndian(pDst, elemSize, size / elemSize);
+            buf->unlock();
+        }
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::flipFromLittleEndian(void* pData, size_t vertexCount,
         size_t vertexSize, const VertexDeclaration::VertexElementList& elems)
 	{
@@ -1528,45 +1537,66 @@ namespace Ogre {
     void MeshSerializerImpl::flipEndian(void* pData, size_t vertexCount,
         size_t vertexSize, const VertexDeclaration::VertexElementList& elems)
 	{
-		void *pBase = pData;
-		for (size_t v = 0; v < vertexCount; ++v)
+		// Work out once which parts of a vertex to flip, and how
+		struct FlipRange { size_t offset, typeSize, count; };
+		vector<FlipRange>::type ranges;
+		VertexDeclaration::VertexElementList::const_iterator ei, eiend;
+		eiend = elems.end();
+		for (ei = elems.begin(); ei != eiend; ++ei)
 		{
-			VertexDeclaration::VertexElementList::const_iterator ei, eiend;
-			eiend = elems.end();
-			for (ei = elems.begin(); ei != eiend; ++ei)
+			// Flip the endian based on the type
+			size_t typeSize = 0;
+			switch (VertexElement::getBaseType((*ei).getType()))
 			{
-				void *pElem;
-				// re-base pointer to the element
-				(*ei).baseVertexPointerToElement(pBase, &pElem);
-				// Flip the endian based on the type
-				size_t typeSize = 0;
-				switch (VertexElement::getBaseType((*ei).getType()))
-				{
-					case VET_FLOAT1:
-						typeSize = sizeof(float);
-						break;
-					case VET_SHORT1:
-						typeSize = sizeof(short);
-						break;
-					case VET_COLOUR:
-					case VET_COLOUR_ABGR:
-					case VET_COLOUR_ARGB:
-						typeSize = sizeof(RGBA);
-						break;
-					case VET_UBYTE4:
-						typeSize = 0; // NO FLIPPING
-						break;
-					default:
-						assert(false); // Should never happen
-				};
-                Serializer::flipEndian(pElem, typeSize,
-					VertexElement::getTypeCount((*ei).getType()));
-
-			}
-
-			pBase = static_cast<void*>(
-				static_cast<unsigned char*>(pBase) + vertexSize);
+				case VET_FLOAT1:
+					typeSize = sizeof(float);
+					break;
+				case VET_SHORT1:
+					typeSize = sizeof(short);
+					break;
+				case VET_COLOUR:
+				case VET_COLOUR_ABGR:
+				case VET_COLOUR_ARGB:
+					typeSize = sizeof(RGBA);
+					break;
+				case VET_UBYTE4:
+					typeSize = 0; // NO FLIPPING
+					break;
+				default:
+					assert(false); // Should never happen
+			};
+			if (typeSize == 0)
+				continue;
+			FlipRange range;
+			range.offset = (*ei).getOffset();
+			range.typeSize = typeSize;
+			range.count = VertexElement::getTypeCount((*ei).getType());
+			ranges.push_back(range);
+		}
+		if (ranges.empty())
+			return;
+
+		// If the vertex is entirely made of elements of one size the whole
+		// buffer can be flipped in one go
+		size_t typeSize = ranges[0].typeSize;
+		size_t covered = 0;
+		bool uniform = vertexSize % typeSize == 0;
+		for (size_t r = 0; r < ranges.size() && uniform; ++r)
+		{
+			uniform = ranges[r].typeSize == typeSize && ranges[r].offset % typeSize == 0;
+			covered += ranges[r].typeSize * ranges[r].count;
+		}
+		if (uniform && covered == vertexSize)
+		{
+			Serializer::flipEndian(pData, typeSize, vertexCount * vertexSize / typeSize);
+			return;
+		}
 
+		unsigned char* pBase = static_cast<unsigned char*>(pData);
+		for (size_t v = 0; v < vertexCount; ++v, pBase += vertexSize)
+		{
+			for (size_t r = 0; r < ranges.size(); ++r)
+				Serializer::flipEndian(pBase + ranges[r].offset, ranges[r].typeSize, ranges[r].count);
 		}
 	}
     //---------------------------------------------------------------------
@@ -2454,10 +2484,7 @@ namespace Ogre {
 				vertexSize, vertexCount,
 				HardwareBuffer::HBU_STATIC, true);
 		// float x,y,z			// repeat by number of vertices in original geometry
-		float* pDst = static_cast<float*>(
-			vbuf->lock(HardwareBuffer::HBL_DISCARD));
-		readFloats(stream, pDst, vertexCount * (includesNormals ? 6 : 3));
-		vbuf->unlock();
+		readBufferData(stream, vbuf.get(), sizeof(float));
 		kf->setVertexBuffer(vbuf);
 
 	}
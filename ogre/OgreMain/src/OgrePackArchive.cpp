@@ -0,0 +1,713 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgrePackArchive.h"
+
+#include "OgreLogManager.h"
+#include "OgreException.h"
+#include "OgreStringVector.h"
+#include "OgreStringConverter.h"
+#include "OgreDeflateChunks.h"
+
+namespace Ogre {
+
+	namespace PackFormat
+	{
+		//---------------------------------------------------------------------
+		static inline char normaliseNameChar(char c)
+		{
+			return c == '\\' ? '/' : static_cast<char>(tolower(static_cast<unsigned char>(c)));
+		}
+		//---------------------------------------------------------------------
+		uint32 hashName(const String& name)
+		{
+			// FNV-1a
+			uint32 hash = 2166136261u;
+			for (String::const_iterator i = name.begin(); i != name.end(); ++i)
+			{
+				hash ^= static_cast<uchar>(normaliseNameChar(*i));
+				hash *= 16777619u;
+			}
+			return hash;
+		}
+		//---------------------------------------------------------------------
+		static bool namesEqual(const char* a, size_t length, const String& b)
+		{
+			if (length != b.length())
+				return false;
+			for (size_t i = 0; i < length; ++i)
+			{
+				if (normaliseNameChar(a[i]) != normaliseNameChar(b[i]))
+					return false;
+			}
+			return true;
+		}
+#if OGRE_ENDIAN == OGRE_ENDIAN_BIG
+		//---------------------------------------------------------------------
+		template <typename T> static void flipEndian(T& val)
+		{
+			uchar* p = reinterpret_cast<uchar*>(&val);
+			std::reverse(p, p + sizeof(T));
+		}
+		//---------------------------------------------------------------------
+		static void flipEndian(Header& h)
+		{
+			flipEndian(h.magic); flipEndian(h.version);
+			flipEndian(h.entryCount); flipEndian(h.hashSize);
+			flipEndian(h.chunkSize); flipEndian(h.chunkOffsetCount);
+			flipEndian(h.indexOffset); flipEndian(h.indexSize);
+		}
+		//---------------------------------------------------------------------
+		static void flipEndian(Entry& e)
+		{
+			flipEndian(e.offset); flipEndian(e.size);
+			flipEndian(e.compressedSize); flipEndian(e.modifiedTime);
+			flipEndian(e.hash); flipEndian(e.nameOffset);
+			flipEndian(e.nameLength); flipEndian(e.firstChunk);
+			flipEndian(e.flags); flipEndian(e.reserved);
+		}
+#endif
+	}
+	using namespace PackFormat;
+
+	//-----------------------------------------------------------------------
+	PackArchive::PackArchive(const String& name, const String& archType )
+		: Archive(name, archType), mHashTable(0), mEntries(0), mChunkOffsets(0), mNames(0)
+	{
+		memset(&mHeader, 0, sizeof(Header));
+	}
+	//-----------------------------------------------------------------------
+	PackArchive::~PackArchive()
+	{
+		unload();
+	}
+	//-----------------------------------------------------------------------
+	void PackArchive::load()
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		if (!mPackStream.isNull())
+			return;
+
+		DataStreamPtr packStream(OGRE_NEW MappedFileDataStream(mName, mName));
+		const uchar* base = packStream->getDataPtr();
+		size_t fileSize = packStream->size();
+
+		// Signature at the start, header at the end
+		uint32 signature[2];
+		Header header;
+		bool valid = fileSize >= sizeof(signature) + sizeof(Header);
+		if (valid)
+		{
+			memcpy(signature, base, sizeof(signature));
+			memcpy(&header, base + fileSize - sizeof(Header), sizeof(Header));
+#if OGRE_ENDIAN == OGRE_ENDIAN_BIG
+			flipEndian(signature[0]);
+			flipEndian(signature[1]);
+			flipEndian(header);
+#endif
+			valid = signature[0] == MAGIC && signature[1] == VERSION &&
+				header.magic == MAGIC && header.version == VERSION &&
+				header.chunkSize > 0 &&
+				header.hashSize > 0 && (header.hashSize & (header.hashSize - 1)) == 0 &&
+				header.indexOffset <= fileSize - sizeof(Header) &&
+				header.indexSize <= fileSize - sizeof(Header) - header.indexOffset &&
+				header.indexSize >= header.hashSize * sizeof(uint32) + 
+					header.entryCount * sizeof(Entry) + header.chunkOffsetCount * sizeof(uint32);
+		}
+		if (!valid)
+		{
+			OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
+				mName + " - error whilst opening archive: not a valid pack archive.",
+				"PackArchive::load");
+		}
+
+		// Read the whole index at once
+		mIndex.resize(static_cast<size_t>(header.indexSize));
+		packStream->seek(static_cast<size_t>(header.indexOffset));
+		packStream->read(&mIndex[0], mIndex.size());
+
+		uchar* pIndex = &mIndex[0];
+		uint32* hashTable = reinterpret_cast<uint32*>(pIndex);
+		pIndex += header.hashSize * sizeof(uint32);
+		Entry* entries = reinterpret_cast<Entry*>(pIndex);
+		pIndex += header.entryCount * sizeof(Entry);
+		uint32* chunkOffsets = reinterpret_cast<uint32*>(pIndex);
+		pIndex += header.chunkOffsetCount * sizeof(uint32);
+		const char* names = reinterpret_cast<const char*>(pIndex);
+		size_t namesSize = mIndex.size() - (pIndex - &mIndex[0]);
+
+#if OGRE_ENDIAN == OGRE_ENDIAN_BIG
+		for (uint32 i = 0; i < header.hashSize; ++i)
+			flipEndian(hashTable[i]);
+		for (uint32 i = 0; i < header.entryCount; ++i)
+			flipEndian(entries[i]);
+		for (uint32 i = 0; i < header.chunkOffsetCount; ++i)
+			flipEndian(chunkOffsets[i]);
+#endif
+
+		// Check the entries refer to valid areas, and cache their info
+		mFileList.clear();
+		mFileList.reserve(header.entryCount);
+		for (uint32 i = 0; i < header.entryCount && valid; ++i)
+		{
+			const Entry& e = entries[i];
+			valid = e.nameOffset <= namesSize && e.nameLength <= namesSize - e.nameOffset &&
+				e.offset <= fileSize && e.compressedSize <= fileSize - e.offset;
+			if (valid && (e.flags & EF_COMPRESSED))
+			{
+				uint64 numChunks = (e.size + header.chunkSize - 1) / header.chunkSize;
+				valid = e.firstChunk <= header.chunkOffsetCount &&
+					numChunks < header.chunkOffsetCount - e.firstChunk &&
+					chunkOffsets[e.firstChunk + numChunks] <= e.compressedSize;
+			}
+			else if (valid && !(e.flags & EF_DIRECTORY))
+			{
+				valid = e.size == e.compressedSize;
+			}
+			if (!valid)
+				break;
+
+			FileInfo info;
+			info.archive = this;
+			info.filename.assign(names + e.nameOffset, e.nameLength);
+			StringUtil::splitFilename(info.filename, info.basename, info.path);
+			info.uncompressedSize = static_cast<size_t>(e.size);
+			// Set compressed size to -1 for folders, as Zip does
+			info.compressedSize = (e.flags & EF_DIRECTORY) ? 
+				size_t(-1) : static_cast<size_t>(e.compressedSize);
+			mFileList.push_back(info);
+		}
+		if (!valid)
+		{
+			mIndex.clear();
+			mFileList.clear();
+			OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
+				mName + " - error whilst opening archive: corrupted index.",
+				"PackArchive::load");
+		}
+
+		mHeader = header;
+		mHashTable = hashTable;
+		mEntries = entries;
+		mChunkOffsets = chunkOffsets;
+		mNames = names;
+		mPackStream = packStream;
+	}
+	//-----------------------------------------------------------------------
+	void PackArchive::unload()
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		// Open streams keep the mapping alive until they're closed
+		mPackStream.setNull();
+		mIndex.clear();
+		mFileList.clear();
+		mHashTable = 0;
+		mEntries = 0;
+		mChunkOffsets = 0;
+		mNames = 0;
+		memset(&mHeader, 0, sizeof(Header));
+	}
+	//-----------------------------------------------------------------------
+	const Entry* PackArchive::findEntry(const String& filename) const
+	{
+		if (!mHashTable)
+			return 0;
+
+		uint32 hash = hashName(filename);
+		uint32 mask = mHeader.hashSize - 1;
+		for (uint32 probe = 0, slot = hash & mask; probe < mHeader.hashSize; 
+			++probe, slot = (slot + 1) & mask)
+		{
+			uint32 index = mHashTable[slot];
+			if (index == 0 || index > mHeader.entryCount)
+				return 0;
+			const Entry& e = mEntries[index - 1];
+			if (e.hash == hash && namesEqual(mNames + e.nameOffset, e.nameLength, filename))
+				return &e;
+		}
+		return 0;
+	}
+	//-----------------------------------------------------------------------
+	String PackArchive::getEntryName(const Entry& entry) const
+	{
+		return String(mNames + entry.nameOffset, entry.nameLength);
+	}
+	//-----------------------------------------------------------------------
+	DataStreamPtr PackArchive::open(const String& filename, bool readOnly) const
+	{
+		OGRE_LOCK_AUTO_MUTEX
+
+		const Entry* e = findEntry(filename);
+		if (!e || (e->flags & EF_DIRECTORY))
+		{
+			LogManager::getSingleton().logMessage(
+				mName + " - Unable to open file " + filename + ", error was 'File not found.'");
+			// return null pointer
+			return DataStreamPtr();
+		}
+
+		const uchar* data = mPackStream->getDataPtr() + e->offset;
+		size_t size = static_cast<size_t>(e->size);
+		if (e->flags & EF_COMPRESSED)
+		{
+			size_t numChunks = (size + mHeader.chunkSize - 1) / mHeader.chunkSize;
+			return DataStreamPtr(OGRE_NEW PackDataStream(filename, mPackStream, data, size,
+				mChunkOffsets + e->firstChunk, numChunks, mHeader.chunkSize));
+		}
+		else
+		{
+			return DataStreamPtr(OGRE_NEW PackDataStream(filename, mPackStream, data, size,
+				0, 0, mHeader.chunkSize));
+		}
+	}
+	//---------------------------------------------------------------------
+	DataStreamPtr PackArchive::create(const String& filename) const
+	{
+		OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, 
+			"Modification of pack archives is not supported, use PackArchiveWriter", 
+			"PackArchive::create");
+	}
+	//---------------------------------------------------------------------
+	void PackArchive::remove(const String& filename) const
+	{
+	}
+	//-----------------------------------------------------------------------
+	StringVectorPtr PackArchive::list(bool recursive, bool dirs)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		StringVectorPtr ret = StringVectorPtr(OGRE_NEW_T(StringVector, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+
+		FileInfoList::iterator i, iend;
+		iend = mFileList.end();
+		for (i = mFileList.begin(); i != iend; ++i)
+			if ((dirs == (i->compressedSize == size_t (-1))) &&
+				(recursive || i->path.empty()))
+				ret->push_back(i->filename);
+
+		return ret;
+	}
+	//-----------------------------------------------------------------------
+	FileInfoListPtr PackArchive::listFileInfo(bool recursive, bool dirs)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		FileInfoList* fil = OGRE_NEW_T(FileInfoList, MEMCATEGORY_GENERAL)();
+		FileInfoList::const_iterator i, iend;
+		iend = mFileList.end();
+		for (i = mFileList.begin(); i != iend; ++i)
+			if ((dirs == (i->compressedSize == size_t (-1))) &&
+				(recursive || i->path.empty()))
+				fil->push_back(*i);
+
+		return FileInfoListPtr(fil, SPFM_DELETE_T);
+	}
+	//-----------------------------------------------------------------------
+	StringVectorPtr PackArchive::find(const String& pattern, bool recursive, bool dirs)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		StringVectorPtr ret = StringVectorPtr(OGRE_NEW_T(StringVector, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+		// If pattern contains a directory name, do a full match
+		bool full_match = (pattern.find ('/') != String::npos) ||
+						  (pattern.find ('\\') != String::npos);
+
+		FileInfoList::iterator i, iend;
+		iend = mFileList.end();
+		for (i = mFileList.begin(); i != iend; ++i)
+			if ((dirs == (i->compressedSize == size_t (-1))) &&
+				(recursive || full_match || i->path.empty()))
+				// Check basename matches pattern (packs are case insensitive)
+				if (StringUtil::match(full_match ? i->filename : i->basename, pattern, false))
+					ret->push_back(i->filename);
+
+		return ret;
+	}
+	//-----------------------------------------------------------------------
+	FileInfoListPtr PackArchive::findFileInfo(const String& pattern, 
+		bool recursive, bool dirs)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		FileInfoListPtr ret = FileInfoListPtr(OGRE_NEW_T(FileInfoList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+		// If pattern contains a directory name, do a full match
+		bool full_match = (pattern.find ('/') != String::npos) ||
+						  (pattern.find ('\\') != String::npos);
+
+		FileInfoList::iterator i, iend;
+		iend = mFileList.end();
+		for (i = mFileList.begin(); i != iend; ++i)
+			if ((dirs == (i->compressedSize == size_t (-1))) &&
+				(recursive || full_match || i->path.empty()))
+				// Check name matches pattern (packs are case insensitive)
+				if (StringUtil::match(full_match ? i->filename : i->basename, pattern, false))
+					ret->push_back(*i);
+
+		return ret;
+	}
+	//-----------------------------------------------------------------------
+	bool PackArchive::exists(const String& filename)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		return findEntry(filename) != 0;
+	}
+	//---------------------------------------------------------------------
+	time_t PackArchive::getModifiedTime(const String& filename)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		const Entry* e = findEntry(filename);
+		return e ? static_cast<time_t>(e->modifiedTime) : 0;
+	}
+	//-----------------------------------------------------------------------
+	const String& PackArchiveFactory::getType(void) const
+	{
+		static String name = "Pack";
+		return name;
+	}
+	//-----------------------------------------------------------------------
+	//-----------------------------------------------------------------------
+	PackDataStream::PackDataStream(const String& name, const DataStreamPtr& packStream,
+		const uchar* data, size_t size, const uint32* chunkOffsets, 
+		size_t numChunks, size_t chunkSize)
+		: DataStream(name), mPackStream(packStream), mData(data), mChunkSize(chunkSize),
+		mPos(0), mChunkBuffer(0), mCachedChunk(0)
+	{
+		mSize = size;
+		if (chunkOffsets)
+			mChunkOffsets.assign(chunkOffsets, chunkOffsets + numChunks + 1);
+	}
+	//-----------------------------------------------------------------------
+	PackDataStream::~PackDataStream()
+	{
+		close();
+	}
+	//-----------------------------------------------------------------------
+	size_t PackDataStream::read(void* buf, size_t count)
+	{
+		if (!mData || mPos >= mSize)
+			return 0;
+		count = std::min(count, mSize - mPos);
+		
+		if (mChunkOffsets.empty())
+		{
+			memcpy(buf, mData + mPos, count);
+			mPos += count;
+			return count;
+		}
+
+		uchar* dest = static_cast<uchar*>(buf);
+		size_t remaining = count;
+		size_t numChunks = mChunkOffsets.size() - 1;
+		while (remaining)
+		{
+			size_t chunk = mPos / mChunkSize;
+			size_t offset = mPos - chunk * mChunkSize;
+
+			if (offset == 0)
+			{
+				// Whole chunks covered by the read go straight to the destination
+				size_t end = mPos + remaining;
+				size_t endChunk = (end == mSize) ? numChunks : end / mChunkSize;
+				if (endChunk > chunk + 1)
+				{
+					DeflateChunks::InflateTask<uint32> task(mData + mChunkOffsets[chunk], 
+						&mChunkOffsets[chunk], dest, mChunkSize, mSize - mPos, 
+						mName, "PackDataStream::read");
+					ParallelTasks::run(task, endChunk - chunk);
+
+					size_t done = std::min(remaining, (endChunk - chunk) * mChunkSize);
+					dest += done;
+					remaining -= done;
+					mPos += done;
+					continue;
+				}
+			}
+
+			if (!mChunkBuffer || mCachedChunk != chunk)
+			{
+				if (!mChunkBuffer)
+					mChunkBuffer = OGRE_ALLOC_T(uchar, mChunkSize, MEMCATEGORY_GENERAL);
+				size_t chunkStart = chunk * mChunkSize;
+				DeflateChunks::InflateTask<uint32> task(mData + mChunkOffsets[chunk], 
+					&mChunkOffsets[chunk], mChunkBuffer, mChunkSize, mSize - chunkStart, 
+					mName, "PackDataStream::read");
+				task.run(0);
+				mCachedChunk = chunk;
+			}
+
+			size_t cnt = std::min(remaining, std::min(mChunkSize, mSize - chunk * mChunkSize) - offset);
+			memcpy(dest, mChunkBuffer + offset, cnt);
+			dest += cnt;
+			remaining -= cnt;
+			mPos += cnt;
+		}
+
+		return count;
+	}
+	//-----------------------------------------------------------------------
+	void PackDataStream::skip(long count)
+	{
+		if (count < 0 && static_cast<size_t>(-count) > mPos)
+			mPos = 0;
+		else
+			mPos = std::min(mSize, mPos + count);
+	}
+	//-----------------------------------------------------------------------
+	void PackDataStream::seek( size_t pos )
+	{
+		mPos = std::min(pos, mSize);
+	}
+	//-----------------------------------------------------------------------
+	size_t PackDataStream::tell(void) const
+	{
+		return mPos;
+	}
+	//-----------------------------------------------------------------------
+	bool PackDataStream::eof(void) const
+	{
+		return mPos >= mSize;
+	}
+	//-----------------------------------------------------------------------
+	const uchar* PackDataStream::getDataPtr(void) const
+	{
+		return mChunkOffsets.empty() ? mData : 0;
+	}
+	//-----------------------------------------------------------------------
+	void PackDataStream::close(void)
+	{
+		if (mChunkBuffer)
+		{
+			OGRE_FREE(mChunkBuffer, MEMCATEGORY_GENERAL);
+			mChunkBuffer = 0;
+		}
+		mChunkOffsets.clear();
+		mData = 0;
+		mPackStream.setNull();
+	}
+	//-----------------------------------------------------------------------
+	//-----------------------------------------------------------------------
+	PackArchiveWriter::PackArchiveWriter()
+		: mAlignment(16), mChunkSize(DEFAULT_CHUNK_SIZE), mCompressionLevel(9)
+	{
+	}
+	//-----------------------------------------------------------------------
+	PackArchiveWriter::~PackArchiveWriter()
+	{
+	}
+	//-----------------------------------------------------------------------
+	void PackArchiveWriter::addFile(const String& name, const DataStreamPtr& stream,
+		bool compress, time_t modifiedTime)
+	{
+		PendingFile f;
+		f.name = name;
+		f.stream = stream;
+		f.archive = 0;
+		f.compress = compress;
+		f.modifiedTime = modifiedTime;
+		mFiles.push_back(f);
+	}
+	//-----------------------------------------------------------------------
+	void PackArchiveWriter::addArchive(Archive* archive, bool compress)
+	{
+		// Files are only opened when writing, to avoid holding thousands open
+		StringVectorPtr names = archive->list(true, false);
+		for (StringVector::iterator i = names->begin(); i != names->end(); ++i)
+		{
+			PendingFile f;
+			f.name = *i;
+			f.archive = archive;
+			f.compress = compress;
+			f.modifiedTime = archive->getModifiedTime(*i);
+			mFiles.push_back(f);
+		}
+	}
+	//-----------------------------------------------------------------------
+	static void writePackData(const DataStreamPtr& stream, const void* data, size_t size)
+	{
+		if (size && stream->write(data, size) != size)
+		{
+			OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE, 
+				"Error writing pack archive " + stream->getName(),
+				"PackArchiveWriter::write");
+		}
+	}
+	//-----------------------------------------------------------------------
+	void PackArchiveWriter::write(const DataStreamPtr& stream)
+	{
+		// Entries sorted by name; directories map to no file, later files
+		// with the same name replace earlier ones
+		typedef map<String, const PendingFile*>::type EntryMap;
+		EntryMap entryMap;
+		for (PendingFileList::iterator i = mFiles.begin(); i != mFiles.end(); ++i)
+		{
+			String name = i->name;
+			std::replace(name.begin(), name.end(), '\\', '/');
+			i->name = name;
+			entryMap[name] = &(*i);
+			for (size_t slash = name.find('/'); slash != String::npos; slash = name.find('/', slash + 1))
+			{
+				String dir = name.substr(0, slash);
+				if (entryMap.find(dir) == entryMap.end())
+					entryMap[dir] = 0;
+			}
+		}
+
+		size_t chunkSize = std::max(mChunkSize, size_t(1024));
+		vector<Entry>::type entries;
+		vector<uint32>::type chunkOffsets;
+		String names;
+		entries.reserve(entryMap.size());
+
+		uint32 signature[2] = { MAGIC, VERSION };
+#if OGRE_ENDIAN == OGRE_ENDIAN_BIG
+		flipEndian(signature[0]);
+		flipEndian(signature[1]);
+#endif
+		writePackData(stream, signature, sizeof(signature));
+		uint64 offset = sizeof(signature);
+		const uchar zeros[256] = { 0 };
+
+		for (EntryMap::iterator i = entryMap.begin(); i != entryMap.end(); ++i)
+		{
+			Entry e;
+			memset(&e, 0, sizeof(Entry));
+			e.hash = hashName(i->first);
+			e.nameOffset = static_cast<uint32>(names.size());
+			e.nameLength = static_cast<uint32>(i->first.size());
+			names += i->first;
+
+			const PendingFile* f = i->second;
+			if (!f)
+			{
+				e.flags = EF_DIRECTORY;
+				entries.push_back(e);
+				continue;
+			}
+			e.modifiedTime = static_cast<int64>(f->modifiedTime);
+
+			DataStreamPtr src = f->archive ? f->archive->open(f->name) : f->stream;
+			if (src.isNull())
+			{
+				OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, 
+					"Cannot open file " + f->name, "PackArchiveWriter::write");
+			}
+			MemoryDataStream data(src);
+			src->close();
+			e.size = data.size();
+
+			bool compressed = false;
+			if (f->compress && data.size() > 0)
+			{
+				DeflateChunks::DeflateTask task(data.getPtr(), data.size(), chunkSize, mCompressionLevel);
+				ParallelTasks::run(task, task.getChunkCount());
+
+				size_t total = 0;
+				for (size_t c = 0; c < task.sizes.size(); ++c)
+					total += task.sizes[c];
+				// Only worth it if at least a tenth is saved
+				if (total * 10 <= data.size() * 9)
+				{
+					compressed = true;
+					e.flags = EF_COMPRESSED;
+					e.offset = offset;
+					e.compressedSize = total;
+					e.firstChunk = static_cast<uint32>(chunkOffsets.size());
+					uint32 chunkOffset = 0;
+					for (size_t c = 0; c < task.sizes.size(); ++c)
+					{
+						chunkOffsets.push_back(chunkOffset);
+						writePackData(stream, task.getChunk(c), task.sizes[c]);
+						chunkOffset += static_cast<uint32>(task.sizes[c]);
+					}
+					chunkOffsets.push_back(chunkOffset);
+					offset += total;
+				}
+			}
+
+			if (!compressed)
+			{
+				// Align stored files so they can be used in place
+				size_t alignment = std::max(mAlignment, size_t(1));
+				size_t padding = static_cast<size_t>((alignment - offset % alignment) % alignment);
+				while (padding)
+				{
+					size_t cnt = std::min(padding, sizeof(zeros));
+					writePackData(stream, zeros, cnt);
+					padding -= cnt;
+					offset += cnt;
+				}
+				e.offset = offset;
+				e.compressedSize = e.size;
+				writePackData(stream, data.getPtr(), data.size());
+				offset += data.size();
+			}
+
+			entries.push_back(e);
+		}
+
+		// Hash table, at most half full
+		uint32 hashSize = 16;
+		while (hashSize < entries.size() * 2)
+			hashSize <<= 1;
+		vector<uint32>::type hashTable(hashSize, 0);
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			uint32 slot = entries[i].hash & (hashSize - 1);
+			while (hashTable[slot])
+				slot = (slot + 1) & (hashSize - 1);
+			hashTable[slot] = static_cast<uint32>(i + 1);
+		}
+
+		Header header;
+		header.magic = MAGIC;
+		header.version = VERSION;
+		header.entryCount = static_cast<uint32>(entries.size());
+		header.hashSize = hashSize;
+		header.chunkSize = static_cast<uint32>(chunkSize);
+		header.chunkOffsetCount = static_cast<uint32>(chunkOffsets.size());
+		header.indexOffset = offset;
+		header.indexSize = hashTable.size() * sizeof(uint32) + entries.size() * sizeof(Entry) +
+			chunkOffsets.size() * sizeof(uint32) + names.size();
+
+#if OGRE_ENDIAN == OGRE_ENDIAN_BIG
+		for (size_t i = 0; i < hashTable.size(); ++i)
+			flipEndian(hashTable[i]);
+		for (size_t i = 0; i < entries.size(); ++i)
+			flipEndian(entries[i]);
+		for (size_t i = 0; i < chunkOffsets.size(); ++i)
+			flipEndian(chunkOffsets[i]);
+		flipEndian(header);
+#endif
+
+		writePackData(stream, &hashTable[0], hashTable.size() * sizeof(uint32));
+		if (!entries.empty())
+			writePackData(stream, &entries[0], entries.size() * sizeof(Entry));
+		if (!chunkOffsets.empty())
+			writePackData(stream, &chunkOffsets[0], chunkOffsets.size() * sizeof(uint32));
+		writePackData(stream, names.c_str(), names.size());
+		writePackData(stream, &header, sizeof(Header));
+	}
+
+}
@@ -0,0 +1,323 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgrePackedParticleData.h"
+#include "OgreParticle.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_SSE
+// Keep this include last, see OgreOptimisedUtilSSE.cpp
+#include "OgreSIMDHelper.h"
+#endif
+
+namespace Ogre
+{
+#if __OGRE_HAVE_SSE
+	//---------------------------------------------------------------------
+	static bool hasSSE(void)
+	{
+		static const bool sse =
+			(PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE) != 0;
+		return sse;
+	}
+#endif
+	//---------------------------------------------------------------------
+	PackedParticleData::PackedParticleData()
+		: positionX(0), positionY(0), positionZ(0)
+		, directionX(0), directionY(0), directionZ(0)
+		, colourR(0), colourG(0), colourB(0), colourA(0)
+		, width(0), height(0)
+		, rotation(0), rotationSpeed(0)
+		, timeToLive(0), totalTimeToLive(0)
+		, ownDimensions(0)
+		, mBuffer(0)
+		, mBackBuffer(0)
+		, mCapacity(0)
+		, mSize(0)
+	{
+	}
+	//---------------------------------------------------------------------
+	PackedParticleData::~PackedParticleData()
+	{
+		OGRE_FREE_SIMD(mBuffer, MEMCATEGORY_SCENE_OBJECTS);
+		OGRE_FREE_SIMD(mBackBuffer, MEMCATEGORY_SCENE_OBJECTS);
+	}
+	//---------------------------------------------------------------------
+	size_t PackedParticleData::getBufferSize(size_t stride)
+	{
+		return stride * (NUM_FLOAT_STREAMS * sizeof(float) + sizeof(uint8));
+	}
+	//---------------------------------------------------------------------
+	void PackedParticleData::assignStreams(void* buffer, size_t stride)
+	{
+		float* f = static_cast<float*>(buffer);
+		positionX = f; f += stride;
+		positionY = f; f += stride;
+		positionZ = f; f += stride;
+		directionX = f; f += stride;
+		directionY = f; f += stride;
+		directionZ = f; f += stride;
+		colourR = f; f += stride;
+		colourG = f; f += stride;
+		colourB = f; f += stride;
+		colourA = f; f += stride;
+		width = f; f += stride;
+		height = f; f += stride;
+		rotation = f; f += stride;
+		rotationSpeed = f; f += stride;
+		timeToLive = f; f += stride;
+		totalTimeToLive = f; f += stride;
+		ownDimensions = reinterpret_cast<uint8*>(f);
+	}
+	//---------------------------------------------------------------------
+	void PackedParticleData::setCapacity(size_t capacity)
+	{
+		if (capacity == mCapacity)
+			return;
+
+		size_t oldStride = getStride();
+		void* oldBuffer = mBuffer;
+
+		mCapacity = capacity;
+		size_t stride = getStride();
+		mBuffer = stride ?
+			OGRE_MALLOC_SIMD(getBufferSize(stride), MEMCATEGORY_SCENE_OBJECTS) : 0;
+		// Padding is processed by the stream operations, so keep it finite
+		if (mBuffer)
+			memset(mBuffer, 0, getBufferSize(stride));
+		OGRE_FREE_SIMD(mBackBuffer, MEMCATEGORY_SCENE_OBJECTS);
+		mBackBuffer = 0;
+
+		// Preserve existing particles
+		mSize = std::min(mSize, mCapacity);
+		if (oldBuffer && mSize)
+		{
+			const float* src = static_cast<const float*>(oldBuffer);
+			float* dest = static_cast<float*>(mBuffer);
+			for (size_t s = 0; s < NUM_FLOAT_STREAMS; ++s)
+			{
+				memcpy(dest + s * stride, src + s * oldStride, mSize * sizeof(float));
+			}
+			memcpy(dest + NUM_FLOAT_STREAMS * stride, src + NUM_FLOAT_STREAMS * oldStride, mSize);
+		}
+		OGRE_FREE_SIMD(oldBuffer, MEMCATEGORY_SCENE_OBJECTS);
+
+		assignStreams(mBuffer, stride);
+	}
+	//---------------------------------------------------------------------
+	size_t PackedParticleData::allocate(size_t count)
+	{
+		count = std::min(count, mCapacity - mSize);
+		mSize += count;
+		return count;
+	}
+	//---------------------------------------------------------------------
+	void PackedParticleData::move(size_t src, size_t dest)
+	{
+		float* f = static_cast<float*>(mBuffer);
+		size_t stride = getStride();
+		for (size_t s = 0; s < NUM_FLOAT_STREAMS; ++s, f += stride)
+		{
+			f[dest] = f[src];
+		}
+		ownDimensions[dest] = ownDimensions[src];
+	}
+	//---------------------------------------------------------------------
+	void PackedParticleData::remove(size_t index)
+	{
+		assert(index < mSize && "Index out of bounds!");
+		--mSize;
+		if (index != mSize)
+			move(mSize, index);
+	}
+	//---------------------------------------------------------------------
+	size_t PackedParticleData::expire(Real timeElapsed)
+	{
+		size_t oldSize = mSize;
+		size_t i = 0;
+		while (i < mSize)
+		{
+			if (timeToLive[i] < timeElapsed)
+			{
+				// Don't advance, the last particle has been moved here
+				remove(i);
+			}
+			else
+			{
+				timeToLive[i] -= timeElapsed;
+				++i;
+			}
+		}
+		return oldSize - mSize;
+	}
+	//---------------------------------------------------------------------
+	void PackedParticleData::applyMotion(Real timeElapsed)
+	{
+		float t = static_cast<float>(timeElapsed);
+		addScaledStream(positionX, directionX, t);
+		addScaledStream(positionY, directionY, t);
+		addScaledStream(positionZ, directionZ, t);
+	}
+	//---------------------------------------------------------------------
+	void PackedParticleData::addToStream(float* stream, float value)
+	{
+		size_t count = getStreamCount();
+#if __OGRE_HAVE_SSE
+		if (hasSSE())
+		{
+			__m128 v = _mm_set1_ps(value);
+			for (size_t i = 0; i < count; i += 4)
+			{
+				_mm_store_ps(stream + i, _mm_add_ps(_mm_load_ps(stream + i), v));
+			}
+			return;
+		}
+#endif
+		for (size_t i = 0; i < count; ++i)
+			stream[i] += value;
+	}
+	//---------------------------------------------------------------------
+	void PackedParticleData::scaleAddStream(float* stream, float scale, float value)
+	{
+		size_t count = getStreamCount();
+#if __OGRE_HAVE_SSE
+		if (hasSSE())
+		{
+			__m128 s = _mm_set1_ps(scale);
+			__m128 v = _mm_set1_ps(value);
+			for (size_t i = 0; i < count; i += 4)
+			{
+				_mm_store_ps(stream + i,
+					_mm_add_ps(_mm_mul_ps(_mm_load_ps(stream + i), s), v));
+			}
+			return;
+		}
+#endif
+		for (size_t i = 0; i < count; ++i)
+			stream[i] = stream[i] * scale + value;
+	}
+	//---------------------------------------------------------------------
+	void PackedParticleData::addClampStream(float* stream, float value,
+		float minValue, float maxValue)
+	{
+		size_t count = getStreamCount();
+#if __OGRE_HAVE_SSE
+		if (hasSSE())
+		{
+			__m128 v = _mm_set1_ps(value);
+			__m128 lo = _mm_set1_ps(minValue);
+			__m128 hi = _mm_set1_ps(maxValue);
+			for (size_t i = 0; i < count; i += 4)
+			{
+				__m128 r = _mm_add_ps(_mm_load_ps(stream + i), v);
+				_mm_store_ps(stream + i, _mm_min_ps(_mm_max_ps(r, lo), hi));
+			}
+			return;
+		}
+#endif
+		for (size_t i = 0; i < count; ++i)
+		{
+			float r = stream[i] + value;
+			stream[i] = r < minValue ? minValue : (r > maxValue ? maxValue : r);
+		}
+	}
+	//---------------------------------------------------------------------
+	void PackedParticleData::addScaledStream(float* dest, const float* src, float scale)
+	{
+		size_t count = getStreamCount();
+#if __OGRE_HAVE_SSE
+		if (hasSSE())
+		{
+			__m128 s = _mm_set1_ps(scale);
+			for (size_t i = 0; i < count; i += 4)
+			{
+				_mm_store_ps(dest + i,
+					_mm_add_ps(_mm_load_ps(dest + i), _mm_mul_ps(_mm_load_ps(src + i), s)));
+			}
+			return;
+		}
+#endif
+		for (size_t i = 0; i < count; ++i)
+			dest[i] += src[i] * scale;
+	}
+	//---------------------------------------------------------------------
+	void PackedParticleData::reorder(const uint32* order)
+	{
+		size_t stride = getStride();
+		if (!mBackBuffer)
+		{
+			mBackBuffer = OGRE_MALLOC_SIMD(getBufferSize(stride), MEMCATEGORY_SCENE_OBJECTS);
+			memset(mBackBuffer, 0, getBufferSize(stride));
+		}
+
+		const float* src = static_cast<const float*>(mBuffer);
+		float* dest = static_cast<float*>(mBackBuffer);
+		for (size_t s = 0; s < NUM_FLOAT_STREAMS; ++s, src += stride, dest += stride)
+		{
+			for (size_t i = 0; i < mSize; ++i)
+				dest[i] = src[order[i]];
+		}
+		const uint8* srcOwn = ownDimensions;
+		uint8* destOwn = reinterpret_cast<uint8*>(dest);
+		for (size_t i = 0; i < mSize; ++i)
+			destOwn[i] = srcOwn[order[i]];
+
+		std::swap(mBuffer, mBackBuffer);
+		assignStreams(mBuffer, stride);
+	}
+	//---------------------------------------------------------------------
+	void PackedParticleData::readParticle(size_t index, Particle* p) const
+	{
+		p->position = getPosition(index);
+		p->direction = getDirection(index);
+		p->colour = getColour(index);
+		p->mOwnDimensions = ownDimensions[index] != 0;
+		p->mWidth = width[index];
+		p->mHeight = height[index];
+		p->rotation = Radian(rotation[index]);
+		p->rotationSpeed = Radian(rotationSpeed[index]);
+		p->timeToLive = timeToLive[index];
+		p->totalTimeToLive = totalTimeToLive[index];
+	}
+	//---------------------------------------------------------------------
+	void PackedParticleData::writeParticle(size_t index, const Particle* p)
+	{
+		setPosition(index, p->position);
+		setDirection(index, p->direction);
+		setColour(index, p->colour);
+		ownDimensions[index] = p->mOwnDimensions ? 1 : 0;
+		width[index] = p->mWidth;
+		height[index] = p->mHeight;
+		rotation[index] = p->rotation.valueRadians();
+		rotationSpeed[index] = p->rotationSpeed.valueRadians();
+		timeToLive[index] = p->timeToLive;
+		totalTimeToLive[index] = p->totalTimeToLive;
+	}
+
+}
@@ -0,0 +1,272 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreParallelTasks.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include "OgreException.h"
+#include <new>
+
+namespace Ogre
+{
+	namespace
+	{
+		/// State of one call to ParallelTasks::run, shared with the worker threads
+		struct ParallelJob
+		{
+			ParallelTasks::Task* task;
+			size_t count;
+			size_t next;
+			size_t completed;
+			String error;
+			bool failed;
+			bool outOfMemory;
+			OGRE_MUTEX(mutex)
+#ifdef OGRE_THREAD_SYNCHRONISER
+			OGRE_THREAD_SYNCHRONISER(sync)
+#endif
+
+			ParallelJob(ParallelTasks::Task* t, size_t c)
+				: task(t), count(c), next(0), completed(0), failed(false), outOfMemory(false) {}
+
+			/// Records the first failure of a task
+			void setError(const String& description, bool noMemory = false)
+			{
+				OGRE_LOCK_MUTEX(mutex)
+				if (failed)
+					return;
+				failed = true;
+				outOfMemory = noMemory;
+				error = description;
+			}
+
+			/// Runs tasks until none are left to claim
+			void runTasks(void)
+			{
+				while (true)
+				{
+					size_t index;
+					{
+						OGRE_LOCK_MUTEX(mutex)
+						if (next >= count)
+							return;
+						index = next++;
+					}
+
+					try
+					{
+						task->run(index);
+					}
+					catch (Exception& e)
+					{
+						setError(e.getFullDescription());
+					}
+					catch (std::bad_alloc&)
+					{
+						setError("out of memory", true);
+					}
+					catch (std::exception& e)
+					{
+						setError(e.what());
+					}
+					catch (...)
+					{
+						setError("unknown exception");
+					}
+
+					{
+						OGRE_LOCK_MUTEX(mutex)
+						++completed;
+#ifdef OGRE_THREAD_SYNCHRONISER
+						if (completed == count)
+						{
+							OGRE_THREAD_NOTIFY_ALL(sync)
+						}
+#endif
+					}
+				}
+			}
+		};
+		typedef SharedPtr<ParallelJob> ParallelJobPtr;
+
+		/// Request data; keeps the job alive for requests picked up after run returned
+		struct ParallelJobRequest
+		{
+			ParallelJobPtr job;
+
+			ParallelJobRequest(const ParallelJobPtr& j) : job(j) {}
+
+			friend std::ostream& operator<<(std::ostream& o, const ParallelJobRequest& r)
+			{ (void)r; return o; }
+		};
+
+#if OGRE_THREAD_SUPPORT
+		/** Handler running jobs on the worker threads of Root's WorkQueue. */
+		class ParallelJobHandler : public WorkQueue::RequestHandler,
+			public WorkQueue::ResponseHandler
+		{
+		protected:
+			/// The queue we're registered with, only set while it exists
+			WorkQueue* mQueue;
+			uint16 mChannel;
+			OGRE_MUTEX(mMutex)
+		public:
+			ParallelJobHandler() : mQueue(0), mChannel(0) {}
+
+			void registerQueue(WorkQueue* queue)
+			{
+				OGRE_LOCK_MUTEX(mMutex)
+				mQueue = queue;
+				if (!queue)
+					return;
+				mChannel = queue->getChannel("Ogre/ParallelTasks");
+				queue->addRequestHandler(mChannel, this);
+				queue->addResponseHandler(mChannel, this);
+			}
+
+			void unregisterQueue(WorkQueue* queue)
+			{
+				OGRE_LOCK_MUTEX(mMutex)
+				if (!queue || queue != mQueue)
+					return;
+				queue->abortRequestsByChannel(mChannel);
+				queue->removeRequestHandler(mChannel, this);
+				queue->removeResponseHandler(mChannel, this);
+				mQueue = 0;
+			}
+
+			/** Issues requests for a job to Root's current queue.
+			@remarks
+				Does nothing if the queue can't be used, in which case the
+				calling thread runs all the tasks.
+			*/
+			void addRequests(const ParallelJobPtr& job, size_t numRequests)
+			{
+				OGRE_LOCK_MUTEX(mMutex)
+				Root* root = Root::getSingletonPtr();
+				WorkQueue* queue = root ? root->getWorkQueue() : 0;
+				if (!queue || queue != mQueue || 
+					queue->isPaused() || !queue->getRequestsAccepted())
+					return;
+				for (size_t i = 0; i < numRequests; ++i)
+					queue->addRequest(mChannel, 0, Any(ParallelJobRequest(job)));
+			}
+
+			WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+			{
+				ParallelJobRequest r = any_cast<ParallelJobRequest>(req->getData());
+				r.job->runTasks();
+				return OGRE_NEW WorkQueue::Response(req, true, Any());
+			}
+
+			void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+			{
+				// Nothing to do, run waits for the tasks directly
+			}
+		};
+
+		ParallelJobHandler& getJobHandler(void)
+		{
+			static ParallelJobHandler handler;
+			return handler;
+		}
+#endif
+	}
+	//---------------------------------------------------------------------
+	void ParallelTasks::run(Task& task, size_t count, size_t maxThreads)
+	{
+		if (count == 0)
+			return;
+
+		ParallelJobPtr job(OGRE_NEW_T(ParallelJob, MEMCATEGORY_GENERAL)(&task, count), SPFM_DELETE_T);
+
+#if OGRE_THREAD_SUPPORT
+		if (maxThreads == 0)
+			maxThreads = std::max(1u, (unsigned)OGRE_THREAD_HARDWARE_CONCURRENCY);
+
+		if (count > 1 && maxThreads > 1)
+		{
+			// Each request runs tasks until none are left, this thread helps too
+			getJobHandler().addRequests(job, std::min(count, maxThreads) - 1);
+		}
+#else
+		(void)maxThreads;
+#endif
+
+		job->runTasks();
+
+#if OGRE_THREAD_SUPPORT
+		{
+			// Wait for the tasks claimed by worker threads
+#ifdef OGRE_THREAD_SYNCHRONISER
+			OGRE_LOCK_MUTEX_NAMED(job->mutex, jobLock)
+			while (job->completed < job->count)
+				OGRE_THREAD_WAIT(job->sync, job->mutex, jobLock)
+#else
+			while (true)
+			{
+				{
+					OGRE_LOCK_MUTEX(job->mutex)
+					if (job->completed == job->count)
+						break;
+				}
+				OGRE_THREAD_SLEEP(0);
+			}
+#endif
+		}
+#endif
+
+		// Every task has completed, the first failure can be passed on
+		if (job->outOfMemory)
+			throw std::bad_alloc();
+		if (job->failed)
+		{
+			OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, job->error,
+				"ParallelTasks::run");
+		}
+	}
+	//---------------------------------------------------------------------
+	void ParallelTasks::_registerWorkQueue(WorkQueue* queue)
+	{
+#if OGRE_THREAD_SUPPORT
+		getJobHandler().registerQueue(queue);
+#else
+		(void)queue;
+#endif
+	}
+	//---------------------------------------------------------------------
+	void ParallelTasks::_unregisterWorkQueue(WorkQueue* queue)
+	{
+#if OGRE_THREAD_SUPPORT
+		getJobHandler().unregisterQueue(queue);
+#else
+		(void)queue;
+#endif
+	}
+
+}
@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include "OgreParticleEmitter.h"
 #include "OgreParticleEmitterFactory.h"
+#include "OgrePackedParticleData.h"
 
 namespace Ogre
 {
@@ -87,6 +88,17 @@ namespace Ogre
     {
     }
     //-----------------------------------------------------------------------
+    void ParticleEmitter::_initParticles(PackedParticleData& data, size_t first, size_t count)
+    {
+        Particle p;
+        p._notifyOwner(mParent);
+        for (size_t i = first; i < first + count; ++i)
+        {
+            _initParticle(&p);
+            data.writeParticle(i, &p);
+        }
+    }
+    //-----------------------------------------------------------------------
     void ParticleEmitter::setPosition(const Vector3& pos) 
     { 
         mPosition = pos; 
@@ -59,8 +59,7 @@ namespace Ogre {
 	ParticleSystem::CmdLocalSpace ParticleSystem::msLocalSpaceCmd;
 	ParticleSystem::CmdIterationInterval ParticleSystem::msIterationIntervalCmd;
 	ParticleSystem::CmdNonvisibleTimeout ParticleSystem::msNonvisibleTimeoutCmd;
-
-    RadixSort<ParticleSystem::ActiveParticleList, Particle*, float> ParticleSystem::mRadixSorter;
+	ParticleSystem::CmdPackedStorage ParticleSystem::msPackedStorageCmd;
 
     Real ParticleSystem::msDefaultIterationInterval = 0;
     Real ParticleSystem::msDefaultNonvisibleTimeout = 0;
@@ -76,7 +75,14 @@ namespace Ogre {
 
 		Real getValue(void) const { return 0; } // N/A
 
-		void setValue(Real value) { mTarget->_update(value); }
+		void setValue(Real value)
+		{
+			ParticleSystemManager& mgr = ParticleSystemManager::getSingleton();
+			if (mgr.getUseWorkerThreads())
+				mgr._queueUpdate(mTarget, value);
+			else
+				mTarget->_update(value);
+		}
 
 	};
     //-----------------------------------------------------------------------
@@ -86,6 +92,7 @@ namespace Ogre {
         mBoundsAutoUpdate(true),
         mBoundsUpdateTime(10.0f),
         mUpdateRemainTime(0),
+        mBoundsChanged(false),
         mWorldAABB(),
         mResourceGroupName(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME),
         mIsRendererConfigured(false),
@@ -101,6 +108,7 @@ namespace Ogre {
         mTimeController(0),
 		mEmittedEmitterPoolInitialised(false),
 		mIsEmitting(true),
+		mUsePackedStorage(false),
         mRenderer(0),
         mCullIndividual(false),
         mPoolSize(0),
@@ -120,6 +128,7 @@ namespace Ogre {
         mBoundsAutoUpdate(true),
         mBoundsUpdateTime(10.0f),
         mUpdateRemainTime(0),
+        mBoundsChanged(false),
         mWorldAABB(),
         mResourceGroupName(resourceGroup),
         mIsRendererConfigured(false),
@@ -135,6 +144,7 @@ namespace Ogre {
         mTimeController(0),
 		mEmittedEmitterPoolInitialised(false),
 		mIsEmitting(true),
+		mUsePackedStorage(false),
         mRenderer(0), 
         mCullIndividual(false),
         mPoolSize(0),
@@ -158,6 +168,9 @@ namespace Ogre {
             // Destroy controller
             ControllerManager::getSingleton().destroyController(mTimeController);
             mTimeController = 0;
+
+            // Drop any update queued by it
+            ParticleSystemManager::getSingleton()._cancelUpdate(this);
         }
 
 		// Arrange for the deletion of emitters & affectors
@@ -290,6 +303,7 @@ namespace Ogre {
 		mIterationIntervalSet = rhs.mIterationIntervalSet;
 		mNonvisibleTimeout = rhs.mNonvisibleTimeout;
 		mNonvisibleTimeoutSet = rhs.mNonvisibleTimeoutSet;
+		setUsePackedStorage(rhs.mUsePackedStorage);
 		// last frame visible and time since last visible should be left default
 
         setRenderer(rhs.getRendererName());
@@ -305,6 +319,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     size_t ParticleSystem::getNumParticles(void) const
     {
+		if (_isUsingPackedStorage())
+			return mPackedParticles.size();
         return mActiveParticles.size();
     }
     //-----------------------------------------------------------------------
@@ -361,10 +377,19 @@ namespace Ogre {
 	}
     //-----------------------------------------------------------------------
     void ParticleSystem::_update(Real timeElapsed)
+    {
+        if (_prepareUpdate(timeElapsed))
+        {
+            _updateParticles(timeElapsed);
+            _finishUpdate();
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::_prepareUpdate(Real timeElapsed)
     {
         // Only update if attached to a node
         if (!mParentNode)
-            return;
+            return false;
 
 		Real nonvisibleTimeout = mNonvisibleTimeoutSet ?
 			mNonvisibleTimeout : msDefaultNonvisibleTimeout;
@@ -380,20 +405,28 @@ namespace Ogre {
 				if (mTimeSinceLastVisible >= nonvisibleTimeout)
 				{
 					// No update
-					return;
+					return false;
 				}
 			}
 		}
 
-		// Scale incoming speed for the rest of the calculation
-		timeElapsed *= mSpeedFactor;
-
         // Init renderer if not done already
         configureRenderer();
 
 		// Initialise emitted emitters list if not done already
 		initialiseEmittedEmitters();
 
+		// Bring the cached node transforms up to date, so that the particle
+		// update only reads from the node
+		mParentNode->_getFullTransform();
+		return true;
+	}
+    //-----------------------------------------------------------------------
+	void ParticleSystem::_updateParticles(Real timeElapsed)
+	{
+		// Scale incoming speed for the rest of the calculation
+		timeElapsed *= mSpeedFactor;
+
 		Real iterationInterval = mIterationIntervalSet ? 
             mIterationInterval : msDefaultIterationInterval;
         if (iterationInterval > 0)
@@ -432,12 +465,29 @@ namespace Ogre {
 
         if (!mBoundsAutoUpdate && mBoundsUpdateTime > 0.0f)
             mBoundsUpdateTime -= timeElapsed; // count down 
-        _updateBounds();
+        if (calculateBounds())
+            mBoundsChanged = true;
 
     }
     //-----------------------------------------------------------------------
+    void ParticleSystem::_finishUpdate(void)
+    {
+        if (mBoundsChanged)
+        {
+            mBoundsChanged = false;
+            if (mParentNode)
+                mParentNode->needUpdate();
+        }
+    }
+    //-----------------------------------------------------------------------
     void ParticleSystem::_expire(Real timeElapsed)
     {
+		if (_isUsingPackedStorage())
+		{
+			mPackedParticles.expire(timeElapsed);
+			return;
+		}
+
         ActiveParticleList::iterator i, itEnd;
         Particle* pParticle;
 		ParticleEmitter* pParticleEmitter;
@@ -485,7 +535,7 @@ namespace Ogre {
     void ParticleSystem::_triggerEmitters(Real timeElapsed)
     {
         // Add up requests for emission
-        static vector<unsigned>::type requested;
+        vector<unsigned>::type& requested = mRequestedEmissions;
         if( requested.size() != mEmitters.size() )
             requested.resize( mEmitters.size() );
 
@@ -494,7 +544,8 @@ namespace Ogre {
 		ActiveEmittedEmitterList::iterator itActiveEmit;
         iEmitEnd = mEmitters.end();
         emitterCount = mEmitters.size();
-        emissionAllowed = mFreeParticles.size();
+        emissionAllowed = _isUsingPackedStorage() ?
+			mPackedParticles.getFreeCount() : mFreeParticles.size();
         totalRequested = 0;
 
         // Count up total requested emissions for regular emitters (and exclude the ones that are used as
@@ -553,6 +604,12 @@ namespace Ogre {
 		if(!requested) 
 			return;
 
+		if (_isUsingPackedStorage())
+		{
+			_executeTriggerEmittersPacked(emitter, requested, timeElapsed);
+			return;
+		}
+
 		Real timeInc = timeElapsed / requested;
 
 		for (unsigned int j = 0; j < requested; ++j)
@@ -608,8 +665,61 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void ParticleSystem::_executeTriggerEmittersPacked(ParticleEmitter* emitter, unsigned requested, Real timeElapsed)
+    {
+		PackedParticleData& data = mPackedParticles;
+		size_t first = data.size();
+		size_t count = data.allocate(requested);
+		if (!count)
+			return;
+
+		emitter->_initParticles(data, first, count);
+
+		Quaternion orientation = Quaternion::IDENTITY;
+		Vector3 scale = Vector3::UNIT_SCALE;
+		Vector3 translation = Vector3::ZERO;
+		if (!mLocalSpace)
+		{
+			orientation = mParentNode->_getDerivedOrientation();
+			scale = mParentNode->_getDerivedScale();
+			translation = mParentNode->_getDerivedPosition();
+		}
+
+		// Apply a subset of the frame's motion to each particle, as for
+		// the list based storage
+		Real timeInc = timeElapsed / requested;
+		Real timePoint = 0.0f;
+		for (size_t i = first; i < first + count; ++i)
+		{
+			Vector3 pos = data.getPosition(i);
+			Vector3 dir = data.getDirection(i);
+
+			// Translate position & direction into world space
+			if (!mLocalSpace)
+			{
+				pos = (orientation * (scale * pos)) + translation;
+				dir = orientation * dir;
+				data.setDirection(i, dir);
+			}
+
+			data.setPosition(i, pos + dir * timePoint);
+			timePoint += timeInc;
+		}
+
+		// apply particle initialization by the affectors
+		ParticleAffectorList::iterator itAff, itAffEnd = mAffectors.end();
+		for (itAff = mAffectors.begin(); itAff != itAffEnd; ++itAff)
+			(*itAff)->_initParticles(data, first, count);
+    }
+    //-----------------------------------------------------------------------
     void ParticleSystem::_applyMotion(Real timeElapsed)
     {
+		if (_isUsingPackedStorage())
+		{
+			mPackedParticles.applyMotion(timeElapsed);
+			return;
+		}
+
         ActiveParticleList::iterator i, itEnd;
         Particle* pParticle;
 		ParticleEmitter* pParticleEmitter;
@@ -637,14 +747,75 @@ namespace Ogre {
     void ParticleSystem::_triggerAffectors(Real timeElapsed)
     {
         ParticleAffectorList::iterator i, itEnd;
-        
         itEnd = mAffectors.end();
+
+		if (_isUsingPackedStorage())
+		{
+			// Affectors without packed support work through the particle
+			// iterator, so particles must be presented to them as Particle
+			// instances. Consecutive ones share the same copies.
+			bool proxies = false;
+			for (i = mAffectors.begin(); i != itEnd; ++i)
+			{
+				if ((*i)->_supportsPackedParticles())
+				{
+					if (proxies)
+					{
+						_checkinProxyParticles(true);
+						proxies = false;
+					}
+					(*i)->_affectParticles(this, mPackedParticles, timeElapsed);
+				}
+				else
+				{
+					if (!proxies)
+					{
+						_checkoutProxyParticles();
+						proxies = true;
+					}
+					(*i)->_affectParticles(this, timeElapsed);
+				}
+			}
+
+			if (proxies)
+				_checkinProxyParticles(true);
+			return;
+		}
+
         for (i = mAffectors.begin(); i != itEnd; ++i)
         {
             (*i)->_affectParticles(this, timeElapsed);
         }
-
     }
+    //-----------------------------------------------------------------------
+	void ParticleSystem::_checkoutProxyParticles(void)
+	{
+		size_t count = mPackedParticles.size();
+		assert(mActiveParticles.empty() && count <= mFreeParticles.size());
+
+		FreeParticleList::iterator i = mFreeParticles.begin();
+		for (size_t n = 0; n < count; ++n, ++i)
+		{
+			mPackedParticles.readParticle(n, *i);
+			(*i)->_notifyOwner(this);
+		}
+		mActiveParticles.splice(mActiveParticles.end(), mFreeParticles,
+			mFreeParticles.begin(), i);
+	}
+    //-----------------------------------------------------------------------
+	void ParticleSystem::_checkinProxyParticles(bool writeBack)
+	{
+		if (writeBack)
+		{
+			size_t n = 0;
+			ActiveParticleList::iterator i, iend = mActiveParticles.end();
+			for (i = mActiveParticles.begin(); i != iend; ++i, ++n)
+			{
+				mPackedParticles.writeParticle(n, *i);
+			}
+		}
+		mFreeParticles.splice(mFreeParticles.begin(), mActiveParticles);
+	}
     //-----------------------------------------------------------------------
     void ParticleSystem::increasePool(size_t size)
     {
@@ -675,6 +846,16 @@ namespace Ogre {
     //-----------------------------------------------------------------------
 	Particle* ParticleSystem::getParticle(size_t index) 
 	{
+		if (_isUsingPackedStorage() && mActiveParticles.empty())
+		{
+			// Return a copy, all pool particles are free at this point
+			assert (index < mPackedParticles.size() && "Index out of bounds!");
+			Particle* p = mParticlePool[index];
+			mPackedParticles.readParticle(index, p);
+			p->_notifyOwner(this);
+			return p;
+		}
+
 		assert (index < mActiveParticles.size() && "Index out of bounds!");
 		ActiveParticleList::iterator i = mActiveParticles.begin();
 		std::advance(i, index);
@@ -684,7 +865,7 @@ namespace Ogre {
     Particle* ParticleSystem::createParticle(void)
     {
 		Particle* p = 0;
-		if (!mFreeParticles.empty())
+		if (!mFreeParticles.empty() && !_isUsingPackedStorage())
 		{
 	        // Fast creation (don't use superclass since emitter will init)
 	        p = mFreeParticles.front();
@@ -724,7 +905,20 @@ namespace Ogre {
     {
         if (mRenderer)
         {
-            mRenderer->_updateRenderQueue(queue, mActiveParticles, mCullIndividual);
+			if (!_isUsingPackedStorage())
+			{
+				mRenderer->_updateRenderQueue(queue, mActiveParticles, mCullIndividual);
+			}
+			else if (mRenderer->_supportsPackedParticles())
+			{
+				mRenderer->_updateRenderQueue(queue, mPackedParticles, mCullIndividual);
+			}
+			else
+			{
+				_checkoutProxyParticles();
+				mRenderer->_updateRenderQueue(queue, mActiveParticles, mCullIndividual);
+				_checkinProxyParticles(false);
+			}
         }
     }
 	//---------------------------------------------------------------------
@@ -800,15 +994,26 @@ namespace Ogre {
 				PT_REAL),
 				&msNonvisibleTimeoutCmd);
 
+			dict->addParameter(ParameterDef("packed_storage", 
+				"Sets whether visual particles are kept in contiguous packed arrays "
+				"rather than as individual objects.",
+				PT_BOOL),
+				&msPackedStorageCmd);
+
         }
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_updateBounds()
     {
-
+        if (calculateBounds())
+            mParentNode->needUpdate();
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::calculateBounds(void)
+    {
         if (mParentNode && (mBoundsAutoUpdate || mBoundsUpdateTime > 0.0f))
         {
-            if (mActiveParticles.empty())
+            if (getNumParticles() == 0)
             {
                 // No particles, reset to null if auto update bounds
                 if (mBoundsAutoUpdate)
@@ -836,6 +1041,18 @@ namespace Ogre {
                 Vector3 halfScale = Vector3::UNIT_SCALE * 0.5;
                 Vector3 defaultPadding = 
                     halfScale * std::max(mDefaultHeight, mDefaultWidth);
+				if (_isUsingPackedStorage())
+				{
+					const PackedParticleData& d = mPackedParticles;
+					for (size_t i = 0; i < d.size(); ++i)
+					{
+						Vector3 padding = d.ownDimensions[i] ?
+							halfScale * std::max(d.width[i], d.height[i]) : defaultPadding;
+						Vector3 pos = d.getPosition(i);
+						min.makeFloor(pos - padding);
+						max.makeCeil(pos + padding);
+					}
+				}
                 for (p = mActiveParticles.begin(); p != mActiveParticles.end(); ++p)
                 {
                     if ((*p)->mOwnDimensions)
@@ -872,8 +1089,9 @@ namespace Ogre {
                 mAABB.merge(newAABB);
             }
 
-            mParentNode->needUpdate();
+            return true;
         }
+        return false;
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::fastForward(Real time, Real interval)
@@ -1033,6 +1251,7 @@ namespace Ogre {
 
         // Move actives to free list
         mFreeParticles.splice(mFreeParticles.end(), mActiveParticles);
+		mPackedParticles.clear();
 
         // Add active emitted emitters to free list
 		addActiveEmittedEmittersToFreeList();
@@ -1083,6 +1302,13 @@ namespace Ogre {
             }
         }
 
+		// Packed storage mirrors the pool so that there is always a proxy
+		// particle available for every packed one
+		if (mUsePackedStorage && mPackedParticles.getCapacity() != mParticlePool.size())
+		{
+			mPackedParticles.setCapacity(mParticlePool.size());
+		}
+
         if (mRenderer && !mIsRendererConfigured)
         {
             mRenderer->_notifyParticleQuota(mParticlePool.size());
@@ -1182,6 +1408,24 @@ namespace Ogre {
 			mRenderer->setKeepParticlesInLocalSpace(keepLocal);
 		}
 	}
+	//-----------------------------------------------------------------------
+	void ParticleSystem::setUsePackedStorage(bool packed)
+	{
+		if (packed == mUsePackedStorage)
+			return;
+
+		clear();
+		mUsePackedStorage = packed;
+		if (packed)
+		{
+			mPackedParticles.setCapacity(mParticlePool.size());
+		}
+		else
+		{
+			// Release the arrays
+			mPackedParticles.setCapacity(0);
+		}
+	}
     //-----------------------------------------------------------------------
     void ParticleSystem::_sortParticles(Camera* cam)
     {
@@ -1196,7 +1440,10 @@ namespace Ogre {
                     // transform the camera direction into local space
                     camDir = mParentNode->_getDerivedOrientation().UnitInverse() * camDir;
                 }
-                mRadixSorter.sort(mActiveParticles, SortByDirectionFunctor(- camDir));
+				if (_isUsingPackedStorage())
+					_sortPackedParticles(sortMode, - camDir);
+				else
+	                sortActiveParticles(SortByDirectionFunctor(- camDir));
             }
             else if (sortMode == SM_DISTANCE)
             {
@@ -1207,10 +1454,52 @@ namespace Ogre {
                     camPos = mParentNode->_getDerivedOrientation().UnitInverse() *
                         (camPos - mParentNode->_getDerivedPosition()) / mParentNode->_getDerivedScale();
                 }
-                mRadixSorter.sort(mActiveParticles, SortByDistanceFunctor(camPos));
+				if (_isUsingPackedStorage())
+					_sortPackedParticles(sortMode, camPos);
+				else
+	                sortActiveParticles(SortByDistanceFunctor(camPos));
             }
         }
     }
+    //-----------------------------------------------------------------------
+	void ParticleSystem::_sortPackedParticles(SortMode sortMode, const Vector3& ref)
+	{
+		const PackedParticleData& d = mPackedParticles;
+		size_t count = d.size();
+		if (count < 2)
+			return;
+
+		// The particles are still in the order of the previous sort, apart from
+		// those swapped in by expiry and the newly emitted ones at the end
+		mPackedParticleSorter.begin(count);
+		if (sortMode == SM_DIRECTION)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				mPackedParticleSorter.add(static_cast<uint32>(i), ref.x * d.positionX[i] +
+					ref.y * d.positionY[i] + ref.z * d.positionZ[i]);
+			}
+		}
+		else
+		{
+			// Sort descending by squared distance
+			for (size_t i = 0; i < count; ++i)
+			{
+				float dx = ref.x - d.positionX[i];
+				float dy = ref.y - d.positionY[i];
+				float dz = ref.z - d.positionZ[i];
+				mPackedParticleSorter.add(static_cast<uint32>(i), - (dx * dx + dy * dy + dz * dz));
+			}
+		}
+
+		if (!mPackedParticleSorter.sort())
+			return;
+
+		mPackedSortOrder.resize(count);
+		for (size_t i = 0; i < count; ++i)
+			mPackedSortOrder[i] = mPackedParticleSorter.getItem(i);
+		mPackedParticles.reorder(&mPackedSortOrder[0]);
+	}
     ParticleSystem::SortByDirectionFunctor::SortByDirectionFunctor(const Vector3& dir)
         : sortDir(dir)
     {
@@ -1587,11 +1876,34 @@ namespace Ogre {
 		static_cast<ParticleSystem*>(target)->setNonVisibleUpdateTimeout(
 			StringConverter::parseReal(val));
 	}
+	//-----------------------------------------------------------------------
+	String ParticleSystem::CmdPackedStorage::doGet(const void* target) const
+	{
+		return StringConverter::toString(
+			static_cast<const ParticleSystem*>(target)->getUsePackedStorage());
+	}
+	void ParticleSystem::CmdPackedStorage::doSet(void* target, const String& val)
+	{
+		static_cast<ParticleSystem*>(target)->setUsePackedStorage(
+			StringConverter::parseBool(val));
+	}
    //-----------------------------------------------------------------------
     ParticleAffector::~ParticleAffector() 
     {
     }
     //-----------------------------------------------------------------------
+    void ParticleAffector::_initParticles(PackedParticleData& data, size_t first, size_t count)
+    {
+        Particle p;
+        p._notifyOwner(mParent);
+        for (size_t i = first; i < first + count; ++i)
+        {
+            data.readParticle(i, &p);
+            _initParticle(&p);
+            data.writeParticle(i, &p);
+        }
+    }
+    //-----------------------------------------------------------------------
     ParticleAffectorFactory::~ParticleAffectorFactory() 
     {
         // Destroy all affectors
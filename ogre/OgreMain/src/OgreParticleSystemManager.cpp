@@ -57,6 +57,7 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     ParticleSystemManager::ParticleSystemManager()
+		: mUseWorkerThreads(false)
     {
 		OGRE_LOCK_AUTO_MUTEX
 #if OGRE_USE_NEW_COMPILERS == 0
@@ -71,6 +72,8 @@ namespace Ogre {
     {
 		OGRE_LOCK_AUTO_MUTEX
 
+		mQueuedUpdates.clear();
+
         // Destroy all templates
         ParticleTemplateMap::iterator t;
         for (t = mSystemTemplates.begin(); t != mSystemTemplates.end(); ++t)
@@ -433,6 +436,67 @@ namespace Ogre {
         pFact->second->destroyInstance(renderer);
 	}
     //-----------------------------------------------------------------------
+    void ParticleSystemManager::_queueUpdate(ParticleSystem* sys, Real timeElapsed)
+    {
+		QueuedUpdateMap::iterator i = mQueuedUpdates.find(sys);
+		if (i == mQueuedUpdates.end())
+			mQueuedUpdates[sys] = timeElapsed;
+		else
+			i->second += timeElapsed;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_cancelUpdate(ParticleSystem* sys)
+    {
+		mQueuedUpdates.erase(sys);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_processQueuedUpdates(void)
+    {
+		if (mQueuedUpdates.empty())
+			return;
+
+		// Anything touching state shared between systems happens here
+		UpdateTaskList tasks;
+		tasks.reserve(mQueuedUpdates.size());
+		for (QueuedUpdateMap::iterator i = mQueuedUpdates.begin(); i != mQueuedUpdates.end(); ++i)
+		{
+			if (i->first->_prepareUpdate(i->second))
+			{
+				UpdateTask task;
+				task.system = i->first;
+				task.timeElapsed = i->second;
+				task.numParticles = i->first->getNumParticles();
+				tasks.push_back(task);
+			}
+		}
+		mQueuedUpdates.clear();
+
+		// Start the largest systems first so that they don't finish last
+		std::sort(tasks.begin(), tasks.end());
+
+		UpdateTaskRunner runner(tasks);
+		try
+		{
+			ParallelTasks::run(runner, tasks.size());
+		}
+		catch (...)
+		{
+			// The systems which did update still need finishing
+			for (UpdateTaskList::iterator i = tasks.begin(); i != tasks.end(); ++i)
+				i->system->_finishUpdate();
+			throw;
+		}
+
+		for (UpdateTaskList::iterator i = tasks.begin(); i != tasks.end(); ++i)
+			i->system->_finishUpdate();
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::UpdateTaskRunner::run(size_t index)
+    {
+		UpdateTask& task = mTasks[index];
+		task.system->_updateParticles(task.timeElapsed);
+    }
+    //-----------------------------------------------------------------------
     void ParticleSystemManager::_initialise(void)
     {
 		OGRE_LOCK_AUTO_MUTEX
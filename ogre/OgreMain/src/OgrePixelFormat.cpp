@@ -30,6 +30,12 @@ THE SOFTWARE.
 #include "OgreBitwise.h"
 #include "OgreColourValue.h"
 #include "OgreException.h"
+#include "OgreParallelTasks.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_SSE2
+#include <emmintrin.h>
+#endif
 
 
 namespace {
@@ -630,6 +636,32 @@ namespace Ogre {
         /* Masks and shifts */
         0, 0, 0, 0, 0, 0, 0, 0
         },
+    //-----------------------------------------------------------------------
+		{"PF_BC4_UNORM",
+        /* Bytes per element */
+        0,
+        /* Flags */
+        PFF_COMPRESSED,
+        /* Component type and count */
+        PCT_BYTE, 1,
+        /* rbits, gbits, bbits, abits */
+        0, 0, 0, 0,
+        /* Masks and shifts */
+        0, 0, 0, 0, 0, 0, 0, 0
+        },
+    //-----------------------------------------------------------------------
+		{"PF_BC5_UNORM",
+        /* Bytes per element */
+        0,
+        /* Flags */
+        PFF_COMPRESSED,
+        /* Component type and count */
+        PCT_BYTE, 2,
+        /* rbits, gbits, bbits, abits */
+        0, 0, 0, 0,
+        /* Masks and shifts */
+        0, 0, 0, 0, 0, 0, 0, 0
+        },
         
     };
     //-----------------------------------------------------------------------
@@ -695,11 +727,13 @@ namespace Ogre {
 				// DXT formats work by dividing the image into 4x4 blocks, then encoding each
 				// 4x4 block with a certain number of bytes. 
 				case PF_DXT1:
+				case PF_BC4_UNORM:
 					return ((width+3)/4)*((height+3)/4)*8 * depth;
 				case PF_DXT2:
 				case PF_DXT3:
 				case PF_DXT4:
 				case PF_DXT5:
+				case PF_BC5_UNORM:
 					return ((width+3)/4)*((height+3)/4)*16 * depth;
 
                 // Size calculations from the PVRTC OpenGL extension spec
@@ -1234,6 +1268,489 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    namespace {
+        /* Row converters, used for pairs of formats which have no specialised
+        conversion in OgrePixelConversions.h. A row is unpacked into a buffer of
+        floats and packed again from it, in chunks, with a loop per format so
+        the format description is only looked up once per row instead of once
+        per pixel. Each loop uses the same expressions as unpackColour and
+        packColour, so the results are identical to the per pixel path.
+        */
+        const size_t ROW_CHUNK_PIXELS = 256;
+        /* Images with at least this many pixels are converted in bands of rows
+        on several threads.
+        */
+        const size_t PARALLEL_CONVERSION_PIXELS = 256 * 256;
+        /* Approximate number of pixels in one band. */
+        const size_t BAND_PIXELS = 64 * 1024;
+
+        typedef void (*RowUnpacker)(const PixelFormatDescription &des, const uint8 *src, float *rgba, size_t count);
+        typedef void (*RowPacker)(const PixelFormatDescription &des, const float *rgba, uint8 *dest, size_t count);
+
+        template <int N>
+        void unpackNativeRow(const PixelFormatDescription &des, const uint8 *src, float *rgba, size_t count)
+        {
+            const uint32 rmask = des.rmask, gmask = des.gmask, bmask = des.bmask, amask = des.amask;
+            const unsigned char rshift = des.rshift, gshift = des.gshift, bshift = des.bshift, ashift = des.ashift;
+            const float rmax = (float)((1<<des.rbits)-1);
+            const float gmax = (float)((1<<des.gbits)-1);
+            const float bmax = (float)((1<<des.bbits)-1);
+            const float amax = (float)((1<<des.abits)-1);
+            const bool luminance = (des.flags & PFF_LUMINANCE) != 0;
+            const bool alpha = (des.flags & PFF_HASALPHA) != 0;
+            for (size_t i = 0; i < count; ++i, src += N, rgba += 4)
+            {
+                const uint32 value = Bitwise::intRead(src, N);
+                rgba[0] = (float)((value & rmask)>>rshift)/rmax;
+                if (luminance)
+                {
+                    rgba[1] = rgba[2] = rgba[0];
+                }
+                else
+                {
+                    rgba[1] = (float)((value & gmask)>>gshift)/gmax;
+                    rgba[2] = (float)((value & bmask)>>bshift)/bmax;
+                }
+                rgba[3] = alpha ? (float)((value & amask)>>ashift)/amax : 1.0f;
+            }
+        }
+
+        template <int N>
+        void packNativeRow(const PixelFormatDescription &des, const float *rgba, uint8 *dest, size_t count)
+        {
+            const uint32 rmask = des.rmask, gmask = des.gmask, bmask = des.bmask, amask = des.amask;
+            const unsigned char rshift = des.rshift, gshift = des.gshift, bshift = des.bshift, ashift = des.ashift;
+            const unsigned int rbits = des.rbits, gbits = des.gbits, bbits = des.bbits, abits = des.abits;
+            for (size_t i = 0; i < count; ++i, rgba += 4, dest += N)
+            {
+                const uint32 value = ((Bitwise::floatToFixed(rgba[0], rbits)<<rshift) & rmask) |
+                    ((Bitwise::floatToFixed(rgba[1], gbits)<<gshift) & gmask) |
+                    ((Bitwise::floatToFixed(rgba[2], bbits)<<bshift) & bmask) |
+                    ((Bitwise::floatToFixed(rgba[3], abits)<<ashift) & amask);
+                Bitwise::intWrite(dest, N, value);
+            }
+        }
+
+#if __OGRE_HAVE_SSE2
+        static bool hasSSE2(void)
+        {
+            static const bool sse2 =
+                (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE2) != 0;
+            return sse2;
+        }
+
+        /* SSE2 versions of the native endian converters for 1, 2 and 4 byte
+        pixels, 4 pixels at a time with the rest of the row left to the loops
+        above. The arithmetic is the same single precision division and
+        truncation, so the results are still identical to the per pixel path.
+        */
+        template <int N>
+        inline __m128i loadNativePixels(const uint8 *src)
+        {
+            if (N == 4)
+                return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            const __m128i zero = _mm_setzero_si128();
+            if (N == 2)
+                return _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)), zero);
+            int value;
+            memcpy(&value, src, sizeof(value));
+            return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero), zero);
+        }
+
+        template <int N>
+        inline void storeNativePixels(__m128i pixels, uint8 *dest)
+        {
+            if (N == 4)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), pixels);
+                return;
+            }
+            // Sign extend the low 16 bits so that the saturating pack keeps them
+            pixels = _mm_srai_epi32(_mm_slli_epi32(pixels, 16), 16);
+            pixels = _mm_packs_epi32(pixels, pixels);
+            if (N == 2)
+            {
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), pixels);
+                return;
+            }
+            const int value = _mm_cvtsi128_si32(_mm_packus_epi16(pixels, pixels));
+            memcpy(dest, &value, sizeof(value));
+        }
+
+        /* One channel of the native formats: mask, shift and scale. */
+        struct NativeChannelSSE2
+        {
+            __m128i mask;
+            __m128i shift;
+            __m128 max;
+            __m128 scale;
+
+            NativeChannelSSE2(uint32 channelMask, unsigned char channelShift, unsigned int bits)
+                : mask(_mm_set1_epi32(channelMask)), shift(_mm_cvtsi32_si128(channelShift)),
+                max(_mm_set1_ps((float)((1<<bits)-1))), scale(_mm_set1_ps((float)(1<<bits)))
+            {
+            }
+
+            __m128 unpack(__m128i pixels) const
+            {
+                return _mm_div_ps(_mm_cvtepi32_ps(_mm_srl_epi32(_mm_and_si128(pixels, mask), shift)), max);
+            }
+
+            /* Same as Bitwise::floatToFixed, clamping to the float below 1
+            instead of returning the maximum for 1 and above.
+            */
+            __m128i pack(__m128 value) const
+            {
+                const __m128 belowOne = _mm_castsi128_ps(_mm_set1_epi32(0x3F7FFFFF));
+                value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), belowOne);
+                return _mm_and_si128(_mm_sll_epi32(_mm_cvttps_epi32(_mm_mul_ps(value, scale)), shift), mask);
+            }
+        };
+
+        template <int N>
+        void unpackNativeRowSSE2(const PixelFormatDescription &des, const uint8 *src, float *rgba, size_t count)
+        {
+            const NativeChannelSSE2 red(des.rmask, des.rshift, des.rbits);
+            const NativeChannelSSE2 green(des.gmask, des.gshift, des.gbits);
+            const NativeChannelSSE2 blue(des.bmask, des.bshift, des.bbits);
+            const NativeChannelSSE2 alpha(des.amask, des.ashift, des.abits);
+            const bool luminance = (des.flags & PFF_LUMINANCE) != 0;
+            const bool hasAlpha = (des.flags & PFF_HASALPHA) != 0;
+            const size_t simdCount = count & ~(size_t)3;
+            for (size_t i = 0; i < simdCount; i += 4, src += 4 * N, rgba += 16)
+            {
+                const __m128i pixels = loadNativePixels<N>(src);
+                __m128 r = red.unpack(pixels), g, b;
+                if (luminance)
+                {
+                    g = b = r;
+                }
+                else
+                {
+                    g = green.unpack(pixels);
+                    b = blue.unpack(pixels);
+                }
+                __m128 a = hasAlpha ? alpha.unpack(pixels) : _mm_set1_ps(1.0f);
+                _MM_TRANSPOSE4_PS(r, g, b, a);
+                _mm_storeu_ps(rgba, r);
+                _mm_storeu_ps(rgba + 4, g);
+                _mm_storeu_ps(rgba + 8, b);
+                _mm_storeu_ps(rgba + 12, a);
+            }
+            unpackNativeRow<N>(des, src, rgba, count - simdCount);
+        }
+
+        template <int N>
+        void packNativeRowSSE2(const PixelFormatDescription &des, const float *rgba, uint8 *dest, size_t count)
+        {
+            const NativeChannelSSE2 red(des.rmask, des.rshift, des.rbits);
+            const NativeChannelSSE2 green(des.gmask, des.gshift, des.gbits);
+            const NativeChannelSSE2 blue(des.bmask, des.bshift, des.bbits);
+            const NativeChannelSSE2 alpha(des.amask, des.ashift, des.abits);
+            const size_t simdCount = count & ~(size_t)3;
+            for (size_t i = 0; i < simdCount; i += 4, rgba += 16, dest += 4 * N)
+            {
+                __m128 r = _mm_loadu_ps(rgba);
+                __m128 g = _mm_loadu_ps(rgba + 4);
+                __m128 b = _mm_loadu_ps(rgba + 8);
+                __m128 a = _mm_loadu_ps(rgba + 12);
+                _MM_TRANSPOSE4_PS(r, g, b, a);
+                const __m128i pixels = _mm_or_si128(_mm_or_si128(red.pack(r), green.pack(g)),
+                    _mm_or_si128(blue.pack(b), alpha.pack(a)));
+                storeNativePixels<N>(pixels, dest);
+            }
+            packNativeRow<N>(des, rgba, dest, count - simdCount);
+        }
+#endif
+
+        /* Float and half formats. Single channel formats replicate red, two
+        channel formats are stored green first, as in unpackColour.
+        */
+        inline float halfToFloat(uint16 v) { return Bitwise::halfToFloat(v); }
+        inline float identity(float v) { return v; }
+        inline uint16 floatToHalf(float v) { return Bitwise::floatToHalf(v); }
+
+        template <typename T, float (*Read)(T), int C>
+        void unpackFloatRow(const PixelFormatDescription &, const uint8 *src, float *rgba, size_t count)
+        {
+            const T *s = reinterpret_cast<const T*>(src);
+            for (size_t i = 0; i < count; ++i, s += C, rgba += 4)
+            {
+                switch (C)
+                {
+                case 1:
+                    rgba[0] = rgba[1] = rgba[2] = Read(s[0]);
+                    rgba[3] = 1.0f;
+                    break;
+                case 2:
+                    rgba[1] = Read(s[0]);
+                    rgba[0] = rgba[2] = Read(s[1]);
+                    rgba[3] = 1.0f;
+                    break;
+                case 3:
+                    rgba[0] = Read(s[0]);
+                    rgba[1] = Read(s[1]);
+                    rgba[2] = Read(s[2]);
+                    rgba[3] = 1.0f;
+                    break;
+                case 4:
+                    rgba[0] = Read(s[0]);
+                    rgba[1] = Read(s[1]);
+                    rgba[2] = Read(s[2]);
+                    rgba[3] = Read(s[3]);
+                    break;
+                }
+            }
+        }
+
+        template <typename T, T (*Write)(float), int C>
+        void packFloatRow(const PixelFormatDescription &, const float *rgba, uint8 *dest, size_t count)
+        {
+            T *d = reinterpret_cast<T*>(dest);
+            for (size_t i = 0; i < count; ++i, rgba += 4, d += C)
+            {
+                switch (C)
+                {
+                case 1:
+                    d[0] = Write(rgba[0]);
+                    break;
+                case 2:
+                    d[0] = Write(rgba[1]);
+                    d[1] = Write(rgba[0]);
+                    break;
+                case 3:
+                    d[0] = Write(rgba[0]);
+                    d[1] = Write(rgba[1]);
+                    d[2] = Write(rgba[2]);
+                    break;
+                case 4:
+                    d[0] = Write(rgba[0]);
+                    d[1] = Write(rgba[1]);
+                    d[2] = Write(rgba[2]);
+                    d[3] = Write(rgba[3]);
+                    break;
+                }
+            }
+        }
+
+        /* PF_SHORT_RGB(A) and PF_BYTE_LA, C channels of T per pixel. */
+        template <typename T, int C>
+        void unpackFixedRow(const PixelFormatDescription &, const uint8 *src, float *rgba, size_t count)
+        {
+            const T *s = reinterpret_cast<const T*>(src);
+            const unsigned int bits = sizeof(T) * 8;
+            for (size_t i = 0; i < count; ++i, s += C, rgba += 4)
+            {
+                if (C == 2)
+                {
+                    rgba[0] = rgba[1] = rgba[2] = Bitwise::fixedToFloat(s[0], bits);
+                    rgba[3] = Bitwise::fixedToFloat(s[1], bits);
+                }
+                else
+                {
+                    rgba[0] = Bitwise::fixedToFloat(s[0], bits);
+                    rgba[1] = Bitwise::fixedToFloat(s[1], bits);
+                    rgba[2] = Bitwise::fixedToFloat(s[2], bits);
+                    rgba[3] = C == 4 ? Bitwise::fixedToFloat(s[C - 1], bits) : 1.0f;
+                }
+            }
+        }
+
+        template <typename T, int C>
+        void packFixedRow(const PixelFormatDescription &, const float *rgba, uint8 *dest, size_t count)
+        {
+            T *d = reinterpret_cast<T*>(dest);
+            const unsigned int bits = sizeof(T) * 8;
+            for (size_t i = 0; i < count; ++i, rgba += 4, d += C)
+            {
+                if (C == 2)
+                {
+                    d[0] = (T)Bitwise::floatToFixed(rgba[0], bits);
+                    d[1] = (T)Bitwise::floatToFixed(rgba[3], bits);
+                }
+                else
+                {
+                    d[0] = (T)Bitwise::floatToFixed(rgba[0], bits);
+                    d[1] = (T)Bitwise::floatToFixed(rgba[1], bits);
+                    d[2] = (T)Bitwise::floatToFixed(rgba[2], bits);
+                    if (C == 4)
+                        d[C - 1] = (T)Bitwise::floatToFixed(rgba[3], bits);
+                }
+            }
+        }
+
+        RowUnpacker getRowUnpacker(PixelFormat pf)
+        {
+            const PixelFormatDescription &des = getDescriptionFor(pf);
+            if (des.flags & PFF_NATIVEENDIAN)
+            {
+#if __OGRE_HAVE_SSE2
+                if (hasSSE2())
+                {
+                    switch (des.elemBytes)
+                    {
+                    case 1: return unpackNativeRowSSE2<1>;
+                    case 2: return unpackNativeRowSSE2<2>;
+                    case 4: return unpackNativeRowSSE2<4>;
+                    }
+                }
+#endif
+                switch (des.elemBytes)
+                {
+                case 1: return unpackNativeRow<1>;
+                case 2: return unpackNativeRow<2>;
+                case 3: return unpackNativeRow<3>;
+                case 4: return unpackNativeRow<4>;
+                default: return 0;
+                }
+            }
+            switch (pf)
+            {
+            case PF_FLOAT32_R: return unpackFloatRow<float, identity, 1>;
+            case PF_FLOAT32_GR: return unpackFloatRow<float, identity, 2>;
+            case PF_FLOAT32_RGB: return unpackFloatRow<float, identity, 3>;
+            case PF_FLOAT32_RGBA: return unpackFloatRow<float, identity, 4>;
+            case PF_FLOAT16_R: return unpackFloatRow<uint16, halfToFloat, 1>;
+            case PF_FLOAT16_GR: return unpackFloatRow<uint16, halfToFloat, 2>;
+            case PF_FLOAT16_RGB: return unpackFloatRow<uint16, halfToFloat, 3>;
+            case PF_FLOAT16_RGBA: return unpackFloatRow<uint16, halfToFloat, 4>;
+            case PF_SHORT_RGB: return unpackFixedRow<uint16, 3>;
+            case PF_SHORT_RGBA: return unpackFixedRow<uint16, 4>;
+            case PF_BYTE_LA: return unpackFixedRow<uint8, 2>;
+            default: return 0;
+            }
+        }
+
+        RowPacker getRowPacker(PixelFormat pf)
+        {
+            const PixelFormatDescription &des = getDescriptionFor(pf);
+            if (des.flags & PFF_NATIVEENDIAN)
+            {
+#if __OGRE_HAVE_SSE2
+                if (hasSSE2())
+                {
+                    switch (des.elemBytes)
+                    {
+                    case 1: return packNativeRowSSE2<1>;
+                    case 2: return packNativeRowSSE2<2>;
+                    case 4: return packNativeRowSSE2<4>;
+                    }
+                }
+#endif
+                switch (des.elemBytes)
+                {
+                case 1: return packNativeRow<1>;
+                case 2: return packNativeRow<2>;
+                case 3: return packNativeRow<3>;
+                case 4: return packNativeRow<4>;
+                default: return 0;
+                }
+            }
+            switch (pf)
+            {
+            case PF_FLOAT32_R: return packFloatRow<float, identity, 1>;
+            case PF_FLOAT32_GR: return packFloatRow<float, identity, 2>;
+            case PF_FLOAT32_RGB: return packFloatRow<float, identity, 3>;
+            case PF_FLOAT32_RGBA: return packFloatRow<float, identity, 4>;
+            case PF_FLOAT16_R: return packFloatRow<uint16, floatToHalf, 1>;
+            case PF_FLOAT16_GR: return packFloatRow<uint16, floatToHalf, 2>;
+            case PF_FLOAT16_RGB: return packFloatRow<uint16, floatToHalf, 3>;
+            case PF_FLOAT16_RGBA: return packFloatRow<uint16, floatToHalf, 4>;
+            case PF_SHORT_RGB: return packFixedRow<uint16, 3>;
+            case PF_SHORT_RGBA: return packFixedRow<uint16, 4>;
+            case PF_BYTE_LA: return packFixedRow<uint8, 2>;
+            default: return 0;
+            }
+        }
+
+        /* Converts a box between two formats which both have a row converter,
+        or which have a specialised conversion.
+        */
+        void convertRows(const PixelBox &src, const PixelBox &dst)
+        {
+// NB VC6 can't handle the templates required for optimised conversion, tough
+#if OGRE_COMPILER != OGRE_COMPILER_MSVC || OGRE_COMP_VER >= 1300
+            // Is there a specialized, inlined, conversion?
+            if(doOptimizedConversion(src, dst))
+                return;
+#endif
+            const PixelFormatDescription &srcDes = getDescriptionFor(src.format);
+            const PixelFormatDescription &dstDes = getDescriptionFor(dst.format);
+            const RowUnpacker unpack = getRowUnpacker(src.format);
+            const RowPacker pack = getRowPacker(dst.format);
+            assert(unpack && pack);
+
+            const size_t srcPixelSize = srcDes.elemBytes;
+            const size_t dstPixelSize = dstDes.elemBytes;
+            const uint8 *srcslice = static_cast<const uint8*>(src.data)
+                + (src.left + src.top * src.rowPitch + src.front * src.slicePitch) * srcPixelSize;
+            uint8 *dstslice = static_cast<uint8*>(dst.data)
+                + (dst.left + dst.top * dst.rowPitch + dst.front * dst.slicePitch) * dstPixelSize;
+            const size_t width = src.getWidth();
+
+            float rgba[ROW_CHUNK_PIXELS * 4];
+            for(size_t z=src.front; z<src.back; z++)
+            {
+                const uint8 *srcrow = srcslice;
+                uint8 *dstrow = dstslice;
+                for(size_t y=src.top; y<src.bottom; y++)
+                {
+                    for(size_t x=0; x<width; x+=ROW_CHUNK_PIXELS)
+                    {
+                        const size_t count = std::min(ROW_CHUNK_PIXELS, width - x);
+                        unpack(srcDes, srcrow + x * srcPixelSize, rgba, count);
+                        pack(dstDes, rgba, dstrow + x * dstPixelSize, count);
+                    }
+                    srcrow += src.rowPitch * srcPixelSize;
+                    dstrow += dst.rowPitch * dstPixelSize;
+                }
+                srcslice += src.slicePitch * srcPixelSize;
+                dstslice += dst.slicePitch * dstPixelSize;
+            }
+        }
+
+        /* Converts a large image in bands of rows, one band per task. */
+        class ConvertBandsTask : public ParallelTasks::Task
+        {
+        protected:
+            const PixelBox &mSrc;
+            const PixelBox &mDst;
+            size_t mRowsPerBand;
+            size_t mBandsPerSlice;
+        public:
+            ConvertBandsTask(const PixelBox &src, const PixelBox &dst)
+                : mSrc(src), mDst(dst)
+            {
+                mRowsPerBand = std::max((size_t)1, BAND_PIXELS / src.getWidth());
+                mBandsPerSlice = (src.getHeight() + mRowsPerBand - 1) / mRowsPerBand;
+            }
+
+            size_t getTaskCount() const
+            {
+                return mBandsPerSlice * mSrc.getDepth();
+            }
+
+            void run(size_t index)
+            {
+                const size_t z = index / mBandsPerSlice;
+                const size_t y = (index % mBandsPerSlice) * mRowsPerBand;
+                const size_t rows = std::min(mRowsPerBand, mSrc.getHeight() - y);
+
+                PixelBox src = mSrc;
+                src.front = mSrc.front + z;
+                src.back = src.front + 1;
+                src.top = mSrc.top + y;
+                src.bottom = src.top + rows;
+                PixelBox dst = mDst;
+                dst.front = mDst.front + z;
+                dst.back = dst.front + 1;
+                dst.top = mDst.top + y;
+                dst.bottom = dst.top + rows;
+                convertRows(src, dst);
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
     /* Convert pixels from one format to another */
     void PixelUtil::bulkPixelConversion(void *srcp, PixelFormat srcFormat,
         void *destp, PixelFormat dstFormat, unsigned int count)
@@ -1329,15 +1846,22 @@ namespace Ogre {
 			return;
 		}
 
-// NB VC6 can't handle the templates required for optimised conversion, tough
-#if OGRE_COMPILER != OGRE_COMPILER_MSVC || OGRE_COMP_VER >= 1300
-        // Is there a specialized, inlined, conversion?
-        if(doOptimizedConversion(src, dst))
+        // Is there a specialized or a row conversion?
+        if(getRowUnpacker(src.format) && getRowPacker(dst.format))
         {
-            // If so, good
+            // Large images are converted in bands of rows on several threads
+            if(src.getWidth() * src.getHeight() * src.getDepth() >= PARALLEL_CONVERSION_PIXELS)
+            {
+                ConvertBandsTask task(src, dst);
+                if(task.getTaskCount() > 1)
+                {
+                    ParallelTasks::run(task, task.getTaskCount());
+                    return;
+                }
+            }
+            convertRows(src, dst);
             return;
         }
-#endif
 
         const size_t srcPixelSize = PixelUtil::getNumElemBytes(src.format);
         const size_t dstPixelSize = PixelUtil::getNumElemBytes(dst.format);
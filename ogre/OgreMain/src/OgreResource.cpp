@@ -41,7 +41,8 @@ namespace Ogre
 		const String& group, bool isManual, ManualResourceLoader* loader)
 		: mCreator(creator), mName(name), mGroup(group), mHandle(handle), 
 		mLoadingState(LOADSTATE_UNLOADED), mIsBackgroundLoaded(false),
-		mSize(0), mIsManual(isManual), mLoader(loader), mStateCount(0)
+		mSize(0), mIsManual(isManual), mLoader(loader), mStateCount(0),
+		mLastUsedFrame(0), mTouchedStateCount(0)
 	{
 	}
 	//-----------------------------------------------------------------------
@@ -334,11 +335,17 @@ namespace Ogre
 	//-----------------------------------------------------------------------
 	void Resource::touch(void) 
 	{
+		// Still resident if nothing has loaded it again since the last touch
+		bool resident = isLoaded() && mStateCount == mTouchedStateCount;
         // make sure loaded
         load();
+		mTouchedStateCount = mStateCount;
 
 		if(mCreator)
+		{
+			mCreator->_notifyResourceUsed(this, resident);
 			mCreator->_notifyResourceTouched(this);
+		}
 	}
 	//-----------------------------------------------------------------------
 	void Resource::addListener(Resource::Listener* lis)
@@ -34,8 +34,61 @@ THE SOFTWARE.
 #include "OgreScriptLoader.h"
 #include "OgreSceneManager.h"
 
+#include <sys/types.h>
+#include <sys/stat.h>
+
 namespace Ogre {
 
+	namespace
+	{
+		// Location cache file: magic, version, entry count, then the entries.
+		// Values are in native byte order, the cache is only meant for the
+		// machine which wrote it.
+		const uint32 LOCATION_CACHE_MAGIC = 0x434C524F; // 'ORLC'
+		const uint32 LOCATION_CACHE_VERSION = 1;
+		// Sanity limit on strings read from the cache
+		const uint32 LOCATION_CACHE_MAX_STRING = 65536;
+
+		template <typename T> void writeCacheValue(std::ostream& out, const T& val)
+		{
+			out.write(reinterpret_cast<const char*>(&val), sizeof(T));
+		}
+		template <typename T> bool readCacheValue(std::istream& in, T& val)
+		{
+			in.read(reinterpret_cast<char*>(&val), sizeof(T));
+			return !in.fail();
+		}
+		void writeCacheString(std::ostream& out, const String& str)
+		{
+			writeCacheValue(out, static_cast<uint32>(str.size()));
+			out.write(str.data(), str.size());
+		}
+		bool readCacheString(std::istream& in, String& str)
+		{
+			uint32 len;
+			if (!readCacheValue(in, len) || len > LOCATION_CACHE_MAX_STRING)
+				return false;
+			str.resize(len);
+			if (len)
+				in.read(&str[0], len);
+			return !in.fail();
+		}
+		String getLocationCacheKey(const Archive* arch, const String& locType, bool recursive)
+		{
+			return locType + (recursive ? "|r|" : "|n|") + arch->getName();
+		}
+		bool getLocationStamp(const String& path, uint64& size, int64& modifiedTime, bool& isDir)
+		{
+			struct stat tagStat;
+			if (stat(path.c_str(), &tagStat) != 0)
+				return false;
+			size = static_cast<uint64>(tagStat.st_size);
+			modifiedTime = static_cast<int64>(tagStat.st_mtime);
+			isDir = (tagStat.st_mode & S_IFDIR) != 0;
+			return true;
+		}
+	}
+
     //-----------------------------------------------------------------------
     template<> ResourceGroupManager* Singleton<ResourceGroupManager>::ms_Singleton = 0;
     ResourceGroupManager* ResourceGroupManager::getSingletonPtr(void)
@@ -55,7 +108,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mLoadingListener(0), mCurrentGroup(0)
+        : mLoadingListener(0), mCurrentGroup(0), mLocationCacheDirty(false)
     {
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME);
@@ -126,6 +179,8 @@ namespace Ogre {
 			// Reset current group
 			mCurrentGroup = 0;
 		}
+
+		saveResourceLocationCache();
 	}
 	//-----------------------------------------------------------------------
 	void ResourceGroupManager::initialiseAllResourceGroups(void)
@@ -154,6 +209,8 @@ namespace Ogre {
 				mCurrentGroup = 0;
 			}
 		}
+
+		saveResourceLocationCache();
 	}
     //-----------------------------------------------------------------------
     void ResourceGroupManager::prepareResourceGroup(const String& name, 
@@ -562,15 +619,30 @@ namespace Ogre {
 		loc->recursive = recursive;
         grp->locationList.push_back(loc);
         // Index resources
-        StringVectorPtr vec = pArch->find("*", recursive);
-        for( StringVector::iterator it = vec->begin(); it != vec->end(); ++it )
-			grp->addToIndex(*it, pArch);
+		bool cached = false;
+		if (!mLocationCacheFile.empty())
+		{
+			loc->files = getCachedLocationFiles(pArch, locType, recursive);
+			cached = !loc->files.isNull();
+			if (!cached)
+				loc->files = scanLocationFiles(pArch, locType, recursive);
+			for (FileInfoList::iterator it = loc->files->begin(); it != loc->files->end(); ++it)
+				grp->addToIndex(it->filename, pArch);
+		}
+		else
+		{
+			StringVectorPtr vec = pArch->find("*", recursive);
+			for( StringVector::iterator it = vec->begin(); it != vec->end(); ++it )
+				grp->addToIndex(*it, pArch);
+		}
 		
 		StringUtil::StrStreamType msg;
 		msg << "Added resource location '" << name << "' of type '" << locType
 			<< "' to resource group '" << resGroup << "'";
 		if (recursive)
 			msg << " with recursive option";
+		if (cached)
+			msg << " from location cache";
 		LogManager::getSingleton().logMessage(msg.str());
 
     }
@@ -1052,6 +1124,22 @@ namespace Ogre {
 		// Fire scripting event
 		fireResourceGroupScriptingStarted(grp->name, scriptCount);
 
+		// Give each loader the chance to do its context free work for the whole
+		// group up front (e.g. parse in parallel). Skipped if a loading listener
+		// is present since it may replace the streams we hand to parseScript.
+		if (!mLoadingListener)
+		{
+			for (ScriptLoaderFileList::iterator slfli = scriptLoaderFileList.begin();
+				slfli != scriptLoaderFileList.end(); ++slfli)
+			{
+				FileInfoList scripts;
+				for (FileListList::iterator flli = slfli->second->begin(); flli != slfli->second->end(); ++flli)
+					scripts.insert(scripts.end(), (*flli)->begin(), (*flli)->end());
+				if (!scripts.empty())
+					slfli->first->_prepareScripts(scripts, grp->name);
+			}
+		}
+
 		// Iterate over scripts and parse
 		// Note we respect original ordering
         for (ScriptLoaderFileList::iterator slfli = scriptLoaderFileList.begin();
@@ -1088,6 +1176,10 @@ namespace Ogre {
             }
 		}
 
+		for (ScriptLoaderFileList::iterator slfli = scriptLoaderFileList.begin();
+			slfli != scriptLoaderFileList.end(); ++slfli)
+			slfli->first->_endScriptPreparation();
+
 		fireResourceGroupScriptingEnded(grp->name);
 		LogManager::getSingleton().logMessage(
 			"Finished parsing scripts for resource group " + grp->name);
@@ -1321,6 +1413,12 @@ namespace Ogre {
 		}
         grp->loadResourceOrderMap.clear();
 
+		for (ResourceManagerMap::iterator m = mResourceManagerMap.begin();
+			m != mResourceManagerMap.end(); ++m)
+		{
+			m->second->_notifyResourceGroupCleared(grp->name);
+		}
+
 		if (groupSet)
 		{
 			mCurrentGroup = 0;
@@ -1591,6 +1689,14 @@ namespace Ogre {
         iend = grp->locationList.end();
         for (i = grp->locationList.begin(); i != iend; ++i)
         {
+			if (!dirs && !(*i)->files.isNull())
+			{
+				FileInfoList lst;
+				findLocationFiles(*i, pattern, lst);
+				for (FileInfoList::iterator fi = lst.begin(); fi != lst.end(); ++fi)
+					vec->push_back(fi->filename);
+				continue;
+			}
             StringVectorPtr lst = (*i)->archive->find(pattern, (*i)->recursive, dirs);
             vec->insert(vec->end(), lst->begin(), lst->end());
         }
@@ -1621,6 +1727,11 @@ namespace Ogre {
         iend = grp->locationList.end();
         for (i = grp->locationList.begin(); i != iend; ++i)
         {
+			if (!dirs && !(*i)->files.isNull())
+			{
+				findLocationFiles(*i, pattern, *vec);
+				continue;
+			}
             FileInfoListPtr lst = (*i)->archive->findFileInfo(pattern, (*i)->recursive, dirs);
             vec->insert(vec->end(), lst->begin(), lst->end());
         }
@@ -1948,6 +2059,208 @@ namespace Ogre {
 	{
 		return mLoadingListener;
 	}
+	//-------------------------------------------------------------------------
+	FileInfoListPtr ResourceGroupManager::getCachedLocationFiles(Archive* arch, 
+		const String& locType, bool recursive)
+	{
+		OGRE_LOCK_MUTEX(mLocationCacheMutex)
+
+		LocationCache::iterator i = mLocationCache.find(getLocationCacheKey(arch, locType, recursive));
+		if (i == mLocationCache.end())
+			return FileInfoListPtr();
+
+		// Any change to the location, or for directories to the set of files 
+		// in any sub directory, invalidates the listing
+		const LocationCacheEntry& entry = i->second;
+		uint64 size;
+		int64 modifiedTime;
+		bool isDir;
+		if (!getLocationStamp(arch->getName(), size, modifiedTime, isDir) ||
+			size != entry.size || modifiedTime != entry.modifiedTime)
+			return FileInfoListPtr();
+		for (size_t d = 0; d < entry.dirs.size(); ++d)
+		{
+			if (!getLocationStamp(arch->getName() + "/" + entry.dirs[d].first, size, modifiedTime, isDir) ||
+				modifiedTime != entry.dirs[d].second)
+				return FileInfoListPtr();
+		}
+
+		FileInfoListPtr files(OGRE_NEW_T(FileInfoList, MEMCATEGORY_GENERAL)(entry.files), SPFM_DELETE_T);
+		for (FileInfoList::iterator f = files->begin(); f != files->end(); ++f)
+			f->archive = arch;
+		return files;
+	}
+	//-------------------------------------------------------------------------
+	FileInfoListPtr ResourceGroupManager::scanLocationFiles(Archive* arch, 
+		const String& locType, bool recursive)
+	{
+		// Take the stamps first, so changes made during the scan invalidate it
+		LocationCacheEntry entry;
+		bool isDir;
+		bool stamped = getLocationStamp(arch->getName(), entry.size, entry.modifiedTime, isDir);
+		if (stamped && isDir && recursive)
+		{
+			StringVectorPtr dirs = arch->find("*", true, true);
+			for (StringVector::iterator d = dirs->begin(); stamped && d != dirs->end(); ++d)
+			{
+				uint64 dirSize = 0;
+				int64 dirTime = 0;
+				stamped = getLocationStamp(arch->getName() + "/" + *d, dirSize, dirTime, isDir);
+				entry.dirs.push_back(std::pair<String, int64>(*d, dirTime));
+			}
+		}
+
+		FileInfoListPtr files = arch->findFileInfo("*", recursive, false);
+
+		// Locations which aren't on the file system can't be cached
+		if (stamped)
+		{
+			entry.files = *files;
+			for (FileInfoList::iterator f = entry.files.begin(); f != entry.files.end(); ++f)
+				f->archive = 0;
+
+			OGRE_LOCK_MUTEX(mLocationCacheMutex)
+			mLocationCache[getLocationCacheKey(arch, locType, recursive)] = entry;
+			mLocationCacheDirty = true;
+		}
+		return files;
+	}
+	//-------------------------------------------------------------------------
+	void ResourceGroupManager::findLocationFiles(const ResourceLocation* loc, 
+		const String& pattern, FileInfoList& result) const
+	{
+		// Same rules as the archives: if pattern contains a directory name,
+		// do a full match
+		bool fullMatch = (pattern.find('/') != String::npos) ||
+			(pattern.find('\\') != String::npos);
+		bool caseSensitive = loc->archive->isCaseSensitive();
+
+		FileInfoList::const_iterator i, iend;
+		iend = loc->files->end();
+		for (i = loc->files->begin(); i != iend; ++i)
+		{
+			if (StringUtil::match(fullMatch ? i->filename : i->basename, pattern, caseSensitive))
+				result.push_back(*i);
+		}
+	}
+	//-------------------------------------------------------------------------
+	void ResourceGroupManager::setResourceLocationCache(const String& filename)
+	{
+		OGRE_LOCK_MUTEX(mLocationCacheMutex)
+
+		mLocationCache.clear();
+		mLocationCacheDirty = false;
+		mLocationCacheFile = filename;
+		if (filename.empty())
+			return;
+
+		std::ifstream in;
+		in.open(filename.c_str(), std::ios::in | std::ios::binary);
+		if (!in)
+		{
+			// Nothing cached yet, written once locations have been scanned
+			return;
+		}
+
+		uint32 magic, version, count;
+		bool valid = readCacheValue(in, magic) && readCacheValue(in, version) &&
+			readCacheValue(in, count) && magic == LOCATION_CACHE_MAGIC && 
+			version == LOCATION_CACHE_VERSION;
+		for (uint32 e = 0; valid && e < count; ++e)
+		{
+			String key;
+			LocationCacheEntry entry;
+			uint32 numDirs, numFiles;
+			valid = readCacheString(in, key) && readCacheValue(in, entry.size) &&
+				readCacheValue(in, entry.modifiedTime) && readCacheValue(in, numDirs);
+			for (uint32 d = 0; valid && d < numDirs; ++d)
+			{
+				std::pair<String, int64> dir;
+				valid = readCacheString(in, dir.first) && readCacheValue(in, dir.second);
+				entry.dirs.push_back(dir);
+			}
+			valid = valid && readCacheValue(in, numFiles);
+			for (uint32 f = 0; valid && f < numFiles; ++f)
+			{
+				FileInfo info;
+				uint64 compressedSize, uncompressedSize;
+				valid = readCacheString(in, info.filename) && readCacheString(in, info.path) &&
+					readCacheString(in, info.basename) && readCacheValue(in, compressedSize) &&
+					readCacheValue(in, uncompressedSize);
+				info.archive = 0;
+				info.compressedSize = static_cast<size_t>(compressedSize);
+				info.uncompressedSize = static_cast<size_t>(uncompressedSize);
+				entry.files.push_back(info);
+			}
+			if (valid)
+				mLocationCache[key] = entry;
+		}
+
+		if (!valid)
+		{
+			mLocationCache.clear();
+			LogManager::getSingleton().logMessage(
+				"Resource location cache " + filename + " is invalid, ignoring it");
+			// Replace it at the next opportunity
+			mLocationCacheDirty = true;
+		}
+		else
+		{
+			LogManager::getSingleton().logMessage("Read " + 
+				StringConverter::toString(mLocationCache.size()) + 
+				" cached resource locations from " + filename);
+		}
+	}
+	//-------------------------------------------------------------------------
+	void ResourceGroupManager::saveResourceLocationCache(void)
+	{
+		OGRE_LOCK_MUTEX(mLocationCacheMutex)
+
+		if (!mLocationCacheDirty || mLocationCacheFile.empty())
+			return;
+
+		std::ofstream out;
+		out.open(mLocationCacheFile.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+		if (out)
+		{
+			writeCacheValue(out, LOCATION_CACHE_MAGIC);
+			writeCacheValue(out, LOCATION_CACHE_VERSION);
+			writeCacheValue(out, static_cast<uint32>(mLocationCache.size()));
+			for (LocationCache::iterator i = mLocationCache.begin(); i != mLocationCache.end(); ++i)
+			{
+				const LocationCacheEntry& entry = i->second;
+				writeCacheString(out, i->first);
+				writeCacheValue(out, entry.size);
+				writeCacheValue(out, entry.modifiedTime);
+				writeCacheValue(out, static_cast<uint32>(entry.dirs.size()));
+				for (size_t d = 0; d < entry.dirs.size(); ++d)
+				{
+					writeCacheString(out, entry.dirs[d].first);
+					writeCacheValue(out, entry.dirs[d].second);
+				}
+				writeCacheValue(out, static_cast<uint32>(entry.files.size()));
+				for (FileInfoList::const_iterator f = entry.files.begin(); f != entry.files.end(); ++f)
+				{
+					writeCacheString(out, f->filename);
+					writeCacheString(out, f->path);
+					writeCacheString(out, f->basename);
+					writeCacheValue(out, static_cast<uint64>(f->compressedSize));
+					writeCacheValue(out, static_cast<uint64>(f->uncompressedSize));
+				}
+			}
+			out.close();
+		}
+
+		if (out.fail())
+		{
+			LogManager::getSingleton().logMessage(
+				"Unable to write resource location cache " + mLocationCacheFile);
+		}
+		else
+		{
+			mLocationCacheDirty = false;
+		}
+	}
 	//---------------------------------------------------------------------
 	//---------------------------------------------------------------------
 	void ResourceGroupManager::ResourceGroup::addToIndex(const String& filename, Archive* arch)
@@ -1974,7 +2287,7 @@ namespace Ogre {
 		{
 			String lcase = filename;
 			StringUtil::toLowerCase(lcase);
-			i = this->resourceIndexCaseInsensitive.find(filename);
+			i = this->resourceIndexCaseInsensitive.find(lcase);
 			if (i != this->resourceIndexCaseInsensitive.end() && i->second == arch)
 				this->resourceIndexCaseInsensitive.erase(i);
 		}
@@ -34,15 +34,29 @@ THE SOFTWARE.
 #include "OgreStringVector.h"
 #include "OgreStringConverter.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreResourceBackgroundQueue.h"
 
 namespace Ogre {
 
+	typedef std::pair<unsigned long, ResourcePtr> EvictionCandidate;
+	typedef vector<EvictionCandidate>::type EvictionCandidateList;
+	/// Orders eviction candidates by the frame they were last used in
+	struct ResourceLastUsedLess
+	{
+		bool operator()(const EvictionCandidate& a, const EvictionCandidate& b) const
+		{
+			return a.first < b.first;
+		}
+	};
+
     //-----------------------------------------------------------------------
     ResourceManager::ResourceManager()
-		: mNextHandle(1), mMemoryUsage(0), mVerbose(true), mLoadOrder(0)
+		: mNextHandle(1), mMemoryUsage(0), mCurrentFrame(0), mResidencyHits(0), mBackgroundEviction(true),
+		mEvictionNeedsRenderSystem(true), mVerbose(true), mLoadOrder(0)
     {
         // Init memory limit & usage
         mMemoryBudget = std::numeric_limits<unsigned long>::max();
+		mMemoryLowWatermark = mMemoryBudget;
     }
     //-----------------------------------------------------------------------
     ResourceManager::~ResourceManager()
@@ -210,6 +224,8 @@ namespace Ogre {
 			}
 		}
 
+		mEvictedResources.erase(res->getHandle());
+
 		ResourceHandleMap::iterator handleIt = mResourcesByHandle.find(res->getHandle());
 		if (handleIt != mResourcesByHandle.end())
 		{
@@ -470,12 +486,111 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ResourceManager::checkUsage(void)
     {
-        // TODO Page out here?
+		EvictionCandidateList candidates;
+		size_t usage;
+		size_t target;
+		{
+			OGRE_LOCK_AUTO_MUTEX
+
+			if (mMemoryUsage <= mMemoryBudget)
+				return;
+
+			// Memory already on its way out in the background counts as freed
+			usage = mMemoryUsage;
+			target = std::min(mMemoryLowWatermark, mMemoryBudget);
+			for (ResourceHandleMap::iterator i = mResourcesByHandle.begin();
+				i != mResourcesByHandle.end(); ++i)
+			{
+				const ResourcePtr& res = i->second;
+				if (!res->isLoaded())
+					continue;
+				if (mPendingEvictions.find(i->first) != mPendingEvictions.end())
+				{
+					usage -= std::min(usage, res->getSize());
+					continue;
+				}
+				if (res->getLastUsedFrame() != mCurrentFrame.get() && isEvictable(res))
+					candidates.push_back(EvictionCandidate(res->getLastUsedFrame(), res));
+			}
+		}
+
+		// Least recently used first; unload outside the manager lock since
+		// unloading locks the resource, which loading locks before the manager
+		std::stable_sort(candidates.begin(), candidates.end(), 
+			ResourceLastUsedLess());
+		for (EvictionCandidateList::iterator i = candidates.begin(); 
+			i != candidates.end() && usage > target; ++i)
+		{
+			usage -= std::min(usage, i->second->getSize());
+			evict(i->second);
+		}
     }
+	//-----------------------------------------------------------------------
+	bool ResourceManager::isEvictable(const ResourcePtr& res) const
+	{
+		// The resource system itself holds a fixed number of references
+		return res->isReloadable() && 
+			res.useCount() <= ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS;
+	}
+	//-----------------------------------------------------------------------
+	void ResourceManager::evict(const ResourcePtr& res)
+	{
+		{
+			OGRE_LOCK_AUTO_MUTEX
+
+			++mResidencyStats.evictions;
+			mEvictedResources.insert(res->getHandle());
+		}
+
+#if OGRE_THREAD_SUPPORT
+		if (mBackgroundEviction && !mEvictionNeedsRenderSystem && 
+			ResourceBackgroundQueue::getSingletonPtr())
+		{
+			{
+				OGRE_LOCK_AUTO_MUTEX
+				mPendingEvictions.insert(res->getHandle());
+			}
+			ResourceBackgroundQueue::getSingleton().unload(mResourceType, res->getHandle());
+			return;
+		}
+#endif
+		res->unload();
+	}
+	//-----------------------------------------------------------------------
+	void ResourceManager::_updateResidency(void)
+	{
+		checkUsage();
+
+		// Only ever written here, under the lock
+		OGRE_LOCK_AUTO_MUTEX
+		mCurrentFrame.set(mCurrentFrame.get() + 1);
+	}
+	//-----------------------------------------------------------------------
+	ResourceManager::ResidencyStats ResourceManager::getResidencyStats(void) const
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		ResidencyStats stats = mResidencyStats;
+		stats.hits = mResidencyHits.get();
+		return stats;
+	}
+	//-----------------------------------------------------------------------
+	void ResourceManager::resetResidencyStats(void)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		mResidencyStats = ResidencyStats();
+		mResidencyHits.set(0);
+	}
 	//-----------------------------------------------------------------------
 	void ResourceManager::_notifyResourceTouched(Resource* res)
 	{
-		// TODO
+		// Nothing to do by default, residency is tracked by _notifyResourceUsed
+	}
+	//-----------------------------------------------------------------------
+	void ResourceManager::_notifyResourceUsed(Resource* res, bool resident)
+	{
+		res->_notifyUsed(mCurrentFrame.get());
+		if (resident)
+			++mResidencyHits;
 	}
 	//-----------------------------------------------------------------------
 	void ResourceManager::_notifyResourceLoaded(Resource* res)
@@ -483,6 +598,11 @@ namespace Ogre {
 		OGRE_LOCK_AUTO_MUTEX
 
 		mMemoryUsage += res->getSize();
+		// A resource loaded for any reason counts as used, so it is not
+		// evicted again before it has been rendered
+		res->_notifyUsed(mCurrentFrame.get());
+		if (mEvictedResources.erase(res->getHandle()))
+			++mResidencyStats.reloads;
 	}
 	//-----------------------------------------------------------------------
 	void ResourceManager::_notifyResourceUnloaded(Resource* res)
@@ -490,6 +610,7 @@ namespace Ogre {
 		OGRE_LOCK_AUTO_MUTEX
 
 		mMemoryUsage -= res->getSize();
+		mPendingEvictions.erase(res->getHandle());
 	}
 	//---------------------------------------------------------------------
 	ResourceManager::ResourcePool* ResourceManager::getResourcePool(const String& name)
@@ -54,6 +54,7 @@ THE SOFTWARE.
 #include "OgreArchiveManager.h"
 #include "OgrePlugin.h"
 #include "OgreFileSystem.h"
+#include "OgrePackArchive.h"
 #include "OgreShadowVolumeExtrudeProgram.h"
 #include "OgreResourceBackgroundQueue.h"
 #include "OgreEntity.h"
@@ -66,6 +67,7 @@ THE SOFTWARE.
 #include "OgrePlatformInformation.h"
 #include "OgreConvexBody.h"
 #include "Threading/OgreDefaultWorkQueue.h"
+#include "OgreParallelTasks.h"
 	
 #if OGRE_NO_FREEIMAGE == 0
 #include "OgreFreeImageCodec.h"
@@ -173,6 +175,7 @@ namespace Ogre {
 		defaultQ->setWorkersCanAccessRenderSystem(false);
 #endif
 		mWorkQueue = defaultQ;
+		ParallelTasks::_registerWorkQueue(mWorkQueue);
 
 		// ResourceBackgroundQueue
 		mResourceBackgroundQueue = OGRE_NEW ResourceBackgroundQueue();
@@ -225,6 +228,8 @@ namespace Ogre {
 #endif
         mFileSystemArchiveFactory = OGRE_NEW FileSystemArchiveFactory();
         ArchiveManager::getSingleton().addArchiveFactory( mFileSystemArchiveFactory );
+        mPackArchiveFactory = OGRE_NEW PackArchiveFactory();
+        ArchiveManager::getSingleton().addArchiveFactory( mPackArchiveFactory );
 #if OGRE_NO_ZIP_ARCHIVE == 0
         mZipArchiveFactory = OGRE_NEW ZipArchiveFactory();
         ArchiveManager::getSingleton().addArchiveFactory( mZipArchiveFactory );
@@ -317,6 +322,7 @@ namespace Ogre {
 #if OGRE_NO_ZIP_ARCHIVE == 0
         OGRE_DELETE mZipArchiveFactory;
 #endif
+        OGRE_DELETE mPackArchiveFactory;
         OGRE_DELETE mFileSystemArchiveFactory;
         OGRE_DELETE mSkeletonManager;
         OGRE_DELETE mMeshManager;
@@ -344,6 +350,7 @@ namespace Ogre {
 		OGRE_DELETE mBillboardChainFactory;
 		OGRE_DELETE mRibbonTrailFactory;
 
+		ParallelTasks::_unregisterWorkQueue(mWorkQueue);
 		OGRE_DELETE mWorkQueue;
 
 		OGRE_DELETE mTimer;
@@ -865,6 +872,19 @@ namespace Ogre {
 		// Tell the queue to process responses
 		mWorkQueue->processResponses();
 
+		// Upload mipmaps of streamed textures within this frame's budget
+		if (TextureManager::getSingletonPtr())
+			TextureManager::getSingleton()._updateStreaming();
+
+		// Evict least recently used resources from managers over budget
+		if (ResourceGroupManager::getSingletonPtr())
+		{
+			ResourceGroupManager::ResourceManagerIterator rmi = 
+				ResourceGroupManager::getSingleton().getResourceManagerIterator();
+			while (rmi.hasMoreElements())
+				rmi.getNext()->_updateResidency();
+		}
+
 		OgreProfileEndGroup("Frame", OGREPROF_GENERAL);
 
         return ret;
@@ -1564,9 +1584,11 @@ namespace Ogre {
 		if (mWorkQueue != queue)
 		{
 			// delete old one (will shut down)
+			ParallelTasks::_unregisterWorkQueue(mWorkQueue);
 			OGRE_DELETE mWorkQueue;
 
 			mWorkQueue = queue;
+			ParallelTasks::_registerWorkQueue(mWorkQueue);
 			if (mIsInitialised)
 				mWorkQueue->startup();
 
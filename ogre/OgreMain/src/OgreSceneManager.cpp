@@ -1188,6 +1188,10 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
 				}
 				pTex->_setTexturePtr(refTex);
 			}
+			// Stamp the texture as used this frame for its manager's memory budget
+			const TexturePtr& boundTex = pTex->_getTexturePtr();
+			if (!boundTex.isNull())
+				boundTex->touch();
 			mDestRenderSystem->_setTextureUnitSettings(unit, *pTex);
 			++unit;
 		}
@@ -1343,6 +1347,8 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     // Update controllers 
     ControllerManager::getSingleton().updateAllControllers();
+    // Complete particle system updates which were queued to worker threads
+    ParticleSystemManager::getSingleton()._processQueuedUpdates();
 
     // Update the scene, only do this once per frame
     unsigned long thisFrameNumber = Root::getSingleton().getNextFrameNumber();
@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include "OgreScriptLexer.h"
 #include "OgreScriptParser.h"
 #include "OgreScriptTranslator.h"
+#include "OgreParallelTasks.h"
+#include "OgreArchive.h"
 
 namespace Ogre
 {
@@ -273,17 +275,297 @@ namespace Ogre
 		}
 	}
 
+	// Script cache
+	namespace
+	{
+		const uint32 SCRIPT_CACHE_MAGIC = 0x4343534F; // 'OSCC'
+		// Bump whenever the tree processing or this format changes
+		const uint32 SCRIPT_CACHE_VERSION = 1;
+
+		uint32 hashText(const String &str)
+		{
+			return FastHash(str.data(), static_cast<int>(str.size()));
+		}
+
+		class ScriptCacheWriter
+		{
+		public:
+			ScriptCacheWriter(vector<uchar>::type &buffer) : mBuffer(buffer) {}
+
+			void write(const void *data, size_t size)
+			{
+				const uchar *bytes = static_cast<const uchar*>(data);
+				mBuffer.insert(mBuffer.end(), bytes, bytes + size);
+			}
+			void writeUInt32(uint32 val) { write(&val, sizeof(val)); }
+			void writeString(const String &str)
+			{
+				writeUInt32(static_cast<uint32>(str.size()));
+				write(str.data(), str.size());
+			}
+
+			void writeNodes(const AbstractNodeList &nodes)
+			{
+				writeUInt32(static_cast<uint32>(nodes.size()));
+				for(AbstractNodeList::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
+					writeNode(i->get());
+			}
+
+			void writeNode(const AbstractNode *node)
+			{
+				uchar type = static_cast<uchar>(node->type);
+				write(&type, 1);
+				writeFile(node->file);
+				writeUInt32(node->line);
+				switch(node->type)
+				{
+				case ANT_ATOM:
+					writeString(static_cast<const AtomAbstractNode*>(node)->value);
+					break;
+				case ANT_OBJECT:
+					{
+						const ObjectAbstractNode *obj = static_cast<const ObjectAbstractNode*>(node);
+						writeString(obj->name);
+						writeString(obj->cls);
+						writeUInt32(static_cast<uint32>(obj->bases.size()));
+						for(std::vector<String>::const_iterator i = obj->bases.begin(); i != obj->bases.end(); ++i)
+							writeString(*i);
+						uchar isAbstract = obj->abstract ? 1 : 0;
+						write(&isAbstract, 1);
+						const map<String,String>::type &vars = obj->getVariables();
+						writeUInt32(static_cast<uint32>(vars.size()));
+						for(map<String,String>::type::const_iterator i = vars.begin(); i != vars.end(); ++i)
+						{
+							writeString(i->first);
+							writeString(i->second);
+						}
+						writeNodes(obj->children);
+						writeNodes(obj->values);
+						writeNodes(obj->overrides);
+					}
+					break;
+				case ANT_PROPERTY:
+					{
+						const PropertyAbstractNode *prop = static_cast<const PropertyAbstractNode*>(node);
+						writeString(prop->name);
+						writeNodes(prop->values);
+					}
+					break;
+				case ANT_IMPORT:
+					{
+						const ImportAbstractNode *import = static_cast<const ImportAbstractNode*>(node);
+						writeString(import->target);
+						writeString(import->source);
+					}
+					break;
+				case ANT_VARIABLE_ACCESS:
+					writeString(static_cast<const VariableAccessAbstractNode*>(node)->name);
+					break;
+				default:
+					break;
+				}
+			}
+		private:
+			// File names are written once and referred to by index
+			void writeFile(const String &file)
+			{
+				map<String, uint32>::type::iterator i = mFiles.find(file);
+				if(i != mFiles.end())
+				{
+					writeUInt32(i->second);
+				}
+				else
+				{
+					uint32 index = static_cast<uint32>(mFiles.size());
+					mFiles[file] = index;
+					writeUInt32(index);
+					writeString(file);
+				}
+			}
+
+			vector<uchar>::type &mBuffer;
+			map<String, uint32>::type mFiles;
+		};
+
+		class ScriptCacheReader
+		{
+		public:
+			ScriptCacheReader(const uchar *data, size_t size, const ScriptCompiler::IdMap &ids)
+				: mPos(data), mEnd(data + size), mIds(ids), mValid(true) {}
+
+			bool isValid() const { return mValid; }
+
+			void read(void *data, size_t size)
+			{
+				if(!mValid || static_cast<size_t>(mEnd - mPos) < size)
+				{
+					mValid = false;
+					memset(data, 0, size);
+					return;
+				}
+				memcpy(data, mPos, size);
+				mPos += size;
+			}
+			uint32 readUInt32()
+			{
+				uint32 val;
+				read(&val, sizeof(val));
+				return val;
+			}
+			String readString()
+			{
+				uint32 size = readUInt32();
+				if(!mValid || static_cast<size_t>(mEnd - mPos) < size)
+				{
+					mValid = false;
+					return StringUtil::BLANK;
+				}
+				String str(reinterpret_cast<const char*>(mPos), size);
+				mPos += size;
+				return str;
+			}
+
+			void readNodes(AbstractNodeList &nodes, AbstractNode *parent)
+			{
+				uint32 count = readUInt32();
+				for(uint32 i = 0; i < count && mValid; ++i)
+				{
+					AbstractNode *node = readNode(parent);
+					if(node)
+						nodes.push_back(AbstractNodePtr(node));
+				}
+			}
+
+			AbstractNode *readNode(AbstractNode *parent)
+			{
+				uchar type;
+				read(&type, 1);
+				String file = readFile();
+				uint32 line = readUInt32();
+				if(!mValid)
+					return 0;
+
+				AbstractNode *node = 0;
+				switch(type)
+				{
+				case ANT_ATOM:
+					{
+						AtomAbstractNode *atom = OGRE_NEW AtomAbstractNode(parent);
+						atom->value = readString();
+						atom->id = lookupId(atom->value);
+						node = atom;
+					}
+					break;
+				case ANT_OBJECT:
+					{
+						ObjectAbstractNode *obj = OGRE_NEW ObjectAbstractNode(parent);
+						node = obj;
+						obj->name = readString();
+						obj->cls = readString();
+						obj->id = lookupId(obj->cls);
+						uint32 numBases = readUInt32();
+						for(uint32 i = 0; i < numBases && mValid; ++i)
+							obj->bases.push_back(readString());
+						uchar isAbstract;
+						read(&isAbstract, 1);
+						obj->abstract = isAbstract != 0;
+						uint32 numVars = readUInt32();
+						for(uint32 i = 0; i < numVars && mValid; ++i)
+						{
+							String name = readString();
+							obj->setVariable(name, readString());
+						}
+						readNodes(obj->children, obj);
+						readNodes(obj->values, obj);
+						readNodes(obj->overrides, obj);
+					}
+					break;
+				case ANT_PROPERTY:
+					{
+						PropertyAbstractNode *prop = OGRE_NEW PropertyAbstractNode(parent);
+						node = prop;
+						prop->name = readString();
+						prop->id = lookupId(prop->name);
+						readNodes(prop->values, prop);
+					}
+					break;
+				case ANT_IMPORT:
+					{
+						ImportAbstractNode *import = OGRE_NEW ImportAbstractNode();
+						import->parent = parent;
+						import->target = readString();
+						import->source = readString();
+						node = import;
+					}
+					break;
+				case ANT_VARIABLE_ACCESS:
+					{
+						VariableAccessAbstractNode *var = OGRE_NEW VariableAccessAbstractNode(parent);
+						var->name = readString();
+						node = var;
+					}
+					break;
+				default:
+					mValid = false;
+					return 0;
+				}
+				node->file = file;
+				node->line = line;
+				return node;
+			}
+		private:
+			String readFile()
+			{
+				uint32 index = readUInt32();
+				if(index == mFiles.size())
+					mFiles.push_back(readString());
+				else if(index > mFiles.size())
+					mValid = false;
+				return mValid ? mFiles[index] : StringUtil::BLANK;
+			}
+
+			// Word ids aren't stored; they are looked up as AbstractTreeBuilder does
+			uint32 lookupId(const String &word) const
+			{
+				ScriptCompiler::IdMap::const_iterator i = mIds.find(word);
+				return i != mIds.end() ? i->second : 0;
+			}
+
+			const uchar *mPos, *mEnd;
+			const ScriptCompiler::IdMap &mIds;
+			vector<String>::type mFiles;
+			bool mValid;
+		};
+	}
+
+	OGRE_STATIC_MUTEX_INSTANCE(ScriptCompiler::msCacheMutex)
+
 	ScriptCompiler::ScriptCompiler()
-		:mListener(0)
+		:mListener(0), mImportSources(0), mImportMissing(false), mCache(0), mCacheText(0)
 	{
 		initWordMap();
 	}
 
 	bool ScriptCompiler::compile(const String &str, const String &source, const String &group)
 	{
+		bool useCache = mCache && !mListener;
+		if(useCache)
+		{
+			// Imports are checked in the group, as loadImportPath looks them up
+			mGroup = group;
+			AbstractNodeListPtr ast = loadCachedAST(str, source);
+			if(!ast.isNull())
+				return _compilePrepared(ast, ErrorList(), group);
+		}
+
 		ScriptLexer lexer;
 		ScriptParser parser;
 		ConcreteNodeListPtr nodes = parser.parse(lexer.tokenize(str, source));
+		if(useCache)
+		{
+			mCacheText = &str;
+			mCacheSource = source;
+		}
 		return compile(nodes, group);
 	}
 
@@ -343,6 +625,10 @@ namespace Ogre
 	{
 		LogManager::getSingleton().logMessage("ScriptCompiler::compile called");
 		
+		// Only set by compile(str, source, group) for this call
+		const String *cacheText = mCacheText;
+		mCacheText = 0;
+
 		// Set up the compilation context
 		mGroup = group;
 
@@ -351,6 +637,7 @@ namespace Ogre
 
 		// Clear the environment
 		mEnv.clear();
+		mImportHashes.clear();
 
 		if(mListener)
 			mListener->preConversion(this, nodes);
@@ -364,6 +651,9 @@ namespace Ogre
 		// Process variable expansion
 		processVariables(ast.get());
 
+		if(cacheText && mErrors.empty())
+			saveCachedAST(ast, *cacheText, mCacheSource);
+
 		// Allows early bail-out through the listener
 		if(mListener && !mListener->postConversion(this, ast))
 			return mErrors.empty();
@@ -448,6 +738,82 @@ namespace Ogre
 		return mErrors.empty();
 	}
 
+	AbstractNodeListPtr ScriptCompiler::_prepare(const String &str, const String &source, const ImportSourceMap &importSources, ErrorList &errors)
+	{
+		mErrors.clear();
+		mEnv.clear();
+		mImportHashes.clear();
+		mImportSources = &importSources;
+		mImportMissing = false;
+
+		AbstractNodeListPtr ast;
+		if(mCache && !mListener)
+		{
+			ast = loadCachedAST(str, source);
+			if(!ast.isNull())
+			{
+				mImportSources = 0;
+				errors.clear();
+				return ast;
+			}
+		}
+
+		try
+		{
+			ScriptLexer lexer;
+			ScriptParser parser;
+			ast = convertToAST(parser.parse(lexer.tokenize(str, source)));
+			processImports(ast);
+			processObjects(ast.get(), ast);
+			processVariables(ast.get());
+		}
+		catch(...)
+		{
+			mImportSources = 0;
+			mImports.clear();
+			mImportRequests.clear();
+			mImportTable.clear();
+			throw;
+		}
+
+		mImportSources = 0;
+		mImports.clear();
+		mImportRequests.clear();
+		mImportTable.clear();
+
+		errors = mErrors;
+		mErrors.clear();
+		if(mImportMissing)
+			ast.setNull();
+		else if(mCache && !mListener && errors.empty())
+			saveCachedAST(ast, str, source);
+		return ast;
+	}
+
+	bool ScriptCompiler::_compilePrepared(const AbstractNodeListPtr &nodes, const ErrorList &errors, const String &group)
+	{
+		LogManager::getSingleton().logMessage("ScriptCompiler::compile called");
+
+		mGroup = group;
+		mErrors.clear();
+		mEnv.clear();
+
+		// Report the errors found while preparing, as compile would have
+		for(ErrorList::const_iterator i = errors.begin(); i != errors.end(); ++i)
+			addError((*i)->code, (*i)->file, (*i)->line, (*i)->message);
+
+		for(AbstractNodeList::iterator i = nodes->begin(); i != nodes->end(); ++i)
+		{
+			if((*i)->type == ANT_OBJECT && reinterpret_cast<ObjectAbstractNode*>((*i).get())->abstract)
+				continue;
+			ScriptTranslator *translator = ScriptCompilerManager::getSingleton().getTranslator(*i);
+			if(translator)
+				translator->translate(this, *i);
+		}
+
+		return mErrors.empty();
+	}
+
 	void ScriptCompiler::addError(uint32 code, const Ogre::String &file, int line, const String &msg)
 	{
 		ErrorPtr err(OGRE_NEW Error());
@@ -456,7 +822,11 @@ namespace Ogre
 		err->line = line;
 		err->message = msg;
 
-		if(mListener)
+		if(mImportSources)
+		{
+			// Preparing; errors are reported later by _compilePrepared
+		}
+		else if(mListener)
 		{
 			mListener->handleError(this, code, file, line, msg);
 		}
@@ -473,6 +843,131 @@ namespace Ogre
 		mErrors.push_back(err);
 	}
 
+	void ScriptCompiler::setCache(Archive *cache)
+	{
+		mCache = cache;
+	}
+
+	Archive *ScriptCompiler::getCache() const
+	{
+		return mCache;
+	}
+
+	static String getScriptCacheFileName(const String &source)
+	{
+		return StringConverter::toString(hashText(source), 8, '0', std::ios::hex) + ".scriptcache";
+	}
+
+	AbstractNodeListPtr ScriptCompiler::loadCachedAST(const String &str, const String &source)
+	{
+		AbstractNodeListPtr retval;
+
+		vector<uchar>::type data;
+		{
+			OGRE_LOCK_MUTEX(msCacheMutex)
+			String filename = getScriptCacheFileName(source);
+			try
+			{
+				if(!mCache->exists(filename))
+					return retval;
+				DataStreamPtr stream = mCache->open(filename);
+				data.resize(stream->size());
+				if(data.empty() || stream->read(&data[0], data.size()) != data.size())
+					return retval;
+			}
+			catch(Exception&)
+			{
+				return retval;
+			}
+		}
+
+		ScriptCacheReader reader(&data[0], data.size(), mIds);
+		if(reader.readUInt32() != SCRIPT_CACHE_MAGIC ||
+			reader.readUInt32() != SCRIPT_CACHE_VERSION ||
+			reader.readUInt32() != OGRE_VERSION ||
+			reader.readUInt32() != static_cast<uint32>(str.size()) ||
+			reader.readUInt32() != hashText(str) ||
+			reader.readString() != source)
+			return retval;
+
+		// Every import must still have the text the tree was built from
+		uint32 numImports = reader.readUInt32();
+		for(uint32 i = 0; i < numImports && reader.isValid(); ++i)
+		{
+			String name = reader.readString();
+			uint32 size = reader.readUInt32();
+			uint32 hash = reader.readUInt32();
+
+			String text;
+			if(mImportSources)
+			{
+				ImportSourceMap::const_iterator j = mImportSources->find(name);
+				if(j == mImportSources->end())
+					return retval;
+				text = j->second;
+			}
+			else
+			{
+				DataStreamPtr stream;
+				try
+				{
+					stream = ResourceGroupManager::getSingleton().openResource(name, mGroup);
+				}
+				catch(Exception&)
+				{
+				}
+				if(stream.isNull())
+					return retval;
+				text = stream->getAsString();
+			}
+			if(text.size() != size || hashText(text) != hash)
+				return retval;
+			mImportHashes[name] = std::make_pair(text.size(), hash);
+		}
+
+		AbstractNodeListPtr nodes(OGRE_NEW_T(AbstractNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+		reader.readNodes(*nodes, 0);
+		if(reader.isValid())
+			retval = nodes;
+		return retval;
+	}
+
+	void ScriptCompiler::saveCachedAST(const AbstractNodeListPtr &nodes, const String &str, const String &source)
+	{
+		if(mCache->isReadOnly())
+			return;
+
+		vector<uchar>::type data;
+		ScriptCacheWriter writer(data);
+		writer.writeUInt32(SCRIPT_CACHE_MAGIC);
+		writer.writeUInt32(SCRIPT_CACHE_VERSION);
+		writer.writeUInt32(OGRE_VERSION);
+		writer.writeUInt32(static_cast<uint32>(str.size()));
+		writer.writeUInt32(hashText(str));
+		writer.writeString(source);
+		writer.writeUInt32(static_cast<uint32>(mImportHashes.size()));
+		for(ImportHashMap::iterator i = mImportHashes.begin(); i != mImportHashes.end(); ++i)
+		{
+			writer.writeString(i->first);
+			writer.writeUInt32(static_cast<uint32>(i->second.first));
+			writer.writeUInt32(i->second.second);
+		}
+		writer.writeNodes(*nodes);
+
+		OGRE_LOCK_MUTEX(msCacheMutex)
+		try
+		{
+			DataStreamPtr stream = mCache->create(getScriptCacheFileName(source));
+			stream->write(&data[0], data.size());
+			stream->close();
+		}
+		catch(Exception &e)
+		{
+			LogManager::getSingleton().logMessage(
+				"Unable to cache script " + source + ": " + e.getDescription());
+		}
+	}
+
 	void ScriptCompiler::setListener(ScriptCompilerListener *listener)
 	{
 		mListener = listener;
@@ -587,18 +1082,34 @@ namespace Ogre
 		AbstractNodeListPtr retval;
 		ConcreteNodeListPtr nodes;
 
+		if(mImportSources)
+		{
+			ImportSourceMap::const_iterator i = mImportSources->find(name);
+			if(i == mImportSources->end())
+			{
+				mImportMissing = true;
+				return retval;
+			}
+			ScriptLexer lexer;
+			ScriptParser parser;
+			nodes = parser.parse(lexer.tokenize(i->second, name));
+			mImportHashes[name] = std::make_pair(i->second.size(), hashText(i->second));
+		}
+
 		if(mListener)
 			nodes = mListener->importFile(this, name);
 
-		if(nodes.isNull() && ResourceGroupManager::getSingletonPtr())
+		if(nodes.isNull() && !mImportSources && ResourceGroupManager::getSingletonPtr())
 		{
 			DataStreamPtr stream = ResourceGroupManager::getSingleton().openResource(name, mGroup);
 			if(!stream.isNull())
 			{
+				String text = stream->getAsString();
 				ScriptLexer lexer;
-				ScriptTokenListPtr tokens = lexer.tokenize(stream->getAsString(), name);
+				ScriptTokenListPtr tokens = lexer.tokenize(text, name);
 				ScriptParser parser;
 				nodes = parser.parse(tokens);
+				mImportHashes[name] = std::make_pair(text.size(), hashText(text));
 			}
 		}
 
@@ -1548,7 +2059,7 @@ namespace Ogre
     }
 	//-----------------------------------------------------------------------
 	ScriptCompilerManager::ScriptCompilerManager()
-		:mListener(0), OGRE_THREAD_POINTER_INIT(mScriptCompiler)
+		:mListener(0), OGRE_THREAD_POINTER_INIT(mScriptCompiler), mCache(0)
 	{
 		OGRE_LOCK_AUTO_MUTEX
 #if OGRE_USE_NEW_COMPILERS == 1
@@ -1583,6 +2094,17 @@ namespace Ogre
 		return mListener;
 	}
 	//-----------------------------------------------------------------------
+	void ScriptCompilerManager::setCache(Archive *cache)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		mCache = cache;
+	}
+	//-----------------------------------------------------------------------
+	Archive *ScriptCompilerManager::getCache()
+	{
+		return mCache;
+	}
+	//-----------------------------------------------------------------------
 	void ScriptCompilerManager::addTranslatorManager(Ogre::ScriptTranslatorManager *man)
 	{
 		OGRE_LOCK_AUTO_MUTEX
@@ -1656,9 +2178,143 @@ namespace Ogre
 		{
 			OGRE_LOCK_AUTO_MUTEX
 			OGRE_THREAD_POINTER_GET(mScriptCompiler)->setListener(mListener);
+			OGRE_THREAD_POINTER_GET(mScriptCompiler)->setCache(mCache);
+		}
+		// Use the tree from _prepareScripts if there is one for this script
+		AbstractNodeListPtr nodes;
+		ScriptCompiler::ErrorList errors;
+		{
+			OGRE_LOCK_AUTO_MUTEX
+			PreparedScriptMap::iterator i = mPreparedScripts.find(stream->getName());
+			if(i != mPreparedScripts.end() && i->second.group == groupName)
+			{
+				if(!mListener)
+				{
+					nodes = i->second.nodes;
+					errors = i->second.errors;
+				}
+				mPreparedScripts.erase(i);
+			}
 		}
-        OGRE_THREAD_POINTER_GET(mScriptCompiler)->compile(stream->getAsString(), stream->getName(), groupName);
+		if(!nodes.isNull())
+			OGRE_THREAD_POINTER_GET(mScriptCompiler)->_compilePrepared(nodes, errors, groupName);
+		else
+			OGRE_THREAD_POINTER_GET(mScriptCompiler)->compile(stream->getAsString(), stream->getName(), groupName);
     }
+	//-----------------------------------------------------------------------
+	namespace
+	{
+		/// Prepares one script per index with a compiler of its own
+		class PrepareScriptsTask : public ParallelTasks::Task
+		{
+		public:
+			struct Item
+			{
+				String name;
+				AbstractNodeListPtr nodes;
+				ScriptCompiler::ErrorList errors;
+			};
+
+			PrepareScriptsTask(vector<Item>::type& items, const ScriptCompiler::ImportSourceMap& sources, Archive* cache)
+				: mItems(items), mSources(sources), mCache(cache) {}
+
+			void run(size_t index)
+			{
+				Item& item = mItems[index];
+				ScriptCompiler::ImportSourceMap::const_iterator src = mSources.find(item.name);
+				try
+				{
+					ScriptCompiler compiler;
+					compiler.setCache(mCache);
+					item.nodes = compiler._prepare(src->second, item.name, mSources, item.errors);
+				}
+				catch(Exception&)
+				{
+					// Leave it to parseScript to compile and report it as usual
+					item.nodes.setNull();
+					item.errors.clear();
+				}
+				catch(std::exception& e)
+				{
+					// Anything else (e.g. bad_alloc) must not escape the worker;
+					// report it against the script when parseScript gets to it
+					ScriptCompiler::ErrorPtr err(OGRE_NEW ScriptCompiler::Error());
+					err->code = ScriptCompiler::CE_OBJECTALLOCATIONERROR;
+					err->file = item.name;
+					err->line = 0;
+					err->message = e.what();
+					item.nodes = AbstractNodeListPtr(OGRE_NEW AbstractNodeList());
+					item.errors.clear();
+					item.errors.push_back(err);
+				}
+			}
+		private:
+			vector<Item>::type& mItems;
+			const ScriptCompiler::ImportSourceMap& mSources;
+			Archive* mCache;
+		};
+	}
+	//-----------------------------------------------------------------------
+	void ScriptCompilerManager::_prepareScripts(const FileInfoList& scripts, const String& groupName)
+	{
+		Archive* cache;
+		{
+			OGRE_LOCK_AUTO_MUTEX
+			if(mListener)
+				return;
+			cache = mCache;
+		}
+		if(scripts.size() < 2)
+			return;
+
+		// Read every script here; opening resources is not safe from the workers.
+		// Names appearing twice are left to the normal path, since an import of
+		// them is ambiguous.
+		ScriptCompiler::ImportSourceMap sources;
+		set<String>::type duplicates;
+		for(FileInfoList::const_iterator i = scripts.begin(); i != scripts.end(); ++i)
+		{
+			if(sources.find(i->filename) != sources.end())
+			{
+				duplicates.insert(i->filename);
+				continue;
+			}
+			DataStreamPtr stream = i->archive->open(i->filename);
+			if(!stream.isNull())
+				sources[i->filename] = stream->getAsString();
+		}
+
+		vector<PrepareScriptsTask::Item>::type items;
+		for(ScriptCompiler::ImportSourceMap::iterator i = sources.begin(); i != sources.end(); ++i)
+		{
+			if(duplicates.find(i->first) != duplicates.end())
+				continue;
+			items.push_back(PrepareScriptsTask::Item());
+			items.back().name = i->first;
+		}
+		for(set<String>::type::iterator i = duplicates.begin(); i != duplicates.end(); ++i)
+			sources.erase(*i);
+
+		PrepareScriptsTask task(items, sources, cache);
+		ParallelTasks::run(task, items.size());
+
+		OGRE_LOCK_AUTO_MUTEX
+		for(vector<PrepareScriptsTask::Item>::type::iterator i = items.begin(); i != items.end(); ++i)
+		{
+			if(i->nodes.isNull())
+				continue;
+			PreparedScript& prepared = mPreparedScripts[i->name];
+			prepared.group = groupName;
+			prepared.nodes = i->nodes;
+			prepared.errors = i->errors;
+		}
+	}
+	//-----------------------------------------------------------------------
+	void ScriptCompilerManager::_endScriptPreparation(void)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		mPreparedScripts.clear();
+	}
 
 	//-------------------------------------------------------------------------
 	String PreApplyTextureAliasesScriptCompilerEvent::eventType = "preApplyTextureAliases";
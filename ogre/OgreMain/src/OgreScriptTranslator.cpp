@@ -481,6 +481,11 @@ namespace Ogre{
 		if(obj->name.empty())
 			compiler->addError(ScriptCompiler::CE_OBJECTNAMEEXPECTED, obj->file, obj->line);
 
+		// Leave it for MaterialManager to translate when first used, if it wants to
+		if(!obj->name.empty() && !compiler->getListener() &&
+			MaterialManager::getSingleton()._deferTranslation(obj->name, compiler->getResourceGroup(), node))
+			return;
+
 		// Create a material with the given name
 		CreateMaterialScriptCompilerEvent evt(node->file, obj->name, compiler->getResourceGroup());
 		bool processed = compiler->_fireEvent(&evt, (void*)&mMaterial);
@@ -33,6 +33,11 @@ THE SOFTWARE.
 #include "OgreException.h"
 #include "OgreVector3.h"
 #include "OgreQuaternion.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_SSE2
+#include <emmintrin.h>
+#endif
 
 
 namespace Ogre {
@@ -270,13 +275,27 @@ namespace Ogre {
     //---------------------------------------------------------------------
     unsigned short Serializer::readChunk(DataStreamPtr& stream)
     {
+        // Read the id and length together, chunk headers are read very often
+        uchar header[sizeof(uint16) + sizeof(uint32)];
+        memset(header, 0, sizeof(header));
+        stream->read(header, sizeof(header));
+
         unsigned short id;
-        readShorts(stream, &id, 1);
-        
-        readInts(stream, &mCurrentstreamLen, 1);
+        memcpy(&id, header, sizeof(uint16));
+        memcpy(&mCurrentstreamLen, header + sizeof(uint16), sizeof(uint32));
+        flipFromLittleEndian(&id, sizeof(uint16));
+        flipFromLittleEndian(&mCurrentstreamLen, sizeof(uint32));
         return id;
     }
     //---------------------------------------------------------------------
+    const uchar* Serializer::getInPlaceData(DataStreamPtr& stream, size_t count) const
+    {
+        const uchar* pData = stream->getDataPtr();
+        if (!pData || stream->size() < stream->tell() + count)
+            return 0;
+        return pData + stream->tell();
+    }
+    //---------------------------------------------------------------------
     void Serializer::readBools(DataStreamPtr& stream, bool* pDest, size_t count)
     {
         //XXX Nasty Hack to convert 1 byte bools to 4 byte bools
@@ -384,9 +403,93 @@ namespace Ogre {
 		}
     }
     
+#if __OGRE_HAVE_SSE2
+    namespace
+    {
+        bool hasSSE2(void)
+        {
+            static const bool sse2 =
+                (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE2) != 0;
+            return sse2;
+        }
+
+        /** Reverses the bytes of words of 2, 4 or 8 bytes, 16 bytes at a time.
+            SSE2 has no byte shuffle, so the 16 bit lanes are put in reverse
+            order within each word and then have their two bytes swapped.
+        @returns the number of words done; the rest are left to the caller
+        */
+        size_t flipEndianSSE2(void* pData, size_t size, size_t count)
+        {
+            uchar* p = static_cast<uchar*>(pData);
+            size_t bytes = (size * count) & ~size_t(15);
+            for (size_t i = 0; i < bytes; i += 16)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+                if (size == 4)
+                    v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+                else if (size == 8)
+                    v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+                v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p + i), v);
+            }
+            return bytes / size;
+        }
+    }
+#endif
+
     void Serializer::flipEndian(void * pData, size_t size, size_t count)
     {
-        for(unsigned int index = 0; index < count; index++)
+#if __OGRE_HAVE_SSE2
+        if ((size == 2 || size == 4 || size == 8) && hasSSE2())
+        {
+            size_t done = flipEndianSSE2(pData, size, count);
+            pData = static_cast<uchar*>(pData) + done * size;
+            count -= done;
+        }
+#endif
+        // Whole words at a time for the common sizes; simple enough loops for
+        // the compiler to vectorise
+        if ((reinterpret_cast<size_t>(pData) & (size - 1)) == 0)
+        {
+            switch (size)
+            {
+            case 2:
+                {
+                    uint16* p = static_cast<uint16*>(pData);
+                    for (size_t i = 0; i < count; ++i)
+                        p[i] = static_cast<uint16>((p[i] >> 8) | (p[i] << 8));
+                }
+                return;
+            case 4:
+                {
+                    uint32* p = static_cast<uint32*>(pData);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        uint32 v = p[i];
+                        p[i] = (v >> 24) | ((v >> 8) & 0x0000FF00) | 
+                            ((v << 8) & 0x00FF0000) | (v << 24);
+                    }
+                }
+                return;
+            case 8:
+                {
+                    uint32* p = static_cast<uint32*>(pData);
+                    for (size_t i = 0; i < count * 2; i += 2)
+                    {
+                        uint32 lo = p[i], hi = p[i + 1];
+                        p[i] = (hi >> 24) | ((hi >> 8) & 0x0000FF00) | 
+                            ((hi << 8) & 0x00FF0000) | (hi << 24);
+                        p[i + 1] = (lo >> 24) | ((lo >> 8) & 0x0000FF00) | 
+                            ((lo << 8) & 0x00FF0000) | (lo << 24);
+                    }
+                }
+                return;
+            default:
+                break;
+            }
+        }
+
+        for(size_t index = 0; index < count; index++)
         {
             flipEndian((void *)((size_t)pData + (index * size)), size);
         }
@@ -0,0 +1,222 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreSkeletonAnimationCache.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreAnimationState.h"
+#include "OgreMatrix4.h"
+#include "OgreMath.h"
+
+namespace Ogre
+{
+	//---------------------------------------------------------------------
+	SkeletonAnimationCache::SkeletonAnimationCache(size_t maxEntries,
+		Real timeQuantum, Real weightQuantum)
+		: mMaxEntries(maxEntries)
+		, mTimeQuantum(timeQuantum)
+		, mWeightQuantum(weightQuantum)
+		, mHits(0)
+		, mMisses(0)
+		, mEvictions(0)
+	{
+	}
+	//---------------------------------------------------------------------
+	SkeletonAnimationCache::~SkeletonAnimationCache()
+	{
+		clear();
+	}
+	//---------------------------------------------------------------------
+	void SkeletonAnimationCache::setMaxEntries(size_t maxEntries)
+	{
+		mMaxEntries = maxEntries;
+		while (mEntries.size() > mMaxEntries)
+			evictOldest();
+	}
+	//---------------------------------------------------------------------
+	void SkeletonAnimationCache::setTimeQuantum(Real quantum)
+	{
+		if (quantum != mTimeQuantum)
+		{
+			mTimeQuantum = quantum;
+			clear();
+		}
+	}
+	//---------------------------------------------------------------------
+	void SkeletonAnimationCache::setWeightQuantum(Real quantum)
+	{
+		if (quantum != mWeightQuantum)
+		{
+			mWeightQuantum = quantum;
+			clear();
+		}
+	}
+	//---------------------------------------------------------------------
+	void SkeletonAnimationCache::clear(void)
+	{
+		for (EntryMap::iterator i = mEntries.begin(); i != mEntries.end(); ++i)
+		{
+			destroyEntry(i->second);
+		}
+		mEntries.clear();
+		mLRUList.clear();
+	}
+	//---------------------------------------------------------------------
+	size_t SkeletonAnimationCache::getNumEntries(void) const
+	{
+		return mEntries.size();
+	}
+	//---------------------------------------------------------------------
+	void SkeletonAnimationCache::resetStatistics(void)
+	{
+		mHits = mMisses = mEvictions = 0;
+	}
+	//---------------------------------------------------------------------
+	bool SkeletonAnimationCache::isCacheable(const AnimationStateSet& animSet)
+	{
+		ConstEnabledAnimationStateIterator it = animSet.getEnabledAnimationStateIterator();
+		while (it.hasMoreElements())
+		{
+			if (it.getNext()->hasBlendMask())
+				return false;
+		}
+		return true;
+	}
+	//---------------------------------------------------------------------
+	SkeletonAnimationCache::CacheKey SkeletonAnimationCache::buildKey(
+		const SkeletonInstance* skel, const AnimationStateSet& animSet)
+	{
+		mScratchSignature.clear();
+		mScratchSignature.push_back(static_cast<int32>(skel->getBlendMode()));
+
+		ConstEnabledAnimationStateIterator it = animSet.getEnabledAnimationStateIterator();
+		while (it.hasMoreElements())
+		{
+			const AnimationState* state = it.getNext();
+			const String& name = state->getAnimationName();
+			mScratchSignature.push_back(static_cast<int32>(
+				FastHash(name.c_str(), static_cast<int>(name.size()))));
+			mScratchSignature.push_back(static_cast<int32>(
+				Math::Floor(state->getTimePosition() / mTimeQuantum + 0.5f)));
+			mScratchSignature.push_back(static_cast<int32>(
+				Math::Floor(state->getWeight() / mWeightQuantum + 0.5f)));
+		}
+
+		CacheKey key;
+		// Instances report the handle of their master skeleton
+		key.skeleton = skel->getHandle();
+		key.hash = FastHash((const char*)&mScratchSignature[0],
+			static_cast<int>(mScratchSignature.size() * sizeof(int32)));
+		return key;
+	}
+	//---------------------------------------------------------------------
+	bool SkeletonAnimationCache::_fetchBoneMatrices(const SkeletonInstance* skel,
+		const AnimationStateSet& animSet, Matrix4* pMatrices)
+	{
+		CacheKey key = buildKey(skel, animSet);
+
+		EntryMap::iterator i = mEntries.find(key);
+		if (i == mEntries.end() ||
+			i->second->numBones != skel->getNumBones() ||
+			i->second->signature != mScratchSignature)
+		{
+			++mMisses;
+			return false;
+		}
+
+		CacheEntry* entry = i->second;
+		memcpy(pMatrices, entry->matrices, sizeof(Matrix4) * entry->numBones);
+		// Move to the front of the LRU list
+		mLRUList.splice(mLRUList.begin(), mLRUList, entry->lruPos);
+		++mHits;
+		return true;
+	}
+	//---------------------------------------------------------------------
+	void SkeletonAnimationCache::_storeBoneMatrices(const SkeletonInstance* skel,
+		const AnimationStateSet& animSet, const Matrix4* pMatrices)
+	{
+		if (mMaxEntries == 0)
+			return;
+
+		CacheKey key = buildKey(skel, animSet);
+		unsigned short numBones = skel->getNumBones();
+
+		CacheEntry* entry;
+		EntryMap::iterator i = mEntries.find(key);
+		if (i != mEntries.end())
+		{
+			// Replace the existing entry (hash collision or changed skeleton)
+			entry = i->second;
+			if (entry->numBones != numBones)
+			{
+				OGRE_FREE_SIMD(entry->matrices, MEMCATEGORY_ANIMATION);
+				entry->matrices = static_cast<Matrix4*>(
+					OGRE_MALLOC_SIMD(sizeof(Matrix4) * numBones, MEMCATEGORY_ANIMATION));
+				entry->numBones = numBones;
+			}
+			mLRUList.splice(mLRUList.begin(), mLRUList, entry->lruPos);
+		}
+		else
+		{
+			while (mEntries.size() >= mMaxEntries)
+				evictOldest();
+
+			entry = OGRE_NEW CacheEntry();
+			entry->key = key;
+			entry->numBones = numBones;
+			entry->matrices = static_cast<Matrix4*>(
+				OGRE_MALLOC_SIMD(sizeof(Matrix4) * numBones, MEMCATEGORY_ANIMATION));
+			mLRUList.push_front(entry);
+			entry->lruPos = mLRUList.begin();
+			mEntries[key] = entry;
+		}
+
+		entry->signature = mScratchSignature;
+		memcpy(entry->matrices, pMatrices, sizeof(Matrix4) * numBones);
+	}
+	//---------------------------------------------------------------------
+	void SkeletonAnimationCache::evictOldest(void)
+	{
+		if (mLRUList.empty())
+			return;
+
+		CacheEntry* entry = mLRUList.back();
+		mLRUList.pop_back();
+		mEntries.erase(entry->key);
+		destroyEntry(entry);
+		++mEvictions;
+	}
+	//---------------------------------------------------------------------
+	void SkeletonAnimationCache::destroyEntry(CacheEntry* entry)
+	{
+		OGRE_FREE_SIMD(entry->matrices, MEMCATEGORY_ANIMATION);
+		OGRE_DELETE entry;
+	}
+
+}
+
@@ -47,6 +47,8 @@ namespace Ogre
     {
         mLoadOrder = 300.0f;
         mResourceType = "Skeleton";
+		// Skeletons live in system memory, so can be unloaded on any thread
+		mEvictionNeedsRenderSystem = false;
 
         ResourceGroupManager::getSingleton()._registerResourceManager(mResourceType, this);
     }
@@ -74,6 +74,7 @@ namespace Ogre {
 		mSpaceWidth = 0;
 		mPixelSpaceWidth = 0;
 		mViewportAspectCoef = 1;
+		mGlyphGeneration = 0;
 
         if (createParamDictionary("TextAreaOverlayElement"))
         {
@@ -339,6 +340,14 @@ namespace Ogre {
 
 		if (getWidth() < largestWidth)
 			setWidth(largestWidth);
+
+		// Glyphs of fonts with a glyph atlas are rendered as they are asked for
+		// above, which may move others. Pages holding glyphs used this frame are
+		// only cleared when nothing else can be, so if that moved glyphs of the 
+		// caption itself, it has more than the atlas holds and building it again
+		// would only do the same; the generation is taken after the build so
+		// that only glyphs moved later cause a rebuild.
+		mGlyphGeneration = mpFont->getGlyphGeneration();
     }
 
 	void TextAreaOverlayElement::updateTextureGeometry()
@@ -593,6 +602,10 @@ namespace Ogre {
 
 		mViewportAspectCoef = vpHeight/vpWidth;
 
+		// Texture coordinates are out of date if the font's glyphs have moved
+		if (!mpFont.isNull() && mpFont->getGlyphGeneration() != mGlyphGeneration)
+			mGeomPositionsOutOfDate = true;
+
 		// Check size if pixel-based / relative-aspect-adjusted
 		switch (mMetricsMode)
 		{
@@ -29,10 +29,15 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreHardwarePixelBuffer.h"
 #include "OgreImage.h"
+#include "OgreImageCodec.h"
 #include "OgreTexture.h"
 #include "OgreException.h"
 #include "OgreResourceManager.h"
 #include "OgreTextureManager.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreStringConverter.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
 
 namespace Ogre {
 	//--------------------------------------------------------------------------
@@ -61,7 +66,11 @@ namespace Ogre {
             mDesiredIntegerBitDepth(0),
             mDesiredFloatBitDepth(0),
             mTreatLuminanceAsAlpha(false),
-            mInternalResourcesCreated(false)
+            mInternalResourcesCreated(false),
+            mTranscodeSourceSize(0),
+            mTranscodeSourceHash(0),
+            mTranscodePending(false),
+            mTranscodedImages(false)
     {
         if (createParamDictionary("Texture"))
         {
@@ -189,7 +198,38 @@ namespace Ogre {
 		if(images.size() < 1)
 			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Cannot load empty vector of images",
 			 "Texture::loadImages");
-        
+
+		bool transcoded = mTranscodedImages;
+		bool transcode = mTranscodePending;
+		mTranscodedImages = mTranscodePending = false;
+
+		if (transcode && transcoded)
+		{
+			// Decoded straight into what the cache holds
+			TextureManager::getSingleton()._saveTranscodedImage(
+				mTranscodeKey, mTranscodeSourceSize, mTranscodeSourceHash, *images[0]);
+			loadImagesImpl(images, true);
+			return;
+		}
+		else if (transcode)
+		{
+			// Make the images into what the cache holds, and load that so that 
+			// later loads from the cache give the same result
+			Image image;
+			if (transcodeImages(images, image))
+			{
+				TextureManager::getSingleton()._saveTranscodedImage(
+					mTranscodeKey, mTranscodeSourceSize, mTranscodeSourceHash, image);
+				loadImagesImpl(ConstImagePtrList(1, &image), true);
+				return;
+			}
+		}
+
+		loadImagesImpl(images, transcoded);
+	}
+	//--------------------------------------------------------------------------
+	void Texture::loadImagesImpl( const ConstImagePtrList& images, bool transcoded )
+	{
 		// Set desired texture size and properties from images[0]
 		mSrcWidth = mWidth = images[0]->getWidth();
 		mSrcHeight = mHeight = images[0]->getHeight();
@@ -197,12 +237,17 @@ namespace Ogre {
 
         // Get source image format and adjust if required
         mSrcFormat = images[0]->getFormat();
-        if (mTreatLuminanceAsAlpha && mSrcFormat == PF_L8)
+        if (!transcoded && mTreatLuminanceAsAlpha && mSrcFormat == PF_L8)
         {
             mSrcFormat = PF_A8;
         }
 
-        if (mDesiredFormat != PF_UNKNOWN)
+        if (transcoded)
+        {
+            // Already in the format chosen when it was transcoded
+            mFormat = mSrcFormat;
+        }
+        else if (mDesiredFormat != PF_UNKNOWN)
         {
             // If have desired format, use it
             mFormat = mDesiredFormat;
@@ -216,6 +261,11 @@ namespace Ogre {
 		// The custom mipmaps in the image have priority over everything
         size_t imageMips = images[0]->getNumMipmaps();
 
+		// The settings of a transcoded texture are restored once it is loaded,
+		// so that it is found in the cache again when reloaded
+		size_t requestedMipmaps = mNumRequestedMipmaps;
+		int usage = mUsage;
+
 		if(imageMips > 0)
 		{
 			mNumMipmaps = mNumRequestedMipmaps = images[0]->getNumMipmaps();
@@ -301,7 +351,7 @@ namespace Ogre {
                 // Sets to treated format in case is difference
                 src.format = mSrcFormat;
 
-                if(mGamma != 1.0f) {
+                if(mGamma != 1.0f && !transcoded) {
                     // Apply gamma correction
                     // Do not overwrite original image but do gamma correction in temporary buffer
                     MemoryDataStreamPtr buf; // for scoped deletion of conversion buffer
@@ -331,7 +381,267 @@ namespace Ogre {
         // Update size (the final size, not including temp space)
         mSize = getNumFaces() * PixelUtil::getMemorySize(mWidth, mHeight, mDepth, mFormat);
 
+        if (transcoded)
+        {
+            mNumRequestedMipmaps = requestedMipmaps;
+            mUsage = usage;
+        }
     }
+	//--------------------------------------------------------------------------
+	void Texture::readSourceImages(const StringVector& names, const String& ext, vector<Image>::type& images)
+	{
+		vector<DataStreamPtr>::type streams;
+		for (StringVector::const_iterator i = names.begin(); i != names.end(); ++i)
+			streams.push_back(ResourceGroupManager::getSingleton().openResource(*i, mGroup, true, this));
+		readSourceImages(names, streams, ext, images);
+	}
+	//--------------------------------------------------------------------------
+	void Texture::readSourceImages(const StringVector& names, const vector<DataStreamPtr>::type& sources, 
+		const String& ext, vector<Image>::type& images)
+	{
+		mTranscodePending = mTranscodedImages = false;
+
+		TextureManager* mgr = TextureManager::getSingletonPtr();
+		bool useCache = mgr && mgr->getTranscodeCache();
+
+		vector<DataStreamPtr>::type streams;
+		size_t sourceSize = 0;
+		uint32 sourceHash = 0;
+		for (vector<DataStreamPtr>::type::const_iterator i = sources.begin(); i != sources.end(); ++i)
+		{
+			DataStreamPtr stream = *i;
+			if (useCache)
+			{
+				// The codecs read the whole source anyway, so it is read into
+				// memory once and hashed there
+				MemoryDataStream* memStream = OGRE_NEW MemoryDataStream(stream);
+				sourceSize += memStream->size();
+				sourceHash = FastHash(reinterpret_cast<const char*>(memStream->getPtr()), 
+					static_cast<int>(memStream->size()), sourceHash);
+				stream = DataStreamPtr(memStream);
+			}
+			streams.push_back(stream);
+		}
+
+		if (useCache)
+		{
+			// The native formats and how they are laid out depend on the render system
+			StringUtil::StrStreamType key;
+			for (StringVector::const_iterator i = names.begin(); i != names.end(); ++i)
+				key << *i << ";";
+			RenderSystem* rs = Root::getSingletonPtr() ? Root::getSingleton().getRenderSystem() : 0;
+			key << (rs ? rs->getName() : StringUtil::BLANK) << ";" << mTextureType << ";";
+			key << PixelUtil::getFormatName(mDesiredFormat) << ";" << mDesiredIntegerBitDepth 
+				<< ";" << mDesiredFloatBitDepth << ";" << ((mUsage & TU_AUTOMIPMAP) ? mNumRequestedMipmaps : 0)
+				<< ";" << mGamma << ";" << mHwGamma << ";" << mTreatLuminanceAsAlpha;
+			mTranscodeKey = key.str();
+			mTranscodeSourceSize = sourceSize;
+			mTranscodeSourceHash = sourceHash;
+
+			images.push_back(Image());
+			if (mgr->_loadTranscodedImage(mTranscodeKey, sourceSize, sourceHash, images.back()))
+			{
+				mTranscodedImages = true;
+				return;
+			}
+			images.pop_back();
+			mTranscodePending = true;
+
+			if (streams.size() == 1)
+			{
+				images.push_back(Image());
+				if (decodeTranscoded(streams[0], ext, images.back()))
+				{
+					mTranscodedImages = true;
+					return;
+				}
+				images.pop_back();
+			}
+		}
+
+		for (vector<DataStreamPtr>::type::iterator i = streams.begin(); i != streams.end(); ++i)
+		{
+			images.push_back(Image());
+			images.back().load(*i, ext);
+		}
+	}
+	//--------------------------------------------------------------------------
+	bool Texture::transcodeImages(const ConstImagePtrList& images, Image& transcoded)
+	{
+		const Image& first = *images[0];
+		bool multiImage = images.size() > 1;
+		size_t faces = multiImage ? images.size() : first.getNumFaces();
+		if ((faces != 1 && faces != 6) || first.getNumMipmaps() > 0 || first.getDepth() > 1 ||
+			PixelUtil::isCompressed(first.getFormat()))
+			return false;
+		for (size_t i = 1; i < images.size(); ++i)
+		{
+			if (images[i]->getWidth() != first.getWidth() || images[i]->getHeight() != first.getHeight() ||
+				images[i]->getFormat() != first.getFormat() || images[i]->getNumMipmaps() > 0)
+				return false;
+		}
+
+		PixelFormat srcFormat = first.getFormat();
+		if (mTreatLuminanceAsAlpha && srcFormat == PF_L8)
+			srcFormat = PF_A8;
+		PixelFormat format = getTranscodeFormat(srcFormat);
+		if (format == PF_UNKNOWN)
+			return false;
+
+		size_t width = first.getWidth();
+		size_t height = first.getHeight();
+		size_t numMips = getTranscodeMipmaps(width, height);
+
+		size_t size = Image::calculateSize(numMips, faces, width, height, 1, format);
+		transcoded.loadDynamicImage(OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL),
+			width, height, 1, format, true, faces, numMips);
+
+		for (size_t face = 0; face < faces; ++face)
+		{
+			PixelBox src = multiImage ? images[face]->getPixelBox(0, 0) : first.getPixelBox(face, 0);
+			src.format = srcFormat;
+			PixelBox dst = transcoded.getPixelBox(face, 0);
+
+			if (mGamma != 1.0f)
+			{
+				// Gamma is applied in the source format, as loadImagesImpl does
+				MemoryDataStreamPtr buf; // for scoped deletion of conversion buffer
+				buf.bind(OGRE_NEW MemoryDataStream(
+					PixelUtil::getMemorySize(src.getWidth(), src.getHeight(), src.getDepth(), src.format)));
+				PixelBox corrected(src.getWidth(), src.getHeight(), src.getDepth(), src.format, buf->getPtr());
+				PixelUtil::bulkPixelConversion(src, corrected);
+				Image::applyGamma(static_cast<uint8*>(corrected.data), mGamma, corrected.getConsecutiveSize(), 
+					static_cast<uchar>(PixelUtil::getNumElemBits(src.format)));
+				PixelUtil::bulkPixelConversion(corrected, dst);
+			}
+			else
+			{
+				PixelUtil::bulkPixelConversion(src, dst);
+			}
+
+			for (size_t mip = 1; mip <= numMips; ++mip)
+			{
+				Image::scale(transcoded.getPixelBox(face, mip - 1), transcoded.getPixelBox(face, mip),
+					Image::FILTER_BOX, mHwGamma);
+			}
+		}
+		return true;
+	}
+	//--------------------------------------------------------------------------
+	PixelFormat Texture::getTranscodeFormat(PixelFormat srcFormat) const
+	{
+		// Choose the format as loadImagesImpl would
+		PixelFormat format = mDesiredFormat != PF_UNKNOWN ? mDesiredFormat :
+			PixelUtil::getFormatForBitDepths(srcFormat, mDesiredIntegerBitDepth, mDesiredFloatBitDepth);
+		format = TextureManager::getSingleton().getNativeFormat(mTextureType, format, mUsage);
+		if (PixelUtil::isCompressed(format) || !PixelUtil::isAccessible(format))
+			return PF_UNKNOWN;
+		return format;
+	}
+	//--------------------------------------------------------------------------
+	size_t Texture::getTranscodeMipmaps(size_t width, size_t height) const
+	{
+		size_t numMips = 0;
+		if (mUsage & TU_AUTOMIPMAP)
+		{
+			for (size_t w = width, h = height; (w > 1 || h > 1) && numMips < mNumRequestedMipmaps; ++numMips)
+			{
+				if (w > 1) w /= 2;
+				if (h > 1) h /= 2;
+			}
+		}
+		return numMips;
+	}
+	//--------------------------------------------------------------------------
+	/** Allocates the image Texture::decodeTranscoded decodes into, in the format
+		the source is transcoded to if it can be.
+	*/
+	class Texture::TranscodeTarget : public ImageCodec::DecodeTarget
+	{
+	public:
+		TranscodeTarget(const Texture* texture, Image& image)
+			: mTexture(texture), mImage(image), mTranscoded(false)
+		{
+		}
+
+		PixelBox getDestination(const ImageCodec::ImageData& desc)
+		{
+			// Luminance treated as alpha is reinterpreted rather than converted
+			PixelFormat format = PF_UNKNOWN;
+			if (desc.num_mipmaps == 0 && desc.depth == 1 && 
+				!(desc.flags & (IF_CUBEMAP | IF_3D_TEXTURE)) && 
+				!PixelUtil::isCompressed(desc.format) &&
+				!(mTexture->mTreatLuminanceAsAlpha && desc.format == PF_L8))
+			{
+				format = mTexture->getTranscodeFormat(desc.format);
+			}
+
+			// Otherwise the top level is decoded for nothing, and the caller
+			// decodes the source again
+			mTranscoded = format != PF_UNKNOWN;
+			size_t numMips = 0;
+			if (mTranscoded)
+				numMips = mTexture->getTranscodeMipmaps(desc.width, desc.height);
+			else
+				format = desc.format;
+
+			size_t size = Image::calculateSize(numMips, 1, desc.width, desc.height, 1, format);
+			mImage.loadDynamicImage(OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL),
+				desc.width, desc.height, 1, format, true, 1, numMips);
+			return mImage.getPixelBox(0, 0);
+		}
+
+		/// Whether the image was decoded in the format it is transcoded to
+		bool isTranscoded(void) const { return mTranscoded; }
+
+	private:
+		const Texture* mTexture;
+		Image& mImage;
+		bool mTranscoded;
+	};
+	//--------------------------------------------------------------------------
+	bool Texture::decodeTranscoded(DataStreamPtr& stream, const String& ext, Image& image)
+	{
+		// Gamma is applied in the source format, so that needs the source image
+		if (mGamma != 1.0f)
+			return false;
+
+		String type = ext.empty() ? Image::getFileExtFromMagic(stream) : ext;
+		if (type.empty())
+			return false;
+		Codec* codec = Codec::getCodec(type);
+		if (codec->getDataType() != "ImageData")
+			return false;
+		ImageCodec* imageCodec = static_cast<ImageCodec*>(codec);
+
+		// Skip sources with several levels or faces if the codec can tell 
+		// without decoding them
+		Codec::CodecDataPtr header = imageCodec->decodeHeader(stream);
+		stream->seek(0);
+		if (!header.isNull())
+		{
+			const ImageCodec::ImageData* desc = 
+				static_cast<const ImageCodec::ImageData*>(header.getPointer());
+			if (desc->num_mipmaps > 0 || desc->depth > 1 || 
+				(desc->flags & (IF_CUBEMAP | IF_3D_TEXTURE)))
+				return false;
+		}
+
+		TranscodeTarget target(this, image);
+		imageCodec->decodeInto(stream, target);
+		if (!target.isTranscoded())
+		{
+			stream->seek(0);
+			return false;
+		}
+
+		for (size_t mip = 1; mip <= image.getNumMipmaps(); ++mip)
+		{
+			Image::scale(image.getPixelBox(0, mip - 1), image.getPixelBox(0, mip),
+				Image::FILTER_BOX, mHwGamma);
+		}
+		return true;
+	}
 	//-----------------------------------------------------------------------------
 	void Texture::createInternalResources(void)
 	{
@@ -354,6 +664,14 @@ namespace Ogre {
 	void Texture::unloadImpl(void)
 	{
 		freeInternalResources();
+		// Images loaded later with loadImage are the caller's own
+		mTranscodePending = mTranscodedImages = false;
+	}
+	//-----------------------------------------------------------------------------
+	void Texture::unprepareImpl(void)
+	{
+		// The prepared images are dropped without being passed to _loadImages
+		mTranscodePending = mTranscodedImages = false;
 	}
     //-----------------------------------------------------------------------------   
     void Texture::copyToTexture( TexturePtr& target )
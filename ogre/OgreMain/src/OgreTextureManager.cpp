@@ -29,8 +29,50 @@ THE SOFTWARE.
 #include "OgreTextureManager.h"
 #include "OgreException.h"
 #include "OgrePixelFormat.h"
+#include "OgreImage.h"
+#include "OgreImageCodec.h"
+#include "OgreLogManager.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreRoot.h"
+#include "OgreArchive.h"
+#include "OgreStringConverter.h"
 
 namespace Ogre {
+	namespace
+	{
+		const uint32 TRANSCODE_CACHE_MAGIC = 0x43545854; // "TXTC"
+		const uint32 TRANSCODE_CACHE_VERSION = 1;
+		const String TRANSCODE_CACHE_EXTENSION = ".texcache";
+
+		/// Header of a transcode cache entry, which is followed by the key and the image data
+		struct TranscodeHeader
+		{
+			uint32 magic;
+			uint32 version;
+			uint32 ogreVersion;
+			uint32 sourceSize;
+			uint32 sourceHash;
+			uint32 keySize;
+			uint32 width;
+			uint32 height;
+			uint32 depth;
+			uint32 faces;
+			uint32 mipmaps;
+			uint32 format;
+			uint32 dataSize;
+		};
+
+		String getTranscodeFileName(const String& key)
+		{
+			return StringConverter::toString(FastHash(key.data(), static_cast<int>(key.size())), 
+				8, '0', std::ios::hex) + TRANSCODE_CACHE_EXTENSION;
+		}
+
+		bool compareModifiedTime(const std::pair<time_t, FileInfo>& a, const std::pair<time_t, FileInfo>& b)
+		{
+			return a.first < b.first;
+		}
+	}
     //-----------------------------------------------------------------------
     template<> TextureManager* Singleton<TextureManager>::ms_Singleton = 0;
     TextureManager* TextureManager::getSingletonPtr(void)
@@ -46,6 +88,16 @@ namespace Ogre {
          : mPreferredIntegerBitDepth(0)
          , mPreferredFloatBitDepth(0)
          , mDefaultNumMipmaps(MIP_UNLIMITED)
+         , mStreamingGeneration(0)
+         , mDefaultStreaming(false)
+         , mStreamingInitialSize(64)
+         , mStreamingUploadBudget(4 * 1024 * 1024)
+         , mStreamingChannel(0)
+         , mStreamingChannelRegistered(false)
+         , mTranscodeCache(0)
+         , mTranscodeCacheBudget(256 * 1024 * 1024)
+         , mTranscodeCacheSize(0)
+         , mTranscodeUseCount(0)
     {
         mResourceType = "Texture";
         mLoadOrder = 75.0f;
@@ -57,6 +109,14 @@ namespace Ogre {
     {
         // subclasses should unregister with resource group manager
 
+		if (mStreamingChannelRegistered && Root::getSingletonPtr())
+		{
+			WorkQueue* wq = Root::getSingleton().getWorkQueue();
+			wq->abortRequestsByChannel(mStreamingChannel);
+			wq->removeRequestHandler(mStreamingChannel, this);
+			wq->removeResponseHandler(mStreamingChannel, this);
+		}
+
     }
     //-----------------------------------------------------------------------
     TextureManager::ResourceCreateOrRetrieveResult TextureManager::createOrRetrieve(
@@ -96,12 +156,30 @@ namespace Ogre {
                                     int numMipmaps, Real gamma, bool isAlpha, PixelFormat desiredFormat,
                                     bool hwGamma)
     {
+		if (mDefaultStreaming && numMipmaps == MIP_DEFAULT &&
+			(texType == TEX_TYPE_2D || texType == TEX_TYPE_CUBE_MAP) &&
+			StringUtil::endsWith(name, ".dds"))
+		{
+			return loadStreamed(name, group, texType, gamma, isAlpha, desiredFormat, hwGamma);
+		}
+
 		ResourceCreateOrRetrieveResult res =
             createOrRetrieve(name,group,false,0,0,texType,numMipmaps,gamma,isAlpha,desiredFormat,hwGamma);
         TexturePtr tex = res.first;
 		tex->load();
         return tex;
     }
+    //-----------------------------------------------------------------------
+    TexturePtr TextureManager::loadStreamed(const String &name, const String& group, 
+        TextureType texType, Real gamma, bool isAlpha, PixelFormat desiredFormat, bool hwGamma)
+    {
+		ResourceCreateOrRetrieveResult res =
+            createOrRetrieve(name, group, true, &mStreamingLoader, 0, texType, MIP_DEFAULT,
+				gamma, isAlpha, desiredFormat, hwGamma);
+        TexturePtr tex = res.first;
+		tex->load();
+        return tex;
+    }
 
     //-----------------------------------------------------------------------
     TexturePtr TextureManager::loadImage( const String &name, const String& group,
@@ -249,6 +327,13 @@ namespace Ogre {
     {
         mDefaultNumMipmaps = num;
     }
+    //-----------------------------------------------------------------------
+	bool TextureManager::isEvictable(const ResourcePtr& res) const
+	{
+		// Manual textures without a loader, such as render targets, are not
+		// reloadable and so are never evicted
+		return res->isReloadable();
+	}
     //-----------------------------------------------------------------------
 	bool TextureManager::isFormatSupported(TextureType ttype, PixelFormat format, int usage)
 	{
@@ -263,4 +348,486 @@ namespace Ogre {
 		return PixelUtil::getNumElemBits(supportedFormat) >= PixelUtil::getNumElemBits(format);
 		
 	}
+    //-----------------------------------------------------------------------
+	void TextureManager::StreamingLoader::loadResource(Resource* resource)
+	{
+		static_cast<TextureManager*>(resource->getCreator())->loadStreamedTexture(
+			static_cast<Texture*>(resource));
+	}
+    //-----------------------------------------------------------------------
+	void TextureManager::loadStreamedTexture(Texture* tex)
+	{
+		if (!mStreamingChannelRegistered)
+		{
+			WorkQueue* wq = Root::getSingleton().getWorkQueue();
+			mStreamingChannel = wq->getChannel("Ogre/TextureStreaming");
+			wq->addRequestHandler(mStreamingChannel, this);
+			wq->addResponseHandler(mStreamingChannel, this);
+			mStreamingChannelRegistered = true;
+		}
+
+		uint32 generation;
+		{
+			// Forget about anything left over from an earlier load
+			OGRE_LOCK_MUTEX(mStreamingMutex)
+			mStreamingTextures.erase(tex->getHandle());
+			generation = ++mStreamingGeneration;
+		}
+
+		DataStreamPtr stream = ResourceGroupManager::getSingleton().openResource(
+			tex->getName(), tex->getGroup(), true, tex);
+		String codecType;
+		String::size_type pos = tex->getName().find_last_of(".");
+		if (pos != String::npos && pos < tex->getName().length() - 1)
+			codecType = tex->getName().substr(pos + 1);
+		else
+			codecType = Image::getFileExtFromMagic(stream);
+		Codec* codec = Codec::getCodec(codecType);
+		if (codec->getDataType() != "ImageData")
+		{
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+				"Texture '" + tex->getName() + "' is not held in an image format", 
+				"TextureManager::loadStreamedTexture");
+		}
+		ImageCodec* imgCodec = static_cast<ImageCodec*>(codec);
+
+		// Skip the levels larger than the initial size, leaving at least two
+		// so that the texture keeps using its own mipmaps
+		size_t firstMip = 0;
+		Codec::CodecDataPtr header = imgCodec->decodeHeader(stream);
+		stream->seek(0);
+		if (!header.isNull())
+		{
+			const ImageCodec::ImageData* info = 
+				static_cast<const ImageCodec::ImageData*>(header.getPointer());
+			size_t size = std::max(info->width, std::max(info->height, info->depth));
+			while (size > mStreamingInitialSize && firstMip + 1 < info->num_mipmaps)
+			{
+				size = std::max((size_t)1, size / 2);
+				++firstMip;
+			}
+		}
+
+		Codec::DecodeResult levels = imgCodec->decodeMipmaps(stream, firstMip, 0);
+		stream.setNull();
+
+		const ImageCodec::ImageData* data = 
+			static_cast<const ImageCodec::ImageData*>(levels.second.getPointer());
+		// If this is a cube map or volume, set the texture type accordingly
+		if (data->flags & IF_CUBEMAP)
+			tex->setTextureType(TEX_TYPE_CUBE_MAP);
+		else if (data->depth > 1)
+			tex->setTextureType(TEX_TYPE_3D);
+		loadStreamedLevels(tex, levels);
+
+		if (firstMip > 0)
+		{
+			StreamingTexture st;
+			st.generation = generation;
+			st.codecType = codecType;
+			st.resident = levels;
+			st.residentMip = firstMip;
+			{
+				OGRE_LOCK_MUTEX(mStreamingMutex)
+				mStreamingTextures[tex->getHandle()] = st;
+			}
+			requestStreamedMipmap(tex, st);
+		}
+
+		fireResidencyChanged(tex, firstMip);
+	}
+    //-----------------------------------------------------------------------
+	void TextureManager::loadStreamedLevels(Texture* tex, const Codec::DecodeResult& levels)
+	{
+		const ImageCodec::ImageData* data = 
+			static_cast<const ImageCodec::ImageData*>(levels.second.getPointer());
+
+		// Wrap the decoded data without copying it
+		Image img;
+		img.loadDynamicImage(levels.first->getPtr(), data->width, data->height, data->depth,
+			data->format, false, (data->flags & IF_CUBEMAP) ? 6 : 1, data->num_mipmaps);
+
+		tex->freeInternalResources();
+		ConstImagePtrList imagePtrs;
+		imagePtrs.push_back(&img);
+		tex->_loadImages(imagePtrs);
+	}
+    //-----------------------------------------------------------------------
+	void TextureManager::requestStreamedMipmap(Texture* tex, const StreamingTexture& st)
+	{
+		StreamingRequest req;
+		req.handle = tex->getHandle();
+		req.generation = st.generation;
+		req.name = tex->getName();
+		req.group = tex->getGroup();
+		req.codecType = st.codecType;
+		req.mipmap = st.residentMip - 1;
+		Root::getSingleton().getWorkQueue()->addRequest(mStreamingChannel, 0, Any(req));
+	}
+    //-----------------------------------------------------------------------
+	void TextureManager::fireResidencyChanged(Texture* tex, size_t residentMipmap)
+	{
+		for (StreamingListenerList::iterator i = mStreamingListeners.begin();
+			i != mStreamingListeners.end(); ++i)
+		{
+			(*i)->textureResidencyChanged(tex, residentMipmap);
+		}
+	}
+    //-----------------------------------------------------------------------
+	size_t TextureManager::getStreamingTextureCount(void) const
+	{
+		OGRE_LOCK_MUTEX(mStreamingMutex)
+		return mStreamingTextures.size();
+	}
+    //-----------------------------------------------------------------------
+	void TextureManager::addStreamingListener(StreamingListener* l)
+	{
+		mStreamingListeners.push_back(l);
+	}
+    //-----------------------------------------------------------------------
+	void TextureManager::removeStreamingListener(StreamingListener* l)
+	{
+		StreamingListenerList::iterator i = 
+			std::find(mStreamingListeners.begin(), mStreamingListeners.end(), l);
+		if (i != mStreamingListeners.end())
+			mStreamingListeners.erase(i);
+	}
+    //-----------------------------------------------------------------------
+	void TextureManager::_updateStreaming(void)
+	{
+		// Textures with a decoded level waiting, least detailed first
+		typedef std::pair<size_t, ResourceHandle> PendingUpload;
+		vector<PendingUpload>::type uploads;
+		{
+			OGRE_LOCK_MUTEX(mStreamingMutex)
+			for (StreamingTextureMap::iterator i = mStreamingTextures.begin();
+				i != mStreamingTextures.end(); ++i)
+			{
+				if (!i->second.pending.first.isNull())
+					uploads.push_back(PendingUpload(i->second.residentMip, i->first));
+			}
+		}
+		if (uploads.empty())
+			return;
+		std::sort(uploads.begin(), uploads.end(), std::greater<PendingUpload>());
+
+		size_t uploaded = 0;
+		for (vector<PendingUpload>::type::iterator u = uploads.begin(); u != uploads.end(); ++u)
+		{
+			TexturePtr tex = getByHandle(u->second);
+			if (tex.isNull())
+			{
+				// Removed since streaming started
+				OGRE_LOCK_MUTEX(mStreamingMutex)
+				mStreamingTextures.erase(u->second);
+				continue;
+			}
+			if (tex->getLoadingState() == Resource::LOADSTATE_LOADING)
+				continue; // come back to it once the load has finished
+
+			// Texture before streaming state, the same order as the loader
+			OGRE_LOCK_MUTEX_NAMED(tex->OGRE_AUTO_MUTEX_NAME, texLock)
+			OGRE_LOCK_MUTEX(mStreamingMutex)
+			StreamingTextureMap::iterator i = mStreamingTextures.find(u->second);
+			if (i == mStreamingTextures.end() || i->second.pending.first.isNull())
+				continue;
+			if (!tex->isLoaded())
+			{
+				// Unloaded since streaming started
+				mStreamingTextures.erase(i);
+				continue;
+			}
+			StreamingTexture& st = i->second;
+
+			// The texture is recreated with every level, so all of its levels are uploaded
+			const ImageCodec::ImageData* levelData = 
+				static_cast<const ImageCodec::ImageData*>(st.pending.second.getPointer());
+			const ImageCodec::ImageData* residentData = 
+				static_cast<const ImageCodec::ImageData*>(st.resident.second.getPointer());
+			size_t uploadSize = levelData->size + residentData->size;
+			if (uploaded > 0 && uploaded + uploadSize > mStreamingUploadBudget)
+				break;
+
+			// Join the new level onto the front of the resident ones for each face
+			size_t numFaces = (levelData->flags & IF_CUBEMAP) ? 6 : 1;
+			size_t levelSize = levelData->size / numFaces;
+			size_t residentSize = residentData->size / numFaces;
+
+			ImageCodec::ImageData* joinedData = OGRE_NEW ImageCodec::ImageData(*levelData);
+			joinedData->num_mipmaps = residentData->num_mipmaps + 1;
+			joinedData->size = uploadSize;
+			Codec::DecodeResult joined;
+			joined.first.bind(OGRE_NEW MemoryDataStream(joinedData->size));
+			joined.second = Codec::CodecDataPtr(joinedData);
+			uchar* dst = joined.first->getPtr();
+			for (size_t face = 0; face < numFaces; ++face)
+			{
+				memcpy(dst, st.pending.first->getPtr() + face * levelSize, levelSize);
+				dst += levelSize;
+				memcpy(dst, st.resident.first->getPtr() + face * residentSize, residentSize);
+				dst += residentSize;
+			}
+
+			try
+			{
+				_notifyResourceUnloaded(tex.get());
+				loadStreamedLevels(tex.get(), joined);
+				_notifyResourceLoaded(tex.get());
+				tex->_dirtyState();
+			}
+			catch (Exception& e)
+			{
+				LogManager::getSingleton().stream() << "Streaming of texture '" << 
+					tex->getName() << "' stopped: " << e.getFullDescription();
+				mStreamingTextures.erase(i);
+				continue;
+			}
+			uploaded += uploadSize;
+
+			st.resident = joined;
+			st.pending = Codec::DecodeResult();
+			--st.residentMip;
+			size_t residentMip = st.residentMip;
+			if (residentMip == 0)
+				mStreamingTextures.erase(i);
+			else
+				requestStreamedMipmap(tex.get(), st);
+
+			fireResidencyChanged(tex.get(), residentMip);
+		}
+	}
+	//---------------------------------------------------------------------
+	bool TextureManager::canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+	{
+		return true;
+	}
+	//---------------------------------------------------------------------
+	WorkQueue::Response* TextureManager::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+	{
+		StreamingResponse resp;
+		resp.request = any_cast<StreamingRequest>(req->getData());
+		if (req->getAborted())
+			return OGRE_NEW WorkQueue::Response(req, false, Any(resp));
+
+		try
+		{
+			DataStreamPtr stream = ResourceGroupManager::getSingleton().openResource(
+				resp.request.name, resp.request.group, true);
+			ImageCodec* codec = static_cast<ImageCodec*>(Codec::getCodec(resp.request.codecType));
+			resp.result = codec->decodeMipmaps(stream, resp.request.mipmap, 1);
+		}
+		catch (Exception& e)
+		{
+			return OGRE_NEW WorkQueue::Response(req, false, Any(resp), e.getFullDescription());
+		}
+		return OGRE_NEW WorkQueue::Response(req, true, Any(resp));
+	}
+	//---------------------------------------------------------------------
+	bool TextureManager::canHandleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+	{
+		return true;
+	}
+	//---------------------------------------------------------------------
+	void TextureManager::handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+	{
+		if (res->getRequest()->getAborted())
+			return;
+
+		StreamingResponse resp = any_cast<StreamingResponse>(res->getData());
+
+		OGRE_LOCK_MUTEX(mStreamingMutex)
+		StreamingTextureMap::iterator i = mStreamingTextures.find(resp.request.handle);
+		// Ignore responses for streaming which has since been restarted or dropped
+		if (i == mStreamingTextures.end() || i->second.generation != resp.request.generation)
+			return;
+
+		if (res->succeeded())
+		{
+			i->second.pending = resp.result;
+		}
+		else
+		{
+			LogManager::getSingleton().stream() << "Streaming of texture '" << 
+				resp.request.name << "' stopped: " << res->getMessages();
+			mStreamingTextures.erase(i);
+		}
+	}
+	//---------------------------------------------------------------------
+	void TextureManager::setTranscodeCache(Archive* cache)
+	{
+		OGRE_LOCK_MUTEX(mTranscodeMutex)
+		mTranscodeCache = cache;
+		mTranscodeEntries.clear();
+		mTranscodeCacheSize = 0;
+		mTranscodeUseCount = 0;
+		if (!cache)
+			return;
+
+		// Entries left by earlier runs count as used in the order they were written
+		typedef vector<std::pair<time_t, FileInfo> >::type TimedFileInfoList;
+		TimedFileInfoList entries;
+		FileInfoListPtr files = cache->findFileInfo("*" + TRANSCODE_CACHE_EXTENSION, false);
+		for (FileInfoList::iterator i = files->begin(); i != files->end(); ++i)
+			entries.push_back(std::make_pair(cache->getModifiedTime(i->filename), *i));
+		std::stable_sort(entries.begin(), entries.end(), compareModifiedTime);
+		for (TimedFileInfoList::iterator i = entries.begin(); i != entries.end(); ++i)
+			touchTranscodeEntry(i->second.filename, i->second.uncompressedSize);
+
+		evictTranscodeEntries(StringUtil::BLANK);
+	}
+	//---------------------------------------------------------------------
+	void TextureManager::setTranscodeCacheBudget(size_t bytes)
+	{
+		OGRE_LOCK_MUTEX(mTranscodeMutex)
+		mTranscodeCacheBudget = bytes;
+		evictTranscodeEntries(StringUtil::BLANK);
+	}
+	//---------------------------------------------------------------------
+	size_t TextureManager::getTranscodeCacheSize(void) const
+	{
+		OGRE_LOCK_MUTEX(mTranscodeMutex)
+		return mTranscodeCacheSize;
+	}
+	//---------------------------------------------------------------------
+	bool TextureManager::_loadTranscodedImage(const String& key, size_t sourceSize, 
+		uint32 sourceHash, Image& image)
+	{
+		String filename = getTranscodeFileName(key);
+		DataStreamPtr stream;
+		{
+			OGRE_LOCK_MUTEX(mTranscodeMutex)
+			if (!mTranscodeCache || mTranscodeEntries.find(filename) == mTranscodeEntries.end())
+				return false;
+			try
+			{
+				stream = mTranscodeCache->open(filename);
+			}
+			catch (Exception&)
+			{
+				return false;
+			}
+		}
+
+		TranscodeHeader header;
+		if (stream->read(&header, sizeof(header)) != sizeof(header) ||
+			header.magic != TRANSCODE_CACHE_MAGIC ||
+			header.version != TRANSCODE_CACHE_VERSION ||
+			header.ogreVersion != OGRE_VERSION ||
+			header.sourceSize != static_cast<uint32>(sourceSize) ||
+			header.sourceHash != sourceHash ||
+			header.keySize != key.size() ||
+			header.format >= PF_COUNT || 
+			(header.faces != 1 && header.faces != 6) ||
+			header.dataSize != Image::calculateSize(header.mipmaps, header.faces, 
+				header.width, header.height, header.depth, static_cast<PixelFormat>(header.format)))
+			return false;
+
+		String storedKey(key.size(), ' ');
+		if (!key.empty() && (stream->read(&storedKey[0], key.size()) != key.size() || storedKey != key))
+			return false;
+
+		// Read the levels straight into the image's buffer
+		uchar* data = OGRE_ALLOC_T(uchar, header.dataSize, MEMCATEGORY_GENERAL);
+		if (stream->read(data, header.dataSize) != header.dataSize)
+		{
+			OGRE_FREE(data, MEMCATEGORY_GENERAL);
+			return false;
+		}
+		image.loadDynamicImage(data, header.width, header.height, header.depth, 
+			static_cast<PixelFormat>(header.format), true, header.faces, header.mipmaps);
+
+		OGRE_LOCK_MUTEX(mTranscodeMutex)
+		TranscodeEntryMap::iterator i = mTranscodeEntries.find(filename);
+		if (i != mTranscodeEntries.end())
+			i->second.lastUsed = ++mTranscodeUseCount;
+		return true;
+	}
+	//---------------------------------------------------------------------
+	void TextureManager::_saveTranscodedImage(const String& key, size_t sourceSize, 
+		uint32 sourceHash, const Image& image)
+	{
+		TranscodeHeader header;
+		header.magic = TRANSCODE_CACHE_MAGIC;
+		header.version = TRANSCODE_CACHE_VERSION;
+		header.ogreVersion = OGRE_VERSION;
+		header.sourceSize = static_cast<uint32>(sourceSize);
+		header.sourceHash = sourceHash;
+		header.keySize = static_cast<uint32>(key.size());
+		header.width = static_cast<uint32>(image.getWidth());
+		header.height = static_cast<uint32>(image.getHeight());
+		header.depth = static_cast<uint32>(image.getDepth());
+		header.faces = static_cast<uint32>(image.getNumFaces());
+		header.mipmaps = static_cast<uint32>(image.getNumMipmaps());
+		header.format = image.getFormat();
+		header.dataSize = static_cast<uint32>(image.getSize());
+
+		String filename = getTranscodeFileName(key);
+
+		OGRE_LOCK_MUTEX(mTranscodeMutex)
+		if (!mTranscodeCache || mTranscodeCache->isReadOnly())
+			return;
+		if (mTranscodeCacheBudget && image.getSize() + sizeof(header) + key.size() > mTranscodeCacheBudget)
+			return;
+
+		try
+		{
+			DataStreamPtr stream = mTranscodeCache->create(filename);
+			stream->write(&header, sizeof(header));
+			stream->write(key.data(), key.size());
+			stream->write(image.getData(), image.getSize());
+			stream->close();
+		}
+		catch (Exception& e)
+		{
+			LogManager::getSingleton().logMessage(
+				"Unable to cache transcoded texture " + key + ": " + e.getDescription());
+			return;
+		}
+
+		touchTranscodeEntry(filename, sizeof(header) + key.size() + image.getSize());
+		evictTranscodeEntries(filename);
+	}
+	//---------------------------------------------------------------------
+	void TextureManager::touchTranscodeEntry(const String& filename, size_t size)
+	{
+		TranscodeEntryMap::iterator i = mTranscodeEntries.find(filename);
+		if (i != mTranscodeEntries.end())
+			mTranscodeCacheSize -= i->second.size;
+		else
+			i = mTranscodeEntries.insert(TranscodeEntryMap::value_type(filename, TranscodeEntry())).first;
+		i->second.size = size;
+		i->second.lastUsed = ++mTranscodeUseCount;
+		mTranscodeCacheSize += size;
+	}
+	//---------------------------------------------------------------------
+	void TextureManager::evictTranscodeEntries(const String& keep)
+	{
+		while (mTranscodeCacheBudget && mTranscodeCacheSize > mTranscodeCacheBudget)
+		{
+			TranscodeEntryMap::iterator oldest = mTranscodeEntries.end();
+			for (TranscodeEntryMap::iterator i = mTranscodeEntries.begin(); i != mTranscodeEntries.end(); ++i)
+			{
+				if (i->first != keep && 
+					(oldest == mTranscodeEntries.end() || i->second.lastUsed < oldest->second.lastUsed))
+					oldest = i;
+			}
+			if (oldest == mTranscodeEntries.end())
+				break;
+
+			if (!mTranscodeCache->isReadOnly())
+			{
+				try
+				{
+					mTranscodeCache->remove(oldest->first);
+				}
+				catch (Exception& e)
+				{
+					LogManager::getSingleton().logMessage(
+						"Unable to remove transcoded texture " + oldest->first + ": " + e.getDescription());
+				}
+			}
+			mTranscodeCacheSize -= oldest->second.size;
+			mTranscodeEntries.erase(oldest);
+		}
+	}
 }
@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "OgreRoot.h"
 
 #include <zzip/zzip.h>
+#include <zzip/mmapped.h>
 
 
 namespace Ogre {
@@ -70,6 +71,11 @@ namespace Ogre {
         return errorMsg;
     }
     //-----------------------------------------------------------------------
+    ZipMapping::~ZipMapping()
+    {
+        zzip_disk_close(mZzipDisk);
+    }
+    //-----------------------------------------------------------------------
     ZipArchive::ZipArchive(const String& name, const String& archType )
         : Archive(name, archType), mZzipDir(0)
     {
@@ -89,6 +95,11 @@ namespace Ogre {
             mZzipDir = zzip_dir_open(mName.c_str(), &zzipError);
             checkZzipError(zzipError, "opening archive");
 
+            // Map the archive too, stored files are then read from memory
+            ZZIP_DISK* zzipDisk = zzip_disk_mmap(zzip_dirfd(mZzipDir));
+            if (zzipDisk)
+                mMapping = ZipMappingPtr(OGRE_NEW ZipMapping(zzipDisk));
+
             // Cache names
             ZZIP_DIRENT zzipEntry;
             while (zzip_dir_read(mZzipDir, &zzipEntry))
@@ -125,6 +136,7 @@ namespace Ogre {
         {
             zzip_dir_close(mZzipDir);
             mZzipDir = 0;
+            mMapping.setNull();
             mFileList.clear();
         }
     
@@ -135,6 +147,18 @@ namespace Ogre {
 		// zziplib is not threadsafe
 		OGRE_LOCK_AUTO_MUTEX
 
+        // Stored files can be served straight from the mapped archive
+		ZZIP_STAT zstat;
+		zzip_off_t offset = zzip_dir_stat_offset(mZzipDir, filename.c_str(), &zstat, ZZIP_CASEINSENSITIVE);
+		if (offset >= 0 && zstat.d_compr == 0 && !mMapping.isNull())
+		{
+			ZZIP_DISK* zzipDisk = mMapping->getDisk();
+			zzip_byte_t* data = zzip_disk_offset_to_data(zzipDisk, offset);
+			size_t size = static_cast<size_t>(zstat.st_size);
+			if (data && static_cast<size_t>(zzipDisk->endbuf - data) >= size)
+				return DataStreamPtr(OGRE_NEW ZipMappedDataStream(filename, mMapping, data, size));
+		}
+
         // Format not used here (always binary)
         ZZIP_FILE* zzipFile = 
             zzip_file_open(mZzipDir, filename.c_str(), ZZIP_ONLYZIP | ZZIP_CASELESS);
@@ -150,8 +174,7 @@ namespace Ogre {
 		}
 
 		// Get uncompressed size too
-		ZZIP_STAT zstat;
-		zzip_dir_stat(mZzipDir, filename.c_str(), &zstat, ZZIP_CASEINSENSITIVE);
+		zzip_file_stat(zzipFile, &zstat);
 
         // Construct & return stream
         return DataStreamPtr(OGRE_NEW ZipDataStream(filename, zzipFile, static_cast<size_t>(zstat.st_size)));
@@ -283,6 +306,24 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+    ZipMappedDataStream::ZipMappedDataStream(const String& name, 
+        const ZipMappingPtr& mapping, void* data, size_t size)
+        : MemoryDataStream(name, data, size, false, true), mMapping(mapping)
+    {
+    }
+    //-----------------------------------------------------------------------
+    ZipMappedDataStream::~ZipMappedDataStream()
+    {
+        close();
+    }
+    //-----------------------------------------------------------------------
+    void ZipMappedDataStream::close(void)
+    {
+        mData = mPos = mEnd = 0;
+        mSize = 0;
+        mMapping.setNull();
+    }
+    //-----------------------------------------------------------------------
     ZipDataStream::ZipDataStream(ZZIP_FILE* zzipFile, size_t uncompressedSize)
         : mZzipFile(zzipFile)
     {
@@ -83,6 +83,12 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        void _affectParticles(ParticleSystem* pSystem, PackedParticleData& data, Real timeElapsed);
+
+        /** See ParticleAffector. */
+        bool _supportsPackedParticles(void) const { return true; }
+
         /** Sets the colour adjustment to be made per second to particles. 
         @param red, green, blue, alpha
             Sets the adjustment to be made to each of the colour components per second. These
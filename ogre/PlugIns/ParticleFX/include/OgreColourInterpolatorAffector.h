@@ -73,6 +73,12 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        void _affectParticles(ParticleSystem* pSystem, PackedParticleData& data, Real timeElapsed);
+
+        /** See ParticleAffector. */
+        bool _supportsPackedParticles(void) const { return true; }
+
 		void setColourAdjust(size_t index, ColourValue colour);
 		ColourValue getColourAdjust(size_t index) const;
         
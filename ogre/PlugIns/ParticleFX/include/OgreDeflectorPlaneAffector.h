@@ -76,6 +76,12 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        void _affectParticles(ParticleSystem* pSystem, PackedParticleData& data, Real timeElapsed);
+
+        /** See ParticleAffector. */
+        bool _supportsPackedParticles(void) const { return true; }
+
         /** Sets the plane point of the deflector plane. */
         void setPlanePoint(const Vector3& pos);
 
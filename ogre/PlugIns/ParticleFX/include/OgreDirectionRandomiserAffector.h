@@ -77,6 +77,12 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        void _affectParticles(ParticleSystem* pSystem, PackedParticleData& data, Real timeElapsed);
+
+        /** See ParticleAffector. */
+        bool _supportsPackedParticles(void) const { return true; }
+
 
         /** Sets the randomness to apply to the particles in a system. */
         void setRandomness(Real force);
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgrePackedParticleData.h"
 
 
 namespace Ogre {
@@ -90,6 +91,15 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ColourFaderAffector::_affectParticles(ParticleSystem* pSystem, 
+        PackedParticleData& data, Real timeElapsed)
+    {
+        data.addClampStream(data.colourR, mRedAdj * timeElapsed, 0.0f, 1.0f);
+        data.addClampStream(data.colourG, mGreenAdj * timeElapsed, 0.0f, 1.0f);
+        data.addClampStream(data.colourB, mBlueAdj * timeElapsed, 0.0f, 1.0f);
+        data.addClampStream(data.colourA, mAlphaAdj * timeElapsed, 0.0f, 1.0f);
+    }
+    //-----------------------------------------------------------------------
     void ColourFaderAffector::setAdjust(float red, float green, float blue, float alpha)
     {
         mRedAdj = red;
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgrePackedParticleData.h"
 
 
 namespace Ogre {
@@ -139,6 +140,33 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ColourFaderAffector2::_affectParticles(ParticleSystem* pSystem, 
+        PackedParticleData& data, Real timeElapsed)
+    {
+		// Choose the adjustment per particle rather than branching, so
+		// that the loops can be vectorised
+		const float adj1[4] = { mRedAdj1 * timeElapsed, mGreenAdj1 * timeElapsed,
+			mBlueAdj1 * timeElapsed, mAlphaAdj1 * timeElapsed };
+		const float adj2[4] = { mRedAdj2 * timeElapsed, mGreenAdj2 * timeElapsed,
+			mBlueAdj2 * timeElapsed, mAlphaAdj2 * timeElapsed };
+		float* channels[4] = { data.colourR, data.colourG, data.colourB, data.colourA };
+
+		const float* ttl = data.timeToLive;
+		const float stateChange = StateChangeVal;
+		const size_t count = data.size();
+		for (size_t c = 0; c < 4; ++c)
+		{
+			float* col = channels[c];
+			const float a1 = adj1[c];
+			const float a2 = adj2[c];
+			for (size_t i = 0; i < count; ++i)
+			{
+				float v = col[i] + (ttl[i] > stateChange ? a1 : a2);
+				col[i] = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+			}
+		}
+    }
+    //-----------------------------------------------------------------------
     void ColourFaderAffector2::setAdjust1(float red, float green, float blue, float alpha)
     {
         mRedAdj1 = red;
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgrePackedParticleData.h"
 
 
 namespace Ogre {
@@ -111,6 +112,40 @@ namespace Ogre {
 			}
 		}
     }
+	//-----------------------------------------------------------------------
+    void ColourInterpolatorAffector::_affectParticles(ParticleSystem* pSystem, 
+		PackedParticleData& data, Real timeElapsed)
+    {
+		const size_t count = data.size();
+		for (size_t n = 0; n < count; ++n)
+		{
+			Real particle_time = 1.0f - (data.timeToLive[n] / data.totalTimeToLive[n]);
+
+			if (particle_time <= mTimeAdj[0])
+			{
+				data.setColour(n, mColourAdj[0]);
+			} else
+			if (particle_time >= mTimeAdj[MAX_STAGES - 1])
+			{
+				data.setColour(n, mColourAdj[MAX_STAGES-1]);
+			} else
+			{
+				for (int i=0;i<MAX_STAGES-1;i++)
+				{
+					if (particle_time >= mTimeAdj[i] && particle_time < mTimeAdj[i + 1])
+					{
+						particle_time -= mTimeAdj[i];
+						particle_time /= (mTimeAdj[i+1]-mTimeAdj[i]);
+						data.colourR[n] = ((mColourAdj[i+1].r * particle_time) + (mColourAdj[i].r * (1.0f - particle_time)));
+						data.colourG[n] = ((mColourAdj[i+1].g * particle_time) + (mColourAdj[i].g * (1.0f - particle_time)));
+						data.colourB[n] = ((mColourAdj[i+1].b * particle_time) + (mColourAdj[i].b * (1.0f - particle_time)));
+						data.colourA[n] = ((mColourAdj[i+1].a * particle_time) + (mColourAdj[i].a * (1.0f - particle_time)));
+						break;
+					}
+				}
+			}
+		}
+    }
     
 	//-----------------------------------------------------------------------
     void ColourInterpolatorAffector::setColourAdjust(size_t index, ColourValue colour)
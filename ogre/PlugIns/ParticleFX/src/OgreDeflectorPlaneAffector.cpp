@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreDeflectorPlaneAffector.h"
 #include "OgreParticleSystem.h"
 #include "OgreParticle.h"
+#include "OgrePackedParticleData.h"
 #include "OgreStringConverter.h"
 
 
@@ -98,6 +99,35 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void DeflectorPlaneAffector::_affectParticles(ParticleSystem* pSystem, 
+        PackedParticleData& data, Real timeElapsed)
+    {
+        // precalculate distance of plane from origin
+        Real planeDistance = - mPlaneNormal.dotProduct(mPlanePoint) / Math::Sqrt(mPlaneNormal.dotProduct(mPlaneNormal));
+        const float nx = mPlaneNormal.x, ny = mPlaneNormal.y, nz = mPlaneNormal.z;
+        const float t = timeElapsed;
+
+        const size_t count = data.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Distance of the current and next position from the plane
+            float a = nx * data.positionX[i] + ny * data.positionY[i] + nz * data.positionZ[i] + planeDistance;
+            float dn = (nx * data.directionX[i] + ny * data.directionY[i] + nz * data.directionZ[i]) * t;
+            if (a + dn <= 0.0f && a > 0.0f)
+            {
+                Vector3 direction(data.getDirection(i) * timeElapsed);
+                // for intersection point
+                Vector3 directionPart = direction * (- a / dn);
+                // set new position
+                data.setPosition(i, (data.getPosition(i) + directionPart) + ((directionPart - direction) * mBounce));
+
+                // reflect direction vector
+                Vector3 dir = data.getDirection(i);
+                data.setDirection(i, (dir - (2.0 * dir.dotProduct(mPlaneNormal) * mPlaneNormal)) * mBounce);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void DeflectorPlaneAffector::setPlanePoint(const Vector3& pos)
     {
         mPlanePoint = pos;
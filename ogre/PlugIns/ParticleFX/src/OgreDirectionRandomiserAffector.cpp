@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreDirectionRandomiserAffector.h"
 #include "OgreParticleSystem.h"
 #include "OgreParticle.h"
+#include "OgrePackedParticleData.h"
 #include "OgreStringConverter.h"
 
 
@@ -98,6 +99,37 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void DirectionRandomiserAffector::_affectParticles(ParticleSystem* pSystem, 
+        PackedParticleData& data, Real timeElapsed)
+    {
+        const size_t count = data.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (mScope > Math::UnitRandom())
+            {
+                Vector3 direction = data.getDirection(i);
+                if (!direction.isZeroLength())
+                {
+                    Real length = 0;
+                    if (mKeepVelocity)
+                    {
+                        length = direction.length();
+                    }
+
+                    direction += Vector3(Math::RangeRandom(-mRandomness, mRandomness) * timeElapsed,
+                        Math::RangeRandom(-mRandomness, mRandomness) * timeElapsed,
+                        Math::RangeRandom(-mRandomness, mRandomness) * timeElapsed);
+
+                    if (mKeepVelocity)
+                    {
+                        direction *= length / direction.length();
+                    }
+                    data.setDirection(i, direction);
+                }
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void DirectionRandomiserAffector::setRandomness(Real force)
     {
         mRandomness = force;
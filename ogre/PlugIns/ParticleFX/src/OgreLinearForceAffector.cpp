@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreLinearForceAffector.h"
 #include "OgreParticleSystem.h"
 #include "OgreParticle.h"
+#include "OgrePackedParticleData.h"
 #include "OgreStringConverter.h"
 
 
@@ -95,6 +96,24 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    void LinearForceAffector::_affectParticles(ParticleSystem* pSystem, 
+        PackedParticleData& data, Real timeElapsed)
+    {
+        if (mForceApplication == FA_ADD)
+        {
+            Vector3 scaledVector = mForceVector * timeElapsed;
+            data.addToStream(data.directionX, scaledVector.x);
+            data.addToStream(data.directionY, scaledVector.y);
+            data.addToStream(data.directionZ, scaledVector.z);
+        }
+        else // FA_AVERAGE
+        {
+            data.scaleAddStream(data.directionX, 0.5f, mForceVector.x * 0.5f);
+            data.scaleAddStream(data.directionY, 0.5f, mForceVector.y * 0.5f);
+            data.scaleAddStream(data.directionZ, 0.5f, mForceVector.z * 0.5f);
+        }
+    }
+    //-----------------------------------------------------------------------
     void LinearForceAffector::setForceVector(const Vector3& force)
     {
         mForceVector = force;
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgrePackedParticleData.h"
 
 
 namespace Ogre {
@@ -85,6 +86,32 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ScaleAffector::_affectParticles(ParticleSystem* pSystem, 
+        PackedParticleData& data, Real timeElapsed)
+    {
+		if (data.empty())
+			return;
+
+		// Particles using the default size start from it
+		const float defaultWidth = pSystem->getDefaultWidth();
+		const float defaultHeight = pSystem->getDefaultHeight();
+		const size_t count = data.size();
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (!data.ownDimensions[i])
+			{
+				data.width[i] = defaultWidth;
+				data.height[i] = defaultHeight;
+				data.ownDimensions[i] = 1;
+			}
+		}
+
+		Real ds = mScaleAdj * timeElapsed;
+		data.addToStream(data.width, ds);
+		data.addToStream(data.height, ds);
+		pSystem->_notifyParticleResized();
+    }
+    //-----------------------------------------------------------------------
     void ScaleAffector::setAdjust( Real rate )
     {
         mScaleAdj = rate;
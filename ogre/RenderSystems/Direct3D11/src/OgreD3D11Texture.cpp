@@ -133,8 +133,7 @@ namespace Ogre
 			
 		//	if ( pos != String::npos )
 		//		ext = mName.substr(pos+1);
-			vector<Image>::type images(6);
-			ConstImagePtrList imagePtrs;
+			StringVector names;
 			static const String suffixes[6] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
 
 			for(size_t i = 0; i < 6; i++)
@@ -142,15 +141,18 @@ namespace Ogre
 				String fullName = baseName + suffixes[i];
 				if (!ext.empty())
 					fullName = fullName + "." + ext;
+				names.push_back(fullName);
+			}
 
-				// find & load resource data intro stream to allow resource
-				// group changes if required
-				DataStreamPtr dstream = 
-					ResourceGroupManager::getSingleton().openResource(
-					fullName, mGroup, true, this);
-
-				images[i].load(dstream, ext);
+			// find & load resource data intro stream to allow resource
+			// group changes if required; the faces may come back from the
+			// transcode cache as a single image
+			vector<Image>::type images;
+			readSourceImages(names, ext, images);
 
+			ConstImagePtrList imagePtrs;
+			for(size_t i = 0; i < images.size(); i++)
+			{
 				size_t imageMips = images[i].getNumMipmaps();
 
 				if(imageMips < mNumMipmaps) {
@@ -166,7 +168,6 @@ namespace Ogre
 		}
 		else
 		{
-			Image img;
 			DataStreamPtr dstream ;
 			// find & load resource data intro stream to allow resource
 			// group changes if required
@@ -209,8 +210,9 @@ namespace Ogre
 			}
 			else
 			{
-				img.load(dstream, ext);
-				loadImage(img);
+				vector<Image>::type images;
+				readSourceImages(StringVector(1, mName), vector<DataStreamPtr>::type(1, dstream), ext, images);
+				loadImage(images[0]);
 			}
 		}
 	}
@@ -42,6 +42,27 @@ THE SOFTWARE.
 namespace Ogre 
 {
 	/****************************************************************************************/
+	/// Names of the six files a cube map not in a single DDS is loaded from
+	static StringVector getCubeFaceNames(const String& name)
+	{
+		String baseName, ext;
+		size_t pos = name.find_last_of(".");
+		baseName = name.substr(0, pos);
+		if ( pos != String::npos )
+			ext = name.substr(pos+1);
+		static const String suffixes[6] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
+
+		StringVector names;
+		for(size_t i = 0; i < 6; i++)
+		{
+			String fullName = baseName + suffixes[i];
+			if (!ext.empty())
+				fullName = fullName + "." + ext;
+			names.push_back(fullName);
+		}
+		return names;
+	}
+	/****************************************************************************************/
     D3D9Texture::D3D9Texture(ResourceManager* creator, const String& name, 
         ResourceHandle handle, const String& group, bool isManual, 
         ManualResourceLoader* loader)
@@ -308,24 +329,15 @@ namespace Ogre
         {
 			// Load from 6 separate files
 			// Use OGRE its own codecs
-			String baseName, ext;
-			size_t pos = mName.find_last_of(".");
-			baseName = mName.substr(0, pos);
-			if ( pos != String::npos )
-				ext = mName.substr(pos+1);
-			static const String suffixes[6] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
+			StringVector names = getCubeFaceNames(mName);
 
 			for(size_t i = 0; i < 6; i++)
 			{
-				String fullName = baseName + suffixes[i];
-				if (!ext.empty())
-					fullName = fullName + "." + ext;
-
             	// find & load resource data intro stream to allow resource
 				// group changes if required
 				DataStreamPtr dstream = 
 					ResourceGroupManager::getSingleton().openResource(
-						fullName, mGroup, true, this);
+						names[i], mGroup, true, this);
 
                 loadedStreams->push_back(MemoryDataStreamPtr(OGRE_NEW MemoryDataStream(dstream)));
 			}
@@ -364,6 +376,7 @@ namespace Ogre
 	/****************************************************************************************/
 	void D3D9Texture::unprepareImpl()
 	{		
+		Texture::unprepareImpl();
 		if (mUsage & TU_RENDERTARGET || isManuallyLoaded())
 		{
 			return;
@@ -586,16 +599,14 @@ namespace Ogre
 			if ( pos != String::npos )
 				ext = mName.substr(pos+1);
 
-			vector<Image>::type images(6);
-			ConstImagePtrList imagePtrs;
-
-			for(size_t i = 0; i < 6; i++)
-			{
-				DataStreamPtr stream((*loadedStreams)[i]);
-				images[i].load(stream, ext);
+			// The faces may come back from the transcode cache as a single image
+			vector<Image>::type images;
+			readSourceImages(getCubeFaceNames(mName), 
+				vector<DataStreamPtr>::type(loadedStreams->begin(), loadedStreams->end()), ext, images);
 
+			ConstImagePtrList imagePtrs;
+			for(size_t i = 0; i < images.size(); i++)
 				imagePtrs.push_back(&images[i]);
-			}
 
             _loadImages( imagePtrs );
         }
@@ -698,8 +709,6 @@ namespace Ogre
         }
 		else
 		{
-			Image img;
-
             assert(loadedStreams->size()==1);
 
 			size_t pos = mName.find_last_of(".");
@@ -707,8 +716,10 @@ namespace Ogre
 			if ( pos != String::npos )
 				ext = mName.substr(pos+1);
 	
-			DataStreamPtr stream((*loadedStreams)[0]);
-			img.load(stream, ext);
+			vector<Image>::type images;
+			readSourceImages(StringVector(1, mName), 
+				vector<DataStreamPtr>::type(1, (*loadedStreams)[0]), ext, images);
+			const Image& img = images[0];
 
 			if (img.getHeight() == 0)
 			{
@@ -844,7 +855,6 @@ namespace Ogre
         }
 		else
 		{
-			Image img;
            	// find & load resource data intro stream to allow resource
 			// group changes if required
             assert(loadedStreams->size()==1);
@@ -854,8 +864,10 @@ namespace Ogre
 			if ( pos != String::npos )
 				ext = mName.substr(pos+1);
 
-			DataStreamPtr stream((*loadedStreams)[0]);
-			img.load(stream, ext);
+			vector<Image>::type images;
+			readSourceImages(StringVector(1, mName), 
+				vector<DataStreamPtr>::type(1, (*loadedStreams)[0]), ext, images);
+			const Image& img = images[0];
 
 			if (img.getHeight() == 0)
 			{
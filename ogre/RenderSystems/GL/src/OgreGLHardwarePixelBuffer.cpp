@@ -371,6 +371,38 @@ void GLTextureBuffer::upload(const PixelBox &data, const Image::Box &dest)
 		}
 		
 	} 
+	else if(mSoftwareMipmap && mTarget != GL_TEXTURE_3D)
+	{
+		// Build the mipmap chain on the CPU and upload every level
+		GLint components = PixelUtil::getComponentCount(mFormat);
+		Image image;
+		image.loadDynamicImage(OGRE_ALLOC_T(uchar, data.getConsecutiveSize(), MEMCATEGORY_GENERAL),
+			data.getWidth(), data.getHeight(), 1, data.format, true);
+		PixelUtil::bulkPixelConversion(data, image.getPixelBox());
+		if(image.getWidth() != dest.getWidth() || image.getHeight() != dest.getHeight())
+			image.resize(static_cast<ushort>(dest.getWidth()), static_cast<ushort>(dest.getHeight()));
+		image.generateMipmaps();
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		for(size_t mip = 0; mip <= image.getNumMipmaps(); ++mip)
+		{
+			PixelBox level = image.getPixelBox(0, mip);
+			if(mTarget == GL_TEXTURE_1D)
+			{
+				glTexImage1D(GL_TEXTURE_1D, static_cast<GLint>(mip), components,
+					level.getWidth(), 0,
+					GLPixelUtil::getGLOriginFormat(level.format), GLPixelUtil::getGLOriginDataType(level.format),
+					level.data);
+			}
+			else
+			{
+				glTexImage2D(mFaceTarget, static_cast<GLint>(mip), components,
+					level.getWidth(), level.getHeight(), 0,
+					GLPixelUtil::getGLOriginFormat(level.format), GLPixelUtil::getGLOriginDataType(level.format),
+					level.data);
+			}
+		}
+	}
 	else if(mSoftwareMipmap)
 	{
 		GLint components = PixelUtil::getComponentCount(mFormat);
@@ -384,21 +416,6 @@ void GLTextureBuffer::upload(const PixelBox &data, const Image::Box &dest)
 		
 		switch(mTarget)
 		{
-		case GL_TEXTURE_1D:
-			gluBuild1DMipmaps(
-				GL_TEXTURE_1D, components,
-				dest.getWidth(),
-				GLPixelUtil::getGLOriginFormat(data.format), GLPixelUtil::getGLOriginDataType(data.format),
-				data.data);
-			break;
-		case GL_TEXTURE_2D:
-		case GL_TEXTURE_CUBE_MAP:
-			gluBuild2DMipmaps(
-				mFaceTarget,
-				components, dest.getWidth(), dest.getHeight(), 
-				GLPixelUtil::getGLOriginFormat(data.format), GLPixelUtil::getGLOriginDataType(data.format), 
-				data.data);
-			break;		
 		case GL_TEXTURE_3D:
 			/* Requires GLU 1.3 which is harder to come by than cards doing hardware mipmapping
 				Most 3D textures don't need mipmaps?
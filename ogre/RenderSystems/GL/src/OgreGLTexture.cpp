@@ -262,22 +262,6 @@ namespace Ogre {
         createInternalResources();
     }
 
-    static inline void do_image_io(const String &name, const String &group,
-                                   const String &ext,
-                                   vector<Image>::type &images,
-                                   Resource *r)
-    {
-		size_t imgIdx = images.size();
-        images.push_back(Image());
-
-        DataStreamPtr dstream = 
-            ResourceGroupManager::getSingleton().openResource(
-                name, group, true, r);
-
-        images[imgIdx].load(dstream, ext);
-    }
-
-	
     void GLTexture::prepareImpl()
     {
         if( mUsage & TU_RENDERTARGET ) return;
@@ -294,7 +278,7 @@ namespace Ogre {
             mTextureType == TEX_TYPE_3D)
         {
 
-            do_image_io(mName, mGroup, ext, *loadedImages, this);
+            readSourceImages(StringVector(1, mName), ext, *loadedImages);
 
 
             // If this is a cube map, set the texture type flag accordingly.
@@ -311,12 +295,11 @@ namespace Ogre {
             {
                 // XX HACK there should be a better way to specify whether 
                 // all faces are in the same file or not
-                do_image_io(mName, mGroup, ext, *loadedImages, this);
+                readSourceImages(StringVector(1, mName), ext, *loadedImages);
             }
             else
             {
-                vector<Image>::type images(6);
-                ConstImagePtrList imagePtrs;
+                StringVector names;
                 static const String suffixes[6] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
 
                 for(size_t i = 0; i < 6; i++)
@@ -324,10 +307,11 @@ namespace Ogre {
                     String fullName = baseName + suffixes[i];
                     if (!ext.empty())
                         fullName = fullName + "." + ext;
-                    // find & load resource data intro stream to allow resource
-                    // group changes if required
-                    do_image_io(fullName,mGroup,ext,*loadedImages,this);
+                    names.push_back(fullName);
                 }
+                // find & load resource data intro stream to allow resource
+                // group changes if required
+                readSourceImages(names, ext, *loadedImages);
             }
         }
         else
@@ -339,6 +323,7 @@ namespace Ogre {
     void GLTexture::unprepareImpl()
     {
         mLoadedImages.setNull();
+        Texture::unprepareImpl();
     }
 
     void GLTexture::loadImpl()
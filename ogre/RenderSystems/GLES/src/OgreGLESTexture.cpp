@@ -36,21 +36,6 @@ THE SOFTWARE.
 #include "OgreRoot.h"
 
 namespace Ogre {
-    static inline void doImageIO(const String &name, const String &group,
-                                 const String &ext,
-                                 std::vector<Image> &images,
-                                 Resource *r)
-    {
-        size_t imgIdx = images.size();
-        images.push_back(Image());
-
-        DataStreamPtr dstream =
-            ResourceGroupManager::getSingleton().openResource(
-                name, group, true, r);
-
-        images[imgIdx].load(dstream, ext);
-    }
-
     GLESTexture::GLESTexture(ResourceManager* creator, const String& name,
                              ResourceHandle handle, const String& group, bool isManual,
                              ManualResourceLoader* loader, GLESSupport& support)
@@ -236,11 +221,11 @@ namespace Ogre {
             ext = mName.substr(pos+1);
         }
 
-        LoadedImages loadedImages = LoadedImages(OGRE_NEW_FIX_FOR_WIN32 std::vector<Image>());
+        LoadedImages loadedImages = LoadedImages(OGRE_NEW_FIX_FOR_WIN32 vector<Image>::type());
 
         if (mTextureType == TEX_TYPE_2D)
         {
-            doImageIO(mName, mGroup, ext, *loadedImages, this);
+            readSourceImages(StringVector(1, mName), ext, *loadedImages);
 
             // If this is a volumetric texture set the texture type flag accordingly.
             if ((*loadedImages)[0].getDepth() > 1)
@@ -277,6 +262,7 @@ namespace Ogre {
     void GLESTexture::unprepareImpl()
     {
         mLoadedImages.setNull();
+        Texture::unprepareImpl();
     }
 
     void GLESTexture::loadImpl()
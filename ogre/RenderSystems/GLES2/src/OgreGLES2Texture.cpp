@@ -33,21 +33,6 @@ THE SOFTWARE.
 #include "OgreRoot.h"
 
 namespace Ogre {
-    static inline void doImageIO(const String &name, const String &group,
-                                 const String &ext,
-                                 vector<Image>::type &images,
-                                 Resource *r)
-    {
-        size_t imgIdx = images.size();
-        images.push_back(Image());
-
-        DataStreamPtr dstream =
-            ResourceGroupManager::getSingleton().openResource(
-                name, group, true, r);
-
-        images[imgIdx].load(dstream, ext);
-    }
-
     GLES2Texture::GLES2Texture(ResourceManager* creator, const String& name,
                              ResourceHandle handle, const String& group, bool isManual,
                              ManualResourceLoader* loader, GLES2Support& support)
@@ -284,7 +269,7 @@ namespace Ogre {
 
         if (mTextureType == TEX_TYPE_1D || mTextureType == TEX_TYPE_2D)
         {
-            doImageIO(mName, mGroup, ext, *loadedImages, this);
+            readSourceImages(StringVector(1, mName), ext, *loadedImages);
 
             // If this is a volumetric texture set the texture type flag accordingly.
             // If this is a cube map, set the texture type flag accordingly.
@@ -312,12 +297,11 @@ namespace Ogre {
             {
                 // XX HACK there should be a better way to specify whether 
                 // all faces are in the same file or not
-                doImageIO(mName, mGroup, ext, *loadedImages, this);
+                readSourceImages(StringVector(1, mName), ext, *loadedImages);
             }
             else
             {
-                vector<Image>::type images(6);
-                ConstImagePtrList imagePtrs;
+                StringVector names;
                 static const String suffixes[6] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
 
                 for(size_t i = 0; i < 6; i++)
@@ -325,10 +309,11 @@ namespace Ogre {
                     String fullName = baseName + suffixes[i];
                     if (!ext.empty())
                         fullName = fullName + "." + ext;
-                    // find & load resource data intro stream to allow resource
-                    // group changes if required
-                    doImageIO(fullName, mGroup, ext, *loadedImages, this);
+                    names.push_back(fullName);
                 }
+                // find & load resource data intro stream to allow resource
+                // group changes if required
+                readSourceImages(names, ext, *loadedImages);
             }
         }
         else
@@ -344,6 +329,7 @@ namespace Ogre {
     void GLES2Texture::unprepareImpl()
     {
         mLoadedImages.setNull();
+        Texture::unprepareImpl();
     }
 
     void GLES2Texture::loadImpl()
@@ -243,6 +243,9 @@ LOCAL_SRC_FILES		:= ogre/OgreMain/src/OgreAlignedAllocator.cpp\
 	ogre/OgreMain/src/OgreOverlayElementCommands.cpp\
 	ogre/OgreMain/src/OgreOverlayManager.cpp\
 	ogre/OgreMain/src/OgrePanelOverlayElement.cpp\
+	ogre/OgreMain/src/OgrePackArchive.cpp\
+	ogre/OgreMain/src/OgrePackedParticleData.cpp\
+	ogre/OgreMain/src/OgreParallelTasks.cpp\
 	ogre/OgreMain/src/OgreParticle.cpp\
 	ogre/OgreMain/src/OgreParticleEmitter.cpp\
 	ogre/OgreMain/src/OgreParticleEmitterCommands.cpp\
@@ -305,6 +308,7 @@ LOCAL_SRC_FILES		:= ogre/OgreMain/src/OgreAlignedAllocator.cpp\
 	ogre/OgreMain/src/OgreSimpleRenderable.cpp\
 	ogre/OgreMain/src/OgreSimpleSpline.cpp\
 	ogre/OgreMain/src/OgreSkeleton.cpp\
+	ogre/OgreMain/src/OgreSkeletonAnimationCache.cpp\
 	ogre/OgreMain/src/OgreSkeletonInstance.cpp\
 	ogre/OgreMain/src/OgreSkeletonManager.cpp\
 	ogre/OgreMain/src/OgreSkeletonSerializer.cpp\
@@ -0,0 +1,65 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgrePrerequisites.h"
+#include "OgreBillboard.h"
+#include "OgreBillboardSet.h"
+#include "OgreHardwareBufferManager.h"
+
+class BillboardSetTests : public CppUnit::TestFixture
+{
+	// CppUnit macros for setting up the test suite
+	CPPUNIT_TEST_SUITE( BillboardSetTests );
+	CPPUNIT_TEST(testBatchMatchesSingle);
+	CPPUNIT_TEST(testRingBufferWraparound);
+	CPPUNIT_TEST_SUITE_END();
+protected:
+	typedef Ogre::vector<Ogre::Billboard>::type BillboardList;
+	typedef Ogre::vector<float>::type VertexList;
+
+	Ogre::Root* mRoot;
+	Ogre::HardwareBufferManager* mBufMgr;
+
+	/// Creates a set holding external billboards, set up to match the given billboards
+	Ogre::BillboardSet* createSet(const Ogre::String& name, size_t poolSize, bool autoUpdate);
+	/// Creates billboards of various sizes, colours, rotations and texture coordinates
+	void createBillboards(Ogre::BillboardSet* owner, BillboardList& billboards, size_t count);
+	/// Generates the vertices of the first count billboards, in one batch or one by one
+	void update(Ogre::BillboardSet* set, const BillboardList& billboards, size_t count, 
+		bool batch);
+	/// Reads the vertices of the last update
+	void readVertices(Ogre::BillboardSet* set, VertexList& vertices);
+public:
+	void setUp();
+	void tearDown();
+
+	void testBatchMatchesSingle();
+	void testRingBufferWraparound();
+
+};
@@ -0,0 +1,76 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgreDDSCodec.h"
+
+using namespace Ogre;
+
+class DDSCodecTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE( DDSCodecTests );
+    CPPUNIT_TEST( testDecodeHeader );
+    CPPUNIT_TEST( testDecodeMipmaps );
+    CPPUNIT_TEST( testDecodeMipmapsCubeMap );
+    CPPUNIT_TEST( testDefaultDecodeMipmaps );
+    CPPUNIT_TEST( testDefaultDecodeInto );
+    CPPUNIT_TEST( testDecompressBC1 );
+    CPPUNIT_TEST( testDecompressBC2 );
+    CPPUNIT_TEST( testDecompressBC3 );
+    CPPUNIT_TEST( testDecompressBC4 );
+    CPPUNIT_TEST( testDecompressBC5 );
+    CPPUNIT_TEST( testDecompressPartialBlocks );
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp();
+    void tearDown();
+
+    void testDecodeHeader();
+    void testDecodeMipmaps();
+    void testDecodeMipmapsCubeMap();
+    void testDefaultDecodeMipmaps();
+    void testDefaultDecodeInto();
+    void testDecompressBC1();
+    void testDecompressBC2();
+    void testDecompressBC3();
+    void testDecompressBC4();
+    void testDecompressBC5();
+    void testDecompressPartialBlocks();
+
+    // Utils
+    DataStreamPtr createFile(size_t width, size_t height, size_t numMips, bool cubeMap);
+    DataStreamPtr createCompressedFile(size_t width, size_t height, size_t numMips, 
+        const char* fourCC, const uchar* blocks, size_t blocksSize);
+    MemoryDataStreamPtr decompress(DataStreamPtr& file, size_t width, size_t height);
+    void checkTexel(const MemoryDataStreamPtr& data, size_t width, size_t x, size_t y,
+        uchar r, uchar g, uchar b, uchar a);
+    void checkMipmaps(const ImageCodec* codec, size_t width, size_t height, size_t numMips, bool cubeMap);
+private:
+    DDSCodec* mCodec;
+};
@@ -0,0 +1,66 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgreGlyphAtlas.h"
+#include "OgreFileSystem.h"
+
+class GlyphAtlasTests : public CppUnit::TestFixture
+{
+	// CppUnit macros for setting up the test suite
+	CPPUNIT_TEST_SUITE( GlyphAtlasTests );
+	CPPUNIT_TEST(testAddAndFind);
+	CPPUNIT_TEST(testSkylinePacking);
+	CPPUNIT_TEST(testEvictsLeastRecentlyUsedPage);
+	CPPUNIT_TEST(testSharedBetweenFonts);
+	CPPUNIT_TEST(testTextAreaFollowsEviction);
+	CPPUNIT_TEST(testTextAreaLargerThanAtlas);
+	CPPUNIT_TEST_SUITE_END();
+protected:
+	std::vector<Ogre::uchar> mCell;
+	Ogre::ArchiveManager* mArchiveMgr;
+	Ogre::FileSystemArchiveFactory* mFileSystemFactory;
+	Ogre::TextureManager* mTextureMgr;
+	Ogre::FontManager* mFontMgr;
+	/// The atlas only uses fonts as keys, so these are not loaded
+	const Ogre::Font* mFontA;
+	const Ogre::Font* mFontB;
+
+	Ogre::PixelBox makeCell(size_t width, size_t height, Ogre::uchar alpha);
+public:
+	void setUp();
+	void tearDown();
+
+	void testAddAndFind();
+	void testSkylinePacking();
+	void testEvictsLeastRecentlyUsedPage();
+	void testSharedBetweenFonts();
+	void testTextAreaFollowsEviction();
+	void testTextAreaLargerThanAtlas();
+
+};
@@ -0,0 +1,198 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __MemoryTextureManager_H__
+#define __MemoryTextureManager_H__
+
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreResourceGroupManager.h"
+
+/** Pixel buffer in system memory, standing in for a render system's. */
+class MemoryPixelBuffer : public Ogre::HardwarePixelBuffer
+{
+public:
+	MemoryPixelBuffer(size_t width, size_t height, size_t depth, Ogre::PixelFormat format)
+		: Ogre::HardwarePixelBuffer(width, height, depth, format, HBU_STATIC, true, false),
+		mData(Ogre::PixelUtil::getMemorySize(width, height, depth, format))
+	{
+	}
+
+	void blitFromMemory(const Ogre::PixelBox& src, const Ogre::Image::Box& dstBox)
+	{
+		copy(src, getPixelBox().getSubVolume(dstBox));
+	}
+
+	void blitToMemory(const Ogre::Image::Box& srcBox, const Ogre::PixelBox& dst)
+	{
+		copy(getPixelBox().getSubVolume(srcBox), dst);
+	}
+
+	/// All of the buffer's pixels
+	Ogre::PixelBox getPixelBox(void)
+	{
+		return Ogre::PixelBox(mWidth, mHeight, mDepth, mFormat, &mData[0]);
+	}
+
+protected:
+	Ogre::PixelBox lockImpl(const Ogre::Image::Box lockBox, LockOptions options)
+	{
+		return getPixelBox().getSubVolume(lockBox);
+	}
+
+	void unlockImpl(void) {}
+
+	static void copy(const Ogre::PixelBox& src, const Ogre::PixelBox& dst)
+	{
+		if (src.getWidth() == dst.getWidth() && src.getHeight() == dst.getHeight() &&
+			src.getDepth() == dst.getDepth())
+			Ogre::PixelUtil::bulkPixelConversion(src, dst);
+		else
+			Ogre::Image::scale(src, dst);
+	}
+
+	std::vector<Ogre::uchar> mData;
+};
+
+/** Texture kept in system memory, which prepares and loads from files as the
+	render systems do, for tests which need textures without a render system.
+*/
+class MemoryTexture : public Ogre::Texture
+{
+public:
+	MemoryTexture(Ogre::ResourceManager* creator, const Ogre::String& name, Ogre::ResourceHandle handle,
+		const Ogre::String& group, bool isManual, Ogre::ManualResourceLoader* loader)
+		: Ogre::Texture(creator, name, handle, group, isManual, loader)
+	{
+	}
+
+	~MemoryTexture()
+	{
+		// Virtual methods can't be called from the base destructor
+		if (isLoaded())
+			unload();
+		else
+			freeInternalResources();
+	}
+
+	Ogre::HardwarePixelBufferSharedPtr getBuffer(size_t face = 0, size_t mipmap = 0)
+	{
+		return mSurfaces[face * (mNumMipmaps + 1) + mipmap];
+	}
+
+protected:
+	void prepareImpl(void)
+	{
+		Ogre::String ext;
+		Ogre::String::size_type pos = mName.find_last_of(".");
+		if (pos != Ogre::String::npos)
+			ext = mName.substr(pos + 1);
+		readSourceImages(Ogre::StringVector(1, mName), ext, mPreparedImages);
+	}
+
+	void unprepareImpl(void)
+	{
+		mPreparedImages.clear();
+		Ogre::Texture::unprepareImpl();
+	}
+
+	void loadImpl(void)
+	{
+		if (mPreparedImages.empty())
+			prepareImpl();
+		Ogre::ConstImagePtrList imagePtrs;
+		for (size_t i = 0; i < mPreparedImages.size(); ++i)
+			imagePtrs.push_back(&mPreparedImages[i]);
+		_loadImages(imagePtrs);
+		mPreparedImages.clear();
+	}
+
+	void createInternalResourcesImpl(void)
+	{
+		size_t maxMips = 0;
+		for (size_t size = std::max(std::max(mWidth, mHeight), mDepth); size > 1; size /= 2)
+			++maxMips;
+		mNumMipmaps = std::min(mNumMipmaps, maxMips);
+		mFormat = Ogre::TextureManager::getSingleton().getNativeFormat(mTextureType, mFormat, mUsage);
+
+		for (size_t face = 0; face < getNumFaces(); ++face)
+		{
+			for (size_t mip = 0; mip <= mNumMipmaps; ++mip)
+			{
+				mSurfaces.push_back(Ogre::HardwarePixelBufferSharedPtr(OGRE_NEW MemoryPixelBuffer(
+					std::max(mWidth >> mip, (size_t)1), std::max(mHeight >> mip, (size_t)1),
+					std::max(mDepth >> mip, (size_t)1), mFormat)));
+			}
+		}
+	}
+
+	void freeInternalResourcesImpl(void)
+	{
+		mSurfaces.clear();
+	}
+
+	/// Images read by prepareImpl, as the render systems keep them until loadImpl
+	Ogre::vector<Ogre::Image>::type mPreparedImages;
+	std::vector<Ogre::HardwarePixelBufferSharedPtr> mSurfaces;
+};
+
+/** Texture manager making MemoryTexture objects, which takes any format. */
+class MemoryTextureManager : public Ogre::TextureManager
+{
+public:
+	MemoryTextureManager()
+	{
+		Ogre::ResourceGroupManager::getSingleton()._registerResourceManager(mResourceType, this);
+	}
+
+	~MemoryTextureManager()
+	{
+		removeAll();
+		Ogre::ResourceGroupManager::getSingleton()._unregisterResourceManager(mResourceType);
+	}
+
+	Ogre::PixelFormat getNativeFormat(Ogre::TextureType ttype, Ogre::PixelFormat format, int usage)
+	{
+		return format;
+	}
+
+	bool isHardwareFilteringSupported(Ogre::TextureType ttype, Ogre::PixelFormat format, int usage,
+		bool preciseFormatOnly)
+	{
+		return true;
+	}
+
+protected:
+	Ogre::Resource* createImpl(const Ogre::String& name, Ogre::ResourceHandle handle, 
+		const Ogre::String& group, bool isManual, Ogre::ManualResourceLoader* loader, 
+		const Ogre::NameValuePairList* createParams)
+	{
+		return OGRE_NEW MemoryTexture(this, name, handle, group, isManual, loader);
+	}
+};
+
+#endif
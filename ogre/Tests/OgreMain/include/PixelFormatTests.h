@@ -31,6 +31,9 @@ THE SOFTWARE.
 
 using namespace Ogre;
 
+/// Reference the optimised conversions are compared with, also used by the benchmarks
+void naiveBulkPixelConversion(const PixelBox &src, const PixelBox &dst);
+
 class PixelFormatTests : public CppUnit::TestFixture
 {
     // CppUnit macros for setting up the test suite
@@ -38,6 +41,8 @@ class PixelFormatTests : public CppUnit::TestFixture
     CPPUNIT_TEST( testIntegerPackUnpack );
     CPPUNIT_TEST( testFloatPackUnpack );
     CPPUNIT_TEST( testBulkConversion );
+    CPPUNIT_TEST( testRowConversion );
+    CPPUNIT_TEST( testParallelConversion );
     CPPUNIT_TEST_SUITE_END();
 public:
     void setUp();
@@ -46,10 +51,13 @@ public:
     void testIntegerPackUnpack();
     void testFloatPackUnpack();
     void testBulkConversion();
+    void testRowConversion();
+    void testParallelConversion();
 
     // Utils
     void setupBoxes(PixelFormat srcFormat, PixelFormat dstFormat);
     void testCase(PixelFormat srcFormat, PixelFormat dstFormat);
+    void fillColours(const PixelBox &box);
 private:
     int size;
     uint8 *randomData;
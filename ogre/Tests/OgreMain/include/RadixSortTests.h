@@ -38,6 +38,8 @@ class RadixSortTests : public CppUnit::TestFixture
 	CPPUNIT_TEST(testIntList);
 	CPPUNIT_TEST(testUnsignedIntVector);
 	CPPUNIT_TEST(testIntVector);
+	CPPUNIT_TEST(testIncrementalNearlySorted);
+	CPPUNIT_TEST(testIncrementalFallback);
 	CPPUNIT_TEST_SUITE_END();
 protected:
 public:
@@ -49,5 +51,7 @@ public:
 	void testIntList();
 	void testUnsignedIntVector();
 	void testIntVector();
+	void testIncrementalNearlySorted();
+	void testIncrementalFallback();
 
 };
@@ -0,0 +1,74 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgreResourceGroupManager.h"
+#include "OgreFileSystem.h"
+#include "TemporaryDirectory.h"
+#include <ctime>
+
+class ResourceGroupManagerTests : public CppUnit::TestFixture
+{
+	// CppUnit macros for setting up the test suite
+	CPPUNIT_TEST_SUITE( ResourceGroupManagerTests );
+	CPPUNIT_TEST(testLocationCacheReused);
+	CPPUNIT_TEST(testLocationChangeRescans);
+	CPPUNIT_TEST(testSubDirectoryChangeRescans);
+	CPPUNIT_TEST(testInvalidLocationCacheReplaced);
+	CPPUNIT_TEST(testPreparedScriptsMatchSerial);
+	CPPUNIT_TEST_SUITE_END();
+protected:
+	TemporaryDirectory* mDir;
+	Ogre::String mCacheFile;
+	/// Modification time the directories are given
+	time_t mModifiedTime;
+	Ogre::ArchiveManager* mArchiveMgr;
+	Ogre::FileSystemArchiveFactory* mFileSystemFactory;
+
+	void writeFile(const Ogre::String& name, const Ogre::String& contents);
+	void setModifiedTime(const Ogre::String& name);
+	time_t getModifiedTime(const Ogre::String& name);
+	/// Starts over with a new ResourceGroupManager, which adds the data directory
+	void restart(bool useCache = true);
+	size_t getListedSize(const Ogre::String& pattern);
+	/** Initialises the default group with the material scripts in the data
+		directory, and describes the materials and compiler errors that result.
+		The group's scripts are prepared ahead of time unless serial is set.
+	*/
+	Ogre::String parseScripts(bool serial);
+public:
+	void setUp();
+	void tearDown();
+
+	void testLocationCacheReused();
+	void testLocationChangeRescans();
+	void testSubDirectoryChangeRescans();
+	void testInvalidLocationCacheReplaced();
+	void testPreparedScriptsMatchSerial();
+
+};
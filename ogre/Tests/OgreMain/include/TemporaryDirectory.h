@@ -0,0 +1,117 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __TemporaryDirectory_H__
+#define __TemporaryDirectory_H__
+
+#include "OgreFileSystem.h"
+#include "OgreException.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  define NOMINMAX // required to stop windows.h messing up std::min
+#  include <windows.h>
+#else
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+/** An empty directory for tests which write files, deleted with everything 
+	in it when the test is done.
+*/
+class TemporaryDirectory
+{
+public:
+	TemporaryDirectory()
+	{
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+		char base[MAX_PATH], path[MAX_PATH];
+		// GetTempFileName makes a unique file, which is swapped for a directory
+		if (GetTempPathA(MAX_PATH, base) && GetTempFileNameA(base, "ogr", 0, path) &&
+			DeleteFileA(path) && CreateDirectoryA(path, 0))
+			mPath = path;
+#else
+		const char* base = getenv("TMPDIR");
+		Ogre::String pattern = Ogre::String(base && *base ? base : "/tmp") + "/ogretestXXXXXX";
+		std::vector<char> path(pattern.begin(), pattern.end());
+		path.push_back(0);
+		if (mkdtemp(&path[0]))
+			mPath = &path[0];
+#endif
+		if (mPath.empty())
+		{
+			OGRE_EXCEPT(Ogre::Exception::ERR_CANNOT_WRITE_TO_FILE,
+				"Cannot create a temporary directory", "TemporaryDirectory::TemporaryDirectory");
+		}
+	}
+
+	~TemporaryDirectory()
+	{
+		Ogre::FileSystemArchive archive(mPath, "FileSystem");
+		archive.load();
+		Ogre::StringVectorPtr files = archive.list(true, false);
+		for (Ogre::StringVector::iterator i = files->begin(); i != files->end(); ++i)
+			archive.remove(*i);
+
+		// Subdirectories are listed before what is in them, so go backwards
+		Ogre::StringVectorPtr dirs = archive.list(true, true);
+		for (Ogre::StringVector::reverse_iterator i = dirs->rbegin(); i != dirs->rend(); ++i)
+			removeDirectory(mPath + "/" + *i);
+		removeDirectory(mPath);
+	}
+
+	/// The full path of the directory
+	const Ogre::String& getPath(void) const { return mPath; }
+
+	/// Creates a directory within this one
+	void createDirectory(const Ogre::String& name) const
+	{
+		Ogre::String path = mPath + "/" + name;
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+		CreateDirectoryA(path.c_str(), 0);
+#else
+		mkdir(path.c_str(), 0777);
+#endif
+	}
+
+private:
+	static void removeDirectory(const Ogre::String& path)
+	{
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+		RemoveDirectoryA(path.c_str());
+#else
+		rmdir(path.c_str());
+#endif
+	}
+
+	Ogre::String mPath;
+};
+
+#endif
@@ -0,0 +1,84 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgreTextureManager.h"
+#include "OgreFileSystem.h"
+#include "TemporaryDirectory.h"
+
+class TextureCacheTests : public CppUnit::TestFixture
+{
+	// CppUnit macros for setting up the test suite
+	CPPUNIT_TEST_SUITE( TextureCacheTests );
+	CPPUNIT_TEST(testSaveAndLoad);
+	CPPUNIT_TEST(testSourceChangeInvalidates);
+	CPPUNIT_TEST(testEvictsLeastRecentlyUsed);
+	CPPUNIT_TEST(testEntriesFoundWhenSet);
+	CPPUNIT_TEST(testLoadTranscodesOnMiss);
+	CPPUNIT_TEST(testLoadTranscodesWithGamma);
+	CPPUNIT_TEST(testLoadFromCacheOnHit);
+	CPPUNIT_TEST(testLoadAfterSourceChange);
+	CPPUNIT_TEST(testKeyedBySettings);
+	CPPUNIT_TEST(testLoadImageAfterUnprepare);
+	CPPUNIT_TEST_SUITE_END();
+protected:
+	TemporaryDirectory* mDir;
+	Ogre::Archive* mCache;
+	Ogre::Archive* mSources;
+	Ogre::ArchiveManager* mArchiveMgr;
+	Ogre::FileSystemArchiveFactory* mFileSystemFactory;
+	Ogre::TextureManager* mManager;
+	Ogre::Codec* mCodec;
+
+	static void makeImage(Ogre::Image& image, size_t size, Ogre::uint8 seed);
+	/// Writes an uncompressed A8R8G8B8 source file
+	void writeSource(const Ogre::String& name, size_t width, size_t height, Ogre::uint8 seed);
+	/// Number of source files decoded so far
+	size_t getDecodeCount(void) const;
+	/// Number of those decoded straight into memory given by the texture
+	size_t getDecodeIntoCount(void) const;
+	/// Converts a source to A8B8G8R8 and generates mipmaps, as the texture does
+	static void makeTranscoded(const Ogre::Image& source, size_t numMips, Ogre::Image& image);
+	/// Copies all of the texture's levels
+	static void readLevels(const Ogre::TexturePtr& texture, std::vector<Ogre::uchar>& data);
+public:
+	void setUp();
+	void tearDown();
+
+	void testSaveAndLoad();
+	void testSourceChangeInvalidates();
+	void testEvictsLeastRecentlyUsed();
+	void testEntriesFoundWhenSet();
+	void testLoadTranscodesOnMiss();
+	void testLoadTranscodesWithGamma();
+	void testLoadFromCacheOnHit();
+	void testLoadAfterSourceChange();
+	void testKeyedBySettings();
+	void testLoadImageAfterUnprepare();
+
+};
@@ -0,0 +1,73 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "OgreTextureManager.h"
+#include "TemporaryDirectory.h"
+
+class TextureStreamingTests : public CppUnit::TestFixture
+{
+	// CppUnit macros for setting up the test suite
+	CPPUNIT_TEST_SUITE( TextureStreamingTests );
+	CPPUNIT_TEST(testLevelsArriveInOrder);
+	CPPUNIT_TEST(testUploadBudget);
+	CPPUNIT_TEST(testUnloadWhileStreaming);
+	CPPUNIT_TEST_SUITE_END();
+protected:
+	/// Records the residency changes of streamed textures
+	class RecordingListener : public Ogre::TextureManager::StreamingListener
+	{
+	public:
+		void textureResidencyChanged(Ogre::Texture* tex, size_t residentMipmap);
+
+		typedef std::pair<Ogre::String, size_t> Change;
+		std::vector<Change> mChanges;
+	};
+
+	TemporaryDirectory* mDir;
+	Ogre::Root* mRoot;
+	Ogre::TextureManager* mManager;
+	RecordingListener mListener;
+
+	/// Writes an uncompressed A8R8G8B8 DDS file holding all of its mipmaps
+	void writeSource(const Ogre::String& name, size_t size, Ogre::uint8 seed);
+	/** Decodes the levels requested so far, then uploads them as a frame does.
+	@returns the number of residency changes this caused
+	*/
+	size_t frame(void);
+	/// Checks the texture holds the source's levels from the given one down
+	void checkLevels(const Ogre::TexturePtr& tex, size_t size, Ogre::uint8 seed, size_t firstMip);
+public:
+	void setUp();
+	void tearDown();
+
+	void testLevelsArriveInOrder();
+	void testUploadBudget();
+	void testUnloadWhileStreaming();
+
+};
@@ -43,9 +43,12 @@ class ZipArchiveTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testFindFileInfoRecursive);
     CPPUNIT_TEST(testFileRead);
     CPPUNIT_TEST(testReadInterleave);
+    CPPUNIT_TEST(testCaseInsensitiveLookup);
+    CPPUNIT_TEST(testStoredFileRead);
     CPPUNIT_TEST_SUITE_END();
 protected:
     Ogre::String testPath;
+    Ogre::String storedPath;
 public:
     void setUp();
     void tearDown();
@@ -60,5 +63,7 @@ public:
     void testFindFileInfoRecursive();
     void testFileRead();
     void testReadInterleave();
+    void testCaseInsensitiveLookup();
+    void testStoredFileRead();
 
 };
@@ -0,0 +1,223 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "BillboardSetTests.h"
+#include "OgreRoot.h"
+#include "OgreMaterialManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreRenderOperation.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( BillboardSetTests );
+
+namespace
+{
+	/// Set which can be viewed without a Camera, as those need a render system
+	class TestBillboardSet : public BillboardSet
+	{
+	public:
+		TestBillboardSet(const String& name, unsigned int poolSize)
+			: BillboardSet(name, poolSize, true) {}
+
+		void setView(const Vector3& position, const Quaternion& orientation)
+		{
+			mCamPos = position;
+			mCamQ = orientation;
+			mCamDir = orientation * Vector3::NEGATIVE_UNIT_Z;
+		}
+	};
+}
+
+void BillboardSetTests::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "BillboardSetTests.log");
+	// Software buffers stand in for those of a render system
+	mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+	// A material without techniques, which can be loaded without a render system
+	MaterialManager::getSingleton().create("BaseWhite", 
+		ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+}
+
+void BillboardSetTests::tearDown()
+{
+	OGRE_DELETE mRoot;
+	OGRE_DELETE mBufMgr;
+}
+
+BillboardSet* BillboardSetTests::createSet(const String& name, size_t poolSize, bool autoUpdate)
+{
+	TestBillboardSet* set = OGRE_NEW TestBillboardSet(name, static_cast<unsigned int>(poolSize));
+	set->setAutoUpdate(autoUpdate);
+	set->setBillboardsInWorldSpace(true);
+	set->setTextureStacksAndSlices(2, 2);
+	set->setDefaultDimensions(2, 3);
+	// The billboards have their own sizes and rotations
+	set->_notifyBillboardResized();
+	set->_notifyBillboardRotated();
+	set->setView(Vector3(10, 20, 30), 
+		Quaternion(Degree(40), Vector3(1, 2, 0.5f).normalisedCopy()));
+	return set;
+}
+
+void BillboardSetTests::createBillboards(BillboardSet* owner, BillboardList& billboards, 
+	size_t count)
+{
+	billboards.clear();
+	for (size_t i = 0; i < count; ++i)
+	{
+		Billboard bb(Vector3(i * 0.5f, i * -0.25f, i * 0.125f + 1.0f), owner,
+			ColourValue(i / (Real)count, 0.5f, 1.0f - i / (Real)count, 0.75f));
+		bb.setTexcoordIndex(static_cast<uint16>(i % 4));
+		if (i % 3 == 1)
+			bb.setDimensions(1.0f + i * 0.1f, 0.5f);
+		if (i % 4 == 2)
+			bb.setRotation(Radian(i * 0.3f));
+		billboards.push_back(bb);
+	}
+}
+
+void BillboardSetTests::update(BillboardSet* set, const BillboardList& billboards, 
+	size_t count, bool batch)
+{
+	set->beginBillboards(count);
+	if (batch)
+	{
+		set->injectBillboards(&billboards[0], count);
+	}
+	else
+	{
+		for (size_t i = 0; i < count; ++i)
+			set->injectBillboard(billboards[i]);
+	}
+	set->endBillboards();
+}
+
+void BillboardSetTests::readVertices(BillboardSet* set, VertexList& vertices)
+{
+	RenderOperation op;
+	set->getRenderOperation(op);
+	const HardwareVertexBufferSharedPtr& buf = 
+		op.vertexData->vertexBufferBinding->getBuffer(0);
+	size_t vertexSize = buf->getVertexSize();
+
+	vertices.resize(op.vertexData->vertexCount * vertexSize / sizeof(float));
+	if (!vertices.empty())
+	{
+		buf->readData(op.vertexData->vertexStart * vertexSize, 
+			op.vertexData->vertexCount * vertexSize, &vertices[0]);
+	}
+}
+
+void BillboardSetTests::testBatchMatchesSingle()
+{
+	// The batch path expands quads with SSE where it can, injecting the 
+	// billboards one at a time uses the scalar code
+	const BillboardType types[] = { BBT_POINT, BBT_ORIENTED_COMMON, BBT_PERPENDICULAR_COMMON };
+	const BillboardRotationType rotations[] = { BBR_TEXCOORD, BBR_VERTEX };
+	const size_t numBillboards = 37;
+	BillboardList billboards;
+
+	for (size_t t = 0; t < 3; ++t)
+	{
+		for (size_t r = 0; r < 2; ++r)
+		{
+			BillboardSet* batched = createSet("batched", numBillboards, false);
+			BillboardSet* single = createSet("single", numBillboards, false);
+			createBillboards(batched, billboards, numBillboards);
+			batched->setBillboardType(types[t]);
+			single->setBillboardType(types[t]);
+			batched->setBillboardRotationType(rotations[r]);
+			single->setBillboardRotationType(rotations[r]);
+
+			update(batched, billboards, billboards.size(), true);
+			update(single, billboards, billboards.size(), false);
+
+			VertexList expected, actual;
+			readVertices(single, expected);
+			readVertices(batched, actual);
+			CPPUNIT_ASSERT_EQUAL(billboards.size() * 4 * 6, expected.size());
+			CPPUNIT_ASSERT(expected == actual);
+
+			OGRE_DELETE batched;
+			OGRE_DELETE single;
+		}
+	}
+}
+
+void BillboardSetTests::testRingBufferWraparound()
+{
+	const size_t poolSize = 16;
+	// Dynamic sets fill the regions of their buffer in turn, static ones only use the first
+	BillboardSet* ring = createSet("ring", poolSize, true);
+	BillboardSet* plain = createSet("plain", poolSize, false);
+	BillboardList billboards;
+	createBillboards(ring, billboards, poolSize);
+
+	const size_t counts[] = { 16, 5, 16, 16, 9, 16, 3, 12, 16, 16, 1, 16 };
+	const size_t numUpdates = sizeof(counts) / sizeof(counts[0]);
+	size_t lastStart = 0, wraps = 0;
+	VertexList expected, actual, previous;
+
+	for (size_t i = 0; i < numUpdates; ++i)
+	{
+		update(ring, billboards, counts[i], true);
+		update(plain, billboards, counts[i], true);
+
+		readVertices(plain, expected);
+		readVertices(ring, actual);
+		CPPUNIT_ASSERT_EQUAL(counts[i] * 4 * 6, expected.size());
+		CPPUNIT_ASSERT(expected == actual);
+
+		RenderOperation op;
+		ring->getRenderOperation(op);
+		const HardwareVertexBufferSharedPtr& buf = 
+			op.vertexData->vertexBufferBinding->getBuffer(0);
+		size_t floatsPerVertex = buf->getVertexSize() / sizeof(float);
+		size_t start = op.vertexData->vertexStart;
+		if (i > 0 && start == 0)
+		{
+			++wraps;
+		}
+		else if (i > 0)
+		{
+			// Written right after the last update, which must still be intact for the GPU
+			CPPUNIT_ASSERT_EQUAL(lastStart + previous.size() / floatsPerVertex, start);
+			VertexList kept(previous.size());
+			buf->readData(lastStart * buf->getVertexSize(), 
+				kept.size() * sizeof(float), &kept[0]);
+			CPPUNIT_ASSERT(previous == kept);
+		}
+		lastStart = start;
+		previous.swap(actual);
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)3, wraps);
+
+	OGRE_DELETE ring;
+	OGRE_DELETE plain;
+}
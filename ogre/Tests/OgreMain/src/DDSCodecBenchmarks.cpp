@@ -0,0 +1,71 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "DDSCodecBenchmarks.h"
+#include "OgreDDSCodec.h"
+#include "OgreFileSystem.h"
+#include "OgreTimer.h"
+#include <iostream>
+
+using namespace Ogre;
+
+// Register the suite with the benchmarks, see src/main.cpp
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( DDSCodecBenchmarks, "Benchmarks" );
+
+void DDSCodecBenchmarks::benchmarkDecompress()
+{
+    // Decode throughput over the test media
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+    FileSystemArchive arch("../../../../Tests/Media/", "FileSystem");
+#else
+    FileSystemArchive arch("../../Tests/Media/", "FileSystem");
+#endif
+    arch.load();
+    StringVectorPtr files = arch.find("*.dds", false);
+    const size_t numDecodes = 10;
+    DDSCodec codec;
+
+    std::cout << std::endl;
+    for (StringVector::iterator i = files->begin(); i != files->end(); ++i)
+    {
+        DataStreamPtr file = arch.open(*i);
+        MemoryDataStreamPtr contents(new MemoryDataStream(file));
+        DataStreamPtr stream = contents;
+        unsigned long total = 0;
+        size_t decodedSize = 0;
+        for (size_t n = 0; n < numDecodes; ++n)
+        {
+            stream->seek(0);
+            Timer timer;
+            Codec::DecodeResult res = codec.decode(stream);
+            total += timer.getMicroseconds();
+            decodedSize = res.first->size();
+        }
+        std::cout << *i << ": " << total / (numDecodes * 1000.0f) << "ms per decode, " <<
+            (decodedSize * numDecodes) / std::max(1.0f, (float)total) << "MB/s" << std::endl;
+    }
+}
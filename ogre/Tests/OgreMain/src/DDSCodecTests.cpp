@@ -0,0 +1,403 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "DDSCodecTests.h"
+#include "OgreImage.h"
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( DDSCodecTests );
+
+namespace
+{
+    /// Codec which leaves decodeMipmaps to ImageCodec
+    class FullDecodeCodec : public ImageCodec
+    {
+    public:
+        FullDecodeCodec(const DDSCodec* dds) : mDDS(dds) {}
+        DataStreamPtr code(MemoryDataStreamPtr& input, CodecDataPtr& pData) const
+        { return mDDS->code(input, pData); }
+        void codeToFile(MemoryDataStreamPtr& input, const String& outFileName, CodecDataPtr& pData) const
+        { mDDS->codeToFile(input, outFileName, pData); }
+        DecodeResult decode(DataStreamPtr& input) const
+        { return mDDS->decode(input); }
+        String getType() const { return "dds"; }
+        String magicNumberToFileExt(const char *magicNumberPtr, size_t maxbytes) const
+        { return mDDS->magicNumberToFileExt(magicNumberPtr, maxbytes); }
+    private:
+        const DDSCodec* mDDS;
+    };
+
+    /// Hands out a sub-box of a wider buffer, in another format
+    class BufferDecodeTarget : public ImageCodec::DecodeTarget
+    {
+    public:
+        BufferDecodeTarget(uint32* buffer, size_t pitch) 
+            : mBuffer(buffer), mPitch(pitch), mCalls(0) {}
+        PixelBox getDestination(const ImageCodec::ImageData& description)
+        {
+            ++mCalls;
+            mDescription = description;
+            PixelBox box(Box(1, 0, 1 + description.width, description.height), 
+                PF_A8B8G8R8, mBuffer);
+            box.rowPitch = mPitch;
+            box.slicePitch = mPitch * description.height;
+            return box;
+        }
+        uint32* mBuffer;
+        size_t mPitch;
+        size_t mCalls;
+        ImageCodec::ImageData mDescription;
+    };
+}
+
+void DDSCodecTests::setUp()
+{
+    mCodec = new DDSCodec();
+}
+
+void DDSCodecTests::tearDown()
+{
+    delete mCodec;
+}
+
+DataStreamPtr DDSCodecTests::createFile(size_t width, size_t height, size_t numMips, bool cubeMap)
+{
+    // Uncompressed A8R8G8B8 file, so no render system is needed to decode it
+    size_t numFaces = cubeMap ? 6 : 1;
+    size_t dataSize = Image::calculateSize(numMips - 1, numFaces, width, height, 1, PF_A8R8G8B8);
+    size_t fileSize = 128 + dataSize;
+    MemoryDataStream* file = new MemoryDataStream(fileSize);
+    uint32* header = reinterpret_cast<uint32*>(file->getPtr());
+    memset(header, 0, 128);
+    header[0] = 0x20534444; // 'DDS '
+    header[1] = 124; // header size
+    header[2] = 0x00021007; // caps, height, width, pixel format, mipmap count
+    header[3] = static_cast<uint32>(height);
+    header[4] = static_cast<uint32>(width);
+    header[7] = static_cast<uint32>(numMips);
+    header[19] = 32; // pixel format size
+    header[20] = 0x41; // RGB with alpha
+    header[22] = 32;
+    header[23] = 0x00ff0000;
+    header[24] = 0x0000ff00;
+    header[25] = 0x000000ff;
+    header[26] = 0xff000000;
+    header[27] = 0x00401008; // texture, complex, mipmap
+    header[28] = cubeMap ? 0x0000fe00 : 0;
+    uchar* data = file->getPtr() + 128;
+    for (size_t i = 0; i < dataSize; ++i)
+        data[i] = static_cast<uchar>((i * 7 + i / 251) & 0xFF);
+    return DataStreamPtr(file);
+}
+
+DataStreamPtr DDSCodecTests::createCompressedFile(size_t width, size_t height, size_t numMips,
+    const char* fourCC, const uchar* blocks, size_t blocksSize)
+{
+    // Block compressed file, the levels of which are filled with copies of the given blocks
+    size_t blockSize = (fourCC[3] == '1' || fourCC[2] == '4') ? 8 : 16;
+    size_t dataSize = 0;
+    for (size_t mip = 0; mip < numMips; ++mip)
+        dataSize += ((std::max((size_t)1, width >> mip) + 3) / 4) * 
+            ((std::max((size_t)1, height >> mip) + 3) / 4) * blockSize;
+    MemoryDataStream* file = new MemoryDataStream(128 + dataSize);
+    uint32* header = reinterpret_cast<uint32*>(file->getPtr());
+    memset(header, 0, 128);
+    header[0] = 0x20534444; // 'DDS '
+    header[1] = 124; // header size
+    header[2] = 0x00021007; // caps, height, width, pixel format, mipmap count
+    header[3] = static_cast<uint32>(height);
+    header[4] = static_cast<uint32>(width);
+    header[7] = static_cast<uint32>(numMips);
+    header[19] = 32; // pixel format size
+    header[20] = 0x4; // FourCC
+    memcpy(&header[21], fourCC, 4);
+    header[27] = numMips > 1 ? 0x00401008 : 0x00001000;
+    uchar* data = file->getPtr() + 128;
+    for (size_t i = 0; i < dataSize; i += blocksSize)
+        memcpy(data + i, blocks, std::min(blocksSize, dataSize - i));
+    return DataStreamPtr(file);
+}
+
+MemoryDataStreamPtr DDSCodecTests::decompress(DataStreamPtr& file, size_t width, size_t height)
+{
+    // There is no render system, so compressed data is always decompressed
+    Codec::DecodeResult res = mCodec->decode(file);
+    const ImageCodec::ImageData* data = 
+        static_cast<const ImageCodec::ImageData*>(res.second.getPointer());
+    CPPUNIT_ASSERT_EQUAL(PF_BYTE_RGBA, data->format);
+    CPPUNIT_ASSERT_EQUAL(width, data->width);
+    CPPUNIT_ASSERT_EQUAL(height, data->height);
+    CPPUNIT_ASSERT_EQUAL(res.first->size(), data->size);
+    return res.first;
+}
+
+void DDSCodecTests::checkTexel(const MemoryDataStreamPtr& data, size_t width, size_t x, size_t y,
+    uchar r, uchar g, uchar b, uchar a)
+{
+    const uchar* texel = data->getPtr() + (y * width + x) * 4;
+    CPPUNIT_ASSERT_EQUAL((int)r, (int)texel[0]);
+    CPPUNIT_ASSERT_EQUAL((int)g, (int)texel[1]);
+    CPPUNIT_ASSERT_EQUAL((int)b, (int)texel[2]);
+    CPPUNIT_ASSERT_EQUAL((int)a, (int)texel[3]);
+}
+
+void DDSCodecTests::checkMipmaps(const ImageCodec* codec, size_t width, size_t height, 
+    size_t numMips, bool cubeMap)
+{
+    size_t numFaces = cubeMap ? 6 : 1;
+    DataStreamPtr file = createFile(width, height, numMips, cubeMap);
+    Codec::DecodeResult fullRes = mCodec->decode(file);
+    const ImageCodec::ImageData* fullData = 
+        static_cast<const ImageCodec::ImageData*>(fullRes.second.getPointer());
+    Image full;
+    full.loadDynamicImage(fullRes.first->getPtr(), fullData->width, fullData->height, 
+        fullData->depth, fullData->format, false, numFaces, fullData->num_mipmaps);
+    CPPUNIT_ASSERT_EQUAL(numMips - 1, full.getNumMipmaps());
+    CPPUNIT_ASSERT_EQUAL(numFaces, full.getNumFaces());
+
+    for (size_t first = 0; first < numMips; ++first)
+    {
+        for (size_t count = 0; count <= 2; ++count)
+        {
+            file->seek(0);
+            Codec::DecodeResult res = codec->decodeMipmaps(file, first, count);
+            const ImageCodec::ImageData* data = 
+                static_cast<const ImageCodec::ImageData*>(res.second.getPointer());
+            size_t decoded = count == 0 ? numMips - first : std::min(count, numMips - first);
+            CPPUNIT_ASSERT_EQUAL(decoded - 1, (size_t)data->num_mipmaps);
+            CPPUNIT_ASSERT_EQUAL(std::max((size_t)1, width >> first), data->width);
+            CPPUNIT_ASSERT_EQUAL(std::max((size_t)1, height >> first), data->height);
+            CPPUNIT_ASSERT_EQUAL(res.first->size(), data->size);
+
+            Image part;
+            part.loadDynamicImage(res.first->getPtr(), data->width, data->height, data->depth,
+                data->format, false, numFaces, data->num_mipmaps);
+            for (size_t face = 0; face < numFaces; ++face)
+            {
+                for (size_t mip = 0; mip < decoded; ++mip)
+                {
+                    PixelBox expected = full.getPixelBox(face, first + mip);
+                    PixelBox actual = part.getPixelBox(face, mip);
+                    CPPUNIT_ASSERT_EQUAL(expected.getConsecutiveSize(), actual.getConsecutiveSize());
+                    CPPUNIT_ASSERT(memcmp(expected.data, actual.data, expected.getConsecutiveSize()) == 0);
+                }
+            }
+        }
+    }
+}
+
+void DDSCodecTests::testDecodeHeader()
+{
+    DataStreamPtr file = createFile(64, 32, 7, false);
+    Codec::CodecDataPtr header = mCodec->decodeHeader(file);
+    CPPUNIT_ASSERT(!header.isNull());
+    const ImageCodec::ImageData* data = 
+        static_cast<const ImageCodec::ImageData*>(header.getPointer());
+    CPPUNIT_ASSERT_EQUAL((size_t)64, data->width);
+    CPPUNIT_ASSERT_EQUAL((size_t)32, data->height);
+    CPPUNIT_ASSERT_EQUAL((ushort)6, data->num_mipmaps);
+    CPPUNIT_ASSERT_EQUAL(PF_A8R8G8B8, data->format);
+    CPPUNIT_ASSERT_EQUAL(Image::calculateSize(6, 1, 64, 32, 1, PF_A8R8G8B8), data->size);
+    // Only the header was read
+    CPPUNIT_ASSERT_EQUAL((size_t)128, file->tell());
+}
+
+void DDSCodecTests::testDecodeMipmaps()
+{
+    checkMipmaps(mCodec, 64, 32, 7, false);
+    // Non power of two with a partial chain
+    checkMipmaps(mCodec, 40, 24, 4, false);
+}
+
+void DDSCodecTests::testDecodeMipmapsCubeMap()
+{
+    checkMipmaps(mCodec, 16, 16, 5, true);
+}
+
+void DDSCodecTests::testDefaultDecodeMipmaps()
+{
+    FullDecodeCodec codec(mCodec);
+    DataStreamPtr file = createFile(16, 16, 5, false);
+    CPPUNIT_ASSERT(codec.decodeHeader(file).isNull());
+    checkMipmaps(&codec, 64, 32, 7, false);
+    checkMipmaps(&codec, 16, 16, 5, true);
+}
+
+namespace
+{
+    // Colour blocks: red and blue end points, each row indexing colours 0 to 3
+    const uchar RED_BLUE_BLOCK[8] = { 0x00, 0xF8, 0x1F, 0x00, 0xE4, 0xE4, 0xE4, 0xE4 };
+    // The same end points in the order which selects 3 colours and transparent black
+    const uchar BLUE_RED_BLOCK[8] = { 0x1F, 0x00, 0x00, 0xF8, 0xE4, 0xE4, 0xE4, 0xE4 };
+    // Interpolated block from 255 to 0 (6 interpolated values), indexes 0 to 7 in each
+    // half row and then the reverse in the last 8 texels
+    const uchar FALLING_BLOCK[8] = { 0xFF, 0x00, 0x88, 0xC6, 0xFA, 0x77, 0x39, 0x05 };
+    // Interpolated block from 0 to 255 (4 interpolated values), same indexes
+    const uchar RISING_BLOCK[8] = { 0x00, 0xFF, 0x88, 0xC6, 0xFA, 0x77, 0x39, 0x05 };
+    const uchar FALLING_VALUES[8] = { 255, 0, 219, 182, 146, 109, 73, 36 };
+    const uchar RISING_VALUES[8] = { 0, 255, 51, 102, 153, 204, 0, 255 };
+
+    size_t fallingIndex(size_t i)
+    {
+        return i < 8 ? i : 15 - i;
+    }
+}
+
+void DDSCodecTests::testDefaultDecodeInto()
+{
+    // ImageCodec decodes the whole image, then converts it into the destination
+    DataStreamPtr file = createFile(8, 4, 1, false);
+    Codec::DecodeResult ref = mCodec->decode(file);
+    file->seek(0);
+
+    const size_t pitch = 10;
+    std::vector<uint32> buffer(pitch * 4, 0xdeadbeef);
+    BufferDecodeTarget target(&buffer[0], pitch);
+    Codec::CodecDataPtr res = mCodec->decodeInto(file, target);
+
+    CPPUNIT_ASSERT_EQUAL((size_t)1, target.mCalls);
+    CPPUNIT_ASSERT_EQUAL((size_t)8, target.mDescription.width);
+    CPPUNIT_ASSERT_EQUAL((size_t)4, target.mDescription.height);
+    CPPUNIT_ASSERT_EQUAL(PF_A8R8G8B8, target.mDescription.format);
+    CPPUNIT_ASSERT_EQUAL(PF_A8R8G8B8, static_cast<ImageCodec::ImageData*>(res.getPointer())->format);
+
+    const uint32* src = reinterpret_cast<const uint32*>(ref.first->getPtr());
+    for (size_t y = 0; y < 4; ++y)
+    {
+        // Columns outside the box are left alone
+        CPPUNIT_ASSERT_EQUAL((uint32)0xdeadbeef, buffer[y * pitch]);
+        CPPUNIT_ASSERT_EQUAL((uint32)0xdeadbeef, buffer[y * pitch + 9]);
+        for (size_t x = 0; x < 8; ++x)
+        {
+            // Red and blue swapped
+            uint32 argb = src[y * 8 + x];
+            uint32 abgr = (argb & 0xff00ff00) | ((argb >> 16) & 0xff) | ((argb & 0xff) << 16);
+            CPPUNIT_ASSERT_EQUAL(abgr, buffer[y * pitch + 1 + x]);
+        }
+    }
+}
+
+void DDSCodecTests::testDecompressBC1()
+{
+    uchar blocks[16];
+    memcpy(blocks, RED_BLUE_BLOCK, 8);
+    memcpy(blocks + 8, BLUE_RED_BLOCK, 8);
+    DataStreamPtr file = createCompressedFile(8, 4, 1, "DXT1", blocks, 16);
+    MemoryDataStreamPtr data = decompress(file, 8, 4);
+    for (size_t y = 0; y < 4; ++y)
+    {
+        // 4 colours
+        checkTexel(data, 8, 0, y, 255, 0, 0, 255);
+        checkTexel(data, 8, 1, y, 0, 0, 255, 255);
+        checkTexel(data, 8, 2, y, 170, 0, 85, 255);
+        checkTexel(data, 8, 3, y, 85, 0, 170, 255);
+        // 3 colours and transparent black
+        checkTexel(data, 8, 4, y, 0, 0, 255, 255);
+        checkTexel(data, 8, 5, y, 255, 0, 0, 255);
+        checkTexel(data, 8, 6, y, 128, 0, 128, 255);
+        checkTexel(data, 8, 7, y, 0, 0, 0, 0);
+    }
+}
+
+void DDSCodecTests::testDecompressBC2()
+{
+    // Explicit alpha rising by 1 each texel, then a block in 3 colour order,
+    // which is only special for DXT1
+    uchar blocks[16] = { 0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE };
+    memcpy(blocks + 8, BLUE_RED_BLOCK, 8);
+    DataStreamPtr file = createCompressedFile(4, 4, 1, "DXT3", blocks, 16);
+    MemoryDataStreamPtr data = decompress(file, 4, 4);
+    for (size_t y = 0; y < 4; ++y)
+    {
+        checkTexel(data, 4, 0, y, 0, 0, 255, (uchar)(y * 4 * 17));
+        checkTexel(data, 4, 1, y, 255, 0, 0, (uchar)((y * 4 + 1) * 17));
+        checkTexel(data, 4, 2, y, 85, 0, 170, (uchar)((y * 4 + 2) * 17));
+        checkTexel(data, 4, 3, y, 170, 0, 85, (uchar)((y * 4 + 3) * 17));
+    }
+}
+
+void DDSCodecTests::testDecompressBC3()
+{
+    uchar blocks[16];
+    memcpy(blocks, FALLING_BLOCK, 8);
+    memcpy(blocks + 8, RED_BLUE_BLOCK, 8);
+    DataStreamPtr file = createCompressedFile(4, 4, 1, "DXT5", blocks, 16);
+    MemoryDataStreamPtr data = decompress(file, 4, 4);
+    const uchar reds[4] = { 255, 0, 170, 85 };
+    const uchar blues[4] = { 0, 255, 85, 170 };
+    for (size_t i = 0; i < 16; ++i)
+        checkTexel(data, 4, i % 4, i / 4, reds[i % 4], 0, blues[i % 4], 
+            FALLING_VALUES[fallingIndex(i)]);
+}
+
+void DDSCodecTests::testDecompressBC4()
+{
+    DataStreamPtr file = createCompressedFile(4, 4, 1, "ATI1", RISING_BLOCK, 8);
+    MemoryDataStreamPtr data = decompress(file, 4, 4);
+    for (size_t i = 0; i < 16; ++i)
+        checkTexel(data, 4, i % 4, i / 4, RISING_VALUES[fallingIndex(i)], 0, 0, 255);
+}
+
+void DDSCodecTests::testDecompressBC5()
+{
+    uchar blocks[16];
+    memcpy(blocks, FALLING_BLOCK, 8);
+    memcpy(blocks + 8, RISING_BLOCK, 8);
+    DataStreamPtr file = createCompressedFile(4, 4, 1, "BC5U", blocks, 16);
+    MemoryDataStreamPtr data = decompress(file, 4, 4);
+    for (size_t i = 0; i < 16; ++i)
+        checkTexel(data, 4, i % 4, i / 4, FALLING_VALUES[fallingIndex(i)], 
+            RISING_VALUES[fallingIndex(i)], 0, 255);
+}
+
+void DDSCodecTests::testDecompressPartialBlocks()
+{
+    // 6x5 texels span 2x2 blocks; the smaller levels are clipped from a single block
+    DataStreamPtr file = createCompressedFile(6, 5, 3, "DXT1", RED_BLUE_BLOCK, 8);
+    Codec::DecodeResult res = mCodec->decode(file);
+    const ImageCodec::ImageData* data = 
+        static_cast<const ImageCodec::ImageData*>(res.second.getPointer());
+    CPPUNIT_ASSERT_EQUAL(Image::calculateSize(2, 1, 6, 5, 1, PF_BYTE_RGBA), data->size);
+    CPPUNIT_ASSERT_EQUAL(res.first->size(), data->size);
+
+    Image image;
+    image.loadDynamicImage(res.first->getPtr(), 6, 5, 1, PF_BYTE_RGBA, false, 1, 2);
+    const uchar reds[4] = { 255, 0, 170, 85 };
+    for (size_t mip = 0; mip < 3; ++mip)
+    {
+        PixelBox box = image.getPixelBox(0, mip);
+        for (size_t y = 0; y < box.getHeight(); ++y)
+        {
+            for (size_t x = 0; x < box.getWidth(); ++x)
+            {
+                const uchar* texel = static_cast<const uchar*>(box.data) + 
+                    (y * box.rowPitch + x) * 4;
+                CPPUNIT_ASSERT_EQUAL((int)reds[x % 4], (int)texel[0]);
+            }
+        }
+    }
+}
@@ -0,0 +1,164 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "DeflateStreamTests.h"
+#include "OgreDeflate.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( DeflateStreamTests );
+
+namespace
+{
+	/// Stream which hides that its data is in memory
+	class UnmappedDataStream : public DataStream
+	{
+	public:
+		UnmappedDataStream(const DataStreamPtr& stream) : mStream(stream) { mSize = stream->size(); }
+
+		size_t read(void* buf, size_t count) { return mStream->read(buf, count); }
+		void skip(long count) { mStream->skip(count); }
+		void seek(size_t pos) { mStream->seek(pos); }
+		size_t tell(void) const { return mStream->tell(); }
+		bool eof(void) const { return mStream->eof(); }
+		void close(void) { mStream->close(); }
+	protected:
+		DataStreamPtr mStream;
+	};
+}
+
+void DeflateStreamTests::setUp()
+{
+	// Compressible, but not trivially so
+	mData.resize(300000);
+	for (size_t i = 0; i < mData.size(); ++i)
+		mData[i] = static_cast<uchar>((i * 7) ^ (i >> 9));
+}
+
+void DeflateStreamTests::tearDown()
+{
+}
+
+DataStreamPtr DeflateStreamTests::compress(size_t chunkSize)
+{
+	// Leave some data in front, deflate streams may be embedded in others
+	DataStreamPtr compressed(OGRE_NEW MemoryDataStream(mData.size() * 2));
+	compressed->write("head", 4);
+	{
+		DeflateStream deflate("test", compressed, chunkSize);
+		deflate.write(&mData[0], mData.size());
+	}
+	return compressed;
+}
+
+DataStreamPtr DeflateStreamTests::reopen(const DataStreamPtr& compressed)
+{
+	// Read back through a read-only view of the written data, which doesn't
+	// keep it alive; callers hold on to the compressed stream
+	MemoryDataStream* mem = static_cast<MemoryDataStream*>(compressed.getPointer());
+	DataStreamPtr ret(OGRE_NEW MemoryDataStream(mem->getPtr(), mem->tell(), false, true));
+	ret->skip(4);
+	return ret;
+}
+
+void DeflateStreamTests::testPlainRoundTrip()
+{
+	DataStreamPtr compressed = compress(0);
+	DeflateStream inflate("test", reopen(compressed));
+	CPPUNIT_ASSERT(inflate.isCompressedStreamValid());
+	CPPUNIT_ASSERT(!inflate.isChunked());
+
+	vector<uchar>::type result(mData.size());
+	CPPUNIT_ASSERT_EQUAL(mData.size(), inflate.read(&result[0], result.size()));
+	CPPUNIT_ASSERT(result == mData);
+}
+
+void DeflateStreamTests::testChunkedRoundTrip()
+{
+	DataStreamPtr compressed = compress(4096);
+	DeflateStream inflate("test", reopen(compressed));
+	CPPUNIT_ASSERT(inflate.isCompressedStreamValid());
+	CPPUNIT_ASSERT(inflate.isChunked());
+	CPPUNIT_ASSERT_EQUAL(mData.size(), inflate.size());
+
+	vector<uchar>::type result(mData.size());
+	CPPUNIT_ASSERT_EQUAL(mData.size(), inflate.read(&result[0], result.size()));
+	CPPUNIT_ASSERT(result == mData);
+	CPPUNIT_ASSERT(inflate.eof());
+}
+
+void DeflateStreamTests::testChunkedRandomAccess()
+{
+	// Random stretches don't compress and are stored as is, the rest is
+	// text like; 3000 byte chunks leave a short last one, and 34 chunks
+	// take three write batches
+	const size_t size = 100000, chunkSize = 3000;
+	vector<uchar>::type data(size);
+	uint32 seed = 1;
+	for (size_t i = 0; i < size; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		bool random = (i / 10000) % 2 != 0;
+		data[i] = random ? static_cast<uchar>(seed >> 16) : static_cast<uchar>('a' + (i % 53) % 26);
+	}
+
+	// Written in pieces which don't line up with the chunks
+	DataStreamPtr compressed(OGRE_NEW MemoryDataStream(size * 2));
+	compressed->write("head", 4);
+	{
+		DeflateStream deflate("test", compressed, chunkSize);
+		for (size_t pos = 0; pos < size; pos += 7777)
+			deflate.write(&data[pos], std::min((size_t)7777, size - pos));
+	}
+	CPPUNIT_ASSERT(compressed->tell() < size);
+
+	// Read back without access to the data in memory, so that chunks are
+	// read from the compressed stream as they are needed
+	DataStreamPtr unmapped(OGRE_NEW UnmappedDataStream(reopen(compressed)));
+	DeflateStream inflate("test", unmapped);
+	CPPUNIT_ASSERT(inflate.isChunked());
+	CPPUNIT_ASSERT_EQUAL(size, inflate.size());
+
+	// Across chunk boundaries and into the short last chunk, backwards too
+	uchar buf[100];
+	const size_t offsets[] = { 2950, 59990, 99950, 20000, 0, 29999 };
+	for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i)
+	{
+		inflate.seek(offsets[i]);
+		size_t cnt = inflate.read(buf, sizeof(buf));
+		CPPUNIT_ASSERT_EQUAL(std::min(sizeof(buf), size - offsets[i]), cnt);
+		CPPUNIT_ASSERT(memcmp(buf, &data[offsets[i]], cnt) == 0);
+	}
+
+	// Whole chunks from the middle of one to the end
+	inflate.seek(1500);
+	vector<uchar>::type result(size - 1500);
+	CPPUNIT_ASSERT_EQUAL(result.size(), inflate.read(&result[0], size));
+	CPPUNIT_ASSERT(memcmp(&result[0], &data[1500], result.size()) == 0);
+	CPPUNIT_ASSERT(inflate.eof());
+}
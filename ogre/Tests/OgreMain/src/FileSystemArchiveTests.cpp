@@ -240,6 +240,31 @@ void FileSystemArchiveTests::testFileRead()
     CPPUNIT_ASSERT_EQUAL(StringUtil::BLANK, stream->getLine()); // blank at end of file
     CPPUNIT_ASSERT(stream->eof());
 
+}
+void FileSystemArchiveTests::testMappedFileRead()
+{
+    FileSystemArchive::setUseMemoryMapping(true);
+    FileSystemArchive arch(testPath, "FileSystem");
+    arch.load();
+
+    DataStreamPtr stream = arch.open("rootfile.txt");
+    FileSystemArchive::setUseMemoryMapping(false);
+
+    // Contents are available in place as well as through the stream
+    CPPUNIT_ASSERT(stream->getDataPtr() != 0);
+    CPPUNIT_ASSERT_EQUAL(String("this is line 1"),
+        String(reinterpret_cast<const char*>(stream->getDataPtr()), 14));
+    CPPUNIT_ASSERT_EQUAL(String("this is line 1 in file 1"), stream->getLine());
+    CPPUNIT_ASSERT_EQUAL(String("this is line 2 in file 1"), stream->getLine());
+    stream->seek(0);
+    CPPUNIT_ASSERT_EQUAL(String("this is line 1 in file 1"), stream->getLine());
+
+    // Writing to a mapped stream is refused
+    CPPUNIT_ASSERT(!stream->isWriteable());
+
+    stream->close();
+    CPPUNIT_ASSERT(stream->getDataPtr() == 0);
+
 }
 void FileSystemArchiveTests::testReadInterleave()
 {
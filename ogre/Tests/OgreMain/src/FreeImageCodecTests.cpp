@@ -0,0 +1,215 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "FreeImageCodecTests.h"
+#include "OgreFreeImageCodec.h"
+#include "OgreException.h"
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( FreeImageCodecTests );
+
+namespace
+{
+    /// Hands out a sub-box of a wider buffer, in the given format
+    class BufferDecodeTarget : public ImageCodec::DecodeTarget
+    {
+    public:
+        BufferDecodeTarget(PixelFormat format, size_t border) 
+            : mFormat(format), mBorder(border) {}
+        PixelBox getDestination(const ImageCodec::ImageData& description)
+        {
+            mDescription = description;
+            mPitch = description.width + mBorder * 2;
+            size_t pixelSize = PixelUtil::getNumElemBytes(mFormat);
+            mBuffer.assign(mPitch * description.height * pixelSize, 0xcd);
+            PixelBox box(Box(mBorder, 0, mBorder + description.width, description.height), 
+                mFormat, &mBuffer[0]);
+            box.rowPitch = mPitch;
+            box.slicePitch = mPitch * description.height;
+            return box;
+        }
+        PixelFormat mFormat;
+        size_t mBorder;
+        size_t mPitch;
+        std::vector<uchar> mBuffer;
+        ImageCodec::ImageData mDescription;
+    };
+}
+
+void FreeImageCodecTests::setUp()
+{
+    FreeImageCodec::startup();
+    mCodec = static_cast<ImageCodec*>(Codec::getCodec("bmp"));
+}
+
+void FreeImageCodecTests::tearDown()
+{
+    FreeImageCodec::shutdown();
+}
+
+DataStreamPtr FreeImageCodecTests::createBitmap(size_t width, size_t height, size_t bpp, 
+    const uint32* palette, size_t numColours)
+{
+    // Rows are stored bottom up, each padded to 4 bytes
+    size_t rowSize = (width * bpp / 8 + 3) & ~3;
+    size_t dataOffset = 14 + 40 + numColours * 4;
+    size_t fileSize = dataOffset + rowSize * height;
+    MemoryDataStreamPtr file(OGRE_NEW MemoryDataStream(fileSize));
+    uchar* data = file->getPtr();
+    memset(data, 0, fileSize);
+
+    // File header
+    data[0] = 'B';
+    data[1] = 'M';
+    *reinterpret_cast<uint32*>(data + 2) = static_cast<uint32>(fileSize);
+    *reinterpret_cast<uint32*>(data + 10) = static_cast<uint32>(dataOffset);
+    // Info header
+    uint32* info = reinterpret_cast<uint32*>(data + 14);
+    info[0] = 40;
+    info[1] = static_cast<uint32>(width);
+    info[2] = static_cast<uint32>(height);
+    *reinterpret_cast<uint16*>(data + 26) = 1; // planes
+    *reinterpret_cast<uint16*>(data + 28) = static_cast<uint16>(bpp);
+    info[8] = static_cast<uint32>(numColours);
+    // Palette, as BGRX
+    memcpy(data + 54, palette, numColours * 4);
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        uchar* row = data + dataOffset + y * rowSize;
+        for (size_t x = 0; x < width * bpp / 8; ++x)
+            row[x] = static_cast<uchar>(numColours ? (x + y * 3) % numColours : x * 29 + y * 71);
+    }
+    return file;
+}
+
+void FreeImageCodecTests::checkDecodeInto(DataStreamPtr& file, PixelFormat format)
+{
+    Codec::DecodeResult ref = mCodec->decode(file);
+    const ImageCodec::ImageData* refData = static_cast<const ImageCodec::ImageData*>(ref.second.getPointer());
+    file->seek(0);
+
+    BufferDecodeTarget target(format, 2);
+    Codec::CodecDataPtr res = mCodec->decodeInto(file, target);
+    const ImageCodec::ImageData* resData = static_cast<const ImageCodec::ImageData*>(res.getPointer());
+
+    // Described as decode would
+    CPPUNIT_ASSERT_EQUAL(refData->width, resData->width);
+    CPPUNIT_ASSERT_EQUAL(refData->height, resData->height);
+    CPPUNIT_ASSERT_EQUAL(refData->format, resData->format);
+    CPPUNIT_ASSERT_EQUAL(refData->format, target.mDescription.format);
+
+    // Same pixels as converting what decode gives
+    size_t width = refData->width, height = refData->height;
+    size_t pixelSize = PixelUtil::getNumElemBytes(format);
+    std::vector<uchar> expected(PixelUtil::getMemorySize(width, height, 1, format));
+    PixelUtil::bulkPixelConversion(PixelBox(width, height, 1, refData->format, ref.first->getPtr()),
+        PixelBox(width, height, 1, format, &expected[0]));
+    for (size_t y = 0; y < height; ++y)
+    {
+        const uchar* row = &target.mBuffer[y * target.mPitch * pixelSize];
+        CPPUNIT_ASSERT(memcmp(&expected[y * width * pixelSize], row + 2 * pixelSize, width * pixelSize) == 0);
+        // Columns outside the box are left alone
+        CPPUNIT_ASSERT_EQUAL((uchar)0xcd, row[0]);
+        CPPUNIT_ASSERT_EQUAL((uchar)0xcd, row[(target.mPitch - 1) * pixelSize]);
+    }
+}
+
+void FreeImageCodecTests::testDecodeIntoPalette()
+{
+    const uint32 palette[5] = { 0x00ff0000, 0x0000ff00, 0x000000ff, 0x00123456, 0x00ffffff };
+    DataStreamPtr file = createBitmap(7, 3, 8, palette, 5);
+    checkDecodeInto(file, PF_A8R8G8B8);
+    file->seek(0);
+    checkDecodeInto(file, PF_R5G6B5);
+
+    // The palette is expanded, first row at the top
+    file->seek(0);
+    BufferDecodeTarget target(PF_A8R8G8B8, 0);
+    mCodec->decodeInto(file, target);
+    const uint32* pixels = reinterpret_cast<const uint32*>(&target.mBuffer[0]);
+    CPPUNIT_ASSERT_EQUAL((uint32)0xff00ff00, pixels[0]);
+    CPPUNIT_ASSERT_EQUAL((uint32)0xff0000ff, pixels[1]);
+    CPPUNIT_ASSERT_EQUAL((uint32)0xffff0000, pixels[2 * 7]);
+    CPPUNIT_ASSERT_EQUAL((uint32)0xff123456, pixels[2 * 7 + 3]);
+}
+
+void FreeImageCodecTests::testDecodeIntoGreyscale()
+{
+    // A black to white palette is decoded as luminance
+    uint32 palette[256];
+    for (uint32 i = 0; i < 256; ++i)
+        palette[i] = i * 0x010101;
+    DataStreamPtr file = createBitmap(6, 4, 8, palette, 256);
+    checkDecodeInto(file, PF_L8);
+    file->seek(0);
+    checkDecodeInto(file, PF_A8B8G8R8);
+}
+
+void FreeImageCodecTests::testDecodeIntoRGB()
+{
+    DataStreamPtr file = createBitmap(5, 4, 24, 0, 0);
+    checkDecodeInto(file, PF_A8B8G8R8);
+    file->seek(0);
+    checkDecodeInto(file, PF_FLOAT32_RGB);
+}
+
+void FreeImageCodecTests::testDecodeIntoRGBA()
+{
+    // 32 bit sources, in their own layout and converted to others
+    DataStreamPtr file = createBitmap(6, 3, 32, 0, 0);
+    checkDecodeInto(file, PF_A8R8G8B8);
+    file->seek(0);
+    checkDecodeInto(file, PF_A8B8G8R8);
+    file->seek(0);
+    checkDecodeInto(file, PF_A4R4G4B4);
+}
+
+void FreeImageCodecTests::testDecodeIntoWrongSize()
+{
+    /// Hands out a box smaller than the image
+    class SmallTarget : public ImageCodec::DecodeTarget
+    {
+    public:
+        PixelBox getDestination(const ImageCodec::ImageData& description)
+        {
+            return PixelBox(description.width - 1, description.height, 1, PF_A8R8G8B8, mBuffer);
+        }
+        uint32 mBuffer[64];
+    };
+
+    DataStreamPtr file = createBitmap(5, 4, 24, 0, 0);
+    SmallTarget target;
+    try
+    {
+        mCodec->decodeInto(file, target);
+        CPPUNIT_FAIL("Expected an exception");
+    }
+    catch (const InvalidParametersException&)
+    {
+    }
+}
@@ -0,0 +1,316 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "GlyphAtlasTests.h"
+#include "MemoryTextureManager.h"
+#include "OgreFontManager.h"
+#include "OgreArchiveManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreLodStrategyManager.h"
+#include "OgreOverlayManager.h"
+#include "OgreTextAreaOverlayElement.h"
+#include "OgreDefaultHardwareBufferManager.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( GlyphAtlasTests );
+
+namespace
+{
+	/// Text area which counts how often its geometry is built
+	class CountingTextArea : public TextAreaOverlayElement
+	{
+	public:
+		CountingTextArea(const String& name) : TextAreaOverlayElement(name), mBuilds(0) {}
+
+		size_t mBuilds;
+
+	protected:
+		void updatePositionGeometry(void)
+		{
+			// Only called by _update once the positions are out of date
+			CPPUNIT_ASSERT(mGeomPositionsOutOfDate);
+			++mBuilds;
+			TextAreaOverlayElement::updatePositionGeometry();
+		}
+
+		// There is no render system to place the element or convert colours for
+		void _updateFromParent(void) {}
+		void updateColours(void) {}
+	};
+}
+
+void GlyphAtlasTests::setUp()
+{
+	OGRE_NEW ResourceGroupManager();
+	mArchiveMgr = OGRE_NEW ArchiveManager();
+	mFileSystemFactory = OGRE_NEW FileSystemArchiveFactory();
+	mArchiveMgr->addArchiveFactory(mFileSystemFactory);
+	OGRE_NEW LodStrategyManager();
+	OGRE_NEW MaterialManager();
+	MaterialManager::getSingleton().initialise();
+	OGRE_NEW DefaultHardwareBufferManager();
+	mTextureMgr = OGRE_NEW MemoryTextureManager();
+	mFontMgr = OGRE_NEW FontManager();
+	OGRE_NEW OverlayManager();
+
+	mFontA = static_cast<Font*>(mFontMgr->create("FontA", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME).getPointer());
+	mFontB = static_cast<Font*>(mFontMgr->create("FontB", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME).getPointer());
+}
+
+void GlyphAtlasTests::tearDown()
+{
+	OGRE_DELETE OverlayManager::getSingletonPtr();
+	OGRE_DELETE mFontMgr;
+	OGRE_DELETE mTextureMgr;
+	OGRE_DELETE HardwareBufferManager::getSingletonPtr();
+	OGRE_DELETE MaterialManager::getSingletonPtr();
+	OGRE_DELETE LodStrategyManager::getSingletonPtr();
+	OGRE_DELETE ResourceGroupManager::getSingletonPtr();
+	OGRE_DELETE mArchiveMgr;
+	OGRE_DELETE mFileSystemFactory;
+}
+
+PixelBox GlyphAtlasTests::makeCell(size_t width, size_t height, uchar alpha)
+{
+	mCell.resize(width * height * 2);
+	for (size_t i = 0; i < mCell.size(); i += 2)
+	{
+		mCell[i] = 0xFF;
+		mCell[i + 1] = alpha;
+	}
+	return PixelBox(width, height, 1, PF_BYTE_LA, &mCell[0]);
+}
+
+void GlyphAtlasTests::testAddAndFind()
+{
+	GlyphAtlas atlas("TestAtlas", "General", 64, 32, 2);
+	CPPUNIT_ASSERT(atlas.findGlyph(mFontA, 'a') == 0);
+
+	const Font::GlyphInfo* glyph = atlas.addGlyph(mFontA, 'a', makeCell(10, 20, 0x80));
+	CPPUNIT_ASSERT(glyph != 0);
+	CPPUNIT_ASSERT_EQUAL(Font::CodePoint('a'), glyph->codePoint);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, glyph->aspectRatio, 1e-6);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0 / 64, glyph->uvRect.right - glyph->uvRect.left, 1e-6);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(20.0 / 64, glyph->uvRect.bottom - glyph->uvRect.top, 1e-6);
+
+	// The cell is copied where its texture coordinates point
+	const Image& image = atlas.getImage();
+	size_t left = static_cast<size_t>(glyph->uvRect.left * 64 + 0.5);
+	size_t top = static_cast<size_t>(glyph->uvRect.top * 64 + 0.5);
+	const uchar* data = image.getData();
+	CPPUNIT_ASSERT_EQUAL(uchar(0x80), data[(top * 64 + left) * 2 + 1]);
+	CPPUNIT_ASSERT_EQUAL(uchar(0x80), data[((top + 19) * 64 + left + 9) * 2 + 1]);
+	CPPUNIT_ASSERT_EQUAL(uchar(0x00), data[((top + 20) * 64 + left) * 2 + 1]);
+	CPPUNIT_ASSERT_EQUAL(uchar(0x00), data[(top * 64 + left + 10) * 2 + 1]);
+
+	const Font::GlyphInfo* found = atlas.findGlyph(mFontA, 'a');
+	CPPUNIT_ASSERT(found != 0);
+	CPPUNIT_ASSERT_EQUAL(glyph->uvRect.left, found->uvRect.left);
+	CPPUNIT_ASSERT(atlas.findGlyph(mFontB, 'a') == 0);
+
+	// Too big for a page
+	CPPUNIT_ASSERT(atlas.addGlyph(mFontA, 'b', makeCell(10, 31, 0xFF)) == 0);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), atlas.getGlyphCount());
+	CPPUNIT_ASSERT_EQUAL(uint32(0), atlas.getGeneration());
+}
+
+void GlyphAtlasTests::testSkylinePacking()
+{
+	GlyphAtlas atlas("TestAtlas", "General", 64, 32, 1);
+
+	// 14x14 cells take 16x16 with their padding, so 8 fit on the page
+	for (Font::CodePoint cp = 0; cp < 8; ++cp)
+		CPPUNIT_ASSERT(atlas.addGlyph(mFontA, cp, makeCell(14, 14, 0xFF)) != 0);
+	CPPUNIT_ASSERT_EQUAL(size_t(8), atlas.getGlyphCount());
+	CPPUNIT_ASSERT_EQUAL(size_t(0), atlas.getEvictionCount());
+
+	// No two glyphs overlap
+	for (Font::CodePoint i = 0; i < 8; ++i)
+	{
+		Font::UVRect a = atlas.findGlyph(mFontA, i)->uvRect;
+		for (Font::CodePoint j = i + 1; j < 8; ++j)
+		{
+			Font::UVRect b = atlas.findGlyph(mFontA, j)->uvRect;
+			CPPUNIT_ASSERT(a.right <= b.left || b.right <= a.left || 
+				a.bottom <= b.top || b.bottom <= a.top);
+		}
+	}
+
+	// A short glyph fills the gap left beside a tall one
+	GlyphAtlas mixed("MixedAtlas", "General", 64, 32, 1);
+	CPPUNIT_ASSERT(mixed.addGlyph(mFontA, 0, makeCell(30, 30, 0xFF)) != 0);
+	CPPUNIT_ASSERT(mixed.addGlyph(mFontA, 1, makeCell(30, 14, 0xFF)) != 0);
+	CPPUNIT_ASSERT(mixed.addGlyph(mFontA, 2, makeCell(30, 14, 0xFF)) != 0);
+	CPPUNIT_ASSERT_EQUAL(size_t(0), mixed.getEvictionCount());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(32.0 / 64, mixed.findGlyph(mFontA, 2)->uvRect.left, 1e-6);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(16.0 / 32, mixed.findGlyph(mFontA, 2)->uvRect.top, 1e-6);
+}
+
+void GlyphAtlasTests::testEvictsLeastRecentlyUsedPage()
+{
+	GlyphAtlas atlas("TestAtlas", "General", 32, 16, 2);
+
+	// Two 14x14 glyphs fill a page
+	for (Font::CodePoint cp = 0; cp < 4; ++cp)
+		CPPUNIT_ASSERT(atlas.addGlyph(mFontA, cp, makeCell(14, 14, 0xFF)) != 0);
+	CPPUNIT_ASSERT_EQUAL(size_t(0), atlas.getEvictionCount());
+
+	// Use the first page, so the second is the least recently used
+	CPPUNIT_ASSERT(atlas.findGlyph(mFontA, 0) != 0);
+	uint32 generation = atlas.getGeneration();
+
+	const Font::GlyphInfo* glyph = atlas.addGlyph(mFontA, 4, makeCell(14, 14, 0x40));
+	CPPUNIT_ASSERT(glyph != 0);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), atlas.getEvictionCount());
+	CPPUNIT_ASSERT(generation != atlas.getGeneration());
+	CPPUNIT_ASSERT(glyph->uvRect.top >= 0.5);
+
+	CPPUNIT_ASSERT(atlas.findGlyph(mFontA, 0) != 0);
+	CPPUNIT_ASSERT(atlas.findGlyph(mFontA, 1) != 0);
+	CPPUNIT_ASSERT(atlas.findGlyph(mFontA, 2) == 0);
+	CPPUNIT_ASSERT(atlas.findGlyph(mFontA, 3) == 0);
+	CPPUNIT_ASSERT(atlas.findGlyph(mFontA, 4) != 0);
+	CPPUNIT_ASSERT_EQUAL(size_t(3), atlas.getGlyphCount());
+
+	// The cleared page holds only the new glyph
+	const uchar* data = atlas.getImage().getData();
+	CPPUNIT_ASSERT_EQUAL(uchar(0x40), data[(16 * 32) * 2 + 1]);
+	CPPUNIT_ASSERT_EQUAL(uchar(0x00), data[(16 * 32 + 16) * 2 + 1]);
+}
+
+void GlyphAtlasTests::testSharedBetweenFonts()
+{
+	GlyphAtlas atlas("TestAtlas", "General", 64, 32, 1);
+	const Font::GlyphInfo* a = atlas.addGlyph(mFontA, 'x', makeCell(8, 12, 0xFF));
+	CPPUNIT_ASSERT(a != 0);
+	Font::UVRect rectA = a->uvRect;
+	const Font::GlyphInfo* b = atlas.addGlyph(mFontB, 'x', makeCell(16, 24, 0xFF));
+	CPPUNIT_ASSERT(b != 0);
+	CPPUNIT_ASSERT(b->uvRect.left >= rectA.right || b->uvRect.top >= rectA.bottom);
+	CPPUNIT_ASSERT_EQUAL(size_t(2), atlas.getGlyphCount());
+
+	atlas.removeGlyphs(mFontA);
+	CPPUNIT_ASSERT(atlas.findGlyph(mFontA, 'x') == 0);
+	CPPUNIT_ASSERT(atlas.findGlyph(mFontB, 'x') != 0);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), atlas.getGlyphCount());
+}
+
+void GlyphAtlasTests::testTextAreaFollowsEviction()
+{
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+	ResourceGroupManager::getSingleton().addResourceLocation("../../../../Samples/Media/fonts", "FileSystem");
+#else
+	ResourceGroupManager::getSingleton().addResourceLocation("../../../Samples/Media/fonts", "FileSystem");
+#endif
+
+	// Two pages, each with room for a handful of glyphs
+	GlyphAtlas* atlas = mFontMgr->createGlyphAtlas("SmallAtlas", 64, 32, 2);
+	FontPtr font = mFontMgr->create("TestFont", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+	font->setType(FT_TRUETYPE);
+	font->setSource("bluehigh.ttf");
+	font->setTrueTypeSize(16);
+	font->setTrueTypeResolution(72);
+	font->setGlyphAtlas("SmallAtlas");
+	font->load();
+
+	CountingTextArea text("TestText");
+	text.initialise();
+	text.setFontName("TestFont");
+	text.setCaption("ab");
+	text._update();
+	CPPUNIT_ASSERT_EQUAL(size_t(1), text.mBuilds);
+	text._update();
+	CPPUNIT_ASSERT_EQUAL(size_t(1), text.mBuilds);
+
+	// Other text fills the atlas until the page holding the caption is cleared
+	for (Font::CodePoint cp = 'c'; atlas->getEvictionCount() == 0 && cp <= 'z'; ++cp)
+		font->getGlyphInfo(cp);
+	CPPUNIT_ASSERT(atlas->getEvictionCount() > 0);
+	CPPUNIT_ASSERT(atlas->findGlyph(font.getPointer(), 'a') == 0);
+
+	// The text area notices and renders the caption's glyphs again
+	text._update();
+	CPPUNIT_ASSERT_EQUAL(size_t(2), text.mBuilds);
+	text._update();
+	CPPUNIT_ASSERT_EQUAL(size_t(2), text.mBuilds);
+
+	// Each glyph is drawn with where it is in the atlas now
+	RenderOperation op;
+	text.getRenderOperation(op);
+	HardwareVertexBufferSharedPtr vbuf = op.vertexData->vertexBufferBinding->getBuffer(0);
+	const float* pVert = static_cast<const float*>(vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+	for (size_t i = 0; i < 2; ++i)
+	{
+		// Upper left of the first triangle is (x, y, z, u, v)
+		const Font::UVRect& uvRect = font->getGlyphTexCoords(static_cast<Font::CodePoint>('a' + i));
+		CPPUNIT_ASSERT_EQUAL(uvRect.left, pVert[i * 30 + 3]);
+		CPPUNIT_ASSERT_EQUAL(uvRect.top, pVert[i * 30 + 4]);
+	}
+	vbuf->unlock();
+}
+
+void GlyphAtlasTests::testTextAreaLargerThanAtlas()
+{
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+	ResourceGroupManager::getSingleton().addResourceLocation("../../../../Samples/Media/fonts", "FileSystem");
+#else
+	ResourceGroupManager::getSingleton().addResourceLocation("../../../Samples/Media/fonts", "FileSystem");
+#endif
+
+	GlyphAtlas* atlas = mFontMgr->createGlyphAtlas("SmallAtlas", 64, 32, 2);
+	FontPtr font = mFontMgr->create("TestFont", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+	font->setType(FT_TRUETYPE);
+	font->setSource("bluehigh.ttf");
+	font->setTrueTypeSize(16);
+	font->setTrueTypeResolution(72);
+	font->setGlyphAtlas("SmallAtlas");
+	font->load();
+
+	// The caption's glyphs evict each other while it is built
+	CountingTextArea text("TestText");
+	text.initialise();
+	text.setFontName("TestFont");
+	text.setCaption("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz");
+	text._update();
+	CPPUNIT_ASSERT_EQUAL(size_t(1), text.mBuilds);
+	size_t evictions = atlas->getEvictionCount();
+	CPPUNIT_ASSERT(evictions > 0);
+
+	// which building it again would only repeat, so it is not rebuilt every frame
+	text._update();
+	text._update();
+	CPPUNIT_ASSERT_EQUAL(size_t(1), text.mBuilds);
+	CPPUNIT_ASSERT_EQUAL(evictions, atlas->getEvictionCount());
+
+	// but still is when other glyphs move its own
+	CPPUNIT_ASSERT(atlas->addGlyph(mFontA, 0, makeCell(62, 30, 0xFF)) != 0);
+	CPPUNIT_ASSERT(atlas->getEvictionCount() > evictions);
+	text._update();
+	CPPUNIT_ASSERT_EQUAL(size_t(2), text.mBuilds);
+}
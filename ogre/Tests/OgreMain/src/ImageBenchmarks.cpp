@@ -0,0 +1,68 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ImageBenchmarks.h"
+#include "OgreTimer.h"
+#include <iostream>
+
+using namespace Ogre;
+
+// Register the suite with the benchmarks, see src/main.cpp
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( ImageBenchmarks, "Benchmarks" );
+
+void ImageBenchmarks::benchmarkScale()
+{
+    // Halve a 1024x1024 image with each filter
+    const Image::Filter filters[] = {
+        Image::FILTER_NEAREST, Image::FILTER_BILINEAR, Image::FILTER_BOX,
+        Image::FILTER_TRIANGLE, Image::FILTER_BICUBIC, Image::FILTER_LANCZOS,
+        Image::FILTER_KAISER };
+    const char* names[] = {
+        "nearest", "bilinear", "box", "triangle", "bicubic", "lanczos", "kaiser" };
+    Image src = createImage(1024, 1024, PF_BYTE_RGBA);
+    fillRandom(src);
+    Image dst = createImage(512, 512, PF_BYTE_RGBA);
+
+    std::cout << std::endl;
+    for (size_t f = 0; f < sizeof(filters) / sizeof(filters[0]); ++f)
+    {
+        Timer timer;
+        Image::scale(src.getPixelBox(), dst.getPixelBox(), filters[f]);
+        unsigned long plain = timer.getMicroseconds();
+        timer.reset();
+        Image::scale(src.getPixelBox(), dst.getPixelBox(), filters[f], true);
+        unsigned long gamma = timer.getMicroseconds();
+        std::cout << names[f] << ": " << plain / 1000.0f << "ms, gamma correct " <<
+            gamma / 1000.0f << "ms" << std::endl;
+    }
+
+    Image chain = createImage(1024, 1024, PF_BYTE_RGBA);
+    fillRandom(chain);
+    Timer timer;
+    chain.generateMipmaps();
+    std::cout << "generateMipmaps: " << timer.getMicroseconds() / 1000.0f << "ms" << std::endl;
+}
@@ -0,0 +1,205 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ImageTests.h"
+#include <cstdlib>
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ImageTests );
+
+Image ImageTests::createImage(size_t width, size_t height, PixelFormat format, size_t faces)
+{
+    Image image;
+    size_t size = Image::calculateSize(0, faces, width, height, 1, format);
+    image.loadDynamicImage(OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL),
+        width, height, 1, format, true, faces);
+    return image;
+}
+
+void ImageTests::fillRandom(const Image& image)
+{
+    srand(0);
+    uchar* data = const_cast<uchar*>(image.getData());
+    for (size_t i = 0; i < image.getSize(); ++i)
+        data[i] = (uchar)rand();
+}
+
+void ImageTests::setUp()
+{
+}
+
+void ImageTests::tearDown()
+{
+}
+
+void ImageTests::testScaleBox()
+{
+    // A 2:1 box filter averages each 2x2 block
+    uchar src[16] = {
+        0, 10, 20, 30,
+        20, 30, 40, 50,
+        100, 100, 0, 0,
+        100, 100, 255, 255 };
+    uchar dst[4];
+    Image::scale(PixelBox(4, 4, 1, PF_L8, src), PixelBox(2, 2, 1, PF_L8, dst), Image::FILTER_BOX);
+
+    CPPUNIT_ASSERT_EQUAL(15, (int)dst[0]);
+    CPPUNIT_ASSERT_EQUAL(35, (int)dst[1]);
+    CPPUNIT_ASSERT_EQUAL(100, (int)dst[2]);
+    CPPUNIT_ASSERT_EQUAL(128, (int)dst[3]);
+}
+
+void ImageTests::testScaleKeepsFlatColour()
+{
+    // Every kernel is normalised, so a flat image stays flat whatever the scale
+    const Image::Filter filters[] = {
+        Image::FILTER_BOX, Image::FILTER_TRIANGLE, Image::FILTER_BICUBIC,
+        Image::FILTER_LANCZOS, Image::FILTER_KAISER };
+    Image src = createImage(37, 23, PF_A8R8G8B8);
+    uint32* pixels = reinterpret_cast<uint32*>(src.getData());
+    for (size_t i = 0; i < 37 * 23; ++i)
+        pixels[i] = 0x80204060;
+
+    for (size_t f = 0; f < sizeof(filters) / sizeof(filters[0]); ++f)
+    {
+        Image down = createImage(10, 7, PF_A8R8G8B8);
+        Image::scale(src.getPixelBox(), down.getPixelBox(), filters[f]);
+        Image up = createImage(80, 50, PF_A8R8G8B8);
+        Image::scale(src.getPixelBox(), up.getPixelBox(), filters[f]);
+
+        const uint32* d = reinterpret_cast<const uint32*>(down.getData());
+        for (size_t i = 0; i < 10 * 7; ++i)
+            CPPUNIT_ASSERT_EQUAL((uint32)0x80204060, d[i]);
+        const uint32* u = reinterpret_cast<const uint32*>(up.getData());
+        for (size_t i = 0; i < 80 * 50; ++i)
+            CPPUNIT_ASSERT_EQUAL((uint32)0x80204060, u[i]);
+    }
+}
+
+void ImageTests::testScaleGammaCorrect()
+{
+    // Averaging black and white gives half the intensity, which is about
+    // 188 once sRGB encoded, rather than 128 when averaging encoded values
+    uchar src[8] = { 0, 0, 0, 0, 255, 255, 255, 255 };
+    uchar dst[4];
+    Image::scale(PixelBox(2, 1, 1, PF_BYTE_RGBA, src), PixelBox(1, 1, 1, PF_BYTE_RGBA, dst),
+        Image::FILTER_BOX, true);
+    CPPUNIT_ASSERT_EQUAL(188, (int)dst[0]);
+    CPPUNIT_ASSERT_EQUAL(188, (int)dst[2]);
+    // Alpha is not gamma corrected
+    CPPUNIT_ASSERT_EQUAL(128, (int)dst[3]);
+
+    Image::scale(PixelBox(2, 1, 1, PF_BYTE_RGBA, src), PixelBox(1, 1, 1, PF_BYTE_RGBA, dst),
+        Image::FILTER_BOX);
+    CPPUNIT_ASSERT_EQUAL(128, (int)dst[0]);
+}
+
+void ImageTests::testScaleBilinearBands()
+{
+    // The byte resampler runs in bands of rows, it must agree with the
+    // single threaded float resampler
+    Image src = createImage(301, 203, PF_BYTE_RGBA);
+    fillRandom(src);
+    Image srcFloat = createImage(301, 203, PF_FLOAT32_RGBA);
+    PixelUtil::bulkPixelConversion(src.getPixelBox(), srcFloat.getPixelBox());
+
+    Image dst = createImage(157, 131, PF_BYTE_RGBA);
+    Image dstFloat = createImage(157, 131, PF_FLOAT32_RGBA);
+    Image::scale(src.getPixelBox(), dst.getPixelBox(), Image::FILTER_BILINEAR);
+    Image::scale(srcFloat.getPixelBox(), dstFloat.getPixelBox(), Image::FILTER_BILINEAR);
+    Image reference = createImage(157, 131, PF_BYTE_RGBA);
+    PixelUtil::bulkPixelConversion(dstFloat.getPixelBox(), reference.getPixelBox());
+
+    for (size_t i = 0; i < dst.getSize(); ++i)
+        CPPUNIT_ASSERT(std::abs((int)dst.getData()[i] - (int)reference.getData()[i]) <= 1);
+}
+
+void ImageTests::testGenerateMipmaps()
+{
+    Image image = createImage(16, 4, PF_R8G8B8);
+    uchar* data = image.getData();
+    for (size_t i = 0; i < 16 * 4; ++i)
+    {
+        data[i * 3 + 0] = 200;
+        data[i * 3 + 1] = (i % 2)? 100 : 0;
+        data[i * 3 + 2] = 10;
+    }
+    image.generateMipmaps();
+
+    // 16x4, 8x2, 4x1, 2x1, 1x1
+    CPPUNIT_ASSERT_EQUAL((size_t)4, image.getNumMipmaps());
+    CPPUNIT_ASSERT_EQUAL(Image::calculateSize(4, 1, 16, 4, 1, PF_R8G8B8), image.getSize());
+    PixelBox level = image.getPixelBox(0, 2);
+    CPPUNIT_ASSERT_EQUAL((size_t)4, level.getWidth());
+    CPPUNIT_ASSERT_EQUAL((size_t)1, level.getHeight());
+
+    // Top level unchanged, then alternating columns average out
+    CPPUNIT_ASSERT_EQUAL(100, (int)image.getData()[4]);
+    uchar* smallest = static_cast<uchar*>(image.getPixelBox(0, 4).data);
+    CPPUNIT_ASSERT_EQUAL(200, (int)smallest[0]);
+    CPPUNIT_ASSERT_EQUAL(50, (int)smallest[1]);
+    CPPUNIT_ASSERT_EQUAL(10, (int)smallest[2]);
+}
+
+void ImageTests::testGenerateMipmapsCubeMap()
+{
+    Image image = createImage(8, 8, PF_L8, 6);
+    for (size_t face = 0; face < 6; ++face)
+    {
+        PixelBox box = image.getPixelBox(face, 0);
+        memset(box.data, (int)(face * 40), box.getConsecutiveSize());
+    }
+    image.generateMipmaps(Image::FILTER_LANCZOS);
+
+    CPPUNIT_ASSERT_EQUAL((size_t)3, image.getNumMipmaps());
+    CPPUNIT_ASSERT_EQUAL((size_t)6, image.getNumFaces());
+    for (size_t face = 0; face < 6; ++face)
+    {
+        for (size_t mip = 0; mip <= 3; ++mip)
+        {
+            PixelBox box = image.getPixelBox(face, mip);
+            CPPUNIT_ASSERT_EQUAL((size_t)(8 >> mip), box.getWidth());
+            CPPUNIT_ASSERT_EQUAL((int)(face * 40), (int)static_cast<uchar*>(box.data)[0]);
+        }
+    }
+}
+
+void ImageTests::testGenerateMipmapsDynamicBuffer()
+{
+    // The application keeps ownership of a buffer it passed without autoDelete
+    uchar buffer[4 * 4];
+    memset(buffer, 60, sizeof(buffer));
+    Image image;
+    image.loadDynamicImage(buffer, 4, 4, 1, PF_L8, false);
+    image.generateMipmaps();
+
+    CPPUNIT_ASSERT_EQUAL((size_t)2, image.getNumMipmaps());
+    CPPUNIT_ASSERT(image.getData() != buffer);
+    CPPUNIT_ASSERT_EQUAL(60, (int)static_cast<uchar*>(image.getPixelBox(0, 2).data)[0]);
+    for (size_t i = 0; i < sizeof(buffer); ++i)
+        CPPUNIT_ASSERT_EQUAL(60, (int)buffer[i]);
+}
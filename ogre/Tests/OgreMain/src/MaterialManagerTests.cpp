@@ -0,0 +1,177 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "MaterialManagerTests.h"
+#include "OgreMaterialManager.h"
+#include "OgreMaterial.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreLodStrategyManager.h"
+#include "OgreScriptCompiler.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( MaterialManagerTests );
+
+namespace
+{
+	const char* testScript =
+		"material Red\n"
+		"{\n"
+		"	technique\n"
+		"	{\n"
+		"		pass\n"
+		"		{\n"
+		"			diffuse 1 0 0\n"
+		"			lighting off\n"
+		"		}\n"
+		"	}\n"
+		"}\n"
+		"material Green\n"
+		"{\n"
+		"	technique\n"
+		"	{\n"
+		"		pass\n"
+		"		{\n"
+		"			diffuse 0 1 0\n"
+		"		}\n"
+		"	}\n"
+		"}\n";
+}
+
+void MaterialManagerTests::setUp()
+{
+	OGRE_NEW ResourceGroupManager();
+	OGRE_NEW LodStrategyManager();
+	MaterialManager* matMgr = OGRE_NEW MaterialManager();
+	matMgr->initialise();
+	OGRE_NEW ScriptCompilerManager();
+	ResourceGroupManager::getSingleton().createResourceGroup("Test");
+}
+
+void MaterialManagerTests::tearDown()
+{
+	OGRE_DELETE ScriptCompilerManager::getSingletonPtr();
+	OGRE_DELETE MaterialManager::getSingletonPtr();
+	OGRE_DELETE LodStrategyManager::getSingletonPtr();
+	OGRE_DELETE ResourceGroupManager::getSingletonPtr();
+}
+
+void MaterialManagerTests::parse(const String& script)
+{
+	DataStreamPtr stream(OGRE_NEW MemoryDataStream("test.material",
+		const_cast<char*>(script.c_str()), script.size()));
+	ScriptCompilerManager::getSingleton().parseScript(stream, "Test");
+}
+
+void MaterialManagerTests::testDeferredTranslation()
+{
+	MaterialManager& matMgr = MaterialManager::getSingleton();
+	matMgr.setDeferredTranslation(true);
+	parse(testScript);
+
+	// Known, but not created yet
+	CPPUNIT_ASSERT(matMgr.resourceExists("Red"));
+	CPPUNIT_ASSERT(matMgr.resourceExists("Green"));
+	CPPUNIT_ASSERT(matMgr.ResourceManager::getByName("Red").isNull());
+	CPPUNIT_ASSERT(matMgr.ResourceManager::getByName("Green").isNull());
+
+	// Asking for one translates only that one
+	MaterialPtr red = matMgr.getByName("Red");
+	CPPUNIT_ASSERT(!red.isNull());
+	CPPUNIT_ASSERT_EQUAL(String("Test"), red->getGroup());
+	CPPUNIT_ASSERT_EQUAL((unsigned short)1, red->getNumTechniques());
+	Pass* pass = red->getTechnique(0)->getPass(0);
+	CPPUNIT_ASSERT(pass->getDiffuse() == ColourValue::Red);
+	CPPUNIT_ASSERT(!pass->getLightingEnabled());
+	CPPUNIT_ASSERT(matMgr.ResourceManager::getByName("Green").isNull());
+
+	// Later lookups find the created material
+	CPPUNIT_ASSERT(matMgr.getByName("Red") == red);
+	CPPUNIT_ASSERT(!matMgr.getByName("Green", "Test").isNull());
+	CPPUNIT_ASSERT(matMgr.getByName("Blue").isNull());
+}
+
+void MaterialManagerTests::testImmediateTranslation()
+{
+	MaterialManager& matMgr = MaterialManager::getSingleton();
+	CPPUNIT_ASSERT(!matMgr.getDeferredTranslation());
+	parse(testScript);
+
+	CPPUNIT_ASSERT(!matMgr.ResourceManager::getByName("Red").isNull());
+	CPPUNIT_ASSERT(!matMgr.ResourceManager::getByName("Green").isNull());
+}
+
+void MaterialManagerTests::testClearGroupDropsDeferred()
+{
+	MaterialManager& matMgr = MaterialManager::getSingleton();
+	matMgr.setDeferredTranslation(true);
+	parse(testScript);
+	CPPUNIT_ASSERT(matMgr.resourceExists("Red"));
+
+	ResourceGroupManager::getSingleton().clearResourceGroup("Test");
+	CPPUNIT_ASSERT(!matMgr.resourceExists("Red"));
+	CPPUNIT_ASSERT(matMgr.getByName("Red").isNull());
+
+	// and the names can be defined again
+	parse(testScript);
+	CPPUNIT_ASSERT(!matMgr.getByName("Red").isNull());
+}
+
+void MaterialManagerTests::testUnloadAndRemoveByNameDontTranslate()
+{
+	MaterialManager& matMgr = MaterialManager::getSingleton();
+	matMgr.setDeferredTranslation(true);
+	parse(testScript);
+	// Every material created so far, the defaults only
+	size_t created = 0;
+	for (ResourceManager::ResourceMapIterator i = matMgr.getResourceIterator(); i.hasMoreElements(); i.moveNext())
+		++created;
+
+	// A deferred material has nothing to unload, and stays defined
+	matMgr.unload("Red");
+	CPPUNIT_ASSERT(matMgr.ResourceManager::getByName("Red").isNull());
+	CPPUNIT_ASSERT(matMgr.resourceExists("Red"));
+
+	// Removing one just forgets it
+	matMgr.remove("Green");
+	CPPUNIT_ASSERT(matMgr.ResourceManager::getByName("Green").isNull());
+	CPPUNIT_ASSERT(!matMgr.resourceExists("Green"));
+	CPPUNIT_ASSERT(matMgr.getByName("Green").isNull());
+
+	// Neither was translated
+	size_t after = 0;
+	for (ResourceManager::ResourceMapIterator i = matMgr.getResourceIterator(); i.hasMoreElements(); i.moveNext())
+		++after;
+	CPPUNIT_ASSERT_EQUAL(created, after);
+
+	// The other is still translated on first use, and goes as usual once created
+	CPPUNIT_ASSERT(!matMgr.getByName("Red").isNull());
+	matMgr.remove("Red");
+	CPPUNIT_ASSERT(!matMgr.resourceExists("Red"));
+}
@@ -0,0 +1,72 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "MeshSerializerBenchmarks.h"
+#include "OgreMeshManager.h"
+#include "OgreTimer.h"
+#include <iostream>
+
+using namespace Ogre;
+
+// Register the suite with the benchmarks, see src/main.cpp
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( MeshSerializerBenchmarks, "Benchmarks" );
+
+void MeshSerializerBenchmarks::benchmarkImport()
+{
+	const size_t vertexCount = 500000;
+	const size_t numLoads = 5;
+	createMesh(vertexCount);
+
+	MeshSerializer::Endian modes[2] = { MeshSerializer::ENDIAN_NATIVE,
+#if OGRE_ENDIAN == OGRE_ENDIAN_BIG
+		MeshSerializer::ENDIAN_LITTLE };
+#else
+		MeshSerializer::ENDIAN_BIG };
+#endif
+	const char* modeNames[2] = { "native", "flipped" };
+
+	std::cout << std::endl;
+	for (int m = 0; m < 2; ++m)
+	{
+		exportMesh(modes[m]);
+		for (int inMemory = 0; inMemory < 2; ++inMemory)
+		{
+			unsigned long total = 0;
+			for (size_t i = 0; i < numLoads; ++i)
+			{
+				DataStreamPtr stream = openExported(inMemory != 0);
+				Timer timer;
+				MeshPtr loaded = import(stream);
+				total += timer.getMicroseconds();
+				mMeshMgr->remove(loaded->getHandle());
+			}
+			std::cout << vertexCount << " vertices, " << modeNames[m] << " endian, " <<
+				(inMemory ? "memory" : "file") << " stream: " <<
+				total / (numLoads * 1000.0f) << "ms per load" << std::endl;
+		}
+	}
+}
@@ -0,0 +1,227 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "MeshSerializerTests.h"
+#include "Ogre.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include <cstdio>
+#include <fstream>
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( MeshSerializerTests );
+
+static const char* TEST_MESH_FILE = "MeshSerializerTest.mesh";
+
+namespace
+{
+	/// Makes the buffer flipping of Serializer callable
+	class FlippingSerializer : public Serializer
+	{
+	public:
+		using Serializer::flipEndian;
+	};
+}
+
+void MeshSerializerTests::setUp()
+{
+	LogManager::getSingleton().createLog("MeshSerializerTests.log", true);
+	OGRE_NEW ResourceGroupManager();
+	OGRE_NEW LodStrategyManager();
+	mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+	mMeshMgr = OGRE_NEW MeshManager();
+	MaterialManager* matMgr = OGRE_NEW MaterialManager();
+	matMgr->initialise();
+}
+
+void MeshSerializerTests::tearDown()
+{
+	mMesh.setNull();
+	std::remove(TEST_MESH_FILE);
+	OGRE_DELETE mMeshMgr;
+	OGRE_DELETE mBufMgr;
+	OGRE_DELETE MaterialManager::getSingletonPtr();
+	OGRE_DELETE LodStrategyManager::getSingletonPtr();
+	OGRE_DELETE ResourceGroupManager::getSingletonPtr();
+}
+
+void MeshSerializerTests::createMesh(size_t vertexCount)
+{
+	mMesh = mMeshMgr->createManual("MeshSerializerTests",
+		ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+	VertexData* vertexData = mMesh->sharedVertexData = OGRE_NEW VertexData();
+	vertexData->vertexCount = vertexCount;
+
+	// Source 0 only holds 4 byte elements, source 1 mixes shorts and bytes
+	VertexDeclaration* decl = vertexData->vertexDeclaration;
+	size_t offset = 0;
+	offset += decl->addElement(0, offset, VET_FLOAT3, VES_POSITION).getSize();
+	offset += decl->addElement(0, offset, VET_FLOAT3, VES_NORMAL).getSize();
+	offset += decl->addElement(0, offset, VET_COLOUR_ARGB, VES_DIFFUSE).getSize();
+	offset += decl->addElement(0, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES, 0).getSize();
+	offset = 0;
+	offset += decl->addElement(1, offset, VET_SHORT2, VES_TEXTURE_COORDINATES, 1).getSize();
+	offset += decl->addElement(1, offset, VET_UBYTE4, VES_BLEND_INDICES).getSize();
+
+	for (unsigned short source = 0; source < 2; ++source)
+	{
+		HardwareVertexBufferSharedPtr vbuf = mBufMgr->createVertexBuffer(
+			decl->getVertexSize(source), vertexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+		uchar* pData = static_cast<uchar*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+		for (size_t i = 0; i < vbuf->getSizeInBytes(); ++i)
+			pData[i] = static_cast<uchar>((i * 31) ^ (i >> 7) ^ source);
+		vbuf->unlock();
+		vertexData->vertexBufferBinding->setBinding(source, vbuf);
+	}
+
+	SubMesh* sub = mMesh->createSubMesh();
+	sub->useSharedVertices = true;
+	sub->setMaterialName("BaseWhite");
+	sub->indexData->indexCount = vertexCount * 3;
+	sub->indexData->indexBuffer = mBufMgr->createIndexBuffer(HardwareIndexBuffer::IT_32BIT,
+		sub->indexData->indexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+	uint32* pIdx = static_cast<uint32*>(
+		sub->indexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+	for (size_t i = 0; i < sub->indexData->indexCount; ++i)
+		pIdx[i] = static_cast<uint32>((i * 7919) % vertexCount);
+	sub->indexData->indexBuffer->unlock();
+
+	mMesh->_setBounds(AxisAlignedBox(-1, -1, -1, 1, 1, 1));
+	mMesh->_setBoundingSphereRadius(Math::Sqrt(3));
+}
+
+void MeshSerializerTests::exportMesh(MeshSerializer::Endian endianMode)
+{
+	MeshSerializer serializer;
+	serializer.exportMesh(mMesh.get(), TEST_MESH_FILE, endianMode);
+}
+
+DataStreamPtr MeshSerializerTests::openExported(bool inMemory)
+{
+	std::ifstream* file = OGRE_NEW_T(std::ifstream, MEMCATEGORY_GENERAL)();
+	file->open(TEST_MESH_FILE, std::ios::in | std::ios::binary);
+	CPPUNIT_ASSERT(!file->fail());
+	DataStreamPtr stream(OGRE_NEW FileStreamDataStream(TEST_MESH_FILE, file, true));
+	if (inMemory)
+		stream = DataStreamPtr(OGRE_NEW MemoryDataStream(TEST_MESH_FILE, stream));
+	return stream;
+}
+
+MeshPtr MeshSerializerTests::import(DataStreamPtr& stream)
+{
+	MeshPtr loaded = mMeshMgr->createManual("MeshSerializerTestsLoaded",
+		ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+	MeshSerializer serializer;
+	serializer.importMesh(stream, loaded.get());
+	return loaded;
+}
+
+void MeshSerializerTests::checkEqual(const MeshPtr& loaded)
+{
+	const VertexBufferBinding* expected = mMesh->sharedVertexData->vertexBufferBinding;
+	const VertexBufferBinding* actual = loaded->sharedVertexData->vertexBufferBinding;
+	CPPUNIT_ASSERT_EQUAL(mMesh->sharedVertexData->vertexCount, loaded->sharedVertexData->vertexCount);
+	CPPUNIT_ASSERT_EQUAL(expected->getBufferCount(), actual->getBufferCount());
+
+	vector<HardwareBuffer*>::type expectedBuffers, actualBuffers;
+	for (unsigned short source = 0; source < expected->getBufferCount(); ++source)
+	{
+		expectedBuffers.push_back(expected->getBuffer(source).get());
+		actualBuffers.push_back(actual->getBuffer(source).get());
+	}
+	expectedBuffers.push_back(mMesh->getSubMesh(0)->indexData->indexBuffer.get());
+	actualBuffers.push_back(loaded->getSubMesh(0)->indexData->indexBuffer.get());
+
+	for (size_t i = 0; i < expectedBuffers.size(); ++i)
+	{
+		size_t size = expectedBuffers[i]->getSizeInBytes();
+		CPPUNIT_ASSERT_EQUAL(size, actualBuffers[i]->getSizeInBytes());
+		const void* pExpected = expectedBuffers[i]->lock(HardwareBuffer::HBL_READ_ONLY);
+		const void* pActual = actualBuffers[i]->lock(HardwareBuffer::HBL_READ_ONLY);
+		bool same = memcmp(pExpected, pActual, size) == 0;
+		expectedBuffers[i]->unlock();
+		actualBuffers[i]->unlock();
+		CPPUNIT_ASSERT(same);
+	}
+}
+
+void MeshSerializerTests::testImportFromFile()
+{
+	createMesh(1000);
+	exportMesh(MeshSerializer::ENDIAN_NATIVE);
+	DataStreamPtr stream = openExported(false);
+	checkEqual(import(stream));
+}
+
+void MeshSerializerTests::testImportInPlace()
+{
+	createMesh(1000);
+	exportMesh(MeshSerializer::ENDIAN_NATIVE);
+	DataStreamPtr stream = openExported(true);
+	CPPUNIT_ASSERT(stream->getDataPtr() != 0);
+	checkEqual(import(stream));
+}
+
+void MeshSerializerTests::testImportFlippedEndian()
+{
+	createMesh(1000);
+#if OGRE_ENDIAN == OGRE_ENDIAN_BIG
+	exportMesh(MeshSerializer::ENDIAN_LITTLE);
+#else
+	exportMesh(MeshSerializer::ENDIAN_BIG);
+#endif
+	DataStreamPtr stream = openExported(true);
+	checkEqual(import(stream));
+}
+
+void MeshSerializerTests::testFlipEndianWords()
+{
+	// Every word size in use, for counts around the 16 byte steps of SIMD
+	// versions and at an offset that leaves the words unaligned
+	FlippingSerializer serializer;
+	const size_t sizes[] = { 2, 4, 8, 3 };
+	uchar data[8 * 40 + 1], expected[8 * 40 + 1];
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+	{
+		size_t size = sizes[s];
+		for (size_t offset = 0; offset < 2; ++offset)
+		{
+			for (size_t count = 0; count <= 40; ++count)
+			{
+				for (size_t i = 0; i < sizeof(data); ++i)
+					data[i] = expected[i] = static_cast<uchar>(i * 7 + 1);
+				for (size_t w = 0; w < count; ++w)
+					for (size_t b = 0; b < size; ++b)
+						expected[offset + w * size + b] = data[offset + w * size + size - 1 - b];
+
+				serializer.flipEndian(data + offset, size, count);
+				CPPUNIT_ASSERT(memcmp(data, expected, sizeof(data)) == 0);
+			}
+		}
+	}
+}
@@ -0,0 +1,199 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "PackArchiveTests.h"
+#include "OgrePackArchive.h"
+#include "OgreFileSystem.h"
+
+using namespace Ogre;
+
+// Regsiter the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( PackArchiveTests );
+
+namespace
+{
+    const size_t bigFileSize = 200000;
+
+    MemoryDataStream* createBigFile(void)
+    {
+        // Mildly compressible data spanning several chunks
+        MemoryDataStream* stream = new MemoryDataStream("big.bin", bigFileSize);
+        uchar* p = stream->getPtr();
+        for (size_t i = 0; i < bigFileSize; ++i)
+            p[i] = static_cast<uchar>((i * 7) ^ (i >> 9));
+        return stream;
+    }
+}
+
+void PackArchiveTests::setUp()
+{
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+    testPath = "../../../../Tests/OgreMain/misc/ArchiveTest/";
+#else
+    testPath = "../../../Tests/OgreMain/misc/ArchiveTest/";
+#endif
+    packPath = "PackArchiveTest.pack";
+
+    FileSystemArchive src(testPath, "FileSystem");
+    src.load();
+
+    PackArchiveWriter writer;
+    writer.setChunkSize(4096);
+    writer.addArchive(&src);
+    writer.addFile("data/big.bin", DataStreamPtr(createBigFile()));
+    writer.addFile("data/stored.bin", DataStreamPtr(createBigFile()), false);
+
+    std::fstream* f = OGRE_NEW_T(std::fstream, MEMCATEGORY_GENERAL)();
+    f->open(packPath.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+    DataStreamPtr out(OGRE_NEW FileStreamDataStream(packPath, f, true));
+    writer.write(out);
+    out->close();
+}
+void PackArchiveTests::tearDown()
+{
+    remove(packPath.c_str());
+}
+
+void PackArchiveTests::testListRecursive()
+{
+    PackArchive arch(packPath, "Pack");
+    arch.load();
+    StringVectorPtr vec = arch.list(true);
+
+    CPPUNIT_ASSERT_EQUAL((size_t)8, vec->size());
+    CPPUNIT_ASSERT_EQUAL(String("data/big.bin"), vec->at(0));
+    CPPUNIT_ASSERT_EQUAL(String("data/stored.bin"), vec->at(1));
+    CPPUNIT_ASSERT_EQUAL(String("level1/materials/scripts/file.material"), vec->at(2));
+    CPPUNIT_ASSERT_EQUAL(String("level1/materials/scripts/file2.material"), vec->at(3));
+    CPPUNIT_ASSERT_EQUAL(String("level2/materials/scripts/file3.material"), vec->at(4));
+    CPPUNIT_ASSERT_EQUAL(String("level2/materials/scripts/file4.material"), vec->at(5));
+    CPPUNIT_ASSERT_EQUAL(String("rootfile.txt"), vec->at(6));
+    CPPUNIT_ASSERT_EQUAL(String("rootfile2.txt"), vec->at(7));
+
+    vec = arch.list(false, true);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, vec->size());
+    CPPUNIT_ASSERT_EQUAL(String("data"), vec->at(0));
+    CPPUNIT_ASSERT_EQUAL(String("level1"), vec->at(1));
+    CPPUNIT_ASSERT_EQUAL(String("level2"), vec->at(2));
+}
+void PackArchiveTests::testListFileInfoNonRecursive()
+{
+    PackArchive arch(packPath, "Pack");
+    arch.load();
+    FileInfoListPtr vec = arch.listFileInfo(false);
+
+    CPPUNIT_ASSERT_EQUAL((size_t)2, vec->size());
+    FileInfo& fi1 = vec->at(0);
+    CPPUNIT_ASSERT_EQUAL(String("rootfile.txt"), fi1.filename);
+    CPPUNIT_ASSERT_EQUAL(String("rootfile.txt"), fi1.basename);
+    CPPUNIT_ASSERT_EQUAL(StringUtil::BLANK, fi1.path);
+    CPPUNIT_ASSERT_EQUAL((size_t)130, fi1.uncompressedSize);
+
+    FileInfo& fi2 = vec->at(1);
+    CPPUNIT_ASSERT_EQUAL(String("rootfile2.txt"), fi2.filename);
+    CPPUNIT_ASSERT_EQUAL((size_t)156, fi2.uncompressedSize);
+}
+void PackArchiveTests::testFindRecursive()
+{
+    PackArchive arch(packPath, "Pack");
+    arch.load();
+    StringVectorPtr vec = arch.find("*.material", true);
+
+    CPPUNIT_ASSERT_EQUAL((size_t)4, vec->size());
+    CPPUNIT_ASSERT_EQUAL(String("level1/materials/scripts/file.material"), vec->at(0));
+    CPPUNIT_ASSERT_EQUAL(String("level2/materials/scripts/file4.material"), vec->at(3));
+}
+void PackArchiveTests::testExists()
+{
+    PackArchive arch(packPath, "Pack");
+    arch.load();
+
+    CPPUNIT_ASSERT(arch.exists("rootfile.txt"));
+    CPPUNIT_ASSERT(arch.exists("ROOTFILE.TXT"));
+    CPPUNIT_ASSERT(arch.exists("level1\\materials\\scripts\\file.material"));
+    CPPUNIT_ASSERT(!arch.exists("rootfile3.txt"));
+    CPPUNIT_ASSERT(!arch.exists("level1/materials/file.material"));
+}
+void PackArchiveTests::testFileRead()
+{
+    PackArchive arch(packPath, "Pack");
+    arch.load();
+
+    DataStreamPtr stream = arch.open("rootfile.txt");
+    CPPUNIT_ASSERT_EQUAL(String("this is line 1 in file 1"), stream->getLine());
+    CPPUNIT_ASSERT_EQUAL(String("this is line 2 in file 1"), stream->getLine());
+    CPPUNIT_ASSERT_EQUAL(String("this is line 3 in file 1"), stream->getLine());
+    CPPUNIT_ASSERT_EQUAL(String("this is line 4 in file 1"), stream->getLine());
+    CPPUNIT_ASSERT_EQUAL(String("this is line 5 in file 1"), stream->getLine());
+    CPPUNIT_ASSERT(stream->eof());
+}
+void PackArchiveTests::testChunkedRandomAccess()
+{
+    PackArchive arch(packPath, "Pack");
+    arch.load();
+
+    DataStreamPtr expected(createBigFile());
+    const uchar* ref = expected->getDataPtr();
+
+    DataStreamPtr stream = arch.open("data/big.bin");
+    CPPUNIT_ASSERT_EQUAL(bigFileSize, stream->size());
+    // Compressed entries can't be used in place
+    CPPUNIT_ASSERT(stream->getDataPtr() == 0);
+
+    // Backwards seeks land in the right chunk without re-reading the file
+    uchar buf[100];
+    const size_t offsets[] = { 150000, 10, 4090, 199950, 8192, 0 };
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i)
+    {
+        stream->seek(offsets[i]);
+        size_t cnt = stream->read(buf, sizeof(buf));
+        CPPUNIT_ASSERT_EQUAL(std::min(sizeof(buf), bigFileSize - offsets[i]), cnt);
+        CPPUNIT_ASSERT(memcmp(buf, ref + offsets[i], cnt) == 0);
+    }
+
+    // Reads spanning many whole chunks
+    stream->seek(0);
+    MemoryDataStream all(stream);
+    CPPUNIT_ASSERT_EQUAL(bigFileSize, all.size());
+    CPPUNIT_ASSERT(memcmp(all.getPtr(), ref, bigFileSize) == 0);
+
+    stream->seek(5000);
+    vector<uchar>::type part(100000);
+    CPPUNIT_ASSERT_EQUAL(part.size(), stream->read(&part[0], part.size()));
+    CPPUNIT_ASSERT(memcmp(&part[0], ref + 5000, part.size()) == 0);
+}
+void PackArchiveTests::testStoredInPlace()
+{
+    PackArchive arch(packPath, "Pack");
+    arch.load();
+
+    DataStreamPtr expected(createBigFile());
+    DataStreamPtr stream = arch.open("data/stored.bin");
+    CPPUNIT_ASSERT_EQUAL(bigFileSize, stream->size());
+    CPPUNIT_ASSERT(stream->getDataPtr() != 0);
+    CPPUNIT_ASSERT(memcmp(stream->getDataPtr(), expected->getDataPtr(), bigFileSize) == 0);
+}
@@ -0,0 +1,117 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "PackedParticleDataBenchmarks.h"
+#include "OgrePackedParticleData.h"
+#include "OgreParticle.h"
+#include "OgreTimer.h"
+#include "OgreMath.h"
+#include <iostream>
+
+using namespace Ogre;
+
+// Register the suite with the benchmarks, see src/main.cpp
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( PackedParticleDataBenchmarks, "Benchmarks" );
+
+void PackedParticleDataBenchmarks::benchmarkUpdate()
+{
+	// Compares a typical update (expire, linear force, motion, re-emission)
+	// of 100k particles with list based and packed storage
+	const size_t numParticles = 100000;
+	const size_t numFrames = 30;
+	const Real frameTime = 1.0f / 60.0f;
+	const Vector3 force(0, -9.8f * frameTime, 0);
+
+	// List based, as ParticleSystem stores particles by default
+	vector<Particle*>::type pool;
+	list<Particle*>::type active, freeList;
+	for (size_t i = 0; i < numParticles; ++i)
+	{
+		pool.push_back(OGRE_NEW Particle());
+		freeList.push_back(pool.back());
+	}
+
+	Timer timer;
+	for (size_t f = 0; f < numFrames; ++f)
+	{
+		list<Particle*>::type::iterator i;
+		for (i = active.begin(); i != active.end(); )
+		{
+			if ((*i)->timeToLive < frameTime)
+				freeList.splice(freeList.end(), active, i++);
+			else
+			{
+				(*i)->timeToLive -= frameTime;
+				++i;
+			}
+		}
+		for (i = active.begin(); i != active.end(); ++i)
+			(*i)->direction += force;
+		for (i = active.begin(); i != active.end(); ++i)
+			(*i)->position += (*i)->direction * frameTime;
+		while (!freeList.empty())
+		{
+			Particle* p = freeList.front();
+			active.splice(active.end(), freeList, freeList.begin());
+			p->position = Vector3::ZERO;
+			p->direction = Vector3::UNIT_Y;
+			p->timeToLive = p->totalTimeToLive = Math::RangeRandom(0.1f, 0.5f);
+		}
+	}
+	unsigned long listTime = timer.getMicroseconds();
+
+	for (size_t i = 0; i < numParticles; ++i)
+		OGRE_DELETE pool[i];
+
+	// Packed
+	PackedParticleData data;
+	data.setCapacity(numParticles);
+
+	timer.reset();
+	for (size_t f = 0; f < numFrames; ++f)
+	{
+		data.expire(frameTime);
+		data.addToStream(data.directionX, force.x);
+		data.addToStream(data.directionY, force.y);
+		data.addToStream(data.directionZ, force.z);
+		data.applyMotion(frameTime);
+		size_t first = data.size();
+		size_t count = data.allocate(data.getFreeCount());
+		for (size_t i = first; i < first + count; ++i)
+		{
+			data.setPosition(i, Vector3::ZERO);
+			data.setDirection(i, Vector3::UNIT_Y);
+			data.timeToLive[i] = data.totalTimeToLive[i] = Math::RangeRandom(0.1f, 0.5f);
+		}
+	}
+	unsigned long packedTime = timer.getMicroseconds();
+
+	std::cout << std::endl << numParticles << " particles, " << numFrames << " frames: list "
+		<< listTime / 1000.0f << "ms, packed " << packedTime / 1000.0f << "ms" << std::endl;
+
+	CPPUNIT_ASSERT_EQUAL(numParticles, data.size());
+}
@@ -0,0 +1,149 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "PackedParticleDataTests.h"
+#include "OgrePackedParticleData.h"
+#include "OgreMath.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( PackedParticleDataTests );
+
+void PackedParticleDataTests::setUp()
+{
+	srand(0);
+}
+void PackedParticleDataTests::tearDown()
+{
+}
+
+void PackedParticleDataTests::testAllocate()
+{
+	PackedParticleData data;
+	data.setCapacity(10);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)6, data.allocate(6));
+	CPPUNIT_ASSERT_EQUAL((size_t)4, data.allocate(6));
+	CPPUNIT_ASSERT_EQUAL((size_t)10, data.size());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, data.getFreeCount());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, data.allocate(1));
+
+	// Arrays must be aligned for SIMD processing
+	CPPUNIT_ASSERT_EQUAL((size_t)0, (size_t)data.positionX % 16);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, (size_t)data.timeToLive % 16);
+}
+
+void PackedParticleDataTests::testExpire()
+{
+	PackedParticleData data;
+	data.setCapacity(8);
+	data.allocate(5);
+	float ttl[5] = { 1.0f, 0.1f, 2.0f, 0.05f, 3.0f };
+	for (size_t i = 0; i < 5; ++i)
+	{
+		data.timeToLive[i] = ttl[i];
+		data.positionX[i] = ttl[i];
+	}
+
+	CPPUNIT_ASSERT_EQUAL((size_t)2, data.expire(0.2f));
+	CPPUNIT_ASSERT_EQUAL((size_t)3, data.size());
+
+	// Survivors keep their own data and have had their life reduced
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		CPPUNIT_ASSERT(data.positionX[i] >= 1.0f);
+		CPPUNIT_ASSERT(Math::RealEqual(data.timeToLive[i], data.positionX[i] - 0.2f, 1e-5f));
+	}
+}
+
+void PackedParticleDataTests::testReorder()
+{
+	PackedParticleData data;
+	data.setCapacity(4);
+	data.allocate(4);
+	for (size_t i = 0; i < 4; ++i)
+	{
+		data.setPosition(i, Vector3((Real)i, 0, 0));
+		data.ownDimensions[i] = (uint8)i;
+	}
+
+	uint32 order[4] = { 3, 1, 0, 2 };
+	data.reorder(order);
+	for (size_t i = 0; i < 4; ++i)
+	{
+		CPPUNIT_ASSERT_EQUAL((Real)order[i], data.getPosition(i).x);
+		CPPUNIT_ASSERT_EQUAL((uint8)order[i], data.ownDimensions[i]);
+	}
+}
+
+void PackedParticleDataTests::testCapacityPreservesParticles()
+{
+	PackedParticleData data;
+	data.setCapacity(3);
+	data.allocate(3);
+	for (size_t i = 0; i < 3; ++i)
+		data.setColour(i, ColourValue((Real)i, 1, 1, 1));
+
+	data.setCapacity(100);
+	CPPUNIT_ASSERT_EQUAL((size_t)3, data.size());
+	for (size_t i = 0; i < 3; ++i)
+		CPPUNIT_ASSERT_EQUAL((Real)i, data.getColour(i).r);
+
+	data.setCapacity(2);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, data.size());
+}
+
+void PackedParticleDataTests::testStreamOperations()
+{
+	// Use a size which is not a multiple of 4
+	PackedParticleData data;
+	data.setCapacity(7);
+	data.allocate(7);
+	for (size_t i = 0; i < 7; ++i)
+	{
+		data.colourR[i] = i * 0.25f;
+		data.rotation[i] = 1.0f;
+		data.rotationSpeed[i] = (float)i;
+		data.directionX[i] = (float)i;
+	}
+
+	data.addClampStream(data.colourR, 0.5f, 0.0f, 1.0f);
+	data.addScaledStream(data.rotation, data.rotationSpeed, 0.5f);
+	data.scaleAddStream(data.directionX, 0.5f, 1.0f);
+	for (size_t i = 0; i < 7; ++i)
+	{
+		CPPUNIT_ASSERT_EQUAL(std::min(i * 0.25f + 0.5f, 1.0f), data.colourR[i]);
+		CPPUNIT_ASSERT_EQUAL(1.0f + i * 0.5f, data.rotation[i]);
+		CPPUNIT_ASSERT_EQUAL(i * 0.5f + 1.0f, data.directionX[i]);
+	}
+
+	data.addToStream(data.colourR, -2.0f);
+	data.addClampStream(data.colourR, 0.0f, 0.0f, 1.0f);
+	for (size_t i = 0; i < 7; ++i)
+		CPPUNIT_ASSERT_EQUAL(0.0f, data.colourR[i]);
+}
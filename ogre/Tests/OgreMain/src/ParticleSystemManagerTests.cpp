@@ -0,0 +1,180 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ParticleSystemManagerTests.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreParticleSystem.h"
+#include "OgreParticleSystemManager.h"
+#include "OgreParticleEmitter.h"
+#include "OgreParticleEmitterFactory.h"
+#include "OgreParticle.h"
+#include "OgreMaterialManager.h"
+#include "OgreControllerManager.h"
+#include "OgreWorkQueue.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ParticleSystemManagerTests );
+
+namespace
+{
+	/// Emitter without any randomness, so that updates can be compared
+	class TestEmitter : public ParticleEmitter
+	{
+	public:
+		TestEmitter(ParticleSystem* psys) : ParticleEmitter(psys) { mType = "Test"; }
+
+		unsigned short _getEmissionCount(Real timeElapsed)
+		{
+			return genConstantEmissionCount(timeElapsed);
+		}
+
+		void _initParticle(Particle* pParticle)
+		{
+			ParticleEmitter::_initParticle(pParticle);
+			pParticle->position = mPosition;
+			genEmissionDirection(pParticle->direction);
+			genEmissionVelocity(pParticle->direction);
+			pParticle->timeToLive = pParticle->totalTimeToLive = genEmissionTTL();
+			genEmissionColour(pParticle->colour);
+		}
+	};
+
+	class TestEmitterFactory : public ParticleEmitterFactory
+	{
+	public:
+		String getName() const { return "Test"; }
+
+		ParticleEmitter* createEmitter(ParticleSystem* psys)
+		{
+			ParticleEmitter* emitter = OGRE_NEW TestEmitter(psys);
+			mEmitters.push_back(emitter);
+			return emitter;
+		}
+	};
+
+	const size_t NUM_SYSTEMS = 12;
+}
+
+void ParticleSystemManagerTests::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "ParticleSystemManagerTests.log");
+	mRoot->getWorkQueue()->startup();
+	// Normally created by Root::initialise, which needs a render system
+	mControllerMgr = OGRE_NEW ControllerManager();
+	mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+
+	ParticleSystemManager::getSingleton()._initialise();
+	mEmitterFactory = OGRE_NEW TestEmitterFactory();
+	ParticleSystemManager::getSingleton().addEmitterFactory(mEmitterFactory);
+	// A material without techniques, which can be loaded without a render system
+	MaterialManager::getSingleton().create("BaseWhite", 
+		ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+}
+
+void ParticleSystemManagerTests::tearDown()
+{
+	// The particle systems use the controller manager until they're destroyed
+	mRoot->destroySceneManager(mSceneMgr);
+	OGRE_DELETE mControllerMgr;
+	OGRE_DELETE mRoot;
+	OGRE_DELETE mEmitterFactory;
+}
+
+ParticleSystem* ParticleSystemManagerTests::createSystem(size_t index)
+{
+	ParticleSystem* sys = mSceneMgr->createParticleSystem(40 + index * 15);
+	sys->setUsePackedStorage(index % 2 == 0);
+	if (index % 3 == 0)
+		sys->setIterationInterval(0.02f);
+
+	// Systems with different numbers of emitters update side by side
+	for (size_t e = 0; e <= index % 3; ++e)
+	{
+		ParticleEmitter* emitter = sys->addEmitter("Test");
+		emitter->setEmissionRate(60.0f + index * 25.0f + e * 10.0f);
+		emitter->setPosition(Vector3((Real)e, (Real)index, 0));
+		emitter->setDirection(Vector3((Real)e, 1, (Real)index).normalisedCopy());
+		emitter->setParticleVelocity(1.0f + index * 0.5f);
+		emitter->setTimeToLive(0.25f + index * 0.05f);
+		emitter->setColour(ColourValue(e * 0.5f, 1, index / (Real)NUM_SYSTEMS));
+	}
+
+	SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+		Vector3(index * 10.0f, 0, 0), Quaternion(Degree(index * 30.0f), Vector3::UNIT_Y));
+	node->attachObject(sys);
+	return sys;
+}
+
+void ParticleSystemManagerTests::testParallelMatchesSerial()
+{
+	ParticleSystemManager& mgr = ParticleSystemManager::getSingleton();
+	mgr.setUseWorkerThreads(true);
+
+	ParticleSystem* serial[NUM_SYSTEMS];
+	ParticleSystem* parallel[NUM_SYSTEMS];
+	for (size_t i = 0; i < NUM_SYSTEMS; ++i)
+	{
+		serial[i] = createSystem(i);
+		parallel[i] = createSystem(i);
+	}
+
+	for (size_t frame = 0; frame < 40; ++frame)
+	{
+		Real timeElapsed = 0.01f + (frame % 4) * 0.01f;
+		for (size_t i = 0; i < NUM_SYSTEMS; ++i)
+		{
+			serial[i]->_update(timeElapsed);
+			mgr._queueUpdate(parallel[i], timeElapsed);
+		}
+		mgr._processQueuedUpdates();
+
+		for (size_t i = 0; i < NUM_SYSTEMS; ++i)
+		{
+			size_t numParticles = serial[i]->getNumParticles();
+			CPPUNIT_ASSERT_EQUAL(numParticles, parallel[i]->getNumParticles());
+			for (size_t p = 0; p < numParticles; ++p)
+			{
+				// getParticle may hand out the same copy for packed storage
+				Particle expected = *serial[i]->getParticle(p);
+				Particle* actual = parallel[i]->getParticle(p);
+				CPPUNIT_ASSERT(expected.position == actual->position);
+				CPPUNIT_ASSERT(expected.direction == actual->direction);
+				CPPUNIT_ASSERT(expected.colour == actual->colour);
+				CPPUNIT_ASSERT_EQUAL(expected.timeToLive, actual->timeToLive);
+			}
+			CPPUNIT_ASSERT(serial[i]->getBoundingBox() == parallel[i]->getBoundingBox());
+		}
+	}
+
+	// Every system has particles to compare by the end
+	for (size_t i = 0; i < NUM_SYSTEMS; ++i)
+		CPPUNIT_ASSERT(parallel[i]->getNumParticles() > 0);
+}
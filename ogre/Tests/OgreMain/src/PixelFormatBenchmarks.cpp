@@ -0,0 +1,74 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "PixelFormatBenchmarks.h"
+#include "OgreTimer.h"
+#include <iostream>
+#include <vector>
+
+using namespace Ogre;
+
+// Register the suite with the benchmarks, see src/main.cpp
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( PixelFormatBenchmarks, "Benchmarks" );
+
+void PixelFormatBenchmarks::benchmarkBulkConversion()
+{
+    // Conversion matrix, time per megapixel against the per pixel conversion
+    const size_t width = 1024, height = 256;
+    const size_t maxPixelSize = 16;
+    std::vector<uint8> srcData(width * height * maxPixelSize), dstData(width * height * maxPixelSize);
+    PixelFormat formats[] = {
+        PF_L8, PF_A8, PF_BYTE_LA, PF_R5G6B5, PF_A4R4G4B4, PF_R8G8B8, PF_A8R8G8B8,
+        PF_A8B8G8R8, PF_FLOAT16_RGB, PF_FLOAT16_RGBA, PF_FLOAT32_RGB, PF_FLOAT32_RGBA,
+        PF_SHORT_RGBA
+    };
+    const size_t numFormats = sizeof(formats) / sizeof(formats[0]);
+
+    std::cout << std::endl << "ms per megapixel, bulk / per pixel" << std::endl;
+    for(size_t i=0; i<numFormats; i++)
+    {
+        PixelBox srcBox(width, height, 1, formats[i], &srcData[0]);
+        fillColours(srcBox);
+        std::cout << PixelUtil::getFormatName(formats[i]) << " ->" << std::endl;
+        for(size_t j=0; j<numFormats; j++)
+        {
+            if(i == j)
+                continue;
+            PixelBox dstBox(width, height, 1, formats[j], &dstData[0]);
+            Timer timer;
+            PixelUtil::bulkPixelConversion(srcBox, dstBox);
+            const unsigned long bulk = timer.getMicroseconds();
+            timer.reset();
+            naiveBulkPixelConversion(srcBox, dstBox);
+            const unsigned long naive = timer.getMicroseconds();
+
+            const float megapixels = (width * height) / 1000000.0f;
+            std::cout << "    " << PixelUtil::getFormatName(formats[j]) << ": " <<
+                bulk / (1000.0f * megapixels) << " / " << naive / (1000.0f * megapixels) << std::endl;
+        }
+    }
+}
@@ -227,3 +227,84 @@ void PixelFormatTests::testBulkConversion()
     //CPPUNIT_ASSERT_MESSAGE("Conversion mismatch", false);
 }
 
+namespace
+{
+    // Formats with a row conversion, in both directions
+    const PixelFormat rowFormats[] = {
+        PF_L8, PF_L16, PF_A8, PF_A4L4, PF_BYTE_LA,
+        PF_R5G6B5, PF_B5G6R5, PF_A4R4G4B4, PF_A1R5G5B5,
+        PF_R8G8B8, PF_B8G8R8, PF_A8R8G8B8, PF_A8B8G8R8, PF_B8G8R8A8, PF_R8G8B8A8,
+        PF_A2R10G10B10, PF_A2B10G10R10,
+        PF_FLOAT16_R, PF_FLOAT16_GR, PF_FLOAT16_RGB, PF_FLOAT16_RGBA,
+        PF_FLOAT32_R, PF_FLOAT32_GR, PF_FLOAT32_RGB, PF_FLOAT32_RGBA,
+        PF_SHORT_RGB, PF_SHORT_RGBA
+    };
+    const size_t numRowFormats = sizeof(rowFormats) / sizeof(rowFormats[0]);
+}
+
+void PixelFormatTests::fillColours(const PixelBox &box)
+{
+    // Random colours in [0,1], so that float formats hold no NaNs
+    const size_t pixelSize = PixelUtil::getNumElemBytes(box.format);
+    srand(0);
+    for(size_t z=box.front; z<box.back; z++)
+        for(size_t y=box.top; y<box.bottom; y++)
+            for(size_t x=box.left; x<box.right; x++)
+            {
+                uint8 *pixel = static_cast<uint8*>(box.data) +
+                    (x + y * box.rowPitch + z * box.slicePitch) * pixelSize;
+                PixelUtil::packColour(rand() / (float)RAND_MAX, rand() / (float)RAND_MAX,
+                    rand() / (float)RAND_MAX, rand() / (float)RAND_MAX, box.format, pixel);
+            }
+}
+
+void PixelFormatTests::testRowConversion()
+{
+    // Every pair must match the per pixel conversion exactly
+    for(size_t i=0; i<numRowFormats; i++)
+    {
+        setupBoxes(rowFormats[i], PF_L8);
+        fillColours(src);
+        for(size_t j=0; j<numRowFormats; j++)
+        {
+            if(i != j)
+                testCase(rowFormats[i], rowFormats[j]);
+        }
+    }
+}
+
+void PixelFormatTests::testParallelConversion()
+{
+    // Large enough to be split into bands, with padding at the end of each row
+    const size_t width = 600, height = 500, depth = 2, pitch = 640;
+    PixelFormat formats[][2] = {
+        {PF_A8R8G8B8, PF_FLOAT16_RGBA},
+        {PF_FLOAT32_RGB, PF_R5G6B5},
+        {PF_R8G8B8, PF_A8B8G8R8}
+    };
+    for(size_t f=0; f<sizeof(formats)/sizeof(formats[0]); f++)
+    {
+        const PixelFormat srcFormat = formats[f][0], dstFormat = formats[f][1];
+        const size_t srcSize = pitch * height * depth * PixelUtil::getNumElemBytes(srcFormat);
+        const size_t dstSize = pitch * height * depth * PixelUtil::getNumElemBytes(dstFormat);
+        std::vector<uint8> srcData(srcSize), dstData(dstSize, 0), refData(dstSize, 0);
+
+        PixelBox srcBox(width, height, depth, srcFormat, &srcData[0]);
+        srcBox.rowPitch = pitch;
+        srcBox.slicePitch = pitch * height;
+        PixelBox dstBox(width, height, depth, dstFormat, &dstData[0]);
+        dstBox.rowPitch = pitch;
+        dstBox.slicePitch = pitch * height;
+        PixelBox refBox = dstBox;
+        refBox.data = &refData[0];
+
+        fillColours(srcBox);
+        PixelUtil::bulkPixelConversion(srcBox, dstBox);
+        naiveBulkPixelConversion(srcBox, refBox);
+
+        StringUtil::StrStreamType msg;
+        msg << "Conversion mismatch [" << PixelUtil::getFormatName(srcFormat) <<
+            "->" << PixelUtil::getFormatName(dstFormat) << "]";
+        CPPUNIT_ASSERT_MESSAGE(msg.str().c_str(), dstData == refData);
+    }
+}
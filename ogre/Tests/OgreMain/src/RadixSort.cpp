@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 #include "RadixSortTests.h"
 #include "OgreRadixSort.h"
+#include "OgreIncrementalSort.h"
 #include "OgreMath.h"
 
 using namespace Ogre;
@@ -200,5 +201,52 @@ void RadixSortTests::testIntVector()
 		lastValue = *v;
 	}
 }
+void RadixSortTests::testIncrementalNearlySorted()
+{
+	IncrementalSort<int> sorter;
+
+	// Sorted, with a few items out of place as after a frame of movement
+	sorter.begin(1000);
+	for (int i = 0; i < 1000; ++i)
+	{
+		float key = (float)i;
+		if (i % 100 == 0)
+			key += 3.5f;
+		sorter.add(i, key);
+	}
+
+	CPPUNIT_ASSERT(sorter.sort());
+	CPPUNIT_ASSERT(!sorter.getLastSortFellBack());
+	for (size_t i = 1; i < sorter.size(); ++i)
+	{
+		int prev = sorter.getItem(i - 1), cur = sorter.getItem(i);
+		float prevKey = (float)prev + (prev % 100 == 0 ? 3.5f : 0.0f);
+		float curKey = (float)cur + (cur % 100 == 0 ? 3.5f : 0.0f);
+		CPPUNIT_ASSERT(curKey >= prevKey);
+	}
+
+	// Sorting again finds nothing to do
+	sorter.begin(1000);
+	for (int i = 0; i < 1000; ++i)
+		sorter.add(i, (float)i);
+	CPPUNIT_ASSERT(!sorter.sort());
+}
+void RadixSortTests::testIncrementalFallback()
+{
+	IncrementalSort<int> sorter;
+	std::vector<float> keys;
 
+	sorter.begin(1000);
+	for (int i = 0; i < 1000; ++i)
+	{
+		keys.push_back((float)Math::RangeRandom(-1e10, 1e10));
+		sorter.add(i, keys.back());
+	}
 
+	CPPUNIT_ASSERT(sorter.sort());
+	CPPUNIT_ASSERT(sorter.getLastSortFellBack());
+	for (size_t i = 1; i < sorter.size(); ++i)
+	{
+		CPPUNIT_ASSERT(keys[sorter.getItem(i)] >= keys[sorter.getItem(i - 1)]);
+	}
+}
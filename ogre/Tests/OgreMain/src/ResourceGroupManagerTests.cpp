@@ -0,0 +1,298 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ResourceGroupManagerTests.h"
+#include "OgreArchiveManager.h"
+#include "OgreLogManager.h"
+#include "OgreLodStrategyManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreScriptCompiler.h"
+#include <fstream>
+#include <ctime>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+#  include <sys/utime.h>
+#else
+#  include <utime.h>
+#endif
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ResourceGroupManagerTests );
+
+namespace
+{
+	/// Does nothing, but its presence makes the group's scripts parse one by one
+	class PassThroughLoadingListener : public ResourceLoadingListener
+	{
+	public:
+		DataStreamPtr resourceLoading(const String&, const String&, Resource*) { return DataStreamPtr(); }
+		void resourceStreamOpened(const String&, const String&, Resource*, DataStreamPtr&) {}
+		bool resourceCollision(Resource*, ResourceManager*) { return false; }
+	};
+
+	/// Collects the errors the script compiler logs
+	class CompilerErrorListener : public LogListener
+	{
+	public:
+		void messageLogged(const String& message, LogMessageLevel, bool, const String&)
+		{
+			if (StringUtil::startsWith(message, "Compiler error", false))
+				errors.insert(message);
+		}
+
+		std::set<String> errors;
+	};
+}
+
+void ResourceGroupManagerTests::setUp()
+{
+	mDir = new TemporaryDirectory();
+	mCacheFile = mDir->getPath() + "/locations.cache";
+	mDir->createDirectory("data");
+	mDir->createDirectory("data/sub");
+	writeFile("data/a.txt", "a");
+	writeFile("data/sub/b.txt", "bb");
+	// Modification times are in whole seconds, so those of the directories 
+	// are moved back for changes made during the test to show
+	mModifiedTime = time(0) - 100;
+	setModifiedTime("data");
+	setModifiedTime("data/sub");
+
+	mArchiveMgr = OGRE_NEW ArchiveManager();
+	mFileSystemFactory = OGRE_NEW FileSystemArchiveFactory();
+	mArchiveMgr->addArchiveFactory(mFileSystemFactory);
+	OGRE_NEW ResourceGroupManager();
+}
+
+void ResourceGroupManagerTests::tearDown()
+{
+	OGRE_DELETE ResourceGroupManager::getSingletonPtr();
+	OGRE_DELETE mArchiveMgr;
+	OGRE_DELETE mFileSystemFactory;
+	delete mDir;
+}
+
+void ResourceGroupManagerTests::writeFile(const String& name, const String& contents)
+{
+	std::ofstream out((mDir->getPath() + "/" + name).c_str(), std::ios::out | std::ios::binary);
+	out << contents;
+}
+
+void ResourceGroupManagerTests::setModifiedTime(const String& name)
+{
+	struct utimbuf times;
+	times.actime = times.modtime = mModifiedTime;
+	utime((mDir->getPath() + "/" + name).c_str(), &times);
+}
+
+time_t ResourceGroupManagerTests::getModifiedTime(const String& name)
+{
+	struct stat tagStat;
+	CPPUNIT_ASSERT_EQUAL(0, stat((mDir->getPath() + "/" + name).c_str(), &tagStat));
+	return tagStat.st_mtime;
+}
+
+void ResourceGroupManagerTests::restart(bool useCache)
+{
+	// As a new run would, which loads the archives again too
+	OGRE_DELETE ResourceGroupManager::getSingletonPtr();
+	OGRE_DELETE mArchiveMgr;
+	mArchiveMgr = OGRE_NEW ArchiveManager();
+	mArchiveMgr->addArchiveFactory(mFileSystemFactory);
+	OGRE_NEW ResourceGroupManager();
+	if (useCache)
+		ResourceGroupManager::getSingleton().setResourceLocationCache(mCacheFile);
+	ResourceGroupManager::getSingleton().addResourceLocation(mDir->getPath() + "/data", "FileSystem", 
+		ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+}
+
+size_t ResourceGroupManagerTests::getListedSize(const String& pattern)
+{
+	FileInfoListPtr files = ResourceGroupManager::getSingleton().findResourceFileInfo(
+		ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, pattern);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), files->size());
+	return files->front().uncompressedSize;
+}
+
+void ResourceGroupManagerTests::testLocationCacheReused()
+{
+	restart();
+#if OGRE_PLATFORM != OGRE_PLATFORM_WIN32
+	// Adding the location mustn't change what the cache is validated by
+	CPPUNIT_ASSERT_EQUAL(mModifiedTime, getModifiedTime("data"));
+#endif
+	CPPUNIT_ASSERT_EQUAL(size_t(1), getListedSize("a.txt"));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), getListedSize("b.txt"));
+	ResourceGroupManager::getSingleton().saveResourceLocationCache();
+	CPPUNIT_ASSERT(std::ifstream(mCacheFile.c_str()).good());
+
+	// Rewriting a file in place leaves its directory as it was, so the cached
+	// listing is used, sizes and all
+	writeFile("data/a.txt", "aaaa");
+	restart();
+	CPPUNIT_ASSERT_EQUAL(size_t(1), getListedSize("a.txt"));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), getListedSize("b.txt"));
+
+	// Which is not the case without the cache
+	restart(false);
+	CPPUNIT_ASSERT_EQUAL(size_t(4), getListedSize("a.txt"));
+}
+
+void ResourceGroupManagerTests::testLocationChangeRescans()
+{
+	restart();
+	ResourceGroupManager::getSingleton().saveResourceLocationCache();
+
+	writeFile("data/c.txt", "ccc");
+	restart();
+	CPPUNIT_ASSERT_EQUAL(size_t(3), getListedSize("c.txt"));
+	CPPUNIT_ASSERT_EQUAL(size_t(1), getListedSize("a.txt"));
+}
+
+void ResourceGroupManagerTests::testSubDirectoryChangeRescans()
+{
+	restart();
+	ResourceGroupManager::getSingleton().saveResourceLocationCache();
+
+	writeFile("data/sub/c.txt", "ccc");
+	restart();
+	CPPUNIT_ASSERT_EQUAL(size_t(3), getListedSize("c.txt"));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), getListedSize("b.txt"));
+}
+
+void ResourceGroupManagerTests::testInvalidLocationCacheReplaced()
+{
+	writeFile("locations.cache", "not a location cache");
+	restart();
+	CPPUNIT_ASSERT_EQUAL(size_t(1), getListedSize("a.txt"));
+	ResourceGroupManager::getSingleton().saveResourceLocationCache();
+
+	// The listing written in its place is used
+	writeFile("data/a.txt", "aaaa");
+	restart();
+	CPPUNIT_ASSERT_EQUAL(size_t(1), getListedSize("a.txt"));
+}
+
+String ResourceGroupManagerTests::parseScripts(bool serial)
+{
+	restart(false);
+	ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+	PassThroughLoadingListener loadingListener;
+	if (serial)
+		rgm.setLoadingListener(&loadingListener);
+	OGRE_NEW LodStrategyManager();
+	MaterialManager* matMgr = OGRE_NEW MaterialManager();
+	matMgr->initialise();
+	OGRE_NEW ScriptCompilerManager();
+
+	CompilerErrorListener errorListener;
+	Log* log = LogManager::getSingleton().getDefaultLog();
+	log->addListener(&errorListener);
+	rgm.initialiseResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+	log->removeListener(&errorListener);
+
+	StringUtil::StrStreamType str;
+	const char* names[] = { "Red", "Blue", "Broken", "Green" };
+	for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+	{
+		MaterialPtr mat = matMgr->getByName(names[i]);
+		str << names[i] << ":";
+		if (!mat.isNull() && mat->getNumTechniques())
+		{
+			Pass* pass = mat->getTechnique(0)->getPass(0);
+			str << " " << pass->getDiffuse() << " " << pass->getLightingEnabled();
+		}
+		str << "\n";
+	}
+	for (std::set<String>::iterator i = errorListener.errors.begin(); i != errorListener.errors.end(); ++i)
+		str << *i << "\n";
+
+	OGRE_DELETE ScriptCompilerManager::getSingletonPtr();
+	OGRE_DELETE matMgr;
+	OGRE_DELETE LodStrategyManager::getSingletonPtr();
+	rgm.setLoadingListener(0);
+	return str.str();
+}
+
+void ResourceGroupManagerTests::testPreparedScriptsMatchSerial()
+{
+	writeFile("data/red.material",
+		"material Red\n"
+		"{\n"
+		"	technique\n"
+		"	{\n"
+		"		pass\n"
+		"		{\n"
+		"			diffuse 1 0 0\n"
+		"			lighting off\n"
+		"		}\n"
+		"	}\n"
+		"}\n");
+	writeFile("data/sub/blue.material",
+		"import Red from \"red.material\"\n"
+		"material Blue : Red\n"
+		"{\n"
+		"	technique\n"
+		"	{\n"
+		"		pass\n"
+		"		{\n"
+		"			diffuse 0 0 1\n"
+		"		}\n"
+		"	}\n"
+		"}\n");
+	writeFile("data/broken.material",
+		"material Broken\n"
+		"{\n"
+		"	technique\n"
+		"	{\n"
+		"		pass\n"
+		"		{\n"
+		"			diffuse 1 1 0\n"
+		"			no_such_property on\n"
+		"		}\n"
+		"	}\n"
+		"}\n"
+		"material Green : Missing\n"
+		"{\n"
+		"}\n");
+
+	String serial = parseScripts(true);
+	String prepared = parseScripts(false);
+	CPPUNIT_ASSERT_EQUAL(serial, prepared);
+
+	// Both did the work, errors included
+	CPPUNIT_ASSERT(prepared.find("Red: ColourValue(1, 0, 0, 1) 0") != String::npos);
+	CPPUNIT_ASSERT(prepared.find("Blue: ColourValue(0, 0, 1, 1) 0") != String::npos);
+	CPPUNIT_ASSERT(prepared.find("Broken: ColourValue(1, 1, 0, 1) 1") != String::npos);
+	CPPUNIT_ASSERT(prepared.find("no_such_property") != String::npos);
+	CPPUNIT_ASSERT(prepared.find("Missing") != String::npos);
+}
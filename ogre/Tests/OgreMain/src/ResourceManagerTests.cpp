@@ -0,0 +1,203 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ResourceManagerTests.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ResourceManagerTests );
+
+namespace
+{
+    const size_t RESOURCE_SIZE = 100;
+
+    /// Resource which occupies a fixed size while loaded
+    class SizedResource : public Resource
+    {
+    public:
+        SizedResource(ResourceManager* creator, const String& name, ResourceHandle handle,
+            const String& group)
+            : Resource(creator, name, handle, group) {}
+        ~SizedResource() { unload(); }
+    protected:
+        void loadImpl(void) { mSize = RESOURCE_SIZE; }
+        void unloadImpl(void) {}
+        size_t calculateSize(void) const { return RESOURCE_SIZE; }
+    };
+
+    class SizedResourceManager : public ResourceManager
+    {
+    public:
+        SizedResourceManager() : mTouches(0)
+        {
+            mResourceType = "SizedResource";
+            // Keep evictions synchronous so they can be checked immediately
+            mBackgroundEviction = false;
+        }
+        ~SizedResourceManager() { removeAll(); }
+
+        /// Overridden as code written before residency tracking would
+        void _notifyResourceTouched(Resource*) { ++mTouches; }
+
+        size_t mTouches;
+    protected:
+        Resource* createImpl(const String& name, ResourceHandle handle, 
+            const String& group, bool isManual, ManualResourceLoader* loader, 
+            const NameValuePairList* createParams)
+        {
+            return OGRE_NEW SizedResource(this, name, handle, group);
+        }
+    };
+}
+
+void ResourceManagerTests::setUp()
+{
+    LogManager::getSingleton().createLog("ResourceManagerTests.log", true);
+    OGRE_NEW ResourceGroupManager();
+    mManager = OGRE_NEW SizedResourceManager();
+}
+
+void ResourceManagerTests::tearDown()
+{
+    OGRE_DELETE mManager;
+    OGRE_DELETE ResourceGroupManager::getSingletonPtr();
+}
+
+void ResourceManagerTests::createResources(size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        String name = "res" + StringConverter::toString(i);
+        mManager->create(name, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+        touchInNewFrame(name);
+    }
+}
+
+void ResourceManagerTests::touchInNewFrame(const String& name)
+{
+    mManager->getByName(name)->touch();
+    mManager->_updateResidency();
+}
+
+void ResourceManagerTests::testEvictLeastRecentlyUsed()
+{
+    createResources(4);
+    // Make res0 the most recently used
+    touchInNewFrame("res0");
+    CPPUNIT_ASSERT_EQUAL(4 * RESOURCE_SIZE, mManager->getMemoryUsage());
+
+    mManager->setMemoryBudget(3 * RESOURCE_SIZE);
+
+    CPPUNIT_ASSERT_EQUAL(3 * RESOURCE_SIZE, mManager->getMemoryUsage());
+    CPPUNIT_ASSERT(mManager->getByName("res0")->isLoaded());
+    CPPUNIT_ASSERT(!mManager->getByName("res1")->isLoaded());
+    CPPUNIT_ASSERT(mManager->getByName("res2")->isLoaded());
+    CPPUNIT_ASSERT(mManager->getByName("res3")->isLoaded());
+
+    // Touching res1 reloads it and evicts the next oldest at the end of the frame
+    touchInNewFrame("res1");
+    CPPUNIT_ASSERT(mManager->getByName("res1")->isLoaded());
+    CPPUNIT_ASSERT(!mManager->getByName("res2")->isLoaded());
+    CPPUNIT_ASSERT_EQUAL(3 * RESOURCE_SIZE, mManager->getMemoryUsage());
+}
+
+void ResourceManagerTests::testEvictToLowWatermark()
+{
+    createResources(4);
+    mManager->setMemoryLowWatermark(2 * RESOURCE_SIZE);
+    mManager->setMemoryBudget(3 * RESOURCE_SIZE);
+
+    CPPUNIT_ASSERT_EQUAL(2 * RESOURCE_SIZE, mManager->getMemoryUsage());
+    CPPUNIT_ASSERT(!mManager->getByName("res0")->isLoaded());
+    CPPUNIT_ASSERT(!mManager->getByName("res1")->isLoaded());
+
+    // Back under budget, so nothing more is evicted
+    touchInNewFrame("res0");
+    CPPUNIT_ASSERT_EQUAL(3 * RESOURCE_SIZE, mManager->getMemoryUsage());
+    CPPUNIT_ASSERT(mManager->getByName("res2")->isLoaded());
+}
+
+void ResourceManagerTests::testReferencedNotEvicted()
+{
+    createResources(4);
+    ResourcePtr held = mManager->getByName("res0");
+
+    mManager->setMemoryBudget(3 * RESOURCE_SIZE);
+
+    CPPUNIT_ASSERT(held->isLoaded());
+    CPPUNIT_ASSERT(!mManager->getByName("res1")->isLoaded());
+}
+
+void ResourceManagerTests::testTouchNotifiesManager()
+{
+    createResources(2);
+    SizedResourceManager* manager = static_cast<SizedResourceManager*>(mManager);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, manager->mTouches);
+
+    // Overriding the touch hook doesn't stop the resource being stamped
+    ResourcePtr res = mManager->getByName("res0");
+    res->touch();
+    CPPUNIT_ASSERT_EQUAL((size_t)3, manager->mTouches);
+    CPPUNIT_ASSERT_EQUAL(mManager->_getCurrentFrame(), res->getLastUsedFrame());
+    CPPUNIT_ASSERT(mManager->getByName("res1")->getLastUsedFrame() < res->getLastUsedFrame());
+}
+
+void ResourceManagerTests::testResidencyStats()
+{
+    createResources(4);
+    // Each resource was loaded by its first touch, which is not a hit
+    CPPUNIT_ASSERT_EQUAL((size_t)0, mManager->getResidencyStats().hits);
+
+    touchInNewFrame("res3");
+    mManager->setMemoryBudget(3 * RESOURCE_SIZE);
+    touchInNewFrame("res0");
+    touchInNewFrame("res0");
+
+    ResourceManager::ResidencyStats stats = mManager->getResidencyStats();
+    CPPUNIT_ASSERT_EQUAL((size_t)2, stats.hits);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, stats.evictions);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, stats.reloads);
+
+    // Reloading an evicted resource before touching it is no hit either
+    mManager->setMemoryBudget(2 * RESOURCE_SIZE);
+    ResourcePtr res = mManager->getByName("res2");
+    CPPUNIT_ASSERT(!res->isLoaded());
+    res->load();
+    res->touch();
+    stats = mManager->getResidencyStats();
+    CPPUNIT_ASSERT_EQUAL((size_t)2, stats.hits);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, stats.reloads);
+    res->touch();
+    CPPUNIT_ASSERT_EQUAL((size_t)3, mManager->getResidencyStats().hits);
+
+    mManager->resetResidencyStats();
+    stats = mManager->getResidencyStats();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.hits);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.evictions);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.reloads);
+}
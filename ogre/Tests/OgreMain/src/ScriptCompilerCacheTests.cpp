@@ -0,0 +1,217 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ScriptCompilerCacheTests.h"
+#include "OgreFileSystem.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ScriptCompilerCacheTests );
+
+namespace
+{
+	/** Cache location counting reads and writes. A prepared tree is only
+		written on a miss, after parsing, so a read without a write is a hit.
+	*/
+	class CountingArchive : public FileSystemArchive
+	{
+	public:
+		CountingArchive(const String& name)
+			: FileSystemArchive(name, "FileSystem"), mOpens(0), mCreates(0) {}
+
+		DataStreamPtr open(const String& filename, bool readOnly = true) const
+		{
+			++mOpens;
+			return FileSystemArchive::open(filename, readOnly);
+		}
+
+		DataStreamPtr create(const String& filename) const
+		{
+			++mCreates;
+			return FileSystemArchive::create(filename);
+		}
+
+		mutable size_t mOpens;
+		mutable size_t mCreates;
+	};
+
+	/// The values of the first property called name in a dumped tree, as "name value..."
+	String getProperty(const String& dump, const String& name)
+	{
+		size_t start = dump.find(name + "#");
+		if (start == String::npos)
+			return StringUtil::BLANK;
+		size_t end = dump.find("}", start);
+		String result = name;
+		// Each value is dumped as "type file:line value#id;"
+		for (size_t i = dump.find("{", start); ; )
+		{
+			size_t valueEnd = dump.find("#", i);
+			if (valueEnd > end)
+				break;
+			size_t valueStart = dump.rfind(" ", valueEnd) + 1;
+			result += " " + dump.substr(valueStart, valueEnd - valueStart);
+			i = dump.find(";", valueEnd);
+		}
+		return result;
+	}
+}
+
+void ScriptCompilerCacheTests::setUp()
+{
+	mDir = new TemporaryDirectory();
+	mCache = OGRE_NEW CountingArchive(mDir->getPath());
+	mCache->load();
+
+	mSources["base.material"] =
+		"abstract material Base\n"
+		"{\n"
+		"	set $colour \"1 0 0\"\n"
+		"	technique\n"
+		"	{\n"
+		"		pass\n"
+		"		{\n"
+		"			diffuse $colour 1\n"
+		"			lighting off\n"
+		"		}\n"
+		"	}\n"
+		"}\n";
+	mSources["derived.material"] =
+		"import Base from \"base.material\"\n"
+		"material Derived : Base\n"
+		"{\n"
+		"	set $colour \"0 1 0\"\n"
+		"	technique\n"
+		"	{\n"
+		"		pass\n"
+		"		{\n"
+		"			depth_write off\n"
+		"		}\n"
+		"	}\n"
+		"}\n";
+}
+
+void ScriptCompilerCacheTests::tearDown()
+{
+	mCache->unload();
+	OGRE_DELETE mCache;
+	delete mDir;
+}
+
+void ScriptCompilerCacheTests::dump(const AbstractNodeList& nodes, StringUtil::StrStreamType& str)
+{
+	str << "{";
+	for (AbstractNodeList::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
+	{
+		const AbstractNode* node = i->get();
+		str << node->type << " " << node->file << ":" << node->line << " ";
+		switch (node->type)
+		{
+		case ANT_ATOM:
+			str << static_cast<const AtomAbstractNode*>(node)->value << "#" <<
+				static_cast<const AtomAbstractNode*>(node)->id;
+			break;
+		case ANT_PROPERTY:
+			str << static_cast<const PropertyAbstractNode*>(node)->name << "#" <<
+				static_cast<const PropertyAbstractNode*>(node)->id;
+			dump(static_cast<const PropertyAbstractNode*>(node)->values, str);
+			break;
+		case ANT_OBJECT:
+			{
+				const ObjectAbstractNode* obj = static_cast<const ObjectAbstractNode*>(node);
+				str << obj->cls << " " << obj->name << "#" << obj->id << (obj->abstract ? " abstract" : "");
+				dump(obj->values, str);
+				dump(obj->children, str);
+			}
+			break;
+		default:
+			break;
+		}
+		str << ";";
+	}
+	str << "}";
+}
+
+String ScriptCompilerCacheTests::prepare(const String& name, bool useCache)
+{
+	ScriptCompiler compiler;
+	if (useCache)
+		compiler.setCache(mCache);
+	ScriptCompiler::ErrorList errors;
+	AbstractNodeListPtr nodes = compiler._prepare(mSources[name], name, mSources, errors);
+	CPPUNIT_ASSERT(!nodes.isNull());
+	CPPUNIT_ASSERT(errors.empty());
+
+	StringUtil::StrStreamType str;
+	dump(*nodes, str);
+	return str.str();
+}
+
+void ScriptCompilerCacheTests::testCachedTreeMatches()
+{
+	String expected = prepare("derived.material", false);
+	CPPUNIT_ASSERT(mCache->find("*.scriptcache", false)->empty());
+
+	// The first run writes the cache, the second reads it without parsing
+	CountingArchive* cache = static_cast<CountingArchive*>(mCache);
+	CPPUNIT_ASSERT_EQUAL(expected, prepare("derived.material", true));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, mCache->find("*.scriptcache", false)->size());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache->mOpens);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, cache->mCreates);
+
+	CPPUNIT_ASSERT_EQUAL(expected, prepare("derived.material", true));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, cache->mOpens);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, cache->mCreates);
+}
+
+void ScriptCompilerCacheTests::testImportChangeInvalidates()
+{
+	String stale = prepare("derived.material", true);
+	CPPUNIT_ASSERT_EQUAL(String("lighting off"), getProperty(stale, "lighting"));
+
+	mSources["base.material"] = StringUtil::replaceAll(mSources["base.material"], "lighting off", "lighting on");
+	String expected = prepare("derived.material", false);
+	CPPUNIT_ASSERT_EQUAL(String("lighting on"), getProperty(expected, "lighting"));
+	String cached = prepare("derived.material", true);
+	CPPUNIT_ASSERT_EQUAL(expected, cached);
+	CPPUNIT_ASSERT_EQUAL(String("lighting on"), getProperty(cached, "lighting"));
+	// The stale tree was not used, and was replaced
+	CPPUNIT_ASSERT(cached != stale);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, static_cast<CountingArchive*>(mCache)->mCreates);
+}
+
+void ScriptCompilerCacheTests::testScriptChangeInvalidates()
+{
+	prepare("derived.material", true);
+
+	mSources["derived.material"] = StringUtil::replaceAll(mSources["derived.material"], "depth_write off", "depth_check off");
+	String expected = prepare("derived.material", false);
+	CPPUNIT_ASSERT(expected.find("depth_check") != String::npos);
+	CPPUNIT_ASSERT_EQUAL(expected, prepare("derived.material", true));
+	CPPUNIT_ASSERT_EQUAL((size_t)2, static_cast<CountingArchive*>(mCache)->mCreates);
+}
@@ -0,0 +1,199 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "SkeletonAnimationCacheTests.h"
+#include "OgreSkeletonAnimationCache.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreSkeletonManager.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreAnimation.h"
+#include "OgreAnimationTrack.h"
+#include "OgreKeyFrame.h"
+#include "OgreBone.h"
+#include "OgreLogManager.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( SkeletonAnimationCacheTests );
+
+namespace
+{
+	const size_t NUM_BONES = 3;
+}
+
+void SkeletonAnimationCacheTests::setUp()
+{
+	LogManager::getSingleton().createLog("SkeletonAnimationCacheTests.log", true);
+	OGRE_NEW ResourceGroupManager();
+	mSkelMgr = OGRE_NEW SkeletonManager();
+
+	// An arm, a forearm swinging in "walk" and a hand turning in "wave"
+	mSkel = mSkelMgr->create("arm.skeleton", 
+		ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+	Bone* root = mSkel->createBone("root");
+	Bone* forearm = root->createChild(1, Vector3(0, 1, 0));
+	Bone* hand = forearm->createChild(2, Vector3(0, 1, 0));
+	mSkel->setBindingPose();
+
+	Animation* walk = mSkel->createAnimation("walk", 1.0f);
+	NodeAnimationTrack* track = walk->createNodeTrack(forearm->getHandle(), forearm);
+	track->createNodeKeyFrame(0.0f)->setRotation(Quaternion::IDENTITY);
+	track->createNodeKeyFrame(1.0f)->setRotation(Quaternion(Degree(90), Vector3::UNIT_Z));
+	Animation* wave = mSkel->createAnimation("wave", 1.0f);
+	track = wave->createNodeTrack(hand->getHandle(), hand);
+	track->createNodeKeyFrame(0.0f)->setTranslate(Vector3::ZERO);
+	TransformKeyFrame* key = track->createNodeKeyFrame(1.0f);
+	key->setTranslate(Vector3(0.5f, 0, 0));
+	key->setRotation(Quaternion(Degree(60), Vector3::UNIT_X));
+}
+
+void SkeletonAnimationCacheTests::tearDown()
+{
+	mSkel.setNull();
+	OGRE_DELETE mSkelMgr;
+	OGRE_DELETE ResourceGroupManager::getSingletonPtr();
+}
+
+void SkeletonAnimationCacheTests::pose(AnimationStateSet& animSet, const String& anim, 
+	Real time, Real weight)
+{
+	AnimationState* state = animSet.getAnimationState(anim);
+	state->setEnabled(true);
+	state->setTimePosition(time);
+	state->setWeight(weight);
+}
+
+void SkeletonAnimationCacheTests::evaluate(SkeletonInstance& inst, 
+	const AnimationStateSet& animSet, Matrix4* matrices)
+{
+	inst.setAnimationState(animSet);
+	inst._getBoneMatrices(matrices);
+}
+
+void SkeletonAnimationCacheTests::testCachedMatchesUncached()
+{
+	SkeletonInstance first(mSkel), second(mSkel);
+	first.load();
+	second.load();
+	CPPUNIT_ASSERT_EQUAL(NUM_BONES, (size_t)first.getNumBones());
+
+	SkeletonAnimationCache cache;
+	AnimationStateSet firstSet, secondSet;
+	mSkel->_initAnimationState(&firstSet);
+	mSkel->_initAnimationState(&secondSet);
+	const Real times[] = { 0.2f, 0.7f };
+	Matrix4 computed[NUM_BONES], cached[NUM_BONES], other[NUM_BONES];
+
+	for (size_t i = 0; i < 2; ++i)
+	{
+		// The first entity computes and stores the palette
+		pose(firstSet, "walk", times[i], 0.75f);
+		pose(firstSet, "wave", times[i] * 0.5f, 0.5f);
+		CPPUNIT_ASSERT(!cache._fetchBoneMatrices(&first, firstSet, cached));
+		evaluate(first, firstSet, computed);
+		cache._storeBoneMatrices(&first, firstSet, computed);
+
+		// The second one in the same pose finds exactly what it would compute
+		pose(secondSet, "walk", times[i], 0.75f);
+		pose(secondSet, "wave", times[i] * 0.5f, 0.5f);
+		CPPUNIT_ASSERT(cache._fetchBoneMatrices(&second, secondSet, cached));
+		evaluate(second, secondSet, other);
+		for (size_t b = 0; b < NUM_BONES; ++b)
+			CPPUNIT_ASSERT(cached[b] == other[b]);
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)2, cache.getNumEntries());
+	CPPUNIT_ASSERT_EQUAL((size_t)2, cache.getHitCount());
+
+	// The poses differ, so the palettes can't have been mixed up
+	pose(secondSet, "walk", times[0], 0.75f);
+	pose(secondSet, "wave", times[0] * 0.5f, 0.5f);
+	CPPUNIT_ASSERT(cache._fetchBoneMatrices(&second, secondSet, cached));
+	CPPUNIT_ASSERT(!(cached[1] == other[1]));
+}
+
+void SkeletonAnimationCacheTests::testTimeChangeMisses()
+{
+	SkeletonInstance inst(mSkel);
+	inst.load();
+	SkeletonAnimationCache cache(16, 0.1f);
+	AnimationStateSet animSet;
+	mSkel->_initAnimationState(&animSet);
+	Matrix4 matrices[NUM_BONES];
+
+	pose(animSet, "walk", 0.3f);
+	evaluate(inst, animSet, matrices);
+	cache._storeBoneMatrices(&inst, animSet, matrices);
+
+	// Within the time quantum the palette is shared
+	pose(animSet, "walk", 0.32f);
+	CPPUNIT_ASSERT(cache._fetchBoneMatrices(&inst, animSet, matrices));
+	// A step further on it has to be computed again
+	pose(animSet, "walk", 0.4f);
+	CPPUNIT_ASSERT(!cache._fetchBoneMatrices(&inst, animSet, matrices));
+	// So does the same time in another animation, or with another one added
+	animSet.getAnimationState("walk")->setEnabled(false);
+	pose(animSet, "wave", 0.3f);
+	CPPUNIT_ASSERT(!cache._fetchBoneMatrices(&inst, animSet, matrices));
+	pose(animSet, "walk", 0.3f);
+	CPPUNIT_ASSERT(!cache._fetchBoneMatrices(&inst, animSet, matrices));
+
+	// Changing the quantum drops every palette
+	animSet.getAnimationState("wave")->setEnabled(false);
+	CPPUNIT_ASSERT(cache._fetchBoneMatrices(&inst, animSet, matrices));
+	cache.setTimeQuantum(0.05f);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getNumEntries());
+	CPPUNIT_ASSERT(!cache._fetchBoneMatrices(&inst, animSet, matrices));
+}
+
+void SkeletonAnimationCacheTests::testWeightChangeMisses()
+{
+	SkeletonInstance inst(mSkel);
+	inst.load();
+	SkeletonAnimationCache cache(16, 0.1f, 0.25f);
+	AnimationStateSet animSet;
+	mSkel->_initAnimationState(&animSet);
+	Matrix4 matrices[NUM_BONES];
+
+	pose(animSet, "walk", 0.5f, 0.5f);
+	pose(animSet, "wave", 0.5f, 0.5f);
+	evaluate(inst, animSet, matrices);
+	cache._storeBoneMatrices(&inst, animSet, matrices);
+
+	pose(animSet, "wave", 0.5f, 0.55f);
+	CPPUNIT_ASSERT(cache._fetchBoneMatrices(&inst, animSet, matrices));
+	pose(animSet, "wave", 0.5f, 0.75f);
+	CPPUNIT_ASSERT(!cache._fetchBoneMatrices(&inst, animSet, matrices));
+	pose(animSet, "wave", 0.5f, 0.5f);
+	pose(animSet, "walk", 0.5f, 1.0f);
+	CPPUNIT_ASSERT(!cache._fetchBoneMatrices(&inst, animSet, matrices));
+
+	cache.setWeightQuantum(0.1f);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getNumEntries());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, cache.getHitCount());
+	CPPUNIT_ASSERT_EQUAL((size_t)2, cache.getMissCount());
+}
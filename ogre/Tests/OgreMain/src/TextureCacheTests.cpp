@@ -0,0 +1,392 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "TextureCacheTests.h"
+#include "MemoryTextureManager.h"
+#include "OgreArchiveManager.h"
+#include "OgreDDSCodec.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( TextureCacheTests );
+
+namespace
+{
+	/// Decodes DDS files with their own extension, counting how many it decodes
+	class CountingCodec : public ImageCodec
+	{
+	public:
+		CountingCodec() : mDecodes(0), mDecodesInto(0) {}
+		DataStreamPtr code(MemoryDataStreamPtr& input, CodecDataPtr& pData) const
+		{ return mDDS.code(input, pData); }
+		void codeToFile(MemoryDataStreamPtr& input, const String& outFileName, CodecDataPtr& pData) const
+		{ mDDS.codeToFile(input, outFileName, pData); }
+		DecodeResult decode(DataStreamPtr& input) const
+		{ ++mDecodes; return mDDS.decode(input); }
+		CodecDataPtr decodeHeader(DataStreamPtr& input) const
+		{ return mDDS.decodeHeader(input); }
+		CodecDataPtr decodeInto(DataStreamPtr& input, DecodeTarget& target) const
+		{ ++mDecodesInto; return ImageCodec::decodeInto(input, target); }
+		String getType() const { return "cachetest"; }
+		String magicNumberToFileExt(const char *magicNumberPtr, size_t maxbytes) const
+		{ return StringUtil::BLANK; }
+
+		mutable size_t mDecodes;
+		mutable size_t mDecodesInto;
+	private:
+		DDSCodec mDDS;
+	};
+}
+
+void TextureCacheTests::setUp()
+{
+	mDir = new TemporaryDirectory();
+	mDir->createDirectory("cache");
+	mDir->createDirectory("sources");
+	mCache = OGRE_NEW FileSystemArchive(mDir->getPath() + "/cache", "FileSystem");
+	mCache->load();
+	mSources = OGRE_NEW FileSystemArchive(mDir->getPath() + "/sources", "FileSystem");
+	mSources->load();
+	mCodec = OGRE_NEW CountingCodec();
+	Codec::registerCodec(mCodec);
+
+	OGRE_NEW ResourceGroupManager();
+	mArchiveMgr = OGRE_NEW ArchiveManager();
+	mFileSystemFactory = OGRE_NEW FileSystemArchiveFactory();
+	mArchiveMgr->addArchiveFactory(mFileSystemFactory);
+	ResourceGroupManager::getSingleton().addResourceLocation(mSources->getName(), "FileSystem");
+	mManager = OGRE_NEW MemoryTextureManager();
+	mManager->setTranscodeCache(mCache);
+}
+
+void TextureCacheTests::tearDown()
+{
+	OGRE_DELETE mManager;
+	OGRE_DELETE ResourceGroupManager::getSingletonPtr();
+	OGRE_DELETE mArchiveMgr;
+	OGRE_DELETE mFileSystemFactory;
+	Codec::unRegisterCodec(mCodec);
+	OGRE_DELETE mCodec;
+	mSources->unload();
+	OGRE_DELETE mSources;
+	mCache->unload();
+	OGRE_DELETE mCache;
+	delete mDir;
+}
+
+void TextureCacheTests::writeSource(const String& name, size_t width, size_t height, uint8 seed)
+{
+	size_t dataSize = PixelUtil::getMemorySize(width, height, 1, PF_A8R8G8B8);
+	std::vector<uchar> file(128 + dataSize);
+	uint32* header = reinterpret_cast<uint32*>(&file[0]);
+	header[0] = 0x20534444; // 'DDS '
+	header[1] = 124; // header size
+	header[2] = 0x00001007; // caps, height, width, pixel format
+	header[3] = static_cast<uint32>(height);
+	header[4] = static_cast<uint32>(width);
+	header[19] = 32; // pixel format size
+	header[20] = 0x41; // RGB with alpha
+	header[22] = 32;
+	header[23] = 0x00ff0000;
+	header[24] = 0x0000ff00;
+	header[25] = 0x000000ff;
+	header[26] = 0xff000000;
+	header[27] = 0x00001000; // texture
+	for (size_t i = 0; i < dataSize; ++i)
+		file[128 + i] = static_cast<uchar>(i * 13 + seed);
+
+	DataStreamPtr stream = mSources->create(name);
+	stream->write(&file[0], file.size());
+	stream->close();
+}
+
+size_t TextureCacheTests::getDecodeCount(void) const
+{
+	return static_cast<CountingCodec*>(mCodec)->mDecodes;
+}
+
+size_t TextureCacheTests::getDecodeIntoCount(void) const
+{
+	return static_cast<CountingCodec*>(mCodec)->mDecodesInto;
+}
+
+void TextureCacheTests::readLevels(const TexturePtr& texture, std::vector<uchar>& data)
+{
+	data.clear();
+	for (size_t mip = 0; mip <= texture->getNumMipmaps(); ++mip)
+	{
+		PixelBox box = static_cast<MemoryPixelBuffer*>(texture->getBuffer(0, mip).getPointer())->getPixelBox();
+		const uchar* pixels = static_cast<const uchar*>(box.data);
+		data.insert(data.end(), pixels, pixels + box.getConsecutiveSize());
+	}
+}
+
+void TextureCacheTests::makeImage(Image& image, size_t size, uint8 seed)
+{
+	size_t numMips = 0;
+	for (size_t s = size; s > 1; s /= 2)
+		++numMips;
+	size_t bytes = Image::calculateSize(numMips, 1, size, size, 1, PF_A8R8G8B8);
+	uchar* data = OGRE_ALLOC_T(uchar, bytes, MEMCATEGORY_GENERAL);
+	for (size_t i = 0; i < bytes; ++i)
+		data[i] = static_cast<uchar>(i * 7 + seed);
+	image.loadDynamicImage(data, size, size, 1, PF_A8R8G8B8, true, 1, numMips);
+}
+
+void TextureCacheTests::makeTranscoded(const Image& source, size_t numMips, Image& image)
+{
+	size_t width = source.getWidth(), height = source.getHeight();
+	size_t bytes = Image::calculateSize(numMips, 1, width, height, 1, PF_A8B8G8R8);
+	image.loadDynamicImage(OGRE_ALLOC_T(uchar, bytes, MEMCATEGORY_GENERAL), 
+		width, height, 1, PF_A8B8G8R8, true, 1, numMips);
+	PixelUtil::bulkPixelConversion(source.getPixelBox(), image.getPixelBox());
+	for (size_t mip = 1; mip <= numMips; ++mip)
+		Image::scale(image.getPixelBox(0, mip - 1), image.getPixelBox(0, mip), Image::FILTER_BOX);
+}
+
+void TextureCacheTests::testSaveAndLoad()
+{
+	Image image;
+	makeImage(image, 32, 1);
+	mManager->_saveTranscodedImage("a.png;", 1000, 0x1234, image);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), mCache->find("*.texcache", false)->size());
+	CPPUNIT_ASSERT(mManager->getTranscodeCacheSize() > image.getSize());
+
+	Image loaded;
+	CPPUNIT_ASSERT(mManager->_loadTranscodedImage("a.png;", 1000, 0x1234, loaded));
+	CPPUNIT_ASSERT_EQUAL(image.getWidth(), loaded.getWidth());
+	CPPUNIT_ASSERT_EQUAL(image.getHeight(), loaded.getHeight());
+	CPPUNIT_ASSERT_EQUAL(image.getNumMipmaps(), loaded.getNumMipmaps());
+	CPPUNIT_ASSERT_EQUAL(image.getNumFaces(), loaded.getNumFaces());
+	CPPUNIT_ASSERT_EQUAL(image.getFormat(), loaded.getFormat());
+	CPPUNIT_ASSERT_EQUAL(image.getSize(), loaded.getSize());
+	CPPUNIT_ASSERT(memcmp(image.getData(), loaded.getData(), image.getSize()) == 0);
+}
+
+void TextureCacheTests::testSourceChangeInvalidates()
+{
+	Image image;
+	makeImage(image, 16, 2);
+	mManager->_saveTranscodedImage("b.png;", 500, 0xabcd, image);
+
+	Image loaded;
+	CPPUNIT_ASSERT(!mManager->_loadTranscodedImage("b.png;", 500, 0xabce, loaded));
+	CPPUNIT_ASSERT(!mManager->_loadTranscodedImage("b.png;", 501, 0xabcd, loaded));
+	CPPUNIT_ASSERT(!mManager->_loadTranscodedImage("c.png;", 500, 0xabcd, loaded));
+
+	// Saving the changed source replaces the entry
+	size_t size = mManager->getTranscodeCacheSize();
+	mManager->_saveTranscodedImage("b.png;", 500, 0xabce, image);
+	CPPUNIT_ASSERT_EQUAL(size, mManager->getTranscodeCacheSize());
+	CPPUNIT_ASSERT(mManager->_loadTranscodedImage("b.png;", 500, 0xabce, loaded));
+}
+
+void TextureCacheTests::testEvictsLeastRecentlyUsed()
+{
+	Image image;
+	makeImage(image, 64, 3);
+	mManager->_saveTranscodedImage("a.png;", 1, 1, image);
+	size_t entrySize = mManager->getTranscodeCacheSize();
+	mManager->setTranscodeCacheBudget(entrySize * 2 + entrySize / 2);
+
+	mManager->_saveTranscodedImage("b.png;", 2, 2, image);
+	Image loaded;
+	CPPUNIT_ASSERT(mManager->_loadTranscodedImage("a.png;", 1, 1, loaded));
+
+	// "b" is now the least recently used, and makes way for "c"
+	mManager->_saveTranscodedImage("c.png;", 3, 3, image);
+	CPPUNIT_ASSERT_EQUAL(entrySize * 2, mManager->getTranscodeCacheSize());
+	CPPUNIT_ASSERT_EQUAL(size_t(2), mCache->find("*.texcache", false)->size());
+	CPPUNIT_ASSERT(mManager->_loadTranscodedImage("a.png;", 1, 1, loaded));
+	CPPUNIT_ASSERT(!mManager->_loadTranscodedImage("b.png;", 2, 2, loaded));
+	CPPUNIT_ASSERT(mManager->_loadTranscodedImage("c.png;", 3, 3, loaded));
+
+	// A smaller budget evicts straight away
+	mManager->setTranscodeCacheBudget(entrySize);
+	CPPUNIT_ASSERT_EQUAL(entrySize, mManager->getTranscodeCacheSize());
+	CPPUNIT_ASSERT(mManager->_loadTranscodedImage("c.png;", 3, 3, loaded));
+}
+
+void TextureCacheTests::testEntriesFoundWhenSet()
+{
+	Image image;
+	makeImage(image, 8, 4);
+	mManager->_saveTranscodedImage("d.png;", 10, 20, image);
+	size_t size = mManager->getTranscodeCacheSize();
+
+	mManager->setTranscodeCache(0);
+	CPPUNIT_ASSERT_EQUAL(size_t(0), mManager->getTranscodeCacheSize());
+	Image loaded;
+	CPPUNIT_ASSERT(!mManager->_loadTranscodedImage("d.png;", 10, 20, loaded));
+
+	mManager->setTranscodeCache(mCache);
+	CPPUNIT_ASSERT_EQUAL(size, mManager->getTranscodeCacheSize());
+	CPPUNIT_ASSERT(mManager->_loadTranscodedImage("d.png;", 10, 20, loaded));
+	CPPUNIT_ASSERT_EQUAL(image.getSize(), loaded.getSize());
+}
+
+void TextureCacheTests::testLoadTranscodesOnMiss()
+{
+	writeSource("a.cachetest", 16, 16, 1);
+	TexturePtr texture = mManager->load("a.cachetest", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+		TEX_TYPE_2D, 4, 1.0f, false, PF_A8B8G8R8);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), getDecodeCount());
+	CPPUNIT_ASSERT_EQUAL(size_t(1), mCache->find("*.texcache", false)->size());
+	// The source was decoded straight into the transcoded image
+	CPPUNIT_ASSERT_EQUAL(size_t(1), getDecodeIntoCount());
+
+	// Loaded in the desired format, with the mipmaps made when transcoding
+	CPPUNIT_ASSERT_EQUAL(PF_A8B8G8R8, texture->getFormat());
+	CPPUNIT_ASSERT_EQUAL(size_t(4), texture->getNumMipmaps());
+	CPPUNIT_ASSERT_EQUAL(size_t(16), texture->getWidth());
+
+	Image source;
+	DataStreamPtr stream = mSources->open("a.cachetest");
+	source.load(stream, "cachetest");
+	Image expected;
+	makeTranscoded(source, 4, expected);
+	std::vector<uchar> levels;
+	readLevels(texture, levels);
+	CPPUNIT_ASSERT_EQUAL(expected.getSize(), levels.size());
+	CPPUNIT_ASSERT(memcmp(expected.getData(), &levels[0], levels.size()) == 0);
+}
+
+void TextureCacheTests::testLoadTranscodesWithGamma()
+{
+	writeSource("a.cachetest", 16, 16, 1);
+	TexturePtr texture = mManager->load("a.cachetest", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+		TEX_TYPE_2D, 4, 2.0f, false, PF_A8B8G8R8);
+
+	// Gamma is applied in the source format, so the source image is decoded first
+	CPPUNIT_ASSERT_EQUAL(size_t(1), getDecodeCount());
+	CPPUNIT_ASSERT_EQUAL(size_t(0), getDecodeIntoCount());
+	CPPUNIT_ASSERT_EQUAL(size_t(1), mCache->find("*.texcache", false)->size());
+	CPPUNIT_ASSERT_EQUAL(PF_A8B8G8R8, texture->getFormat());
+	CPPUNIT_ASSERT_EQUAL(size_t(4), texture->getNumMipmaps());
+
+	Image source;
+	DataStreamPtr stream = mSources->open("a.cachetest");
+	source.load(stream, "cachetest");
+	Image::applyGamma(source.getData(), 2.0f, source.getSize(), 32);
+	Image expected;
+	makeTranscoded(source, 4, expected);
+	std::vector<uchar> levels;
+	readLevels(texture, levels);
+	CPPUNIT_ASSERT_EQUAL(expected.getSize(), levels.size());
+	CPPUNIT_ASSERT(memcmp(expected.getData(), &levels[0], levels.size()) == 0);
+}
+
+void TextureCacheTests::testLoadFromCacheOnHit()
+{
+	writeSource("a.cachetest", 16, 16, 1);
+	TexturePtr texture = mManager->load("a.cachetest", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+		TEX_TYPE_2D, 4, 1.0f, false, PF_A8B8G8R8);
+	std::vector<uchar> transcoded;
+	readLevels(texture, transcoded);
+
+	// Reloading finds the entry saved by the first load
+	texture->reload();
+	CPPUNIT_ASSERT_EQUAL(size_t(1), getDecodeCount());
+	CPPUNIT_ASSERT_EQUAL(PF_A8B8G8R8, texture->getFormat());
+	CPPUNIT_ASSERT_EQUAL(size_t(4), texture->getNumMipmaps());
+	std::vector<uchar> cached;
+	readLevels(texture, cached);
+	CPPUNIT_ASSERT(transcoded == cached);
+
+	// As does a new texture
+	texture.setNull();
+	mManager->remove("a.cachetest");
+	texture = mManager->load("a.cachetest", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+		TEX_TYPE_2D, 4, 1.0f, false, PF_A8B8G8R8);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), getDecodeCount());
+	readLevels(texture, cached);
+	CPPUNIT_ASSERT(transcoded == cached);
+}
+
+void TextureCacheTests::testLoadAfterSourceChange()
+{
+	writeSource("a.cachetest", 16, 16, 1);
+	TexturePtr texture = mManager->load("a.cachetest", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+		TEX_TYPE_2D, 0, 1.0f, false, PF_A8B8G8R8);
+	std::vector<uchar> before;
+	readLevels(texture, before);
+
+	// Same name and size, other pixels
+	writeSource("a.cachetest", 16, 16, 2);
+	texture->reload();
+	CPPUNIT_ASSERT_EQUAL(size_t(2), getDecodeCount());
+	std::vector<uchar> after;
+	readLevels(texture, after);
+	CPPUNIT_ASSERT(before != after);
+
+	// The entry was replaced
+	CPPUNIT_ASSERT_EQUAL(size_t(1), mCache->find("*.texcache", false)->size());
+	texture->reload();
+	CPPUNIT_ASSERT_EQUAL(size_t(2), getDecodeCount());
+}
+
+void TextureCacheTests::testKeyedBySettings()
+{
+	writeSource("a.cachetest", 16, 1, 1);
+	TexturePtr texture = mManager->load("a.cachetest", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+		TEX_TYPE_2D, 0, 1.0f, false, PF_A8B8G8R8);
+	texture.setNull();
+	mManager->remove("a.cachetest");
+	CPPUNIT_ASSERT_EQUAL(size_t(1), getDecodeCount());
+
+	// Another texture type or format can't use the same entry
+	texture = mManager->load("a.cachetest", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+		TEX_TYPE_1D, 0, 1.0f, false, PF_A8B8G8R8);
+	texture.setNull();
+	mManager->remove("a.cachetest");
+	CPPUNIT_ASSERT_EQUAL(size_t(2), getDecodeCount());
+	texture = mManager->load("a.cachetest", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+		TEX_TYPE_2D, 0, 1.0f, false, PF_R8G8B8A8);
+	CPPUNIT_ASSERT_EQUAL(size_t(3), getDecodeCount());
+	CPPUNIT_ASSERT_EQUAL(size_t(3), mCache->find("*.texcache", false)->size());
+}
+
+void TextureCacheTests::testLoadImageAfterUnprepare()
+{
+	writeSource("a.cachetest", 16, 16, 1);
+	TexturePtr texture = mManager->load("a.cachetest", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+		TEX_TYPE_2D, 0, 1.0f, false, PF_A8B8G8R8);
+	texture->unload();
+
+	// Read from the cache, but never loaded from it
+	texture->prepare();
+	CPPUNIT_ASSERT_EQUAL(size_t(1), getDecodeCount());
+	texture->unload();
+
+	// An image of the caller's own is converted to the desired format as usual
+	Image image;
+	makeImage(image, 16, 3);
+	texture->loadImage(image);
+	CPPUNIT_ASSERT_EQUAL(PF_A8B8G8R8, texture->getFormat());
+	CPPUNIT_ASSERT_EQUAL(size_t(1), getDecodeCount());
+}
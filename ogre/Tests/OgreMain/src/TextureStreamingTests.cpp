@@ -0,0 +1,229 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "TextureStreamingTests.h"
+#include "MemoryTextureManager.h"
+#include "OgreRoot.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+#include <fstream>
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( TextureStreamingTests );
+
+namespace
+{
+	/// Work queue without threads, whose requests are handled when the test says so
+	class SteppedWorkQueue : public DefaultWorkQueue
+	{
+	public:
+		SteppedWorkQueue() : DefaultWorkQueue("TextureStreamingTests") {}
+
+		void processRequests(void)
+		{
+			while (!mRequestQueue.empty())
+				_processNextRequest();
+		}
+	};
+
+	/// Size of the levels of a square A8R8G8B8 image from the given one down
+	size_t getLevelsSize(size_t size, size_t firstMip)
+	{
+		size_t total = 0;
+		for (size_t s = size >> firstMip; s > 0; s /= 2)
+			total += s * s * 4;
+		return total;
+	}
+}
+
+void TextureStreamingTests::RecordingListener::textureResidencyChanged(Texture* tex, size_t residentMipmap)
+{
+	mChanges.push_back(Change(tex->getName(), residentMipmap));
+}
+
+void TextureStreamingTests::setUp()
+{
+	mDir = new TemporaryDirectory();
+	mRoot = OGRE_NEW Root("", "", "TextureStreamingTests.log");
+	mRoot->setWorkQueue(OGRE_NEW SteppedWorkQueue());
+	ResourceGroupManager::getSingleton().addResourceLocation(mDir->getPath(), "FileSystem");
+	mManager = OGRE_NEW MemoryTextureManager();
+	mManager->addStreamingListener(&mListener);
+}
+
+void TextureStreamingTests::tearDown()
+{
+	mManager->removeStreamingListener(&mListener);
+	OGRE_DELETE mManager;
+	OGRE_DELETE mRoot;
+	delete mDir;
+}
+
+void TextureStreamingTests::writeSource(const String& name, size_t size, uint8 seed)
+{
+	size_t numLevels = 1;
+	for (size_t s = size; s > 1; s /= 2)
+		++numLevels;
+	size_t dataSize = getLevelsSize(size, 0);
+	std::vector<uchar> file(128 + dataSize);
+	uint32* header = reinterpret_cast<uint32*>(&file[0]);
+	header[0] = 0x20534444; // 'DDS '
+	header[1] = 124; // header size
+	header[2] = 0x00021007; // caps, height, width, pixel format, mipmap count
+	header[3] = static_cast<uint32>(size);
+	header[4] = static_cast<uint32>(size);
+	header[7] = static_cast<uint32>(numLevels);
+	header[19] = 32; // pixel format size
+	header[20] = 0x41; // RGB with alpha
+	header[22] = 32;
+	header[23] = 0x00ff0000;
+	header[24] = 0x0000ff00;
+	header[25] = 0x000000ff;
+	header[26] = 0xff000000;
+	header[27] = 0x00401008; // texture, complex, mipmap
+	for (size_t i = 0; i < dataSize; ++i)
+		file[128 + i] = static_cast<uchar>(i * 13 + seed);
+
+	std::ofstream out((mDir->getPath() + "/" + name).c_str(), std::ios::out | std::ios::binary);
+	out.write(reinterpret_cast<const char*>(&file[0]), file.size());
+}
+
+size_t TextureStreamingTests::frame(void)
+{
+	size_t changes = mListener.mChanges.size();
+	static_cast<SteppedWorkQueue*>(mRoot->getWorkQueue())->processRequests();
+	mRoot->getWorkQueue()->processResponses();
+	mManager->_updateStreaming();
+	return mListener.mChanges.size() - changes;
+}
+
+void TextureStreamingTests::checkLevels(const TexturePtr& tex, size_t size, uint8 seed, size_t firstMip)
+{
+	CPPUNIT_ASSERT(tex->isLoaded());
+	CPPUNIT_ASSERT_EQUAL(size >> firstMip, tex->getWidth());
+	CPPUNIT_ASSERT_EQUAL(size >> firstMip, tex->getHeight());
+	CPPUNIT_ASSERT_EQUAL(PF_A8R8G8B8, tex->getFormat());
+	size_t offset = getLevelsSize(size, 0) - getLevelsSize(size, firstMip);
+	for (size_t mip = 0; mip <= tex->getNumMipmaps(); ++mip)
+	{
+		HardwarePixelBufferSharedPtr buf = tex->getBuffer(0, mip);
+		std::vector<uchar> data(buf->getSizeInBytes());
+		buf->blitToMemory(PixelBox(buf->getWidth(), buf->getHeight(), 1, PF_A8R8G8B8, &data[0]));
+		for (size_t i = 0; i < data.size(); ++i, ++offset)
+			CPPUNIT_ASSERT_EQUAL(static_cast<uchar>(offset * 13 + seed), data[i]);
+	}
+	CPPUNIT_ASSERT_EQUAL(getLevelsSize(size, 0), offset);
+}
+
+void TextureStreamingTests::testLevelsArriveInOrder()
+{
+	writeSource("a.dds", 256, 1);
+	mManager->setStreamingInitialSize(64);
+	TexturePtr tex = mManager->loadStreamed("a.dds", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+	// Levels no larger than the initial size are there straight away
+	checkLevels(tex, 256, 1, 2);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, mManager->getStreamingTextureCount());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, mListener.mChanges.size());
+	CPPUNIT_ASSERT_EQUAL((size_t)2, mListener.mChanges.back().second);
+
+	// then one more per frame, the texture keeping all of its levels
+	CPPUNIT_ASSERT_EQUAL((size_t)1, frame());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, mListener.mChanges.back().second);
+	checkLevels(tex, 256, 1, 1);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, frame());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, mListener.mChanges.back().second);
+	checkLevels(tex, 256, 1, 0);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)0, mManager->getStreamingTextureCount());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, frame());
+}
+
+void TextureStreamingTests::testUploadBudget()
+{
+	writeSource("a.dds", 256, 1);
+	writeSource("b.dds", 256, 2);
+	mManager->setStreamingInitialSize(64);
+	// Room for the 128 pixel levels of both textures, but not for both of the
+	// textures they are uploaded with
+	mManager->setStreamingUploadBudget(2 * 128 * 128 * 4 + 1000);
+	CPPUNIT_ASSERT(mManager->getStreamingUploadBudget() < 2 * getLevelsSize(256, 1));
+	TexturePtr a = mManager->loadStreamed("a.dds", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+	TexturePtr b = mManager->loadStreamed("b.dds", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+	mListener.mChanges.clear();
+
+	// One texture a frame, however large the upload, least detailed first
+	CPPUNIT_ASSERT_EQUAL((size_t)1, frame());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, mListener.mChanges.back().second);
+	String first = mListener.mChanges.back().first;
+	CPPUNIT_ASSERT_EQUAL((size_t)1, frame());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, mListener.mChanges.back().second);
+	CPPUNIT_ASSERT(mListener.mChanges.back().first != first);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, frame());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, mListener.mChanges.back().second);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, frame());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, mListener.mChanges.back().second);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, mManager->getStreamingTextureCount());
+	checkLevels(a, 256, 1, 0);
+	checkLevels(b, 256, 2, 0);
+
+	// Both fit in a larger budget
+	mManager->setStreamingUploadBudget(2 * getLevelsSize(256, 1));
+	a->reload();
+	b->reload();
+	CPPUNIT_ASSERT_EQUAL((size_t)2, frame());
+	CPPUNIT_ASSERT_EQUAL((size_t)2, mManager->getStreamingTextureCount());
+}
+
+void TextureStreamingTests::testUnloadWhileStreaming()
+{
+	writeSource("a.dds", 256, 1);
+	mManager->setStreamingInitialSize(64);
+	TexturePtr tex = mManager->loadStreamed("a.dds", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, mManager->getStreamingTextureCount());
+
+	// The decoded level is dropped rather than uploaded
+	tex->unload();
+	CPPUNIT_ASSERT_EQUAL((size_t)0, frame());
+	CPPUNIT_ASSERT(!tex->isLoaded());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, mManager->getStreamingTextureCount());
+
+	// Loading again streams it from the start
+	tex->load();
+	checkLevels(tex, 256, 1, 2);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, frame());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, frame());
+	checkLevels(tex, 256, 1, 0);
+
+	// and a texture removed while streaming is forgotten too
+	tex->reload();
+	mManager->remove(tex->getHandle());
+	tex.setNull();
+	CPPUNIT_ASSERT_EQUAL((size_t)0, frame());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, mManager->getStreamingTextureCount());
+}
@@ -37,8 +37,10 @@ void ZipArchiveTests::setUp()
 {
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
     testPath = "../../../../Tests/OgreMain/misc/ArchiveTest.zip";
+    storedPath = "../../../../Tests/OgreMain/misc/StoredArchiveTest.zip";
 #else
     testPath = "../../../Tests/OgreMain/misc/ArchiveTest.zip";
+    storedPath = "../../../Tests/OgreMain/misc/StoredArchiveTest.zip";
 #endif
 }
 void ZipArchiveTests::tearDown()
@@ -269,3 +271,57 @@ void ZipArchiveTests::testReadInterleave()
     CPPUNIT_ASSERT(stream2->eof());
 
 }
+void ZipArchiveTests::testCaseInsensitiveLookup()
+{
+    ZipArchive arch(testPath, "Zip");
+    arch.load();
+
+    CPPUNIT_ASSERT(arch.exists("ROOTFILE.TXT"));
+    CPPUNIT_ASSERT(arch.exists("Level2/Materials/Scripts/File3.Material"));
+    CPPUNIT_ASSERT(!arch.exists("rootfile3.txt"));
+    CPPUNIT_ASSERT(!arch.exists("scripts/file3.material"));
+
+    // Deflated files are read through zziplib
+    DataStreamPtr stream = arch.open("RootFile2.txt");
+    CPPUNIT_ASSERT(!stream.isNull());
+    CPPUNIT_ASSERT_EQUAL((size_t)156, stream->size());
+    CPPUNIT_ASSERT_EQUAL(String("this is line 1 in file 2"), stream->getLine());
+
+    // Stored files are found the same way, testStoredFileRead reads one
+    stream = arch.open("LEVEL1/materials/scripts/file2.material");
+    CPPUNIT_ASSERT(!stream.isNull());
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stream->size());
+    CPPUNIT_ASSERT(stream->eof());
+
+    CPPUNIT_ASSERT(arch.open("rootfile3.txt").isNull());
+}
+void ZipArchiveTests::testStoredFileRead()
+{
+    // StoredArchiveTest.zip holds rootfile2.txt without compression, so it
+    // is read from the mapped archive rather than inflated by zziplib
+    ZipArchive deflated(testPath, "Zip");
+    deflated.load();
+    ZipArchive stored(storedPath, "Zip");
+    stored.load();
+
+    DataStreamPtr expected = deflated.open("rootfile2.txt");
+    DataStreamPtr actual = stored.open("RootFile2.txt");
+    CPPUNIT_ASSERT(!actual.isNull());
+    CPPUNIT_ASSERT(actual->getDataPtr() != 0);
+    CPPUNIT_ASSERT(expected->getDataPtr() == 0);
+    CPPUNIT_ASSERT_EQUAL((size_t)156, actual->size());
+    CPPUNIT_ASSERT_EQUAL(expected->getAsString(), actual->getAsString());
+
+    // Reads from the middle of the file
+    char expectedBytes[20], actualBytes[20];
+    expected->seek(100);
+    actual->seek(100);
+    CPPUNIT_ASSERT_EQUAL((size_t)20, expected->read(expectedBytes, 20));
+    CPPUNIT_ASSERT_EQUAL((size_t)20, actual->read(actualBytes, 20));
+    CPPUNIT_ASSERT(memcmp(expectedBytes, actualBytes, 20) == 0);
+
+    // The stream keeps the mapping after the archive is unloaded
+    stored.unload();
+    actual->seek(0);
+    CPPUNIT_ASSERT_EQUAL(String("this is line 1 in file 2"), actual->getLine());
+}
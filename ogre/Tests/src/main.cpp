@@ -35,11 +35,20 @@ int main(int argc, char *argv[])
 
     // Add the top suite to the test runner
     CPPUNIT_NS::TestRunner runner;
+#ifdef OGRE_BENCHMARKS
+    // Benchmark_Ogre runs the suites registered as benchmarks instead
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry("Benchmarks").makeTest() );
+#else
     runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+#endif
     runner.run( controller );
 
     // Print test results to a file
+#ifdef OGRE_BENCHMARKS
+	std::ofstream ofile("OgreBenchmarkResults.log");
+#else
 	std::ofstream ofile("OgreTestResults.log");
+#endif
 	
     CPPUNIT_NS::CompilerOutputter* outputter =
         CPPUNIT_NS::CompilerOutputter::defaultOutputter(&result, ofile);
@@ -141,6 +141,8 @@ void TextureUnitPropertyGridPage::populate()
 	pfChoices.Add(wxT("DXT3"), PF_DXT3); 
 	pfChoices.Add(wxT("DXT4"), PF_DXT4);
 	pfChoices.Add(wxT("DXT5"), PF_DXT5); 
+	pfChoices.Add(wxT("BC4_UNORM"), PF_BC4_UNORM);
+	pfChoices.Add(wxT("BC5_UNORM"), PF_BC5_UNORM);
 	pfChoices.Add(wxT("FLOAT16_R"), PF_FLOAT16_R);   
 	pfChoices.Add(wxT("FLOAT16_RGB"), PF_FLOAT16_RGB);   
 	pfChoices.Add(wxT("FLOAT16_RGBA"), PF_FLOAT16_RGBA);   
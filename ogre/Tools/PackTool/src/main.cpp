@@ -0,0 +1,150 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2009 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+
+#include "Ogre.h"
+#include "OgreFileSystem.h"
+#include "OgrePackArchive.h"
+
+#include <iostream>
+
+using namespace std;
+using namespace Ogre;
+
+void help(void)
+{
+    // Print help message
+    cout << endl << "OgrePackTool: Packs a folder into an OGRE pack archive." << endl;
+    cout << "Usage: OgrePackTool [opts] sourcefolder destfile" << endl;
+	cout << "-s             = Store all files uncompressed" << endl;
+	cout << "-c chunksize   = Size of compressed chunks in bytes (default 65536)" << endl;
+	cout << "-a alignment   = Alignment of stored files in bytes (default 16)" << endl;
+	cout << "-z level       = zlib compression level, 1-9 (default 9)" << endl;
+	cout << "-l             = List the contents of destfile instead of writing it" << endl;
+    cout << "sourcefolder   = folder whose contents (recursively) are packed" << endl;
+    cout << "destfile       = name of the pack to write" << endl;
+
+    cout << endl;
+}
+
+void listPack(const String& filename)
+{
+	PackArchive pack(filename, "Pack");
+	pack.load();
+	FileInfoListPtr files = pack.listFileInfo(true, false);
+	for (FileInfoList::iterator i = files->begin(); i != files->end(); ++i)
+	{
+		cout << i->filename << " " << i->uncompressedSize << " -> " << 
+			i->compressedSize << endl;
+	}
+	cout << files->size() << " files" << endl;
+}
+
+int main(int numargs, char** args)
+{
+    if (numargs < 2)
+    {
+        help();
+        return -1;
+    }
+
+	int retCode = 0;
+	LogManager* logMgr = 0;
+	try 
+	{
+		logMgr = new LogManager();
+		logMgr->createLog("OgrePackTool.log", true, false);
+
+		UnaryOptionList unOptList;
+		BinaryOptionList binOptList;
+
+		unOptList["-s"] = false;
+		unOptList["-l"] = false;
+		binOptList["-c"] = "";
+		binOptList["-a"] = "";
+		binOptList["-z"] = "";
+
+		int startIdx = findCommandLineOpts(numargs, args, unOptList, binOptList);
+
+		if (unOptList["-l"])
+		{
+			if (startIdx >= numargs)
+			{
+				help();
+				return -1;
+			}
+			listPack(args[startIdx]);
+		}
+		else
+		{
+			if (startIdx + 2 > numargs)
+			{
+				help();
+				return -1;
+			}
+			String source(args[startIdx]);
+			String dest(args[startIdx + 1]);
+
+			PackArchiveWriter writer;
+			if (!binOptList["-c"].empty())
+				writer.setChunkSize(StringConverter::parseUnsignedInt(binOptList["-c"]));
+			if (!binOptList["-a"].empty())
+				writer.setAlignment(StringConverter::parseUnsignedInt(binOptList["-a"]));
+			if (!binOptList["-z"].empty())
+				writer.setCompressionLevel(StringConverter::parseInt(binOptList["-z"]));
+
+			FileSystemArchive sourceArchive(source, "FileSystem");
+			sourceArchive.load();
+			writer.addArchive(&sourceArchive, !unOptList["-s"]);
+
+			std::fstream* outFile = OGRE_NEW_T(std::fstream, MEMCATEGORY_GENERAL)();
+			outFile->open(dest.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+			if (!*outFile)
+			{
+				OGRE_DELETE_T(outFile, basic_fstream, MEMCATEGORY_GENERAL);
+				OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+					"Cannot open " + dest + " for writing", "OgrePackTool");
+			}
+			DataStreamPtr outStream(OGRE_NEW FileStreamDataStream(dest, outFile, true));
+			writer.write(outStream);
+			outStream->close();
+
+			cout << "Wrote " << dest << endl;
+		}
+	}
+	catch (Exception& e)
+	{
+		cout << "Exception caught: " << e.getDescription() << endl;
+		retCode = 1;
+	}
+
+	delete logMgr;
+
+	return retCode;
+}
+
@@ -6,6 +6,7 @@
 /* @(#) $Id$ */
 
 #include "zutil.h"
+#include "adler32_simd.h"
 
 #define local static
 
@@ -96,6 +97,14 @@ uLong ZEXPORT adler32(adler, buf, len)
         return adler | (sum2 << 16);
     }
 
+#ifdef Z_X86_SIMD
+    if (len >= ADLER32_SSSE3_MIN_LEN) {
+        cpu_check_features();
+        if (x86_cpu_has_ssse3)
+            return adler32_ssse3(adler | (sum2 << 16), buf, len);
+    }
+#endif /* Z_X86_SIMD */
+
     /* do length NMAX blocks -- requires just one modulo operation */
     while (len >= NMAX) {
         len -= NMAX;
@@ -0,0 +1,20 @@
+/* adler32_simd.h -- header to use adler32_simd.c
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+/* WARNING: this file should *not* be used by applications. It is
+   part of the implementation of the compression library and is
+   subject to change. Applications should only use zlib.h.
+ */
+
+#include "cpu_features.h"
+
+#ifdef Z_X86_SIMD
+
+/* adler32() hands buffers of at least this many bytes to adler32_ssse3() */
+#define ADLER32_SSSE3_MIN_LEN 64
+
+uLong ZLIB_INTERNAL adler32_ssse3 OF((uLong adler, const Bytef *buf,
+                                      uInt len));
+
+#endif /* Z_X86_SIMD */
@@ -0,0 +1,59 @@
+/* cpu_features.c -- processor feature detection
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+#include "zutil.h"
+#include "cpu_features.h"
+
+#ifdef Z_X86_SIMD
+
+#ifdef _MSC_VER
+#  include <intrin.h>
+#else
+#  include <cpuid.h>
+#endif
+
+int ZLIB_INTERNAL x86_cpu_has_sse2 = 0;
+int ZLIB_INTERNAL x86_cpu_has_ssse3 = 0;
+int ZLIB_INTERNAL x86_cpu_has_sse42 = 0;
+int ZLIB_INTERNAL x86_cpu_has_pclmulqdq = 0;
+
+local int cpu_checked = 0;
+
+/* ========================================================================= */
+void ZLIB_INTERNAL cpu_check_features()
+{
+    unsigned ecx, edx;
+
+    if (cpu_checked)
+        return;
+
+#ifdef _MSC_VER
+    {
+        int regs[4];
+
+        __cpuid(regs, 0);
+        if (regs[0] >= 1)
+            __cpuid(regs, 1);
+        else
+            regs[2] = regs[3] = 0;
+        ecx = (unsigned)regs[2];
+        edx = (unsigned)regs[3];
+    }
+#else
+    {
+        unsigned eax, ebx;
+
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            ecx = edx = 0;
+    }
+#endif
+
+    x86_cpu_has_sse2 = (edx & 0x04000000) != 0;
+    x86_cpu_has_ssse3 = (ecx & 0x00000200) != 0;
+    x86_cpu_has_sse42 = (ecx & 0x00100000) != 0;
+    x86_cpu_has_pclmulqdq = (ecx & 0x00000002) != 0;
+    cpu_checked = 1;
+}
+
+#endif /* Z_X86_SIMD */
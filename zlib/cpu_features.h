@@ -0,0 +1,44 @@
+/* cpu_features.h -- processor features used to pick accelerated code paths
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+/* WARNING: this file should *not* be used by applications. It is
+   part of the implementation of the compression library and is
+   subject to change. Applications should only use zlib.h.
+ */
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+/* The SIMD code paths are built for x86 and x86-64 with compilers which can
+   enable instruction sets per function, so the rest of the library keeps
+   the baseline instruction set and runs on any processor.  Define Z_NO_SIMD
+   to leave them out altogether. */
+#if !defined(Z_NO_SIMD) && !defined(ASMINF) && \
+    (defined(__x86_64__) || defined(__i386__) || \
+     defined(_M_X64) || defined(_M_IX86))
+#  if defined(_MSC_VER) && _MSC_VER >= 1600
+#    define Z_X86_SIMD
+#    define Z_TARGET(isa)
+#  elif defined(__clang__) || (defined(__GNUC__) && \
+        (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#    define Z_X86_SIMD
+#    define Z_TARGET(isa) __attribute__((target(isa)))
+#  endif
+#endif
+
+#ifdef Z_X86_SIMD
+
+/* Set by cpu_check_features(), which the checksums and inflate call before
+   they first look at them.  Detection writes the same values every time,
+   so it needs no lock. */
+extern int ZLIB_INTERNAL x86_cpu_has_sse2;
+extern int ZLIB_INTERNAL x86_cpu_has_ssse3;
+extern int ZLIB_INTERNAL x86_cpu_has_sse42;
+extern int ZLIB_INTERNAL x86_cpu_has_pclmulqdq;
+
+void ZLIB_INTERNAL cpu_check_features OF((void));
+
+#endif /* Z_X86_SIMD */
+
+#endif /* CPU_FEATURES_H */
@@ -27,6 +27,7 @@
 #endif /* MAKECRCH */
 
 #include "zutil.h"      /* for STDC and FAR definitions */
+#include "crc32_simd.h"
 
 #define local static
 
@@ -230,6 +231,24 @@ unsigned long ZEXPORT crc32(crc, buf, len)
         make_crc_table();
 #endif /* DYNAMIC_CRC_TABLE */
 
+#ifdef Z_X86_SIMD
+    /* fold the bulk of the buffer with carry-less multiplies, and leave the
+       tail of less than a chunk to the tables */
+    if (len >= CRC32_PCLMUL_MIN_LEN) {
+        cpu_check_features();
+        if (x86_cpu_has_pclmulqdq && x86_cpu_has_sse42) {
+            uInt chunk = len & ~(uInt)(CRC32_PCLMUL_CHUNK - 1);
+
+            crc = crc32_pclmul((unsigned)(crc ^ 0xffffffffUL), buf, chunk)
+                  ^ 0xffffffffUL;
+            buf += chunk;
+            len -= chunk;
+            if (len == 0)
+                return crc;
+        }
+    }
+#endif /* Z_X86_SIMD */
+
 #ifdef BYFOUR
     if (sizeof(void *) == sizeof(ptrdiff_t)) {
         u4 endian;
@@ -0,0 +1,130 @@
+/* crc32_simd.c -- compute the CRC-32 of a data stream with carry-less multiply
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+/*
+  The buffer is folded into four 128-bit lanes 64 bytes at a time with
+  PCLMULQDQ, the lanes are folded into one, and that is reduced to 32 bits
+  with a Barrett reduction.  See "Fast CRC Computation for Generic
+  Polynomials Using PCLMULQDQ Instruction", V. Gopal et al., Intel 2009.
+  The constants are for the reflected zlib polynomial 0xedb88320:
+
+    k1 = x^(4*128+32) mod P, k2 = x^(4*128-32) mod P   fold by four lanes
+    k3 = x^(128+32) mod P,   k4 = x^(128-32) mod P     fold by one lane
+    k5 = x^64 mod P                                   fold 96 to 64 bits
+    P' = the polynomial, u = x^64 / P                  Barrett reduction
+
+  all bit reflected and shifted left by one.  The result is bit identical to
+  crc32() on the same data.
+ */
+
+#include "zutil.h"
+#include "crc32_simd.h"
+
+#ifdef Z_X86_SIMD
+
+#include <emmintrin.h>
+#include <smmintrin.h>
+#include <wmmintrin.h>
+
+#ifdef _MSC_VER
+#  define Z_ALIGN16(decl) __declspec(align(16)) decl
+#else
+#  define Z_ALIGN16(decl) decl __attribute__((aligned(16)))
+#endif
+
+local const Z_ALIGN16(unsigned long long k1k2[2]) =
+    {0x0154442bd4ULL, 0x01c6e41596ULL};
+local const Z_ALIGN16(unsigned long long k3k4[2]) =
+    {0x01751997d0ULL, 0x00ccaa009eULL};
+local const Z_ALIGN16(unsigned long long k5k0[2]) =
+    {0x0163cd6124ULL, 0x0000000000ULL};
+local const Z_ALIGN16(unsigned long long poly[2]) =
+    {0x01db710641ULL, 0x01f7011641ULL};
+
+/* ========================================================================= */
+Z_TARGET("sse4.2,pclmul")
+unsigned ZLIB_INTERNAL crc32_pclmul(crc, buf, len)
+    unsigned crc;
+    const unsigned char FAR *buf;
+    uInt len;
+{
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    /* load the first 64 bytes and mix in the CRC register */
+    x1 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    x0 = _mm_load_si128((const __m128i *)k1k2);
+    buf += 64;
+    len -= 64;
+
+    /* fold 64 bytes at a time */
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        y5 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+        y6 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+        y7 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+        y8 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+        buf += 64;
+        len -= 64;
+    }
+
+    /* fold the four lanes into one */
+    x0 = _mm_load_si128((const __m128i *)k3k4);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    /* fold in what is left 16 bytes at a time */
+    while (len >= 16) {
+        x2 = _mm_loadu_si128((const __m128i *)buf);
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        buf += 16;
+        len -= 16;
+    }
+
+    /* fold 128 bits down to 64 */
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    /* Barrett reduce to 32 bits */
+    x0 = _mm_load_si128((const __m128i *)poly);
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (unsigned)_mm_extract_epi32(x1, 1);
+}
+
+#endif /* Z_X86_SIMD */
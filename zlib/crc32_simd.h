@@ -0,0 +1,24 @@
+/* crc32_simd.h -- header to use crc32_simd.c
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+/* WARNING: this file should *not* be used by applications. It is
+   part of the implementation of the compression library and is
+   subject to change. Applications should only use zlib.h.
+ */
+
+#include "cpu_features.h"
+
+#ifdef Z_X86_SIMD
+
+/* crc32_pclmul() needs at least this many bytes, and a multiple of the
+   chunk size */
+#define CRC32_PCLMUL_MIN_LEN 64
+#define CRC32_PCLMUL_CHUNK 16
+
+/* Takes and returns the CRC register, that is the CRC-32 inverted */
+unsigned ZLIB_INTERNAL crc32_pclmul OF((unsigned crc,
+                                        const unsigned char FAR *buf,
+                                        uInt len));
+
+#endif /* Z_X86_SIMD */
@@ -0,0 +1,320 @@
+/* inffast_chunk.c -- fast decoding with wide loads and chunked copies
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+#include "zutil.h"
+#include "inftrees.h"
+#include "inflate.h"
+#include "inffast_chunk.h"
+
+#ifdef Z_X86_SIMD
+
+#include <emmintrin.h>
+
+#ifdef _MSC_VER
+typedef unsigned __int64 z_word64;
+#else
+typedef unsigned long long z_word64;
+#endif
+
+/*
+   Decode literal, length, and distance codes and write out the resulting
+   literal and match bytes, as inflate_fast() does, and with the same result.
+   It differs in three ways:
+
+   - The bit buffer is 64 bits wide and refilled with one unaligned eight
+     byte load at the top of each loop, which leaves at least 56 bits in it.
+     That covers the 48 bits a length/distance pair can use, so there are no
+     further refills inside the loop, and up to three literals are decoded
+     for each refill.  Bits above the count in the bit buffer are either
+     zero or the stream bits which belong there, so refills can or in the
+     new bytes.
+
+   - Matches are copied from the output 16 bytes at a time.  A match closer
+     than 16 bytes repeats a pattern that short, so a 16 byte vector of the
+     pattern is stored, stepping by the largest multiple of the distance
+     which fits in a vector.  Either way up to 15 bytes past the end of the
+     match are written; they lie inside the output buffer and are
+     overwritten by the output which follows.
+
+   - Copies out of the window never overlap the output, so they are plain
+     memory copies.
+
+   Entry assumptions:
+
+        state->mode == LEN
+        strm->avail_in >= INFLATE_CHUNK_MIN_INPUT
+        strm->avail_out >= INFLATE_CHUNK_MIN_OUTPUT
+        start >= strm->avail_out
+        state->bits < 8
+
+   On return, state->mode is one of:
+
+        LEN -- ran out of enough output space or enough available input
+        TYPE -- reached end of block code, inflate() to interpret next block
+        BAD -- error in block data
+ */
+
+/* Load eight bytes without alignment, least significant byte first.  This
+   file is only built for x86, which is little endian. */
+local z_word64 load64(p)
+    const unsigned char FAR *p;
+{
+    z_word64 v;
+
+    zmemcpy((Bytef *)&v, (const Bytef *)p, sizeof(v));
+    return v;
+}
+
+/* Copy len bytes from dist bytes back in the output, in 16 byte chunks,
+   and return the new end of the output */
+Z_TARGET("sse2")
+local unsigned char FAR *chunk_copy(out, dist, len)
+    unsigned char FAR *out;
+    unsigned dist;
+    unsigned len;
+{
+    const unsigned char FAR *from = out - dist;
+    unsigned char FAR *limit = out + len;
+
+    if (dist >= INFLATE_CHUNK_SIZE) {
+        /* each load only reads bytes already written */
+        do {
+            _mm_storeu_si128((__m128i *)out,
+                             _mm_loadu_si128((const __m128i *)from));
+            out += INFLATE_CHUNK_SIZE;
+            from += INFLATE_CHUNK_SIZE;
+        } while (out < limit);
+    }
+    else {
+        unsigned char pattern[INFLATE_CHUNK_SIZE];
+        unsigned step;
+        unsigned i;
+        __m128i chunk;
+
+        for (i = 0; i < INFLATE_CHUNK_SIZE; i++)
+            pattern[i] = from[i % dist];
+        chunk = _mm_loadu_si128((const __m128i *)pattern);
+        step = INFLATE_CHUNK_SIZE - INFLATE_CHUNK_SIZE % dist;
+        do {
+            _mm_storeu_si128((__m128i *)out, chunk);
+            out += step;
+        } while (out < limit);
+    }
+    return limit;
+}
+
+void ZLIB_INTERNAL inflate_fast_chunk(strm, start)
+z_streamp strm;
+unsigned start;         /* inflate()'s starting value for strm->avail_out */
+{
+    struct inflate_state FAR *state;
+    unsigned char FAR *in;      /* local strm->next_in */
+    unsigned char FAR *last;    /* while in < last, eight bytes can be read */
+    unsigned char FAR *out;     /* local strm->next_out */
+    unsigned char FAR *beg;     /* inflate()'s initial strm->next_out */
+    unsigned char FAR *end;     /* while out < end, enough space available */
+    unsigned char FAR *limit;   /* end of the output buffer */
+#ifdef INFLATE_STRICT
+    unsigned dmax;              /* maximum distance from zlib header */
+#endif
+    unsigned wsize;             /* window size or zero if not using window */
+    unsigned whave;             /* valid bytes in the window */
+    unsigned wnext;             /* window write index */
+    unsigned char FAR *window;  /* allocated sliding window, if wsize != 0 */
+    z_word64 hold;              /* local strm->hold */
+    unsigned bits;              /* local strm->bits */
+    code const FAR *lcode;      /* local strm->lencode */
+    code const FAR *dcode;      /* local strm->distcode */
+    unsigned lmask;             /* mask for first level of length codes */
+    unsigned dmask;             /* mask for first level of distance codes */
+    code here;                  /* retrieved table entry */
+    unsigned op;                /* code bits, operation, extra bits, or */
+                                /*  window position, window bytes to copy */
+    unsigned len;               /* match length, unused bytes */
+    unsigned dist;              /* match distance */
+    unsigned char FAR *from;    /* where to copy match from */
+
+    /* copy state to local variables */
+    state = (struct inflate_state FAR *)strm->state;
+    in = strm->next_in;
+    last = in + (strm->avail_in - (INFLATE_CHUNK_MIN_INPUT - 1));
+    out = strm->next_out;
+    beg = out - (start - strm->avail_out);
+    limit = out + strm->avail_out;
+    end = out + (strm->avail_out - (INFLATE_CHUNK_MIN_OUTPUT - 1));
+#ifdef INFLATE_STRICT
+    dmax = state->dmax;
+#endif
+    wsize = state->wsize;
+    whave = state->whave;
+    wnext = state->wnext;
+    window = state->window;
+    hold = state->hold;
+    bits = state->bits;
+    lcode = state->lencode;
+    dcode = state->distcode;
+    lmask = (1U << state->lenbits) - 1;
+    dmask = (1U << state->distbits) - 1;
+
+    /* decode literals and length/distances until end-of-block or not enough
+       input data or output space */
+    do {
+        hold |= load64(in) << bits;
+        in += (63 - bits) >> 3;
+        bits |= 56;
+        here = lcode[hold & lmask];
+      dolen:
+        op = (unsigned)(here.bits);
+        hold >>= op;
+        bits -= op;
+        op = (unsigned)(here.op);
+        if (op == 0) {                          /* literal */
+            Tracevv((stderr, here.val >= 0x20 && here.val < 0x7f ?
+                    "inflate:         literal '%c'\n" :
+                    "inflate:         literal 0x%02x\n", here.val));
+            *out++ = (unsigned char)(here.val);
+            /* at least 41 bits are left, enough for two more literals */
+            here = lcode[hold & lmask];
+            if (here.op == 0) {
+                hold >>= here.bits;
+                bits -= here.bits;
+                *out++ = (unsigned char)(here.val);
+                here = lcode[hold & lmask];
+                if (here.op == 0) {
+                    hold >>= here.bits;
+                    bits -= here.bits;
+                    *out++ = (unsigned char)(here.val);
+                }
+            }
+        }
+        else if (op & 16) {                     /* length base */
+            len = (unsigned)(here.val);
+            op &= 15;                           /* number of extra bits */
+            if (op) {
+                len += (unsigned)hold & ((1U << op) - 1);
+                hold >>= op;
+                bits -= op;
+            }
+            Tracevv((stderr, "inflate:         length %u\n", len));
+            here = dcode[hold & dmask];
+          dodist:
+            op = (unsigned)(here.bits);
+            hold >>= op;
+            bits -= op;
+            op = (unsigned)(here.op);
+            if (op & 16) {                      /* distance base */
+                dist = (unsigned)(here.val);
+                op &= 15;                       /* number of extra bits */
+                dist += (unsigned)hold & ((1U << op) - 1);
+#ifdef INFLATE_STRICT
+                if (dist > dmax) {
+                    strm->msg = (char *)"invalid distance too far back";
+                    state->mode = BAD;
+                    break;
+                }
+#endif
+                hold >>= op;
+                bits -= op;
+                Tracevv((stderr, "inflate:         distance %u\n", dist));
+                op = (unsigned)(out - beg);     /* max distance in output */
+                if (dist > op) {                /* see if copy from window */
+                    op = dist - op;             /* distance back in window */
+                    if (op > whave) {
+                        if (state->sane) {
+                            strm->msg =
+                                (char *)"invalid distance too far back";
+                            state->mode = BAD;
+                            break;
+                        }
+#ifdef INFLATE_ALLOW_INVALID_DISTANCE_TOOFAR_ARRR
+                        if (len <= op - whave) {
+                            do {
+                                *out++ = 0;
+                            } while (--len);
+                            continue;
+                        }
+                        len -= op - whave;
+                        do {
+                            *out++ = 0;
+                        } while (--op > whave);
+                        if (op == 0) {
+                            out = chunk_copy(out, dist, len);
+                            continue;
+                        }
+#endif
+                    }
+                    if (wnext == 0) {           /* very common case */
+                        from = window + (wsize - op);
+                    }
+                    else if (wnext < op) {      /* wrap around window */
+                        from = window + (wsize + wnext - op);
+                        op -= wnext;
+                        if (op < len) {         /* some from end of window */
+                            zmemcpy(out, from, op);
+                            out += op;
+                            len -= op;
+                            from = window;
+                            op = wnext;
+                        }
+                    }
+                    else {                      /* contiguous in window */
+                        from = window + (wnext - op);
+                    }
+                    if (op < len) {             /* some from window */
+                        zmemcpy(out, from, op);
+                        out += op;
+                        len -= op;
+                        out = chunk_copy(out, dist, len);  /* rest from output */
+                    }
+                    else {
+                        zmemcpy(out, from, len);
+                        out += len;
+                    }
+                }
+                else
+                    out = chunk_copy(out, dist, len);   /* direct from output */
+            }
+            else if ((op & 64) == 0) {          /* 2nd level distance code */
+                here = dcode[here.val + (hold & ((1U << op) - 1))];
+                goto dodist;
+            }
+            else {
+                strm->msg = (char *)"invalid distance code";
+                state->mode = BAD;
+                break;
+            }
+        }
+        else if ((op & 64) == 0) {              /* 2nd level length code */
+            here = lcode[here.val + (hold & ((1U << op) - 1))];
+            goto dolen;
+        }
+        else if (op & 32) {                     /* end-of-block */
+            Tracevv((stderr, "inflate:         end of block\n"));
+            state->mode = TYPE;
+            break;
+        }
+        else {
+            strm->msg = (char *)"invalid literal/length code";
+            state->mode = BAD;
+            break;
+        }
+    } while (in < last && out < end);
+
+    /* return unused bytes */
+    len = bits >> 3;
+    in -= len;
+    bits -= len << 3;
+    hold &= ((z_word64)1 << bits) - 1;
+
+    /* update state and return */
+    strm->avail_in -= (unsigned)(in - strm->next_in);
+    strm->next_in = in;
+    strm->avail_out = (unsigned)(limit - out);
+    strm->next_out = out;
+    state->hold = (unsigned long)hold;
+    state->bits = bits;
+    return;
+}
+
+#endif /* Z_X86_SIMD */
@@ -0,0 +1,23 @@
+/* inffast_chunk.h -- header to use inffast_chunk.c
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+/* WARNING: this file should *not* be used by applications. It is
+   part of the implementation of the compression library and is
+   subject to change. Applications should only use zlib.h.
+ */
+
+#include "cpu_features.h"
+
+#ifdef Z_X86_SIMD
+
+/* inflate_fast_chunk() reads the input eight bytes at a time and may write
+   up to a chunk past the end of a match, so it needs more input and output
+   space than inflate_fast() */
+#define INFLATE_CHUNK_SIZE 16
+#define INFLATE_CHUNK_MIN_INPUT 8
+#define INFLATE_CHUNK_MIN_OUTPUT (258 + INFLATE_CHUNK_SIZE - 1)
+
+void ZLIB_INTERNAL inflate_fast_chunk OF((z_streamp strm, unsigned start));
+
+#endif /* Z_X86_SIMD */
@@ -84,6 +84,7 @@
 #include "inftrees.h"
 #include "inflate.h"
 #include "inffast.h"
+#include "inffast_chunk.h"
 
 #ifdef MAKEFIXED
 #  ifndef BUILDFIXED
@@ -184,6 +185,9 @@ int stream_size;
         strm->opaque = (voidpf)0;
     }
     if (strm->zfree == (free_func)0) strm->zfree = zcfree;
+#ifdef Z_X86_SIMD
+    cpu_check_features();
+#endif
     state = (struct inflate_state FAR *)
             ZALLOC(strm, 1, sizeof(struct inflate_state));
     if (state == Z_NULL) return Z_MEM_ERROR;
@@ -1006,6 +1010,12 @@ int flush;
         case LEN:
             if (have >= 6 && left >= 258) {
                 RESTORE();
+#ifdef Z_X86_SIMD
+                if (x86_cpu_has_sse2 && have >= INFLATE_CHUNK_MIN_INPUT &&
+                    left >= INFLATE_CHUNK_MIN_OUTPUT)
+                    inflate_fast_chunk(strm, out);
+                else
+#endif
                 inflate_fast(strm, out);
                 LOAD();
                 if (state->mode == TYPE)
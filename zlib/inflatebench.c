@@ -0,0 +1,446 @@
+/* inflatebench.c -- compare inflate and checksum throughput with and without
+ * the SIMD code paths
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+/*
+   usage: inflatebench [-n iterations] [file ...]
+
+   Each file, or a set of generated samples when none is given, is deflated
+   once with a zlib and once with a gzip wrapper.  Both streams are then
+   inflated with the generic code and with the accelerated code, first in
+   randomly sized pieces to check that the output is the same byte for byte,
+   then whole for timing.  crc32() and adler32() are checked against the
+   generic code over every length and alignment up to a few hundred bytes
+   and timed on the sample.  Exits with status 1 if anything differs.
+
+   This program is built from the library sources rather than linked
+   against it, since it switches the internal processor feature flags.
+ */
+
+#include "zutil.h"
+#include "cpu_features.h"
+#include <stdio.h>
+#include <time.h>
+
+#define SAMPLE_SIZE (4L << 20)
+
+local int iterations = 20;
+local int failed = 0;
+
+#ifdef Z_X86_SIMD
+local int has_sse2, has_ssse3, has_sse42, has_pclmulqdq;
+#endif
+
+void use_simd       OF((int on));
+void *xmalloc       OF((uLong size));
+uLong next_random   OF((uLong *seed));
+void make_text      OF((Bytef *buf, uLong len));
+void make_binary    OF((Bytef *buf, uLong len));
+void make_random    OF((Bytef *buf, uLong len));
+uLong compress_wrapped OF((const Bytef *src, uLong len, Bytef *dst,
+                           uLong cap, int gzip));
+int inflate_pieces  OF((const Bytef *src, uLong len, Bytef *dst, uLong cap,
+                        uLong *seed));
+double time_inflate OF((const Bytef *src, uLong len, Bytef *dst, uLong cap));
+void check_sums     OF((void));
+double time_crc32   OF((const Bytef *buf, uLong len));
+double time_adler32 OF((const Bytef *buf, uLong len));
+void bench          OF((const char *name, const Bytef *data, uLong len));
+int  main           OF((int argc, char *argv[]));
+
+/* ===========================================================================
+ * Switch the accelerated code paths on or off
+ */
+void use_simd(on)
+    int on;
+{
+#ifdef Z_X86_SIMD
+    cpu_check_features();
+    x86_cpu_has_sse2 = on ? has_sse2 : 0;
+    x86_cpu_has_ssse3 = on ? has_ssse3 : 0;
+    x86_cpu_has_sse42 = on ? has_sse42 : 0;
+    x86_cpu_has_pclmulqdq = on ? has_pclmulqdq : 0;
+#else
+    (void)on;
+#endif
+}
+
+void *xmalloc(size)
+    uLong size;
+{
+    void *p = malloc((size_t)size);
+
+    if (p == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+uLong next_random(seed)
+    uLong *seed;
+{
+    *seed = (*seed * 1103515245UL + 12345UL) & 0xffffffffUL;
+    return *seed >> 8;
+}
+
+/* ===========================================================================
+ * Sample data: words of text, structured binary records, and noise
+ */
+void make_text(buf, len)
+    Bytef *buf;
+    uLong len;
+{
+    static const char *words[] = {
+        "the", "mesh", "texture", "of", "and", "material", "pass", "node",
+        "scene", "render", "vertex", "buffer", "shadow", "light", "a", "to",
+        "compositor", "technique", "skeleton", "animation", "is", "in"
+    };
+    uLong seed = 1, i = 0;
+
+    while (i < len) {
+        const char *w = words[next_random(&seed) % (sizeof(words) / sizeof(*words))];
+
+        while (*w && i < len)
+            buf[i++] = (Bytef)*w++;
+        if (i < len)
+            buf[i++] = (Bytef)(next_random(&seed) % 13 ? ' ' : '\n');
+    }
+}
+
+void make_binary(buf, len)
+    Bytef *buf;
+    uLong len;
+{
+    uLong seed = 2, i;
+
+    /* 32 byte records of slowly changing floats and small indices */
+    for (i = 0; i < len; i++) {
+        uLong record = i / 32, field = i % 32;
+
+        if (field < 12)
+            buf[i] = (Bytef)(field % 4 == 3 ? 0x3f : (record * (field + 1)) >> 4);
+        else if (field < 24)
+            buf[i] = (Bytef)(field % 4 < 2 ? next_random(&seed) % 3 : 0);
+        else
+            buf[i] = (Bytef)(record >> (field - 24));
+    }
+}
+
+void make_random(buf, len)
+    Bytef *buf;
+    uLong len;
+{
+    uLong seed = 3, i;
+
+    for (i = 0; i < len; i++)
+        buf[i] = (Bytef)next_random(&seed);
+}
+
+/* ===========================================================================
+ * Deflate with a zlib or gzip wrapper
+ */
+uLong compress_wrapped(src, len, dst, cap, gzip)
+    const Bytef *src;
+    uLong len;
+    Bytef *dst;
+    uLong cap;
+    int gzip;
+{
+    z_stream strm;
+    int err;
+
+    memset(&strm, 0, sizeof(strm));
+    err = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                       gzip ? MAX_WBITS + 16 : MAX_WBITS, 8,
+                       Z_DEFAULT_STRATEGY);
+    if (err != Z_OK) {
+        fprintf(stderr, "deflateInit2 error: %d\n", err);
+        exit(1);
+    }
+    strm.next_in = (Bytef *)src;
+    strm.avail_in = (uInt)len;
+    strm.next_out = dst;
+    strm.avail_out = (uInt)cap;
+    err = deflate(&strm, Z_FINISH);
+    if (err != Z_STREAM_END) {
+        fprintf(stderr, "deflate error: %d\n", err);
+        exit(1);
+    }
+    deflateEnd(&strm);
+    return strm.total_out;
+}
+
+/* ===========================================================================
+ * Inflate feeding input and taking output in random pieces, which moves the
+ * boundaries between the fast and the byte at a time paths around.  Returns
+ * the number of bytes inflated, or -1 on an error.
+ */
+int inflate_pieces(src, len, dst, cap, seed)
+    const Bytef *src;
+    uLong len;
+    Bytef *dst;
+    uLong cap;
+    uLong *seed;
+{
+    z_stream strm;
+    uLong in = 0, out = 0;
+    int err;
+
+    memset(&strm, 0, sizeof(strm));
+    if (inflateInit2(&strm, MAX_WBITS + 32) != Z_OK)
+        return -1;
+    do {
+        uLong ilen = 1 + next_random(seed) % 4096;
+        uLong olen = 1 + next_random(seed) % 8192;
+
+        if (ilen > len - in) ilen = len - in;
+        if (olen > cap - out) olen = cap - out;
+        strm.next_in = (Bytef *)src + in;
+        strm.avail_in = (uInt)ilen;
+        strm.next_out = dst + out;
+        strm.avail_out = (uInt)olen;
+        err = inflate(&strm, Z_NO_FLUSH);
+        in += ilen - strm.avail_in;
+        out += olen - strm.avail_out;
+        if (err == Z_BUF_ERROR && out == cap)
+            break;
+    } while (err == Z_OK || err == Z_BUF_ERROR);
+    inflateEnd(&strm);
+    return err == Z_STREAM_END ? (int)out : -1;
+}
+
+/* ===========================================================================
+ * Seconds per inflate of the whole stream into a buffer big enough for it
+ */
+double time_inflate(src, len, dst, cap)
+    const Bytef *src;
+    uLong len;
+    Bytef *dst;
+    uLong cap;
+{
+    clock_t start = clock();
+    int i;
+
+    for (i = 0; i < iterations; i++) {
+        z_stream strm;
+
+        memset(&strm, 0, sizeof(strm));
+        inflateInit2(&strm, MAX_WBITS + 32);
+        strm.next_in = (Bytef *)src;
+        strm.avail_in = (uInt)len;
+        strm.next_out = dst;
+        strm.avail_out = (uInt)cap;
+        if (inflate(&strm, Z_FINISH) != Z_STREAM_END)
+            failed = 1;
+        inflateEnd(&strm);
+    }
+    return (double)(clock() - start) / CLOCKS_PER_SEC / iterations;
+}
+
+/* ===========================================================================
+ * Check the checksums over every length and alignment up to 300 bytes, and
+ * over a few long runs which span several NMAX blocks
+ */
+void check_sums()
+{
+    static const uLong lengths[] = {1000, 5552, 5553, 65536, 100003};
+    Bytef *buf = (Bytef *)xmalloc(100003 + 16);
+    uLong off, len, i;
+
+    make_random(buf, 100003 + 16);
+    for (off = 0; off < 16; off++) {
+        for (len = 0; len < 300; len++) {
+            uLong crc1, crc2, adler1, adler2;
+
+            use_simd(0);
+            crc1 = crc32(0x12345678UL, buf + off, (uInt)len);
+            adler1 = adler32(0x12345678UL, buf + off, (uInt)len);
+            use_simd(1);
+            crc2 = crc32(0x12345678UL, buf + off, (uInt)len);
+            adler2 = adler32(0x12345678UL, buf + off, (uInt)len);
+            if (crc1 != crc2 || adler1 != adler2) {
+                fprintf(stderr, "checksum mismatch at offset %lu length %lu\n",
+                        off, len);
+                failed = 1;
+            }
+        }
+    }
+    for (i = 0; i < sizeof(lengths) / sizeof(*lengths); i++) {
+        uLong crc1, crc2, adler1, adler2;
+
+        use_simd(0);
+        crc1 = crc32(0L, buf + 3, (uInt)lengths[i]);
+        adler1 = adler32(0xfff0fff0UL, buf + 3, (uInt)lengths[i]);
+        use_simd(1);
+        crc2 = crc32(0L, buf + 3, (uInt)lengths[i]);
+        adler2 = adler32(0xfff0fff0UL, buf + 3, (uInt)lengths[i]);
+        if (crc1 != crc2 || adler1 != adler2) {
+            fprintf(stderr, "checksum mismatch at length %lu\n", lengths[i]);
+            failed = 1;
+        }
+    }
+    free(buf);
+}
+
+double time_crc32(buf, len)
+    const Bytef *buf;
+    uLong len;
+{
+    clock_t start = clock();
+    int i;
+
+    for (i = 0; i < iterations; i++)
+        crc32(0L, buf, (uInt)len);
+    return (double)(clock() - start) / CLOCKS_PER_SEC / iterations;
+}
+
+double time_adler32(buf, len)
+    const Bytef *buf;
+    uLong len;
+{
+    clock_t start = clock();
+    int i;
+
+    for (i = 0; i < iterations; i++)
+        adler32(1L, buf, (uInt)len);
+    return (double)(clock() - start) / CLOCKS_PER_SEC / iterations;
+}
+
+/* ===========================================================================
+ * Check and time one sample
+ */
+void bench(name, data, len)
+    const char *name;
+    const Bytef *data;
+    uLong len;
+{
+    uLong cap = compressBound(len) + 64;
+    Bytef *compr = (Bytef *)xmalloc(cap);
+    Bytef *out = (Bytef *)xmalloc(len + 1);
+    double mb = len / 1048576.0;
+    int gzip;
+
+    for (gzip = 0; gzip < 2; gzip++) {
+        uLong clen = compress_wrapped(data, len, compr, cap, gzip);
+        double base, simd;
+        int on;
+
+        for (on = 0; on < 2; on++) {
+            uLong seed = 7;
+
+            use_simd(on);
+            memset(out, 0, len + 1);
+            if (inflate_pieces(compr, clen, out, len + 1, &seed) != (int)len ||
+                memcmp(out, data, len) != 0) {
+                fprintf(stderr, "%s: %s inflate output differs\n", name,
+                        on ? "accelerated" : "generic");
+                failed = 1;
+            }
+        }
+
+        use_simd(0);
+        base = time_inflate(compr, clen, out, len);
+        use_simd(1);
+        simd = time_inflate(compr, clen, out, len);
+        if (memcmp(out, data, len) != 0) {
+            fprintf(stderr, "%s: inflate output differs\n", name);
+            failed = 1;
+        }
+        printf("%-12s %-4s inflate %8.1f MB/s -> %8.1f MB/s  (x%.2f)\n",
+               name, gzip ? "gzip" : "zlib", mb / base, mb / simd,
+               base / simd);
+    }
+
+    {
+        double base, simd;
+
+        use_simd(0);
+        base = time_crc32(data, len);
+        use_simd(1);
+        simd = time_crc32(data, len);
+        printf("%-12s      crc32   %8.1f MB/s -> %8.1f MB/s  (x%.2f)\n",
+               name, mb / base, mb / simd, base / simd);
+        use_simd(0);
+        base = time_adler32(data, len);
+        use_simd(1);
+        simd = time_adler32(data, len);
+        printf("%-12s      adler32 %8.1f MB/s -> %8.1f MB/s  (x%.2f)\n",
+               name, mb / base, mb / simd, base / simd);
+    }
+
+    free(out);
+    free(compr);
+}
+
+/* ===========================================================================
+ * Usage:  inflatebench [-n iterations] [file ...]
+ */
+int main(argc, argv)
+    int argc;
+    char *argv[];
+{
+    int arg = 1;
+
+#ifdef Z_X86_SIMD
+    cpu_check_features();
+    has_sse2 = x86_cpu_has_sse2;
+    has_ssse3 = x86_cpu_has_ssse3;
+    has_sse42 = x86_cpu_has_sse42;
+    has_pclmulqdq = x86_cpu_has_pclmulqdq;
+    printf("sse2 %d, ssse3 %d, sse4.2 %d, pclmulqdq %d\n", has_sse2,
+           has_ssse3, has_sse42, has_pclmulqdq);
+#else
+    printf("built without the SIMD code paths\n");
+#endif
+
+    if (argc > 2 && strcmp(argv[1], "-n") == 0) {
+        iterations = atoi(argv[2]);
+        if (iterations < 1)
+            iterations = 1;
+        arg = 3;
+    }
+
+    check_sums();
+
+    if (arg == argc) {
+        Bytef *data = (Bytef *)xmalloc(SAMPLE_SIZE);
+
+        make_text(data, SAMPLE_SIZE);
+        bench("text", data, SAMPLE_SIZE);
+        make_binary(data, SAMPLE_SIZE);
+        bench("binary", data, SAMPLE_SIZE);
+        make_random(data, SAMPLE_SIZE);
+        bench("random", data, SAMPLE_SIZE);
+        free(data);
+    }
+    for (; arg < argc; arg++) {
+        FILE *file = fopen(argv[arg], "rb");
+        Bytef *data;
+        long len;
+
+        if (file == NULL || fseek(file, 0, SEEK_END) != 0 ||
+            (len = ftell(file)) <= 0) {
+            fprintf(stderr, "cannot read %s\n", argv[arg]);
+            if (file != NULL)
+                fclose(file);
+            failed = 1;
+            continue;
+        }
+        rewind(file);
+        data = (Bytef *)xmalloc((uLong)len);
+        if (fread(data, 1, (size_t)len, file) != (size_t)len) {
+            fprintf(stderr, "cannot read %s\n", argv[arg]);
+            failed = 1;
+        }
+        else
+            bench(argv[arg], data, (uLong)len);
+        free(data);
+        fclose(file);
+    }
+
+    if (failed)
+        printf("*** output differs ***\n");
+    return failed;
+}
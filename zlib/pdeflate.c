@@ -0,0 +1,766 @@
+/* pdeflate.c -- compress data on several threads into one deflate stream
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+/*
+   The input is cut into blocks of blockSize bytes.  Each block is a job,
+   deflated on its own raw stream after a preset dictionary of the last
+   window's worth of the block before it, and ended with a sync flush, or
+   with Z_FINISH for the last one.  Jobs are kept in a list in input order.
+   The worker threads take them from a queue, and the calling thread writes
+   the ones at the front of the list which are done, combining their check
+   values as it goes.  Job buffers are recycled through a free list, and the
+   number of jobs in flight is limited, so memory does not grow with the
+   length of the input.
+
+   Define Z_NO_THREADS to build without thread support, in which case all
+   blocks are compressed on the calling thread.
+ */
+
+#include "zutil.h"
+#include "pdeflate.h"
+
+#ifndef Z_NO_THREADS
+#  ifdef _WIN32
+#    if !defined(_WIN32_WINNT) || _WIN32_WINNT < 0x0600
+#      undef _WIN32_WINNT
+#      define _WIN32_WINNT 0x0600   /* for condition variables */
+#    endif
+#    include <windows.h>
+#    include <process.h>
+#  else
+#    include <pthread.h>
+#    include <unistd.h>
+#  endif
+#endif
+
+#define DEFAULT_BLOCK (256L << 10)
+#define MIN_BLOCK (32L << 10)
+#define MAX_THREADS 256
+#define JOBS_PER_THREAD 2
+
+/* a piece of the input and what it compresses to */
+typedef struct pdeflate_job_s {
+    struct pdeflate_job_s *order;   /* next job in input order */
+    struct pdeflate_job_s *queue;   /* next job waiting for a thread */
+    Bytef *in;                  /* the block's input */
+    uLong len;                  /* bytes in in */
+    Bytef *dict;                /* end of the previous block's input */
+    uInt dictLen;               /* bytes in dict, 0 for the first block */
+    Bytef *out;                 /* compressed data */
+    uLong outLen;               /* bytes in out */
+    uLong outSize;              /* allocated size of out */
+    uLong check;                /* adler32 or crc32 of in */
+    int last;                   /* true to end the deflate stream */
+    int done;                   /* true once compressed */
+    int err;                    /* Z_OK or an error from compressing */
+} pdeflate_job;
+
+#ifndef Z_NO_THREADS
+#  ifdef _WIN32
+typedef HANDLE pd_thread;
+typedef CRITICAL_SECTION pd_mutex;
+typedef CONDITION_VARIABLE pd_cond;
+#    define PD_LOCK(m) EnterCriticalSection(&(m))
+#    define PD_UNLOCK(m) LeaveCriticalSection(&(m))
+#    define PD_WAIT(c, m) SleepConditionVariableCS(&(c), &(m), INFINITE)
+#    define PD_SIGNAL(c) WakeConditionVariable(&(c))
+#    define PD_BROADCAST(c) WakeAllConditionVariable(&(c))
+#  else
+typedef pthread_t pd_thread;
+typedef pthread_mutex_t pd_mutex;
+typedef pthread_cond_t pd_cond;
+#    define PD_LOCK(m) pthread_mutex_lock(&(m))
+#    define PD_UNLOCK(m) pthread_mutex_unlock(&(m))
+#    define PD_WAIT(c, m) pthread_cond_wait(&(c), &(m))
+#    define PD_SIGNAL(c) pthread_cond_signal(&(c))
+#    define PD_BROADCAST(c) pthread_cond_broadcast(&(c))
+#  endif
+#endif
+
+struct pdeflate_state {
+    int level;                  /* compression level */
+    int wbits;                  /* log2 of the window size */
+    int wrap;                   /* 0 raw, 1 zlib, 2 gzip */
+    uLong blockSize;            /* input per block */
+    uInt dictSize;              /* bytes of dictionary handed on */
+    out_func out;               /* where compressed data goes */
+    void FAR *out_desc;         /* and its argument */
+    int threads;                /* number of compressing threads */
+    int maxJobs;                /* jobs in flight before write() waits */
+    int err;                    /* first error, sticky */
+    int started;                /* true once the header is written */
+    int finished;               /* true once the trailer is written */
+    uLong check;                /* check value of the data written so far */
+    uLong total;                /* uncompressed bytes written, mod 2^32 */
+    pdeflate_job *fill;         /* block collecting input */
+    pdeflate_job *head;         /* oldest job in flight */
+    pdeflate_job *tail;         /* newest job in flight */
+    int jobs;                   /* jobs in flight */
+    pdeflate_job *free;         /* jobs for reuse */
+    z_stream zs;                /* used when there are no threads */
+    int zsInit;                 /* true once zs is initialised */
+#ifndef Z_NO_THREADS
+    pdeflate_job *queue;        /* jobs waiting for a thread */
+    pdeflate_job *queueTail;
+    int stop;                   /* tells the threads to quit */
+    pd_mutex lock;              /* protects the job lists and flags */
+    pd_cond work;               /* signalled when a job is queued */
+    pd_cond done;               /* signalled when a job is compressed */
+    pd_thread *pool;            /* the threads */
+    int running;                /* threads started */
+#endif
+};
+
+local pdeflate_job *new_job OF((pdeflate_streamp s));
+local void free_job OF((pdeflate_job *job));
+local int compress_job OF((pdeflate_streamp s, z_streamp zs,
+                           pdeflate_job *job));
+local int write_out OF((pdeflate_streamp s, const Bytef *buf, uLong len));
+local int write_job OF((pdeflate_streamp s, pdeflate_job *job));
+local int submit OF((pdeflate_streamp s, int last));
+local int drain OF((pdeflate_streamp s, int keep));
+local int cpu_count OF((void));
+
+/* ========================================================================= */
+local int cpu_count()
+{
+#if defined(Z_NO_THREADS)
+    return 1;
+#elif defined(_WIN32)
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return n > 0 ? (int)n : 1;
+#else
+    return 1;
+#endif
+}
+
+/* ========================================================================= */
+local pdeflate_job *new_job(s)
+    pdeflate_streamp s;
+{
+    pdeflate_job *job;
+
+#ifndef Z_NO_THREADS
+    PD_LOCK(s->lock);
+#endif
+    job = s->free;
+    if (job != Z_NULL)
+        s->free = job->order;
+#ifndef Z_NO_THREADS
+    PD_UNLOCK(s->lock);
+#endif
+
+    if (job == Z_NULL) {
+        job = (pdeflate_job *)calloc(1, sizeof(pdeflate_job));
+        if (job == Z_NULL)
+            return Z_NULL;
+        job->in = (Bytef *)malloc((size_t)s->blockSize);
+        job->dict = (Bytef *)malloc(s->dictSize);
+        if (job->in == Z_NULL || job->dict == Z_NULL) {
+            free_job(job);
+            return Z_NULL;
+        }
+    }
+    job->order = job->queue = Z_NULL;
+    job->len = 0;
+    job->dictLen = 0;
+    job->outLen = 0;
+    job->last = job->done = 0;
+    job->err = Z_OK;
+    return job;
+}
+
+local void free_job(job)
+    pdeflate_job *job;
+{
+    free(job->in);
+    free(job->dict);
+    free(job->out);
+    free(job);
+}
+
+/* ===========================================================================
+ * Deflate one block on a raw stream zs which is reset for it.  Runs on any
+ * thread and only touches the job.
+ */
+local int compress_job(s, zs, job)
+    pdeflate_streamp s;
+    z_streamp zs;
+    pdeflate_job *job;
+{
+    int flush = job->last ? Z_FINISH : Z_SYNC_FLUSH;
+    uLong need;
+    int ret;
+
+    if (deflateReset(zs) != Z_OK)
+        return Z_STREAM_ERROR;
+    if (job->dictLen &&
+        deflateSetDictionary(zs, job->dict, job->dictLen) != Z_OK)
+        return Z_STREAM_ERROR;
+
+    /* room for incompressible data, the sync flush's empty stored block
+       and a final empty block */
+    need = deflateBound(zs, job->len) + 16;
+    if (job->outSize < need) {
+        free(job->out);
+        job->out = (Bytef *)malloc((size_t)need);
+        if (job->out == Z_NULL) {
+            job->outSize = 0;
+            return Z_MEM_ERROR;
+        }
+        job->outSize = need;
+    }
+
+    zs->next_in = job->in;
+    zs->avail_in = (uInt)job->len;
+    job->outLen = 0;
+    for (;;) {
+        zs->next_out = job->out + job->outLen;
+        zs->avail_out = (uInt)(job->outSize - job->outLen);
+        ret = deflate(zs, flush);
+        job->outLen = job->outSize - zs->avail_out;
+        if (ret == Z_STREAM_END || (ret == Z_OK && !job->last &&
+                                    zs->avail_out != 0))
+            break;
+        if (ret != Z_OK && ret != Z_BUF_ERROR)
+            return ret;
+
+        /* out of room after all, grow the buffer and go on */
+        {
+            Bytef *more = (Bytef *)realloc(job->out,
+                                           (size_t)(job->outSize * 2));
+
+            if (more == Z_NULL)
+                return Z_MEM_ERROR;
+            job->out = more;
+            job->outSize *= 2;
+        }
+    }
+
+    if (s->wrap == 2)
+        job->check = crc32(crc32(0L, Z_NULL, 0), job->in, (uInt)job->len);
+    else if (s->wrap == 1)
+        job->check = adler32(adler32(0L, Z_NULL, 0), job->in, (uInt)job->len);
+    return Z_OK;
+}
+
+#ifndef Z_NO_THREADS
+
+/* ===========================================================================
+ * Compressing thread: takes jobs off the queue until told to stop
+ */
+#ifdef _WIN32
+local unsigned __stdcall compress_thread(void *arg)
+#else
+local void *compress_thread(void *arg)
+#endif
+{
+    pdeflate_streamp s = (pdeflate_streamp)arg;
+    z_stream zs;
+    int init;
+
+    memset(&zs, 0, sizeof(zs));
+    init = deflateInit2(&zs, s->level, Z_DEFLATED, -s->wbits, 8,
+                        Z_DEFAULT_STRATEGY);
+
+    PD_LOCK(s->lock);
+    for (;;) {
+        pdeflate_job *job;
+        int ret;
+
+        while (s->queue == Z_NULL && !s->stop)
+            PD_WAIT(s->work, s->lock);
+        if (s->stop)
+            break;
+        job = s->queue;
+        s->queue = job->queue;
+        if (s->queue == Z_NULL)
+            s->queueTail = Z_NULL;
+        PD_UNLOCK(s->lock);
+
+        ret = init == Z_OK ? compress_job(s, &zs, job) : init;
+
+        PD_LOCK(s->lock);
+        job->err = ret;
+        job->done = 1;
+        PD_BROADCAST(s->done);
+    }
+    PD_UNLOCK(s->lock);
+
+    if (init == Z_OK)
+        deflateEnd(&zs);
+    return 0;
+}
+
+#endif /* !Z_NO_THREADS */
+
+/* ========================================================================= */
+local int write_out(s, buf, len)
+    pdeflate_streamp s;
+    const Bytef *buf;
+    uLong len;
+{
+    while (len) {
+        unsigned n = len > 0x40000000UL ? 0x40000000U : (unsigned)len;
+
+        if (s->out(s->out_desc, (unsigned char FAR *)buf, n))
+            return Z_BUF_ERROR;
+        buf += n;
+        len -= n;
+    }
+    return Z_OK;
+}
+
+/* ===========================================================================
+ * Write out a compressed job, after the header if it is the first
+ */
+local int write_job(s, job)
+    pdeflate_streamp s;
+    pdeflate_job *job;
+{
+    Bytef head[10];
+    int ret;
+
+    if (!s->started) {
+        s->started = 1;
+        if (s->wrap == 1) {
+            uInt header = (Z_DEFLATED + ((s->wbits - 8) << 4)) << 8;
+            uInt level_flags;
+
+            /* the same as deflate() writes */
+            if (s->level == Z_DEFAULT_COMPRESSION || s->level == 6)
+                level_flags = 2;
+            else if (s->level < 2)
+                level_flags = 0;
+            else if (s->level < 6)
+                level_flags = 1;
+            else
+                level_flags = 3;
+            header |= (level_flags << 6);
+            header += 31 - (header % 31);
+            head[0] = (Bytef)(header >> 8);
+            head[1] = (Bytef)(header & 0xff);
+            if ((ret = write_out(s, head, 2)) != Z_OK)
+                return ret;
+        }
+        else if (s->wrap == 2) {
+            head[0] = 31;
+            head[1] = 139;
+            head[2] = 8;                        /* deflate */
+            head[3] = 0;                        /* no flags */
+            head[4] = head[5] = head[6] = head[7] = 0;   /* no time */
+            head[8] = (Bytef)(s->level == 9 ? 2 :
+                               (s->level >= 0 && s->level < 2 ? 4 : 0));
+            head[9] = OS_CODE;
+            if ((ret = write_out(s, head, 10)) != Z_OK)
+                return ret;
+        }
+    }
+
+    if ((ret = write_out(s, job->out, job->outLen)) != Z_OK)
+        return ret;
+
+    if (s->wrap == 2)
+        s->check = crc32_combine(s->check, job->check, (z_off_t)job->len);
+    else if (s->wrap == 1)
+        s->check = adler32_combine(s->check, job->check, (z_off_t)job->len);
+    s->total += job->len;
+    return Z_OK;
+}
+
+/* ===========================================================================
+ * Write out the jobs at the front of the list which are done, first
+ * waiting for them while more than keep jobs are in flight
+ */
+local int drain(s, keep)
+    pdeflate_streamp s;
+    int keep;
+{
+    for (;;) {
+        pdeflate_job *job;
+        int ret;
+
+#ifndef Z_NO_THREADS
+        PD_LOCK(s->lock);
+        while (s->head != Z_NULL && !s->head->done && s->jobs > keep)
+            PD_WAIT(s->done, s->lock);
+#endif
+        job = s->head;
+        if (job == Z_NULL || !job->done) {
+#ifndef Z_NO_THREADS
+            PD_UNLOCK(s->lock);
+#endif
+            return Z_OK;
+        }
+        s->head = job->order;
+        if (s->head == Z_NULL)
+            s->tail = Z_NULL;
+        s->jobs--;
+#ifndef Z_NO_THREADS
+        PD_UNLOCK(s->lock);
+#endif
+
+        ret = job->err;
+        if (ret == Z_OK)
+            ret = write_job(s, job);
+
+#ifndef Z_NO_THREADS
+        PD_LOCK(s->lock);
+#endif
+        job->order = s->free;
+        s->free = job;
+#ifndef Z_NO_THREADS
+        PD_UNLOCK(s->lock);
+#endif
+        if (ret != Z_OK)
+            return ret;
+    }
+}
+
+/* ===========================================================================
+ * Hand the block being filled to the threads, and start the next one with
+ * the end of it as its dictionary unless this is the last
+ */
+local int submit(s, last)
+    pdeflate_streamp s;
+    int last;
+{
+    pdeflate_job *job = s->fill;
+    pdeflate_job *next = Z_NULL;
+
+    if (!last) {
+        next = new_job(s);
+        if (next == Z_NULL)
+            return Z_MEM_ERROR;
+        next->dictLen = s->dictSize;
+        zmemcpy(next->dict, job->in + job->len - s->dictSize, s->dictSize);
+    }
+    job->last = last;
+    s->fill = next;
+
+#ifndef Z_NO_THREADS
+    if (s->running) {
+        PD_LOCK(s->lock);
+        if (s->tail != Z_NULL)
+            s->tail->order = job;
+        else
+            s->head = job;
+        s->tail = job;
+        s->jobs++;
+        if (s->queueTail != Z_NULL)
+            s->queueTail->queue = job;
+        else
+            s->queue = job;
+        s->queueTail = job;
+        PD_SIGNAL(s->work);
+        PD_UNLOCK(s->lock);
+        return drain(s, s->maxJobs);
+    }
+#endif
+
+    /* no threads, compress it here */
+    if (!s->zsInit) {
+        if (deflateInit2(&s->zs, s->level, Z_DEFLATED, -s->wbits, 8,
+                         Z_DEFAULT_STRATEGY) != Z_OK)
+            return Z_MEM_ERROR;
+        s->zsInit = 1;
+    }
+    job->err = compress_job(s, &s->zs, job);
+    job->done = 1;
+    s->head = s->tail = job;
+    s->jobs = 1;
+    return drain(s, 0);
+}
+
+/* ========================================================================= */
+int ZEXPORT pdeflateInit(strm, level, windowBits, threads, blockSize, out,
+                         out_desc)
+    pdeflate_streamp *strm;
+    int level;
+    int windowBits;
+    int threads;
+    uLong blockSize;
+    out_func out;
+    void FAR *out_desc;
+{
+    pdeflate_streamp s;
+    int wrap = 1;
+
+    if (strm == Z_NULL || out == Z_NULL)
+        return Z_STREAM_ERROR;
+    *strm = Z_NULL;
+    if (windowBits < 0) {
+        wrap = 0;
+        windowBits = -windowBits;
+    }
+    else if (windowBits > 15) {
+        wrap = 2;
+        windowBits -= 16;
+    }
+    if (windowBits < 8 || windowBits > 15 ||
+        level < Z_DEFAULT_COMPRESSION || level > 9 || threads < 0)
+        return Z_STREAM_ERROR;
+    if (blockSize == 0)
+        blockSize = DEFAULT_BLOCK;
+    if (blockSize < MIN_BLOCK || (uInt)blockSize != blockSize)
+        return Z_STREAM_ERROR;
+    if (threads == 0)
+        threads = cpu_count();
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+
+    s = (pdeflate_streamp)calloc(1, sizeof(struct pdeflate_state));
+    if (s == Z_NULL)
+        return Z_MEM_ERROR;
+    s->level = level;
+    s->wbits = windowBits;
+    s->wrap = wrap;
+    s->blockSize = blockSize;
+    s->dictSize = 1U << windowBits;
+    s->out = out;
+    s->out_desc = out_desc;
+    s->threads = threads;
+    s->maxJobs = threads * JOBS_PER_THREAD;
+    s->check = wrap == 2 ? crc32(0L, Z_NULL, 0) : adler32(0L, Z_NULL, 0);
+
+#ifndef Z_NO_THREADS
+#  ifdef _WIN32
+    InitializeCriticalSection(&s->lock);
+    InitializeConditionVariable(&s->work);
+    InitializeConditionVariable(&s->done);
+#  else
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->work, NULL);
+    pthread_cond_init(&s->done, NULL);
+#  endif
+    if (threads > 1) {
+        s->pool = (pd_thread *)calloc((size_t)threads, sizeof(pd_thread));
+        if (s->pool == Z_NULL) {
+            pdeflateEnd(s);
+            return Z_MEM_ERROR;
+        }
+        for (; s->running < threads; s->running++) {
+#  ifdef _WIN32
+            s->pool[s->running] = (HANDLE)_beginthreadex(NULL, 0,
+                                      compress_thread, s, 0, NULL);
+            if (s->pool[s->running] == 0)
+                break;
+#  else
+            if (pthread_create(&s->pool[s->running], NULL, compress_thread,
+                               s) != 0)
+                break;
+#  endif
+        }
+        if (s->running < threads) {
+            pdeflateEnd(s);
+            return Z_MEM_ERROR;
+        }
+    }
+#endif
+
+    s->fill = new_job(s);
+    if (s->fill == Z_NULL) {
+        pdeflateEnd(s);
+        return Z_MEM_ERROR;
+    }
+    *strm = s;
+    return Z_OK;
+}
+
+/* ========================================================================= */
+int ZEXPORT pdeflateWrite(strm, buf, len)
+    pdeflate_streamp strm;
+    const Bytef *buf;
+    uLong len;
+{
+    pdeflate_streamp s = strm;
+
+    if (s == Z_NULL || s->finished || (buf == Z_NULL && len))
+        return Z_STREAM_ERROR;
+    if (s->err != Z_OK)
+        return s->err;
+
+    while (len) {
+        pdeflate_job *job = s->fill;
+        uLong n = s->blockSize - job->len;
+
+        if (n > len)
+            n = len;
+        zmemcpy(job->in + job->len, buf, (uInt)n);
+        job->len += n;
+        buf += n;
+        len -= n;
+        if (job->len == s->blockSize &&
+            (s->err = submit(s, 0)) != Z_OK)
+            return s->err;
+    }
+    return Z_OK;
+}
+
+/* ========================================================================= */
+int ZEXPORT pdeflateFinish(strm)
+    pdeflate_streamp strm;
+{
+    pdeflate_streamp s = strm;
+    Bytef trailer[8];
+
+    if (s == Z_NULL || s->finished)
+        return Z_STREAM_ERROR;
+    if (s->err != Z_OK)
+        return s->err;
+
+    if ((s->err = submit(s, 1)) != Z_OK ||
+        (s->err = drain(s, 0)) != Z_OK)
+        return s->err;
+
+    if (s->wrap == 1) {
+        trailer[0] = (Bytef)(s->check >> 24);
+        trailer[1] = (Bytef)(s->check >> 16);
+        trailer[2] = (Bytef)(s->check >> 8);
+        trailer[3] = (Bytef)s->check;
+        s->err = write_out(s, trailer, 4);
+    }
+    else if (s->wrap == 2) {
+        trailer[0] = (Bytef)s->check;
+        trailer[1] = (Bytef)(s->check >> 8);
+        trailer[2] = (Bytef)(s->check >> 16);
+        trailer[3] = (Bytef)(s->check >> 24);
+        trailer[4] = (Bytef)s->total;
+        trailer[5] = (Bytef)(s->total >> 8);
+        trailer[6] = (Bytef)(s->total >> 16);
+        trailer[7] = (Bytef)(s->total >> 24);
+        s->err = write_out(s, trailer, 8);
+    }
+    if (s->err != Z_OK)
+        return s->err;
+    s->finished = 1;
+    return Z_STREAM_END;
+}
+
+/* ========================================================================= */
+int ZEXPORT pdeflateEnd(strm)
+    pdeflate_streamp strm;
+{
+    pdeflate_streamp s = strm;
+    pdeflate_job *job;
+
+    if (s == Z_NULL)
+        return Z_STREAM_ERROR;
+
+#ifndef Z_NO_THREADS
+    PD_LOCK(s->lock);
+    s->stop = 1;
+    PD_BROADCAST(s->work);
+    PD_UNLOCK(s->lock);
+    while (s->running) {
+        s->running--;
+#  ifdef _WIN32
+        WaitForSingleObject(s->pool[s->running], INFINITE);
+        CloseHandle(s->pool[s->running]);
+#  else
+        pthread_join(s->pool[s->running], NULL);
+#  endif
+    }
+    free(s->pool);
+#  ifdef _WIN32
+    DeleteCriticalSection(&s->lock);
+#  else
+    pthread_cond_destroy(&s->done);
+    pthread_cond_destroy(&s->work);
+    pthread_mutex_destroy(&s->lock);
+#  endif
+#endif
+
+    /* the threads are gone, so every job is on one of these lists */
+    while ((job = s->head) != Z_NULL) {
+        s->head = job->order;
+        free_job(job);
+    }
+    while ((job = s->free) != Z_NULL) {
+        s->free = job->order;
+        free_job(job);
+    }
+    if (s->fill != Z_NULL)
+        free_job(s->fill);
+    if (s->zsInit)
+        deflateEnd(&s->zs);
+    free(s);
+    return Z_OK;
+}
+
+/* ========================================================================= */
+uLong ZEXPORT pdeflateBound(sourceLen, blockSize)
+    uLong sourceLen;
+    uLong blockSize;
+{
+    uLong blocks;
+
+    if (blockSize == 0)
+        blockSize = DEFAULT_BLOCK;
+    if (blockSize < MIN_BLOCK)
+        blockSize = MIN_BLOCK;
+    blocks = sourceLen / blockSize + 1;
+
+    /* stored blocks at worst, five bytes a sync flush and a final block in
+       each, and the largest header and trailer */
+    return sourceLen + (sourceLen >> 12) + (sourceLen >> 14) +
+           (sourceLen >> 25) + blocks * 16 + 18;
+}
+
+/* ========================================================================= */
+typedef struct {
+    Bytef *next;
+    uLong left;
+} buffer_desc;
+
+local int buffer_out OF((void FAR *desc, unsigned char FAR *buf,
+                         unsigned len));
+
+local int buffer_out(desc, buf, len)
+    void FAR *desc;
+    unsigned char FAR *buf;
+    unsigned len;
+{
+    buffer_desc *b = (buffer_desc *)desc;
+
+    if (len > b->left)
+        return 1;
+    zmemcpy(b->next, buf, len);
+    b->next += len;
+    b->left -= len;
+    return 0;
+}
+
+int ZEXPORT compressParallel(dest, destLen, source, sourceLen, level, threads)
+    Bytef *dest;
+    uLongf *destLen;
+    const Bytef *source;
+    uLong sourceLen;
+    int level;
+    int threads;
+{
+    pdeflate_streamp strm;
+    buffer_desc b;
+    int err;
+
+    b.next = dest;
+    b.left = *destLen;
+    err = pdeflateInit(&strm, level, MAX_WBITS, threads, 0, buffer_out, &b);
+    if (err != Z_OK)
+        return err;
+    err = pdeflateWrite(strm, source, sourceLen);
+    if (err == Z_OK)
+        err = pdeflateFinish(strm);
+    pdeflateEnd(strm);
+    if (err != Z_STREAM_END)
+        return err;
+    *destLen = (uLong)(b.next - dest);
+    return Z_OK;
+}
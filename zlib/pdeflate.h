@@ -0,0 +1,108 @@
+/* pdeflate.h -- interface of the parallel deflate compressor
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+#ifndef PDEFLATE_H
+#define PDEFLATE_H
+
+#include "zlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+     The parallel compressor splits its input into blocks and deflates them
+   on several threads at once.  Each block is primed with the last 32K of the
+   block before it as a preset dictionary, so matches can still reach back
+   across block boundaries and compression is within a fraction of a percent
+   of deflate() at the same level.  Every block but the last ends with a sync
+   flush, leaving it on a byte boundary without the final bit, and the blocks
+   are written out in order behind a zlib or gzip header.  The check value in
+   the trailer is put together from the blocks' own with adler32_combine() or
+   crc32_combine().  The result is one ordinary stream which any inflater
+   reads.
+
+     The compressed data depends only on the level, the window size and the
+   block size, not on the number of threads or on how the input is handed to
+   pdeflateWrite(), so a build gives the same output on every machine.
+
+     Compressed data is passed to the out function supplied to
+   pdeflateInit(), the same type as inflateBack() uses, always from the
+   thread calling pdeflateWrite() or pdeflateFinish() and always in order.
+*/
+
+typedef struct pdeflate_state FAR *pdeflate_streamp;
+
+ZEXTERN int ZEXPORT pdeflateInit OF((pdeflate_streamp *strm, int level,
+                                     int windowBits, int threads,
+                                     uLong blockSize, out_func out,
+                                     void FAR *out_desc));
+/*
+     Creates a parallel compressor in *strm.  level is as for deflateInit(),
+   and windowBits as for deflateInit2(): 8..15 for a zlib stream, 16 more for
+   a gzip stream with a minimal header, and -8..-15 for raw deflate data.
+   threads is the number of threads compressing, 0 for as many as there are
+   processors; with 1 all work is done on the calling thread.  blockSize is
+   the amount of input each block gets, 0 for the default of 256K, and must
+   be at least 32K otherwise.  Larger blocks lose less to the sync flushes,
+   smaller ones give more parallelism on small inputs.
+
+     pdeflateInit returns Z_OK on success, Z_MEM_ERROR if there was not
+   enough memory or the threads could not be started, and Z_STREAM_ERROR if
+   a parameter is invalid.
+*/
+
+ZEXTERN int ZEXPORT pdeflateWrite OF((pdeflate_streamp strm,
+                                      const Bytef *buf, uLong len));
+/*
+     Adds len bytes from buf to the data to compress.  Blocks are handed to
+   the threads as they fill up and compressed data is passed on as soon as
+   it is ready in order, so this may call the out function.  At most two
+   blocks per thread are in flight at once; past that pdeflateWrite waits
+   for the oldest, which bounds the memory used however much is written.
+
+     Returns Z_OK, Z_BUF_ERROR if the out function returned non-zero,
+   Z_MEM_ERROR if a block ran out of memory, or Z_STREAM_ERROR if the stream
+   is invalid or already finished.  Once an error is returned the stream
+   only accepts pdeflateEnd().
+*/
+
+ZEXTERN int ZEXPORT pdeflateFinish OF((pdeflate_streamp strm));
+/*
+     Compresses what is left, waits for all blocks and writes the end of
+   the stream and the trailer.  Returns Z_STREAM_END once everything has
+   been passed to the out function, or one of the errors of pdeflateWrite().
+*/
+
+ZEXTERN int ZEXPORT pdeflateEnd OF((pdeflate_streamp strm));
+/*
+     Stops the threads and frees the compressor.  Anything not yet finished
+   with pdeflateFinish() is discarded.  Returns Z_OK, or Z_STREAM_ERROR if
+   strm is null.
+*/
+
+ZEXTERN int ZEXPORT compressParallel OF((Bytef *dest, uLongf *destLen,
+                                         const Bytef *source,
+                                         uLong sourceLen, int level,
+                                         int threads));
+/*
+     Compresses the source buffer into a zlib stream in the destination
+   buffer with pdeflate, as compress2() does.  destLen is the size of the
+   destination buffer on entry, which should be at least the value
+   returned by pdeflateBound(), and the size of the compressed data on
+   exit.  Returns Z_OK, Z_MEM_ERROR, Z_BUF_ERROR if the destination buffer
+   was too small, or Z_STREAM_ERROR if a parameter is invalid.
+*/
+
+ZEXTERN uLong ZEXPORT pdeflateBound OF((uLong sourceLen, uLong blockSize));
+/*
+     Returns an upper bound on the size of a zlib or gzip stream written by
+   pdeflate with the given block size, 0 for the default.
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PDEFLATE_H */
@@ -0,0 +1,352 @@
+/* pdeflatetest.c -- test and time the parallel deflate compressor
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+/*
+   usage: pdeflatetest [-t] [file]
+
+   Compresses generated samples, and the file if one is given, as zlib, gzip
+   and raw streams with several thread counts and block sizes, handing the
+   input over in odd sized pieces.  Checks that inflate() reads every stream
+   back to the input, and that the output is the same whatever the number
+   of threads.  With -t it then times deflate() against pdeflate on the file
+   or on a generated sample.  Exits with status 1 if anything fails.
+ */
+
+#include "zlib.h"
+#include "pdeflate.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <sys/time.h>
+#endif
+
+#define SAMPLE_SIZE (3L << 20)
+
+typedef struct {
+    Bytef *buf;
+    uLong len;
+    uLong size;
+} sink;
+
+static int failed = 0;
+
+int sink_out        OF((void FAR *desc, unsigned char FAR *buf, unsigned len));
+void *xmalloc       OF((uLong size));
+void make_sample    OF((Bytef *buf, uLong len));
+int pcompress       OF((const Bytef *src, uLong len, int windowBits,
+                        int threads, uLong blockSize, uLong piece, sink *out));
+int check_inflate   OF((const sink *comp, int windowBits, const Bytef *src,
+                        uLong len));
+void test_streams   OF((const Bytef *src, uLong len, const char *name));
+double now          OF((void));
+void time_compress  OF((const Bytef *src, uLong len));
+int  main           OF((int argc, char *argv[]));
+
+int sink_out(desc, buf, len)
+    void FAR *desc;
+    unsigned char FAR *buf;
+    unsigned len;
+{
+    sink *s = (sink *)desc;
+
+    if (s->len + len > s->size) {
+        uLong size = s->size ? s->size : 65536L;
+        Bytef *more;
+
+        while (s->len + len > size)
+            size *= 2;
+        more = (Bytef *)realloc(s->buf, (size_t)size);
+        if (more == NULL)
+            return 1;
+        s->buf = more;
+        s->size = size;
+    }
+    memcpy(s->buf + s->len, buf, len);
+    s->len += len;
+    return 0;
+}
+
+void *xmalloc(size)
+    uLong size;
+{
+    void *p = malloc((size_t)(size ? size : 1));
+
+    if (p == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+/* ===========================================================================
+ * Text with long range repeats, so matches cross block boundaries, broken
+ * up by stretches of noise
+ */
+void make_sample(buf, len)
+    Bytef *buf;
+    uLong len;
+{
+    static const char *words[] = {
+        "pass", "texture_unit", "material", "technique", "{", "}", "ambient",
+        "diffuse", "0.5", "1", "scene_blend", "alpha_blend", "depth_write",
+        "off", "vertex_program_ref", "param_named_auto", "worldviewproj"
+    };
+    uLong seed = 1, i = 0;
+
+    while (i < len) {
+        seed = (seed * 1103515245UL + 12345UL) & 0xffffffffUL;
+        if ((seed >> 8) % 97 == 0) {
+            uLong n = (seed >> 16) % 200;
+
+            while (n-- && i < len) {
+                seed = (seed * 1103515245UL + 12345UL) & 0xffffffffUL;
+                buf[i++] = (Bytef)(seed >> 16);
+            }
+        }
+        else {
+            const char *w = words[(seed >> 8) % (sizeof(words) / sizeof(*words))];
+
+            while (*w && i < len)
+                buf[i++] = (Bytef)*w++;
+            if (i < len)
+                buf[i++] = (Bytef)((seed >> 20) % 5 ? ' ' : '\n');
+        }
+    }
+}
+
+/* ===========================================================================
+ * Compress src with pdeflate, writing it piece bytes at a time
+ */
+int pcompress(src, len, windowBits, threads, blockSize, piece, out)
+    const Bytef *src;
+    uLong len;
+    int windowBits;
+    int threads;
+    uLong blockSize;
+    uLong piece;
+    sink *out;
+{
+    pdeflate_streamp strm;
+    uLong done = 0;
+    int err;
+
+    out->len = 0;
+    err = pdeflateInit(&strm, Z_DEFAULT_COMPRESSION, windowBits, threads,
+                       blockSize, sink_out, out);
+    if (err != Z_OK)
+        return err;
+    while (err == Z_OK && done < len) {
+        uLong n = len - done < piece ? len - done : piece;
+
+        err = pdeflateWrite(strm, src + done, n);
+        done += n;
+    }
+    if (err == Z_OK)
+        err = pdeflateFinish(strm);
+    pdeflateEnd(strm);
+    return err == Z_STREAM_END ? Z_OK : err;
+}
+
+/* ===========================================================================
+ * Inflate a stream with the ordinary inflater and compare it to src
+ */
+int check_inflate(comp, windowBits, src, len)
+    const sink *comp;
+    int windowBits;
+    const Bytef *src;
+    uLong len;
+{
+    z_stream strm;
+    Bytef *out = (Bytef *)xmalloc(len + 1);
+    int err;
+
+    memset(&strm, 0, sizeof(strm));
+    err = inflateInit2(&strm, windowBits);
+    if (err == Z_OK) {
+        strm.next_in = comp->buf;
+        strm.avail_in = (uInt)comp->len;
+        strm.next_out = out;
+        strm.avail_out = (uInt)(len + 1);
+        err = inflate(&strm, Z_FINISH);
+        if (err == Z_STREAM_END && (strm.total_out != len ||
+                                    strm.avail_in != 0 ||
+                                    memcmp(out, src, len) != 0))
+            err = Z_DATA_ERROR;
+        inflateEnd(&strm);
+    }
+    free(out);
+    return err == Z_STREAM_END ? Z_OK : err;
+}
+
+/* ========================================================================= */
+void test_streams(src, len, name)
+    const Bytef *src;
+    uLong len;
+    const char *name;
+{
+    static const int wbits[] = {MAX_WBITS, MAX_WBITS + 16, -MAX_WBITS, 10};
+    static const int threads[] = {1, 2, 4};
+    static const uLong blocks[] = {32768L, 0};
+    unsigned w, t, b;
+
+    for (w = 0; w < sizeof(wbits) / sizeof(*wbits); w++) {
+        for (b = 0; b < sizeof(blocks) / sizeof(*blocks); b++) {
+            sink first, comp;
+
+            memset(&first, 0, sizeof(first));
+            memset(&comp, 0, sizeof(comp));
+            for (t = 0; t < sizeof(threads) / sizeof(*threads); t++) {
+                int err = pcompress(src, len, wbits[w], threads[t], blocks[b],
+                                    t == 0 ? len + 1 : 1000 + 777 * t, &comp);
+
+                if (err == Z_OK)
+                    err = check_inflate(&comp, wbits[w], src, len);
+                if (err != Z_OK) {
+                    fprintf(stderr, "%s: windowBits %d, %d threads, block %lu: "
+                            "error %d\n", name, wbits[w], threads[t],
+                            blocks[b], err);
+                    failed = 1;
+                }
+                if (t == 0) {
+                    sink tmp = first;
+
+                    first = comp;
+                    comp = tmp;
+                }
+                else if (comp.len != first.len ||
+                         memcmp(comp.buf, first.buf, comp.len) != 0) {
+                    fprintf(stderr, "%s: windowBits %d, block %lu: output "
+                            "differs with %d threads\n", name, wbits[w],
+                            blocks[b], threads[t]);
+                    failed = 1;
+                }
+            }
+            free(first.buf);
+            free(comp.buf);
+        }
+    }
+}
+
+/* ===========================================================================
+ * Wall clock time in seconds; clock() would count the time of every thread
+ */
+double now()
+{
+#ifdef _WIN32
+    return GetTickCount() / 1000.0;
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+#endif
+}
+
+/* ===========================================================================
+ * Time deflate() and pdeflate with a few thread counts, repeating each for
+ * a second or so
+ */
+void time_compress(src, len)
+    const Bytef *src;
+    uLong len;
+{
+    uLongf clen = compressBound(len);
+    Bytef *comp = (Bytef *)xmalloc(clen);
+    sink out;
+    double mb = len / 1048576.0;
+    double start, base;
+    int threads, reps;
+
+    memset(&out, 0, sizeof(out));
+    reps = 0;
+    start = now();
+    do {
+        clen = compressBound(len);
+        compress2(comp, &clen, src, len, Z_DEFAULT_COMPRESSION);
+        reps++;
+    } while (now() - start < 1.0);
+    base = (now() - start) / reps;
+    printf("deflate             %8.1f MB/s  %lu bytes\n", mb / base,
+           (uLong)clen);
+
+    for (threads = 2; threads <= 8; threads *= 2) {
+        double t;
+
+        reps = 0;
+        start = now();
+        do {
+            if (pcompress(src, len, MAX_WBITS, threads, 0, len + 1, &out)
+                != Z_OK)
+                failed = 1;
+            reps++;
+        } while (now() - start < 1.0);
+        t = (now() - start) / reps;
+        printf("pdeflate %d threads  %8.1f MB/s  %lu bytes  (x%.2f)\n",
+               threads, mb / t, out.len, base / t);
+    }
+    free(out.buf);
+    free(comp);
+}
+
+/* ========================================================================= */
+int main(argc, argv)
+    int argc;
+    char *argv[];
+{
+    Bytef *sample = (Bytef *)xmalloc(SAMPLE_SIZE);
+    uLong sizes[] = {0, 1, 100, 32768L, 65536L + 5, 262144L, 262144L * 3};
+    Bytef *data = sample;
+    uLong len = SAMPLE_SIZE;
+    int timing = 0, arg = 1;
+    unsigned i;
+
+    if (argc > arg && strcmp(argv[arg], "-t") == 0) {
+        timing = 1;
+        arg++;
+    }
+
+    make_sample(sample, SAMPLE_SIZE);
+    for (i = 0; i < sizeof(sizes) / sizeof(*sizes); i++) {
+        char name[32];
+
+        sprintf(name, "%lu bytes", sizes[i]);
+        test_streams(sample, sizes[i], name);
+    }
+    test_streams(sample, SAMPLE_SIZE, "sample");
+
+    if (argc > arg) {
+        FILE *file = fopen(argv[arg], "rb");
+        long size;
+
+        if (file == NULL || fseek(file, 0, SEEK_END) != 0 ||
+            (size = ftell(file)) <= 0) {
+            fprintf(stderr, "cannot read %s\n", argv[arg]);
+            return 1;
+        }
+        rewind(file);
+        len = (uLong)size;
+        data = (Bytef *)xmalloc(len);
+        if (fread(data, 1, (size_t)len, file) != (size_t)len) {
+            fprintf(stderr, "cannot read %s\n", argv[arg]);
+            return 1;
+        }
+        fclose(file);
+        test_streams(data, len, argv[arg]);
+    }
+
+    if (timing)
+        time_compress(data, len);
+
+    if (data != sample)
+        free(data);
+    free(sample);
+    if (failed)
+        printf("*** pdeflate test FAILED ***\n");
+    else
+        printf("*** pdeflate test OK ***\n");
+    return failed;
+}
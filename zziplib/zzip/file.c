@@ -199,110 +199,108 @@ zzip_file_open(ZZIP_DIR * dir, zzip_char_t * name, int o_mode)
         { dir->errcode = ENOENT; return NULL; }
 
     if (o_mode & ZZIP_NOPATHS)
+    {
         name = filename_basename(name);
 
-    while (1)
-    {
-        register zzip_char_t *hdr_name = hdr->d_name;
+        while (1)
+        {
+            HINT4("name='%s', compr=%d, size=%d\n",
+                  hdr->d_name, hdr->d_compr, hdr->d_usize);
 
-        if (o_mode & ZZIP_NOPATHS)
-            hdr_name = filename_basename(hdr_name);
+            if (! filename_strcmp(filename_basename(hdr->d_name), name))
+                break;
+            if (hdr->d_reclen == 0)
+                { hdr = NULL; break; }
+            hdr = (struct zzip_dir_hdr *) ((char *) hdr + hdr->d_reclen);
+        }
+    } else
+        hdr = __zzip_dir_find(dir, name, filename_strcmp);
 
-        HINT4("name='%s', compr=%d, size=%d\n",
-              hdr->d_name, hdr->d_compr, hdr->d_usize);
+    if (! hdr)
+        { dir->errcode = ZZIP_ENOENT; return NULL; }
 
-        if (! filename_strcmp(hdr_name, name))
-        {
-            switch (hdr->d_compr)
-            {
-            case 0:            /* store */
-            case 8:            /* inflate */
-                break;
-            default:
-                { err = ZZIP_UNSUPP_COMPR; goto error; }
-            }
+    switch (hdr->d_compr)
+    {
+    case 0:            /* store */
+    case 8:            /* inflate */
+        break;
+    default:
+        { err = ZZIP_UNSUPP_COMPR; goto error; }
+    }
 
-            if (dir->cache.locked == NULL)
-                dir->cache.locked = &self;
+    if (dir->cache.locked == NULL)
+        dir->cache.locked = &self;
 
-            if (dir->cache.locked == &self && dir->cache.fp)
-            {
-                fp = dir->cache.fp;
-                dir->cache.fp = NULL;
-                /* memset(zfp, 0, sizeof *fp); cleared in zzip_file_close() */
-            } else
-            {
-                if (! (fp = (ZZIP_FILE *) calloc(1, sizeof(*fp))))
-                    { err =  ZZIP_OUTOFMEM; goto error; }
-            }
+    if (dir->cache.locked == &self && dir->cache.fp)
+    {
+        fp = dir->cache.fp;
+        dir->cache.fp = NULL;
+        /* memset(zfp, 0, sizeof *fp); cleared in zzip_file_close() */
+    } else
+    {
+        if (! (fp = (ZZIP_FILE *) calloc(1, sizeof(*fp))))
+            { err =  ZZIP_OUTOFMEM; goto error; }
+    }
 
-            fp->dir = dir;
-            fp->io = dir->io;
-            dir->refcount++;
+    fp->dir = dir;
+    fp->io = dir->io;
+    dir->refcount++;
 
-            if (dir->cache.locked == &self && dir->cache.buf32k)
-            {
-                fp->buf32k = dir->cache.buf32k;
-                dir->cache.buf32k = NULL;
-            } else
-            {
-                if (! (fp->buf32k = (char *) malloc(ZZIP_32K)))
-                    { err = ZZIP_OUTOFMEM; goto error; }
-            }
+    if (dir->cache.locked == &self && dir->cache.buf32k)
+    {
+        fp->buf32k = dir->cache.buf32k;
+        dir->cache.buf32k = NULL;
+    } else
+    {
+        if (! (fp->buf32k = (char *) malloc(ZZIP_32K)))
+            { err = ZZIP_OUTOFMEM; goto error; }
+    }
 
-            if (dir->cache.locked == &self)
-                dir->cache.locked = NULL;
-            /*
-             * In order to support simultaneous open files in one zip archive
-             * we'll fix the fd offset when opening new file/changing which
-             * file to read...
-             */
+    if (dir->cache.locked == &self)
+        dir->cache.locked = NULL;
+    /*
+     * In order to support simultaneous open files in one zip archive
+     * we'll fix the fd offset when opening new file/changing which
+     * file to read...
+     */
 
-            if (zzip_file_saveoffset(dir->currentfp) < 0)
-                { err = ZZIP_DIR_SEEK; goto error; }
+    if (zzip_file_saveoffset(dir->currentfp) < 0)
+        { err = ZZIP_DIR_SEEK; goto error; }
 
-            fp->offset = hdr->d_off;
-            dir->currentfp = fp;
+    fp->offset = hdr->d_off;
+    dir->currentfp = fp;
 
-            if (dir->io->fd.seeks(dir->fd, hdr->d_off, SEEK_SET) < 0)
-                { err = ZZIP_DIR_SEEK; goto error; }
+    if (dir->io->fd.seeks(dir->fd, hdr->d_off, SEEK_SET) < 0)
+        { err = ZZIP_DIR_SEEK; goto error; }
 
-            {
-                /* skip local header - should test tons of other info,
-                 * but trust that those are correct */
-                zzip_ssize_t dataoff;
-                struct zzip_file_header *p = (void *) fp->buf32k;
+    {
+        /* skip local header - should test tons of other info,
+         * but trust that those are correct */
+        zzip_ssize_t dataoff;
+        struct zzip_file_header *p = (void *) fp->buf32k;
 
-                dataoff = dir->io->fd.read(dir->fd, (void *) p, sizeof(*p));
-                if (dataoff < (zzip_ssize_t) sizeof(*p))
-                    { err = ZZIP_DIR_READ;  goto error; }
-                if (! zzip_file_header_check_magic(p))   /* PK\3\4 */
-                    { err = ZZIP_CORRUPTED; goto error; }
+        dataoff = dir->io->fd.read(dir->fd, (void *) p, sizeof(*p));
+        if (dataoff < (zzip_ssize_t) sizeof(*p))
+            { err = ZZIP_DIR_READ;  goto error; }
+        if (! zzip_file_header_check_magic(p))   /* PK\3\4 */
+            { err = ZZIP_CORRUPTED; goto error; }
 
-                dataoff = zzip_file_header_sizeof_tail(p);
+        dataoff = zzip_file_header_sizeof_tail(p);
 
-                if (dir->io->fd.seeks(dir->fd, dataoff, SEEK_CUR) < 0)
-                    { err = ZZIP_DIR_SEEK; goto error; }
+        if (dir->io->fd.seeks(dir->fd, dataoff, SEEK_CUR) < 0)
+            { err = ZZIP_DIR_SEEK; goto error; }
 
-                fp->dataoffset = dir->io->fd.tells(dir->fd);
-                fp->usize = hdr->d_usize;
-                fp->csize = hdr->d_csize;
-            }
+        fp->dataoffset = dir->io->fd.tells(dir->fd);
+        fp->usize = hdr->d_usize;
+        fp->csize = hdr->d_csize;
+    }
 
-            err = zzip_inflate_init(fp, hdr);
-            if (err)
-                goto error;
+    err = zzip_inflate_init(fp, hdr);
+    if (err)
+        goto error;
+
+    return fp;
 
-            return fp;
-        } else
-        {
-            if (hdr->d_reclen == 0)
-                break;
-            hdr = (struct zzip_dir_hdr *) ((char *) hdr + hdr->d_reclen);
-        }                       /*filename_strcmp */
-    }                           /*forever */
-    dir->errcode = ZZIP_ENOENT;
-    return NULL;
   error:
     if (fp)
         zzip_file_close(fp);
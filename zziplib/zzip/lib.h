@@ -59,6 +59,8 @@ struct zzip_dir
         char * volatile buf32k; 
     } cache;
     struct zzip_dir_hdr * hdr0;  /* zfi; */
+    struct zzip_dir_hdr ** hash; /* hdr0 entries by name, open addressing */
+    unsigned long hashmask;      /* number of hash slots - 1 */
     struct zzip_dir_hdr * hdr;   /* zdp; directory pointer, for dirent stuff */
     struct zzip_file * currentfp; /* last fp used... */
     struct zzip_dirent dirent;
@@ -74,6 +76,11 @@ struct zzip_dir
 int      __zzip_try_open (zzip_char_t* filename, int filemode,
                           zzip_strings_t* ext, zzip_plugin_io_t io);
 
+/* find a directory entry by its full name through the dir's hash index */
+struct zzip_dir_hdr*
+         __zzip_dir_find (ZZIP_DIR* dir, zzip_char_t* name,
+                          int (*cmp)(zzip_char_t*, zzip_char_t*));
+
 ZZIP_DIR * 
 zzip_dir_fdopen(int fd, zzip_error_t * errcode_p);
 
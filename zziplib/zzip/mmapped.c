@@ -151,10 +151,10 @@ zzip_disk_open(char *filename)
         return 0;
     ___ ZZIP_DISK *disk = zzip_disk_mmap(fd);
     if (disk)
-        return disk;
+        { close(fd); return disk; }
     ___ zzip_byte_t *buffer = malloc(st.st_size);
     if (! buffer)
-        return 0;
+        { close(fd); return 0; }
     if ((st.st_size == read(fd, buffer, st.st_size)) &&
         (disk = zzip_disk_new()))
     {
@@ -165,6 +165,7 @@ zzip_disk_open(char *filename)
     } else {
         free(buffer);
     }
+    close(fd);
     return disk;
     ____;
     ____;
@@ -278,6 +279,31 @@ zzip_disk_entry_to_data(ZZIP_DISK * disk, struct zzip_disk_entry * entry)
     return 0;
 }
 
+/** => zzip_disk_entry_to_data
+ * This function takes the offset of a local file header instead of a
+ * central directory entry, as => zzip_dir_stat_offset returns it. That
+ * way a zip opened with => zzip_dir_open can find its files through the
+ * hash index of the ZZIP_DIR and read stored ones from the mapped disk.
+ * It returns null when the header is outside the mapped range or is not
+ * a file header; the caller has to check the data size against endbuf.
+ */
+zzip_byte_t *
+zzip_disk_offset_to_data(ZZIP_DISK * disk, zzip_off_t offset)
+{
+    struct zzip_file_header *file;
+    zzip_byte_t *data;
+    if (offset < 0 || offset > disk->endbuf - disk->buffer
+        || disk->endbuf - disk->buffer - offset < (zzip_off_t) sizeof(*file))
+        return 0;
+    file = (struct zzip_file_header *) (disk->buffer + offset);
+    if (! zzip_file_header_check_magic(file))
+        return 0;
+    data = zzip_file_header_to_data(file);
+    if (data > disk->endbuf)
+        return 0;
+    return data;
+}
+
 /** => zzip_disk_entry_to_data
  * This function does half the job of => zzip_disk_entry_to_data where it
  * can augment with => zzip_file_header_to_data helper from format/fetch.h
@@ -92,6 +92,8 @@ zzip_disk_extern struct zzip_file_header*
 zzip_disk_entry_to_file_header(ZZIP_DISK* disk, ZZIP_DISK_ENTRY* entry);
 zzip_disk_extern zzip_byte_t*
 zzip_disk_entry_to_data(ZZIP_DISK* disk, ZZIP_DISK_ENTRY* entry);
+zzip_disk_extern zzip_byte_t*
+zzip_disk_offset_to_data(ZZIP_DISK* disk, zzip_off_t offset);
 
 zzip_disk_extern ZZIP_DISK_ENTRY*
 zzip_disk_findfile(ZZIP_DISK* disk,
@@ -33,6 +33,20 @@
  */
 int
 zzip_dir_stat(ZZIP_DIR * dir, zzip_char_t * name, ZZIP_STAT * zs, int flags)
+{
+    return (zzip_dir_stat_offset(dir, name, zs, flags) < 0 ? -1 : 0);
+}
+
+/** => zzip_dir_stat
+ * This function does the lookup of => zzip_dir_stat and returns the offset
+ * of the file's local header in the zip-archive, or -1 if there is no such
+ * file. With the offset the data of a stored file can be taken straight
+ * from a => zzip_disk_mmap of the same archive, see
+ * => zzip_disk_offset_to_data
+ */
+zzip_off_t
+zzip_dir_stat_offset(ZZIP_DIR * dir, zzip_char_t * name, ZZIP_STAT * zs,
+                     int flags)
 {
     struct zzip_dir_hdr *hdr = dir->hdr0;
     int (*cmp) (zzip_char_t *, zzip_char_t *);
@@ -50,28 +64,32 @@ zzip_dir_stat(ZZIP_DIR * dir, zzip_char_t * name, ZZIP_STAT * zs, int flags)
         char *n = strrchr(name, '/');
         if (n)
             name = n + 1;
-    }
 
-    while (1)
-    {
-        register char *hdr_name = hdr->d_name;
-        if (flags & ZZIP_IGNOREPATH)
+        while (1)
         {
-            register char *n = strrchr(hdr_name, '/');
-            if (n)
-                hdr_name = n + 1;
-        }
+            register char *hdr_name = hdr->d_name;
+            register char *m = strrchr(hdr_name, '/');
+            if (m)
+                hdr_name = m + 1;
 
-        if (! cmp(hdr_name, name))
-            break;
+            if (! cmp(hdr_name, name))
+                break;
 
-        if (! hdr->d_reclen)
-        {
-            dir->errcode = ZZIP_ENOENT;
-            return -1;
+            if (! hdr->d_reclen)
+            {
+                hdr = 0;
+                break;
+            }
+
+            hdr = (struct zzip_dir_hdr *) ((char *) hdr + hdr->d_reclen);
         }
+    } else
+        hdr = __zzip_dir_find(dir, name, cmp);
 
-        hdr = (struct zzip_dir_hdr *) ((char *) hdr + hdr->d_reclen);
+    if (! hdr)
+    {
+        dir->errcode = ZZIP_ENOENT;
+        return -1;
     }
 
     zs->d_compr = hdr->d_compr;
@@ -79,7 +97,7 @@ zzip_dir_stat(ZZIP_DIR * dir, zzip_char_t * name, ZZIP_STAT * zs, int flags)
     zs->st_size = hdr->d_usize;
     zs->d_name = hdr->d_name;
 
-    return 0;
+    return hdr->d_off;
 }
 
 /** => zzip_dir_stat
@@ -567,6 +567,108 @@ __zzip_parse_root_directory(int fd,
 #  endif
 }
 
+/*
+ * The hash folds ascii case and takes a backslash for a slash, so the
+ * caseless lookups of => zzip_file_open and => zzip_dir_stat land on the
+ * same slot as the exact ones and only the compare function differs.
+ */
+static unsigned long
+__zzip_name_hash(zzip_char_t * name)
+{
+    register unsigned long h = 2166136261UL;
+    register int c;
+
+    while ((c = (unsigned char) *name++))
+    {
+        if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+        else if (c == '\\')
+            c = '/';
+        h = (h ^ c) * 16777619UL;
+    }
+    return h;
+}
+
+/**
+ * This function is used by => zzip_dir_fdopen after the central directory
+ * has been parsed. It builds an open addressing table over the entries in
+ * hdr0, at most half full, so that looking up a name does not walk the
+ * whole directory. Entries are put in directory order, which makes a
+ * lookup return the first of several entries with the same name just
+ * like the scan did. If there is no memory for the table the lookups
+ * simply keep scanning.
+ */
+static void
+__zzip_dir_hash(ZZIP_DIR * dir)
+{
+    struct zzip_dir_hdr *hdr = dir->hdr0;
+    unsigned long entries = 1;
+    unsigned long size = 16;
+
+    if (! hdr)
+        return;
+
+    for (; hdr->d_reclen; entries++)
+        hdr = (struct zzip_dir_hdr *) ((char *) hdr + hdr->d_reclen);
+    while (size < entries * 2)
+        size <<= 1;
+
+    dir->hash = (struct zzip_dir_hdr **) calloc(size, sizeof(*dir->hash));
+    if (! dir->hash)
+        return;
+    dir->hashmask = size - 1;
+
+    hdr = dir->hdr0;
+    while (1)
+    {
+        register unsigned long i = __zzip_name_hash(hdr->d_name) & (size - 1);
+
+        while (dir->hash[i])
+            i = (i + 1) & (size - 1);
+        dir->hash[i] = hdr;
+
+        if (! hdr->d_reclen)
+            break;
+        hdr = (struct zzip_dir_hdr *) ((char *) hdr + hdr->d_reclen);
+    }
+    HINT3("hashed %lu entries in %lu slots", entries, size);
+}
+
+/**
+ * This function is used by => zzip_file_open and => zzip_dir_stat to find
+ * the entry with the given full name, using cmp to compare names. It goes
+ * through the hash index of the dir and only scans the directory when
+ * there is none. Returns null if there is no such entry.
+ */
+struct zzip_dir_hdr *
+__zzip_dir_find(ZZIP_DIR * dir, zzip_char_t * name,
+                int (*cmp) (zzip_char_t *, zzip_char_t *))
+{
+    struct zzip_dir_hdr *hdr;
+
+    if (dir->hash)
+    {
+        register unsigned long i = __zzip_name_hash(name) & dir->hashmask;
+
+        for (; (hdr = dir->hash[i]); i = (i + 1) & dir->hashmask)
+        {
+            if (! cmp(hdr->d_name, name))
+                return hdr;
+        }
+        return 0;
+    }
+
+    for (hdr = dir->hdr0; hdr; )
+    {
+        if (! cmp(hdr->d_name, name))
+            return hdr;
+        if (! hdr->d_reclen)
+            break;
+        hdr = (struct zzip_dir_hdr *) ((char *) hdr + hdr->d_reclen);
+    }
+    return 0;
+}
+
 /* ------------------------- high-level interface ------------------------- */
 
 #ifndef O_BINARY
@@ -643,6 +745,8 @@ zzip_dir_free(ZZIP_DIR * dir)
         dir->io->fd.close(dir->fd);
     if (dir->hdr0)
         free(dir->hdr0);
+    if (dir->hash)
+        free(dir->hash);
     if (dir->cache.fp)
         free(dir->cache.fp);
     if (dir->cache.buf32k)
@@ -742,6 +846,8 @@ __zzip_dir_parse(ZZIP_DIR * dir)
     if ((rv = __zzip_parse_root_directory(dir->fd, &trailer, &dir->hdr0,
                                           dir->io)) != 0)
         { goto error; }
+
+    __zzip_dir_hash(dir);
   error:
     return rv;
 }
@@ -217,6 +217,9 @@ _zzip_export
 int		zzip_dir_stat(ZZIP_DIR * dir, zzip_char_t* name, 
 			      ZZIP_STAT * zs, int flags);
 _zzip_export
+zzip_off_t	zzip_dir_stat_offset(ZZIP_DIR * dir, zzip_char_t* name,
+				     ZZIP_STAT * zs, int flags);
+_zzip_export
 int		zzip_file_stat(ZZIP_FILE * fp, ZZIP_STAT * zs);
 _zzip_export
 int		zzip_fstat(ZZIP_FILE * fp, ZZIP_STAT * zs);